@@ -0,0 +1 @@
+#include "../../src/io/fingerprintdatabase.h"
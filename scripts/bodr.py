@@ -59,6 +59,8 @@ if __name__ == '__main__':
     print ""
     print "const struct ElementData ElementData[] = {"
 
+    symbols = ["Xx"]
+
     for child in root:
         if child.tag == "{http://www.xml-cml.org/schema}atom":
             elementData = ["0" for i in range(11)]
@@ -91,7 +93,30 @@ if __name__ == '__main__':
 
             print "    {{\"{0}\", \"{1}\", {2}, {3}, {4}, {5}, {6}, {7}, {8}, {9}, {10}}},".format(*elementData)
 
+            if elementData[0] != "Xx":
+                symbols.append(elementData[0])
+
     print "};"
     print ""
     print "const Element::AtomicNumberType ElementDataSize = sizeof(ElementData) / sizeof(*ElementData);"
 
+    # symbol table indexed by the first and second letters of the symbol
+    symbolTable = [[0 for i in range(27)] for j in range(26)]
+    for atomicNumber, symbol in enumerate(symbols):
+        if atomicNumber == 0 or len(symbol) > 2:
+            continue
+        elif len(symbol) == 1:
+            symbolTable[ord(symbol[0]) - ord('A')][0] = atomicNumber
+        else:
+            symbolTable[ord(symbol[0]) - ord('A')][ord(symbol[1]) - ord('a') + 1] = atomicNumber
+
+    print ""
+    print "// The atomic number for each one and two letter element symbol. The"
+    print "// first index is the first letter of the symbol. The second index is"
+    print "// 0 for single letter symbols or the second letter of the symbol plus"
+    print "// one for two letter symbols."
+    print "const Element::AtomicNumberType SymbolTable[26][27] = {"
+    for i, row in enumerate(symbolTable):
+        print "    {{{0}}}, // {1}".format(", ".join(str(x) for x in row), chr(ord('A') + i))
+    print "};"
+
@@ -34,18 +34,23 @@
 ******************************************************************************/
 
 #include <string>
+#include <vector>
 #include <iostream>
 
+#include <boost/ref.hpp>
+#include <boost/bind.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/program_options.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <chemkit/chemkit.h>
-#include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
 #include <chemkit/moleculefile.h>
 #include <chemkit/substructurequery.h>
+#include <chemkit/moleculefilereader.h>
+#include <chemkit/substructurescreen.h>
+#include <chemkit/substructureindex.h>
 
 void printHelp(char *argv[], const boost::program_options::options_description &options)
 {
@@ -60,10 +65,55 @@ void printHelp(char *argv[], const boost::program_options::options_description &
     std::cout << options << "\n";
 }
 
+void writeName(const boost::shared_ptr<chemkit::Molecule> &molecule)
+{
+    std::cout << molecule->name() << "\n";
+}
+
+// Returns the candidate molecules from an index one at a time.
+class CandidateSource
+{
+public:
+    CandidateSource(chemkit::SubstructureIndex *index, const std::vector<size_t> &candidates)
+        : m_index(index),
+          m_candidates(candidates),
+          m_position(0),
+          m_failed(false)
+    {
+    }
+
+    boost::shared_ptr<chemkit::Molecule> operator()()
+    {
+        if(m_failed || m_position >= m_candidates.size()){
+            return boost::shared_ptr<chemkit::Molecule>();
+        }
+
+        boost::shared_ptr<chemkit::Molecule> molecule = m_index->molecule(m_candidates[m_position++]);
+        if(!molecule){
+            m_failed = true;
+        }
+
+        return molecule;
+    }
+
+    bool failed() const
+    {
+        return m_failed;
+    }
+
+private:
+    chemkit::SubstructureIndex *m_index;
+    std::vector<size_t> m_candidates;
+    size_t m_position;
+    bool m_failed;
+};
+
 int main(int argc, char *argv[])
 {
     std::string formula;
     std::string fileName;
+    std::string indexFileName;
+    size_t threadCount = 1;
 
     boost::program_options::options_description options;
     options.add_options()
@@ -81,6 +131,14 @@ int main(int argc, char *argv[])
             "Return only non-matching molecules.")
         ("names-only,n",
             "Output only the names of matching molecules.")
+        ("jobs,j",
+            boost::program_options::value<size_t>(&threadCount),
+            "Number of threads to use for matching (0 uses all cores).")
+        ("unordered,u",
+            "Output matching molecules as soon as they are found rather than in input order.")
+        ("index",
+            boost::program_options::value<std::string>(&indexFileName),
+            "Fingerprint index file used to skip molecules that cannot match (created if missing or out of date).")
         ("help,h",
             "Shows this help message");
 
@@ -133,10 +191,10 @@ int main(int argc, char *argv[])
         return -1;
     }
 
-    // read input file
-    chemkit::MoleculeFile inputFile(fileName);
-    if(!inputFile.read()){
-        std::cerr << "Error: failed to read input file: " << inputFile.errorString() << std::endl;
+    // open input file
+    chemkit::MoleculeFileReader reader(fileName);
+    if(!reader.open()){
+        std::cerr << "Error: failed to read input file: " << reader.errorString() << std::endl;
         return -1;
     }
 
@@ -145,6 +203,7 @@ int main(int argc, char *argv[])
     bool exactMatch = variables.find("exact-match") != variables.end();
     bool invertMatch = variables.find("invert-match") != variables.end();
     bool namesOnly = variables.find("names-only") != variables.end();
+    bool unordered = variables.find("unordered") != variables.end();
 
     int flags = 0;
     if(compositionOnly){
@@ -158,23 +217,56 @@ int main(int argc, char *argv[])
     query.setMolecule(patternMolecule);
     query.setFlags(flags);
 
-    chemkit::MoleculeFile outputFile;
+    chemkit::SubstructureScreen screen(query);
+    screen.setThreadCount(threadCount);
+    screen.setInverted(invertMatch);
+    screen.setOrdered(!unordered);
 
-    foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, inputFile.molecules()){
-        bool match = query.matches(molecule.get());
-
-        if((match && !invertMatch) || (!match && invertMatch)){
-            outputFile.addMolecule(molecule);
+    // the index can only exclude molecules so it is not used for inverted
+    // matches and it cannot screen composition matches which ignore bonds
+    chemkit::SubstructureIndex index;
+    bool useIndex = !indexFileName.empty() && !invertMatch && !compositionOnly;
+    if(useIndex){
+        if(!index.read(indexFileName) || index.fileName() != fileName || !index.isCurrent()){
+            if(!index.build(fileName)){
+                std::cerr << "Error: failed to build index: " << index.errorString() << std::endl;
+                return -1;
+            }
+            if(!index.write(indexFileName)){
+                std::cerr << "Warning: failed to write index file: " << index.errorString() << std::endl;
+            }
         }
     }
 
+    chemkit::SubstructureScreen::SourceFunction source;
+    CandidateSource candidateSource(&index, useIndex ? index.candidates(query) : std::vector<size_t>());
+    if(useIndex){
+        source = boost::ref(candidateSource);
+    }
+    else{
+        source = boost::bind(&chemkit::MoleculeFileReader::readNext, &reader);
+    }
+
+    chemkit::MoleculeFile outputFile;
+
     if(namesOnly){
-        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, outputFile.molecules()){
-            std::cout << molecule->name() << "\n";
-        }
+        screen.run(source, writeName);
     }
     else{
-        bool ok = outputFile.write(std::cout, inputFile.formatName());
+        screen.run(source, boost::bind(&chemkit::MoleculeFile::addMolecule, &outputFile, _1));
+    }
+
+    if(candidateSource.failed()){
+        std::cerr << "Error: failed to read input file: " << index.errorString() << std::endl;
+        return -1;
+    }
+    else if(!reader.errorString().empty()){
+        std::cerr << "Error: failed to read input file: " << reader.errorString() << std::endl;
+        return -1;
+    }
+
+    if(!namesOnly){
+        bool ok = outputFile.write(std::cout, reader.formatName());
         if(!ok){
             std::cerr << "Error: failed to write output file: " << outputFile.errorString() << std::endl;
             return -1;
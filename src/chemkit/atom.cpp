@@ -257,9 +257,9 @@ Bond* Atom::bond(size_t index) const
 /// member of.
 Atom::BondRange Atom::bonds() const
 {
-    const std::vector<Bond *> &bonds = m_molecule->d->atomBonds[m_index];
+    m_molecule->insertPendingBonds();
 
-    return boost::make_iterator_range(bonds.begin(), bonds.end());
+    return m_molecule->atomBonds(m_index);
 }
 
 /// Returns the number of bonds that this atom is a member of.
@@ -304,7 +304,7 @@ Atom* Atom::neighbor(size_t index) const
 /// bonded to the atom.
 Atom::NeighborRange Atom::neighbors() const
 {
-    const std::vector<Bond *> &bonds = m_molecule->d->atomBonds[m_index];
+    BondRange bonds = this->bonds();
 
     return boost::make_iterator_range(
                 boost::make_transform_iterator(
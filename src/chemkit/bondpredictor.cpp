@@ -35,9 +35,13 @@
 
 #include "bondpredictor.h"
 
+#include <algorithm>
+
 #include "atom.h"
 #include "foreach.h"
 #include "molecule.h"
+#include "spatialindex.h"
+#include "cartesiancoordinates.h"
 
 namespace chemkit {
 
@@ -45,12 +49,23 @@ namespace chemkit {
 class BondPredictorPrivate
 {
 public:
+    bool couldBeBonded(Real distance, Real radiusSum) const;
+
     Molecule *molecule;
     Real tolerance;
     Real minimumBondLength;
     Real maximumBondLength;
 };
 
+// Returns true if two atoms distance apart whose covalent radii add
+// up to radiusSum could feasibly be bonded.
+bool BondPredictorPrivate::couldBeBonded(Real distance, Real radiusSum) const
+{
+    return distance > minimumBondLength &&
+           distance < maximumBondLength &&
+           std::abs(radiusSum - distance) < tolerance;
+}
+
 // === BondPredictor ======================================================= //
 /// \class BondPredictor bondpredictor.h chemkit/bondpredictor.h
 /// \ingroup chemkit
@@ -146,21 +161,47 @@ Molecule* BondPredictor::molecule() const
 
 // --- Prediction ---------------------------------------------------------- //
 /// Returns a list of pairs of atoms that are predicted to be bonded.
+///
+/// Only atoms close enough to possibly be bonded are compared, which
+/// are found with a SpatialIndex. The running time is linear in the
+/// number of atoms.
 std::vector<BondPredictor::PredictedBond> BondPredictor::predictedBonds()
 {
     std::vector<PredictedBond> bonds;
 
-    if(!d->molecule)
+    if(!d->molecule || d->molecule->isEmpty())
         return bonds;
 
     std::vector<Atom *> atoms(d->molecule->atoms().begin(), d->molecule->atoms().end());
 
-    for(unsigned int i = 0; i < atoms.size(); i++){
-        for(unsigned int j = i+1; j < atoms.size(); j++){
-            if(couldBeBonded(atoms[i], atoms[j])){
-                bonds.push_back(boost::make_tuple(atoms[i], atoms[j], Bond::Single));
-            }
-        }
+    // cache positions and radii
+    CartesianCoordinates coordinates(atoms.size());
+    std::vector<Real> radii(atoms.size());
+    Real maximumRadius = 0;
+
+    for(size_t i = 0; i < atoms.size(); i++){
+        coordinates[i] = atoms[i]->position();
+        radii[i] = atoms[i]->covalentRadius();
+        maximumRadius = std::max(maximumRadius, radii[i]);
+    }
+
+    // no two atoms further apart than this can be bonded
+    Real cutoff = std::min(maximumBondLength(), 2 * maximumRadius + tolerance());
+    if(cutoff <= 0 || cutoff <= minimumBondLength())
+        return bonds;
+
+    SpatialIndex index(&coordinates, cutoff);
+
+    // the neighbors are sorted so that the bonds are returned in the
+    // same order as a pairwise comparison of all atoms
+    foreach(const SpatialIndex::Pair &pair, index.pairs(cutoff)){
+        size_t i = pair[0];
+        size_t j = pair[1];
+
+        Real distance = (coordinates[i] - coordinates[j]).norm();
+
+        if(d->couldBeBonded(distance, radii[i] + radii[j]))
+            bonds.push_back(boost::make_tuple(atoms[i], atoms[j], Bond::Single));
     }
 
     return bonds;
@@ -182,14 +223,7 @@ void BondPredictor::predictBonds(Molecule *molecule)
 // Returns \c true if the atoms could feasibly be bonded.
 bool BondPredictor::couldBeBonded(Atom *a, Atom *b) const
 {
-    Real distance = a->distance(b);
-
-    if(distance > minimumBondLength() &&
-       distance < maximumBondLength() &&
-       std::abs((a->covalentRadius() + b->covalentRadius()) - distance) < tolerance())
-        return true;
-    else
-        return false;
+    return d->couldBeBonded(a->distance(b), a->covalentRadius() + b->covalentRadius());
 }
 
 } // end chemkit namespace
@@ -86,6 +86,12 @@ size_t CartesianCoordinates::size() const
     return m_coordinates.size();
 }
 
+/// Reserves storage for at least \p size coordinates.
+void CartesianCoordinates::reserve(size_t size)
+{
+    m_coordinates.reserve(size);
+}
+
 /// Returns \c true if the matrix is empty.
 bool CartesianCoordinates::isEmpty() const
 {
@@ -387,6 +393,83 @@ boost::array<Vector3, 4> CartesianCoordinates::wilsonAngleGradientRadians(size_t
                                                          position(l));
 }
 
+/// Returns the distance between the points at \p i and \p j and
+/// stores its gradient in \p gradient.
+Real CartesianCoordinates::distanceAndGradient(size_t i, size_t j, boost::array<Vector3, 2> &gradient) const
+{
+    return chemkit::geometry::distanceAndGradient(position(i), position(j), gradient);
+}
+
+/// Returns the bond angle between the points at \p i, \p j, and
+/// \p k and stores its gradient in \p gradient. The returned angle
+/// is in degrees.
+Real CartesianCoordinates::angleAndGradient(size_t i, size_t j, size_t k, boost::array<Vector3, 3> &gradient) const
+{
+    return chemkit::geometry::angleAndGradient(position(i),
+                                               position(j),
+                                               position(k),
+                                               gradient);
+}
+
+/// Returns the bond angle between the points at \p i, \p j, and
+/// \p k and stores its gradient in \p gradient. The returned angle
+/// is in radians.
+Real CartesianCoordinates::angleAndGradientRadians(size_t i, size_t j, size_t k, boost::array<Vector3, 3> &gradient) const
+{
+    return chemkit::geometry::angleAndGradientRadians(position(i),
+                                                      position(j),
+                                                      position(k),
+                                                      gradient);
+}
+
+/// Returns the torsion angle between the points at \p i, \p j, \p k,
+/// and \p l and stores its gradient in \p gradient. The returned
+/// angle is in degrees.
+Real CartesianCoordinates::torsionAngleAndGradient(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const
+{
+    return chemkit::geometry::torsionAngleAndGradient(position(i),
+                                                      position(j),
+                                                      position(k),
+                                                      position(l),
+                                                      gradient);
+}
+
+/// Returns the torsion angle between the points at \p i, \p j, \p k,
+/// and \p l and stores its gradient in \p gradient. The returned
+/// angle is in radians.
+Real CartesianCoordinates::torsionAngleAndGradientRadians(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const
+{
+    return chemkit::geometry::torsionAngleAndGradientRadians(position(i),
+                                                             position(j),
+                                                             position(k),
+                                                             position(l),
+                                                             gradient);
+}
+
+/// Returns the wilson angle between the points at \p i, \p j, \p k
+/// and \p l and stores its gradient in \p gradient. The returned
+/// angle is in degrees.
+Real CartesianCoordinates::wilsonAngleAndGradient(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const
+{
+    return chemkit::geometry::wilsonAngleAndGradient(position(i),
+                                                     position(j),
+                                                     position(k),
+                                                     position(l),
+                                                     gradient);
+}
+
+/// Returns the wilson angle between the points at \p i, \p j, \p k
+/// and \p l and stores its gradient in \p gradient. The returned
+/// angle is in radians.
+Real CartesianCoordinates::wilsonAngleAndGradientRadians(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const
+{
+    return chemkit::geometry::wilsonAngleAndGradientRadians(position(i),
+                                                            position(j),
+                                                            position(k),
+                                                            position(l),
+                                                            gradient);
+}
+
 // --- Math ---------------------------------------------------------------- //
 /// Returns a new coordinate matrix containing the result of adding
 /// the coordinates with \p coordinates.
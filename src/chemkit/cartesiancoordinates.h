@@ -60,6 +60,7 @@ public:
     // properties
     void resize(size_t size);
     size_t size() const;
+    void reserve(size_t size);
     bool isEmpty() const;
     Matrix toMatrix() const;
 
@@ -98,6 +99,13 @@ public:
     boost::array<Vector3, 4> torsionAngleGradientRadians(size_t i, size_t j, size_t k, size_t l) const;
     boost::array<Vector3, 4> wilsonAngleGradient(size_t i, size_t j, size_t k, size_t l) const;
     boost::array<Vector3, 4> wilsonAngleGradientRadians(size_t i, size_t j, size_t k, size_t l) const;
+    Real distanceAndGradient(size_t i, size_t j, boost::array<Vector3, 2> &gradient) const;
+    Real angleAndGradient(size_t i, size_t j, size_t k, boost::array<Vector3, 3> &gradient) const;
+    Real angleAndGradientRadians(size_t i, size_t j, size_t k, boost::array<Vector3, 3> &gradient) const;
+    Real torsionAngleAndGradient(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const;
+    Real torsionAngleAndGradientRadians(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const;
+    Real wilsonAngleAndGradient(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const;
+    Real wilsonAngleAndGradientRadians(size_t i, size_t j, size_t k, size_t l, boost::array<Vector3, 4> &gradient) const;
 
     // math
     CartesianCoordinates add(const CartesianCoordinates &coordinates) const;
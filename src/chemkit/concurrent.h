@@ -38,13 +38,43 @@
 
 #include "chemkit.h"
 
+#include <vector>
+
+#include <boost/bind.hpp>
 #include <boost/thread.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/scoped_array.hpp>
+
+#include "threadpool.h"
 
 namespace chemkit {
 namespace concurrent {
 
-/// Runs \p function asynchronously in a separate thread. Returns a
-/// future containing the value returned from \p function.
+namespace detail {
+
+template<typename Task>
+inline void runPackagedTask(const boost::shared_ptr<Task> &task)
+{
+    (*task)();
+}
+
+template<typename Input, typename Function>
+inline void mapElement(const std::vector<Input> &input,
+                       typename Function::result_type *output,
+                       const Function &function,
+                       size_t index)
+{
+    output[index] = function(input[index]);
+}
+
+} // end detail namespace
+
+/// Runs \p function asynchronously in the global thread pool. Returns
+/// a future containing the value returned from \p function.
+///
+/// When called from one of the pool's worker threads \p function is
+/// run immediately in the calling thread. This prevents a worker from
+/// blocking on a future that no other thread is free to complete.
 ///
 /// \internal
 template<typename Function>
@@ -52,15 +82,64 @@ inline boost::shared_future<typename Function::result_type> run(const Function &
 {
     typedef typename Function::result_type result_type;
 
-    boost::packaged_task<result_type> task(function);
-    boost::shared_future<result_type> future(task.get_future());
+    boost::shared_ptr<boost::packaged_task<result_type> > task =
+        boost::make_shared<boost::packaged_task<result_type> >(function);
+    boost::shared_future<result_type> future(task->get_future());
 
-    // execute task in detached thread
-    boost::thread(boost::move(task)).detach();
+    ThreadPool *pool = ThreadPool::globalInstance();
+    if(pool->isWorkerThread()){
+        (*task)();
+    }
+    else{
+        pool->submit(boost::bind(&detail::runPackagedTask<boost::packaged_task<result_type> >, task));
+    }
 
     return future;
 }
 
+/// Calls \p function for each index in the range [\p begin, \p end)
+/// using the global thread pool. Returns \c false if \p token was
+/// canceled before all indices were processed.
+///
+/// \see ThreadPool::parallelFor()
+///
+/// \internal
+template<typename Function>
+inline bool parallel_for(size_t begin, size_t end, const Function &function, const CancellationToken *token = 0)
+{
+    return ThreadPool::globalInstance()->parallelFor(begin, end, function, token);
+}
+
+/// Applies \p function to each element in \p input using the global
+/// thread pool and returns the results in the same order. If \p token
+/// is canceled an empty vector is returned.
+///
+/// \internal
+template<typename Input, typename Function>
+inline std::vector<typename Function::result_type> parallel_map(const std::vector<Input> &input,
+                                                                const Function &function,
+                                                                const CancellationToken *token = 0)
+{
+    typedef typename Function::result_type result_type;
+
+    // results are written to a plain array because neighbouring
+    // elements of some vectors (e.g. std::vector<bool>) share storage
+    boost::scoped_array<result_type> output(new result_type[input.size()]);
+
+    bool finished = parallel_for(0, input.size(),
+                                 boost::bind(&detail::mapElement<Input, Function>,
+                                             boost::cref(input),
+                                             output.get(),
+                                             boost::cref(function),
+                                             _1),
+                                 token);
+    if(!finished){
+        return std::vector<result_type>();
+    }
+
+    return std::vector<result_type>(output.get(), output.get() + input.size());
+}
+
 } // end concurrent namespace
 } // end chemkit namespace
 
@@ -39,6 +39,8 @@
 #include "foreach.h"
 #include "molecule.h"
 #include "concurrent.h"
+#include "spatialindex.h"
+#include "cartesiancoordinates.h"
 
 namespace chemkit {
 
@@ -133,13 +135,25 @@ bool CoordinatePredictor::eliminateCloseContacts(Molecule *molecule, Real distan
     bool done = false;
     bool modified = false;
 
+    CartesianCoordinates coordinates(molecule->size());
+    for(size_t i = 0; i < molecule->size(); i++){
+        coordinates[i] = molecule->atom(i)->position();
+    }
+
+    // only atoms in nearby cells need to be checked
+    SpatialIndex index(&coordinates, distance);
+
     while(!done){
         done = true;
 
         for(size_t i = 0; i < molecule->size(); i++){
             Atom *a = molecule->atom(i);
 
-            for(size_t j = i + 1; j < molecule->size(); j++){
+            foreach(size_t j, index.within(a->position(), distance)){
+                if(j <= i){
+                    continue;
+                }
+
                 Atom *b = molecule->atom(j);
 
                 if(a->distance(b) < distance){
@@ -148,6 +162,7 @@ bool CoordinatePredictor::eliminateCloseContacts(Molecule *molecule, Real distan
                     // move atom b by a random unit vector
                     b->setPosition(b->position() +
                                    distance * Vector3::Random().normalized());
+                    index.setPosition(j, b->position());
 
                     // set modified flag
                     modified = true;
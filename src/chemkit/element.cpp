@@ -183,6 +183,101 @@ const struct ElementData ElementData[] = {
 
 const Element::AtomicNumberType ElementDataSize = sizeof(ElementData) / sizeof(*ElementData);
 
+// The atomic number for each one and two letter element symbol. The
+// first index is the first letter of the symbol. The second index is
+// 0 for single letter symbols or the second letter of the symbol plus
+// one for two letter symbols.
+const Element::AtomicNumberType SymbolTable[26][27] = {
+    {0, 0, 0, 89, 0, 0, 0, 47, 0, 0, 0, 0, 13, 95, 0, 0, 0, 0, 18, 33, 85, 79, 0, 0, 0, 0, 0}, // A
+    {5, 56, 0, 0, 0, 4, 0, 0, 107, 83, 0, 97, 0, 0, 0, 0, 0, 0, 35, 0, 0, 0, 0, 0, 0, 0, 0}, // B
+    {6, 20, 0, 0, 48, 58, 98, 0, 0, 0, 0, 0, 17, 96, 112, 27, 0, 0, 24, 55, 0, 29, 0, 0, 0, 0, 0}, // C
+    {0, 0, 105, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 110, 0, 0, 0, 0, 0, 66, 0}, // D
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 68, 99, 0, 63, 0, 0, 0, 0, 0}, // E
+    {9, 0, 0, 0, 0, 26, 0, 0, 0, 0, 0, 0, 0, 100, 0, 0, 0, 0, 87, 0, 0, 0, 0, 0, 0, 0, 0}, // F
+    {0, 31, 0, 0, 64, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // G
+    {1, 0, 0, 0, 0, 2, 72, 80, 0, 0, 0, 0, 0, 0, 0, 67, 0, 0, 0, 108, 0, 0, 0, 0, 0, 0, 0}, // H
+    {53, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 49, 0, 0, 0, 77, 0, 0, 0, 0, 0, 0, 0, 0}, // I
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // J
+    {19, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 36, 0, 0, 0, 0, 0, 0, 0, 0}, // K
+    {0, 57, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 103, 0, 0, 71, 0, 0, 0, 0, 0}, // L
+    {0, 0, 0, 0, 101, 0, 0, 12, 0, 0, 0, 0, 0, 0, 25, 42, 0, 0, 0, 0, 109, 0, 0, 0, 0, 0, 0}, // M
+    {7, 11, 41, 0, 60, 10, 0, 0, 0, 28, 0, 0, 0, 0, 0, 102, 93, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // N
+    {8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 76, 0, 0, 0, 0, 0, 0, 0}, // O
+    {15, 91, 82, 0, 46, 0, 0, 0, 0, 0, 0, 0, 0, 61, 0, 84, 0, 0, 59, 0, 78, 94, 0, 0, 0, 0, 0}, // P
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // Q
+    {0, 88, 37, 0, 0, 75, 104, 111, 45, 0, 0, 0, 0, 0, 86, 0, 0, 0, 0, 0, 0, 44, 0, 0, 0, 0, 0}, // R
+    {16, 0, 51, 21, 0, 34, 0, 106, 0, 14, 0, 0, 0, 62, 50, 0, 0, 0, 38, 0, 0, 0, 0, 0, 0, 0, 0}, // S
+    {0, 73, 65, 43, 0, 52, 0, 0, 90, 22, 0, 0, 81, 69, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // T
+    {92, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // U
+    {23, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // V
+    {74, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // W
+    {0, 0, 0, 0, 0, 54, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // X
+    {39, 0, 70, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, // Y
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 0, 0, 40, 0, 0, 0, 0, 0, 0, 0, 0}, // Z
+};
+
+// --- Symbol Lookup ------------------------------------------------------- //
+// Returns the position of the letter c in the alphabet or -1 if c is
+// not a letter. If caseSensitive is true the letter must be uppercase
+// when upper is true and lowercase otherwise.
+inline int letterIndex(char c, bool upper, bool caseSensitive)
+{
+    if(c >= 'A' && c <= 'Z' && (upper || !caseSensitive)){
+        return c - 'A';
+    }
+    else if(c >= 'a' && c <= 'z' && (!upper || !caseSensitive)){
+        return c - 'a';
+    }
+
+    return -1;
+}
+
+// Returns the atomic number of the element with the given symbol or 0
+// if the symbol is not valid. One and two letter symbols are looked up
+// directly in the symbol table. Only the temporary names for the
+// heaviest elements (e.g. "Uuo") have three letters.
+Element::AtomicNumberType lookupSymbol(const char *symbol, size_t length, bool caseSensitive)
+{
+    if(length == 0 || length > 3){
+        return 0;
+    }
+
+    int first = letterIndex(symbol[0], true, caseSensitive);
+    if(first < 0){
+        return 0;
+    }
+    else if(length == 1){
+        return SymbolTable[first][0];
+    }
+
+    int second = letterIndex(symbol[1], false, caseSensitive);
+    if(second < 0){
+        return 0;
+    }
+    else if(length == 2){
+        return SymbolTable[first][second + 1];
+    }
+
+    int third = letterIndex(symbol[2], false, caseSensitive);
+    if(third < 0){
+        return 0;
+    }
+
+    for(Element::AtomicNumberType i = 1; i < ElementDataSize; i++){
+        const char *elementSymbol = ElementData[i].symbol;
+
+        if(elementSymbol[1] != '\0' &&
+           elementSymbol[2] != '\0' &&
+           elementSymbol[0] - 'A' == first &&
+           elementSymbol[1] - 'a' == second &&
+           elementSymbol[2] - 'a' == third){
+            return i;
+        }
+    }
+
+    return 0;
+}
+
 } // end anonymous namespace
 
 // === Element ============================================================= //
@@ -200,28 +295,14 @@ const Element::AtomicNumberType ElementDataSize = sizeof(ElementData) / sizeof(*
 /// valid the atomic number is set to \c 0.
 Element::Element(const char *symbol)
 {
-    m_atomicNumber = 0;
-
-    for(int i = 1; i < ElementDataSize; i++){
-        if(!strcmp(symbol, ElementData[i].symbol)){
-            m_atomicNumber = i;
-            break;
-        }
-    }
+    m_atomicNumber = lookupSymbol(symbol, strlen(symbol), true);
 }
 
 /// Creates a new element with the given symbol. If the symbol is not
 /// valid the atomic number is set to \c 0.
 Element::Element(const std::string &symbol)
 {
-    m_atomicNumber = 0;
-
-    for(int i = 1; i < ElementDataSize; i++){
-        if(!symbol.compare(ElementData[i].symbol)){
-            m_atomicNumber = i;
-            break;
-        }
-    }
+    m_atomicNumber = lookupSymbol(symbol.c_str(), symbol.size(), true);
 }
 
 // --- Properties ---------------------------------------------------------- //
@@ -454,37 +535,29 @@ Element Element::fromSymbol(const char *symbol)
 /// Returns the element corresponding to \p symbol with \p length.
 Element Element::fromSymbol(const char *symbol, size_t length)
 {
-    for(AtomicNumberType i = 1; i < ElementDataSize; i++){
-        if(strlen(ElementData[i].symbol) == length &&
-           strncmp(symbol, ElementData[i].symbol, length) == 0){
-            return Element(i);
-        }
-    }
-
-    return Element();
+    return Element(lookupSymbol(symbol, length, true));
 }
 
 /// Returns the element corresponding to \p symbol.
 Element Element::fromSymbol(char symbol)
 {
-    switch(symbol){
-        case 'H': return Element(1);
-        case 'B': return Element(5);
-        case 'C': return Element(6);
-        case 'N': return Element(7);
-        case 'O': return Element(8);
-        case 'F': return Element(9);
-        case 'P': return Element(15);
-        case 'S': return Element(16);
-        case 'K': return Element(19);
-        case 'V': return Element(23);
-        case 'Y': return Element(39);
-        case 'I': return Element(53);
-        case 'W': return Element(74);
-        case 'U': return Element(92);
-    }
+    return Element(lookupSymbol(&symbol, 1, true));
+}
 
-    return Element();
+/// Returns the element corresponding to \p symbol ignoring the case
+/// of its letters. For example, \c "FE", \c "fe" and \c "Fe" all
+/// return iron. This is useful for file formats such as PDB which
+/// store element symbols in uppercase.
+Element Element::fromSymbolCaseInsensitive(const std::string &symbol)
+{
+    return Element(lookupSymbol(symbol.c_str(), symbol.size(), false));
+}
+
+/// Returns the element corresponding to \p symbol with \p length
+/// ignoring the case of its letters.
+Element Element::fromSymbolCaseInsensitive(const char *symbol, size_t length)
+{
+    return Element(lookupSymbol(symbol, length, false));
 }
 
 /// Returns \c true if the atomic number is valid.
@@ -84,6 +84,8 @@ public:
     static Element fromSymbol(const char *symbol);
     static Element fromSymbol(const char *symbol, size_t length);
     static Element fromSymbol(char symbol);
+    static Element fromSymbolCaseInsensitive(const std::string &symbol);
+    static Element fromSymbolCaseInsensitive(const char *symbol, size_t length);
     static bool isValidAtomicNumber(AtomicNumberType atomicNumber);
     static bool isValidSymbol(const std::string &symbol);
 
@@ -52,34 +52,93 @@ namespace geometry {
 inline boost::array<Vector3, 2> distanceGradient(const Point3 &a, const Point3 &b)
 {
     boost::array<Vector3, 2> gradient;
+    chemkit::geometry::distanceAndGradient(a, b, gradient);
+    return gradient;
+}
+
+/// Returns the gradient of the angle between points \p a, \p b
+/// and \p c.
+inline boost::array<Vector3, 3> angleGradient(const Point3 &a, const Point3 &b, const Point3 &c)
+{
+    boost::array<Vector3, 3> gradient;
+    chemkit::geometry::angleAndGradient(a, b, c, gradient);
+    return gradient;
+}
+
+/// Returns the gradient of the angle between points \p a, \p b
+/// and \p c.
+inline boost::array<Vector3, 3> angleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c)
+{
+    boost::array<Vector3, 3> gradient;
+    chemkit::geometry::angleAndGradientRadians(a, b, c, gradient);
+    return gradient;
+}
+
+/// Returns the gradient of the torsion angle between the points
+/// \p a, \p b, \p c, and \p d.
+inline boost::array<Vector3, 4> torsionAngleGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+{
+    boost::array<Vector3, 4> gradient;
+    chemkit::geometry::torsionAngleAndGradient(a, b, c, d, gradient);
+    return gradient;
+}
+
+/// Returns the gradient of the torsion angle between the points
+/// \p a, \p b, \p c, and \p d.
+inline boost::array<Vector3, 4> torsionAngleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+{
+    boost::array<Vector3, 4> gradient;
+    chemkit::geometry::torsionAngleAndGradientRadians(a, b, c, d, gradient);
+    return gradient;
+}
+
+/// Returns the gradient of the wilson angle between the points
+/// \p a, \p b, \p c, and \p d.
+inline boost::array<Vector3, 4> wilsonAngleGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+{
+    boost::array<Vector3, 4> gradient;
+    chemkit::geometry::wilsonAngleAndGradient(a, b, c, d, gradient);
+    return gradient;
+}
 
+/// Returns the gradient of the wilson angle between the points
+/// \p a, \p b, \p c, and \p d.
+inline boost::array<Vector3, 4> wilsonAngleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+{
+    boost::array<Vector3, 4> gradient;
+    chemkit::geometry::wilsonAngleAndGradientRadians(a, b, c, d, gradient);
+    return gradient;
+}
+
+/// Returns the distance between points \p a and \p b and stores
+/// its gradient in \p gradient.
+inline Real distanceAndGradient(const Point3 &a, const Point3 &b, boost::array<Vector3, 2> &gradient)
+{
     Real distance = chemkit::geometry::distance(a, b);
 
     gradient[0] = (a - b) / distance;
     gradient[1] = -gradient[0];
 
-    return gradient;
+    return distance;
 }
 
-/// Returns the gradient of the angle between points \p a, \p b
-/// and \p c.
-inline boost::array<Vector3, 3> angleGradient(const Point3 &a, const Point3 &b, const Point3 &c)
+/// Returns the angle between points \p a, \p b and \p c and stores
+/// its gradient in \p gradient. Angle is in Degrees.
+inline Real angleAndGradient(const Point3 &a, const Point3 &b, const Point3 &c, boost::array<Vector3, 3> &gradient)
 {
-    boost::array<Vector3, 3> gradient = chemkit::geometry::angleGradientRadians(a, b, c);
+    Real theta = chemkit::geometry::angleAndGradientRadians(a, b, c, gradient);
 
     for(size_t i = 0; i < gradient.size(); i++){
         gradient[i] *= chemkit::constants::RadiansToDegrees;
     }
 
-    return gradient;
+    return theta * chemkit::constants::RadiansToDegrees;
 }
 
-/// Returns the gradient of the angle between points \p a, \p b
-/// and \p c.
-inline boost::array<Vector3, 3> angleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c)
+/// Returns the angle between points \p a, \p b and \p c and stores
+/// its gradient in \p gradient. Angle is in Radians.
+inline Real angleAndGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, boost::array<Vector3, 3> &gradient)
 {
-    boost::array<Vector3, 3> gradient;
-
     Real theta = chemkit::geometry::angleRadians(a, b, c);
 
     Real rab = chemkit::geometry::distance(a, b);
@@ -89,28 +148,28 @@ inline boost::array<Vector3, 3> angleGradientRadians(const Point3 &a, const Poin
     gradient[1] = ((((b - c) + (b - a)) * (rab * rbc) - (((b - a) * (rbc/rab) + (b - c) * (rab/rbc)) * (b - a).dot(b - c))) / pow(rab * rbc, 2)) / -sin(theta);
     gradient[2] = -gradient[0] - gradient[1];
 
-    return gradient;
+    return theta;
 }
 
-/// Returns the gradient of the torsion angle between the points
-/// \p a, \p b, \p c, and \p d.
-inline boost::array<Vector3, 4> torsionAngleGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+/// Returns the torsion angle between the points \p a, \p b, \p c,
+/// and \p d and stores its gradient in \p gradient. Angle is in
+/// Degrees.
+inline Real torsionAngleAndGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient)
 {
-    boost::array<Vector3, 4> gradient = chemkit::geometry::torsionAngleGradientRadians(a, b, c, d);
+    Real phi = chemkit::geometry::torsionAngleAndGradientRadians(a, b, c, d, gradient);
 
     for(size_t i = 0; i < gradient.size(); i++){
         gradient[i] *= chemkit::constants::RadiansToDegrees;
     }
 
-    return gradient;
+    return phi * chemkit::constants::RadiansToDegrees;
 }
 
-/// Returns the gradient of the torsion angle between the points
-/// \p a, \p b, \p c, and \p d.
-inline boost::array<Vector3, 4> torsionAngleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+/// Returns the torsion angle between the points \p a, \p b, \p c,
+/// and \p d and stores its gradient in \p gradient. Angle is in
+/// Radians.
+inline Real torsionAngleAndGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient)
 {
-    boost::array<Vector3, 4> gradient;
-
     Real phi = chemkit::geometry::torsionAngleRadians(a, b, c, d);
 
     Vector3 ab = b - a;
@@ -130,25 +189,27 @@ inline boost::array<Vector3, 4> torsionAngleGradientRadians(const Point3 &a, con
     gradient[2] = (bd.cross(q) - ab.cross(p)) * (1.0 / sin(phi));
     gradient[3] = cb.cross(q) * (1.0 / sin(phi));
 
-    return gradient;
+    return phi;
 }
 
-/// Returns the gradient of the wilson angle between the points
-/// \p a, \p b, \p c, and \p d.
-inline boost::array<Vector3, 4> wilsonAngleGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+/// Returns the wilson angle between the points \p a, \p b, \p c,
+/// and \p d and stores its gradient in \p gradient. Angle is in
+/// Degrees.
+inline Real wilsonAngleAndGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient)
 {
-    boost::array<Vector3, 4> gradient = chemkit::geometry::wilsonAngleGradientRadians(a, b, c, d);
+    Real w = chemkit::geometry::wilsonAngleAndGradientRadians(a, b, c, d, gradient);
 
     for(size_t i = 0; i < gradient.size(); i++){
         gradient[i] *= chemkit::constants::RadiansToDegrees;
     }
 
-    return gradient;
+    return w * chemkit::constants::RadiansToDegrees;
 }
 
-/// Returns the gradient of the wilson angle between the points
-/// \p a, \p b, \p c, and \p d.
-inline boost::array<Vector3, 4> wilsonAngleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d)
+/// Returns the wilson angle between the points \p a, \p b, \p c,
+/// and \p d and stores its gradient in \p gradient. Angle is in
+/// Radians.
+inline Real wilsonAngleAndGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient)
 {
     Vector3 ba = a - b;
     Vector3 bc = c - b;
@@ -166,14 +227,12 @@ inline boost::array<Vector3, 4> wilsonAngleGradientRadians(const Point3 &a, cons
 
     Real w = chemkit::geometry::wilsonAngleRadians(a, b, c, d);
 
-    boost::array<Vector3, 4> gradient;
-
     gradient[0] = ((bd.cross(bc) / (cos(w) * sin(theta)) - (ba - bc * cos(theta)) * (tan(w) / pow(sin(theta), 2)))) / rba;
     gradient[2] = ((ba.cross(bd) / (cos(w) * sin(theta)) - (bc - ba * cos(theta)) * (tan(w) / pow(sin(theta), 2)))) / rbc;
     gradient[3] = (bc.cross(ba) / (cos(w) * sin(theta)) - bd * tan(w)) / rbd;
     gradient[1] = -(gradient[0] + gradient[2] + gradient[3]);
 
-    return gradient;
+    return w;
 }
 
 // --- Transforms ---------------------------------------------------------- //
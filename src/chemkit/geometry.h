@@ -83,6 +83,13 @@ inline boost::array<Vector3, 4> torsionAngleGradient(const Point3 &a, const Poin
 inline boost::array<Vector3, 4> torsionAngleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d);
 inline boost::array<Vector3, 4> wilsonAngleGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d);
 inline boost::array<Vector3, 4> wilsonAngleGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d);
+inline Real distanceAndGradient(const Point3 &a, const Point3 &b, boost::array<Vector3, 2> &gradient);
+inline Real angleAndGradient(const Point3 &a, const Point3 &b, const Point3 &c, boost::array<Vector3, 3> &gradient);
+inline Real angleAndGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, boost::array<Vector3, 3> &gradient);
+inline Real torsionAngleAndGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient);
+inline Real torsionAngleAndGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient);
+inline Real wilsonAngleAndGradient(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient);
+inline Real wilsonAngleAndGradientRadians(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &d, boost::array<Vector3, 4> &gradient);
 
 // predicates
 CHEMKIT_EXPORT Real planeOrientation(const Point3 &a, const Point3 &b, const Point3 &c, const Point3 &p);
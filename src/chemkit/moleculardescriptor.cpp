@@ -40,6 +40,7 @@
 
 #include "foreach.h"
 #include "pluginmanager.h"
+#include "moleculardescriptorcontext.h"
 
 namespace chemkit {
 
@@ -131,6 +132,20 @@ Variant MolecularDescriptor::value(const Molecule *molecule) const
     return Variant();
 }
 
+/// Calculates the value of the descriptor for the molecule in
+/// \p context. Descriptors which use intermediate results that are
+/// shared with other descriptors (e.g. molecular surfaces) should
+/// reimplement this method and retrieve them from the context.
+///
+/// The default implementation calls value() with the molecule
+/// from \p context.
+///
+/// \see MolecularDescriptorContext
+Variant MolecularDescriptor::value(MolecularDescriptorContext *context) const
+{
+    return value(context->molecule());
+}
+
 // --- Static Methods ------------------------------------------------------ //
 /// Creates a new molecular descriptor.
 MolecularDescriptor* MolecularDescriptor::create(const std::string &name)
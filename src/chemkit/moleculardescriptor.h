@@ -47,6 +47,7 @@
 namespace chemkit {
 
 class Molecule;
+class MolecularDescriptorContext;
 class MolecularDescriptorPrivate;
 
 class CHEMKIT_EXPORT MolecularDescriptor
@@ -61,6 +62,7 @@ public:
 
     // descriptor
     virtual Variant value(const Molecule *molecule) const;
+    virtual Variant value(MolecularDescriptorContext *context) const;
 
     // static methods
     static MolecularDescriptor* create(const std::string &name);
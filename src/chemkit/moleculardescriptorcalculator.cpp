@@ -0,0 +1,275 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculardescriptorcalculator.h"
+
+#include <boost/bind.hpp>
+
+#include "foreach.h"
+#include "concurrent.h"
+#include "moleculardescriptor.h"
+#include "moleculardescriptorcontext.h"
+
+namespace chemkit {
+
+namespace {
+
+// Calculates every descriptor for a single molecule and stores the
+// values in the row for the molecule.
+void calculateRow(const std::vector<const Molecule *> &molecules,
+                  const std::vector<MolecularDescriptor *> &descriptors,
+                  std::vector<std::vector<Variant> > &columns,
+                  size_t row)
+{
+    const Molecule *molecule = molecules[row];
+    if(!molecule){
+        return;
+    }
+
+    MolecularDescriptorContext context(molecule, descriptors);
+
+    for(size_t i = 0; i < descriptors.size(); i++){
+        columns[i][row] = context.descriptor(descriptors[i]->name());
+    }
+}
+
+} // end anonymous namespace
+
+// === MolecularDescriptorCalculatorPrivate ================================ //
+class MolecularDescriptorCalculatorPrivate
+{
+public:
+    std::vector<MolecularDescriptor *> descriptors;
+    std::vector<std::vector<Variant> > columns;
+    size_t rowCount;
+    std::string errorString;
+};
+
+// === MolecularDescriptorCalculator ======================================= //
+/// \class MolecularDescriptorCalculator moleculardescriptorcalculator.h chemkit/moleculardescriptorcalculator.h
+/// \ingroup chemkit
+/// \brief The MolecularDescriptorCalculator class calculates a set
+///        of molecular descriptors for many molecules.
+///
+/// The descriptor objects are created once and shared by every
+/// molecule. Each molecule is calculated with its own
+/// MolecularDescriptorContext so intermediate results (e.g.
+/// molecular surfaces) are shared between the descriptors. The
+/// molecules are calculated in parallel using the global thread
+/// pool.
+///
+/// The results are stored as a table with one row per molecule and
+/// one column per descriptor.
+///
+/// For example, to calculate the mass and the wiener index of each
+/// molecule in a file:
+/// \code
+/// MolecularDescriptorCalculator calculator;
+/// calculator.addDescriptor("molecular-mass");
+/// calculator.addDescriptor("wiener-index");
+///
+/// calculator.calculate(file.molecules());
+///
+/// const std::vector<Variant> &masses = calculator.column("molecular-mass");
+/// \endcode
+///
+/// Molecules must not be modified during the calculation and each
+/// molecule should only occur once in the input.
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new descriptor calculator.
+MolecularDescriptorCalculator::MolecularDescriptorCalculator()
+    : d(new MolecularDescriptorCalculatorPrivate)
+{
+    d->rowCount = 0;
+}
+
+/// Destroys the descriptor calculator.
+MolecularDescriptorCalculator::~MolecularDescriptorCalculator()
+{
+    foreach(MolecularDescriptor *descriptor, d->descriptors){
+        delete descriptor;
+    }
+
+    delete d;
+}
+
+// --- Descriptors --------------------------------------------------------- //
+/// Adds the descriptor with \p name to the calculator. Returns
+/// \c false if the descriptor is not available.
+///
+/// Adding a descriptor clears any previously calculated results.
+bool MolecularDescriptorCalculator::addDescriptor(const std::string &name)
+{
+    MolecularDescriptor *descriptor = MolecularDescriptor::create(name);
+    if(!descriptor){
+        d->errorString = "Molecular descriptor '" + name + "' is not available.";
+        return false;
+    }
+
+    d->descriptors.push_back(descriptor);
+    clear();
+
+    return true;
+}
+
+/// Sets the descriptors for the calculator to \p names. Returns
+/// \c false if any of the descriptors are not available.
+bool MolecularDescriptorCalculator::setDescriptors(const std::vector<std::string> &names)
+{
+    foreach(MolecularDescriptor *descriptor, d->descriptors){
+        delete descriptor;
+    }
+    d->descriptors.clear();
+    clear();
+
+    bool ok = true;
+
+    foreach(const std::string &name, names){
+        if(!addDescriptor(name)){
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+/// Returns the names of the descriptors in the calculator.
+std::vector<std::string> MolecularDescriptorCalculator::descriptors() const
+{
+    std::vector<std::string> names;
+
+    foreach(const MolecularDescriptor *descriptor, d->descriptors){
+        names.push_back(descriptor->name());
+    }
+
+    return names;
+}
+
+/// Returns the number of descriptors in the calculator.
+size_t MolecularDescriptorCalculator::descriptorCount() const
+{
+    return d->descriptors.size();
+}
+
+// --- Calculation --------------------------------------------------------- //
+/// Calculates the descriptors for each molecule in \p molecules.
+/// Returns \c false if \p token was canceled before every molecule
+/// was calculated.
+///
+/// Null molecules are skipped and leave null values in their row.
+bool MolecularDescriptorCalculator::calculate(const std::vector<const Molecule *> &molecules,
+                                              const CancellationToken *token)
+{
+    d->rowCount = molecules.size();
+    d->columns.assign(d->descriptors.size(), std::vector<Variant>(molecules.size()));
+
+    bool finished = concurrent::parallel_for(0, molecules.size(),
+                                             boost::bind(calculateRow,
+                                                         boost::cref(molecules),
+                                                         boost::cref(d->descriptors),
+                                                         boost::ref(d->columns),
+                                                         _1),
+                                             token);
+    if(!finished){
+        d->errorString = "Calculation was canceled.";
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+// --- Results ------------------------------------------------------------- //
+/// Returns the number of rows (molecules) in the results.
+size_t MolecularDescriptorCalculator::rowCount() const
+{
+    return d->rowCount;
+}
+
+/// Returns the values of the descriptor at \p index for each
+/// molecule.
+const std::vector<Variant>& MolecularDescriptorCalculator::column(size_t index) const
+{
+    static const std::vector<Variant> empty;
+
+    if(index >= d->columns.size()){
+        return empty;
+    }
+
+    return d->columns[index];
+}
+
+/// Returns the values of the descriptor with \p name for each
+/// molecule. Returns an empty vector if the calculator does not
+/// contain the descriptor.
+const std::vector<Variant>& MolecularDescriptorCalculator::column(const std::string &name) const
+{
+    for(size_t i = 0; i < d->descriptors.size(); i++){
+        if(d->descriptors[i]->name() == name){
+            return column(i);
+        }
+    }
+
+    return column(d->columns.size());
+}
+
+/// Returns the value of the descriptor at \p column for the
+/// molecule at \p row.
+Variant MolecularDescriptorCalculator::value(size_t row, size_t column) const
+{
+    const std::vector<Variant> &values = this->column(column);
+    if(row >= values.size()){
+        return Variant();
+    }
+
+    return values[row];
+}
+
+/// Removes all of the calculated results.
+void MolecularDescriptorCalculator::clear()
+{
+    d->columns.clear();
+    d->rowCount = 0;
+}
+
+// --- Error Handling ------------------------------------------------------ //
+/// Returns a string describing the last error that occured.
+std::string MolecularDescriptorCalculator::errorString() const
+{
+    return d->errorString;
+}
+
+} // end chemkit namespace
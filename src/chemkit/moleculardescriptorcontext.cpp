@@ -0,0 +1,199 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculardescriptorcontext.h"
+
+#include <map>
+
+#include "foreach.h"
+#include "molecule.h"
+#include "moleculardescriptor.h"
+#include "topologicaldistancematrix.h"
+
+namespace chemkit {
+
+// === MolecularDescriptorContextPrivate =================================== //
+class MolecularDescriptorContextPrivate
+{
+public:
+    const Molecule *molecule;
+    std::vector<MolecularDescriptor *> descriptors;
+    std::vector<MolecularDescriptor *> createdDescriptors;
+    std::map<std::string, Variant> values;
+    MolecularSurface *surfaces[3];
+    TopologicalDistanceMatrix *distanceMatrix;
+};
+
+// === MolecularDescriptorContext ========================================== //
+/// \class MolecularDescriptorContext moleculardescriptorcontext.h chemkit/moleculardescriptorcontext.h
+/// \ingroup chemkit
+/// \brief The MolecularDescriptorContext class caches intermediate
+///        results shared by molecular descriptors.
+///
+/// Many descriptors are calculated from the same intermediate
+/// results. For example, the van der waals area and volume
+/// descriptors both require the alpha shape of the molecule and the
+/// graph descriptors all require the topological distance matrix. A
+/// context calculates each intermediate result once for its
+/// molecule and shares it with every descriptor evaluated through
+/// it. Descriptor values are also cached so that descriptors which
+/// depend on other descriptors (such as the rule of five) do not
+/// recalculate them.
+///
+/// The molecule must not be modified while the context exists.
+///
+/// \see MolecularDescriptor::value(), MolecularDescriptorCalculator
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new descriptor context for \p molecule.
+MolecularDescriptorContext::MolecularDescriptorContext(const Molecule *molecule)
+    : d(new MolecularDescriptorContextPrivate)
+{
+    d->molecule = molecule;
+
+    for(int i = 0; i < 3; i++){
+        d->surfaces[i] = 0;
+    }
+
+    d->distanceMatrix = 0;
+}
+
+/// Creates a new descriptor context for \p molecule. The
+/// \p descriptors are used to calculate the values requested with
+/// descriptor() instead of creating new descriptor objects. The
+/// context does not take ownership of the descriptors.
+MolecularDescriptorContext::MolecularDescriptorContext(const Molecule *molecule,
+                                                       const std::vector<MolecularDescriptor *> &descriptors)
+    : d(new MolecularDescriptorContextPrivate)
+{
+    d->molecule = molecule;
+    d->descriptors = descriptors;
+
+    for(int i = 0; i < 3; i++){
+        d->surfaces[i] = 0;
+    }
+
+    d->distanceMatrix = 0;
+}
+
+/// Destroys the descriptor context.
+MolecularDescriptorContext::~MolecularDescriptorContext()
+{
+    foreach(MolecularDescriptor *descriptor, d->createdDescriptors){
+        delete descriptor;
+    }
+
+    for(int i = 0; i < 3; i++){
+        delete d->surfaces[i];
+    }
+
+    delete d->distanceMatrix;
+
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the molecule for the context.
+const Molecule* MolecularDescriptorContext::molecule() const
+{
+    return d->molecule;
+}
+
+// --- Descriptors --------------------------------------------------------- //
+/// Returns the value of the descriptor with \p name for the
+/// molecule. The value is only calculated the first time it is
+/// requested. Returns a null variant if the descriptor is not
+/// available.
+Variant MolecularDescriptorContext::descriptor(const std::string &name)
+{
+    std::map<std::string, Variant>::const_iterator iter = d->values.find(name);
+    if(iter != d->values.end()){
+        return iter->second;
+    }
+
+    const MolecularDescriptor *descriptor = 0;
+
+    foreach(const MolecularDescriptor *candidate, d->descriptors){
+        if(candidate->name() == name){
+            descriptor = candidate;
+            break;
+        }
+    }
+
+    if(!descriptor){
+        MolecularDescriptor *created = MolecularDescriptor::create(name);
+        if(created){
+            d->createdDescriptors.push_back(created);
+        }
+
+        descriptor = created;
+    }
+
+    Variant value;
+    if(descriptor && d->molecule){
+        value = descriptor->value(this);
+    }
+
+    d->values[name] = value;
+
+    return value;
+}
+
+// --- Intermediates ------------------------------------------------------- //
+/// Returns the molecular surface of \p type for the molecule. The
+/// surface (and its alpha shape) is only created the first time it
+/// is requested.
+const MolecularSurface* MolecularDescriptorContext::surface(MolecularSurface::SurfaceType type)
+{
+    MolecularSurface *&surface = d->surfaces[type];
+
+    if(!surface){
+        surface = new MolecularSurface(d->molecule, type);
+    }
+
+    return surface;
+}
+
+/// Returns the topological distance matrix for the molecule.
+const TopologicalDistanceMatrix* MolecularDescriptorContext::distanceMatrix()
+{
+    if(!d->distanceMatrix){
+        d->distanceMatrix = new TopologicalDistanceMatrix(d->molecule);
+    }
+
+    return d->distanceMatrix;
+}
+
+} // end chemkit namespace
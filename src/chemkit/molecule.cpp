@@ -36,6 +36,7 @@
 #include "molecule.h"
 
 #include <map>
+#include <new>
 #include <queue>
 #include <sstream>
 #include <algorithm>
@@ -75,6 +76,8 @@ namespace chemkit {
 
 // === MoleculePrivate ===================================================== //
 MoleculePrivate::MoleculePrivate()
+    : atomPool(sizeof(Atom), 8),
+      bondPool(sizeof(Bond), 8)
 {
     fragmentsPerceived = false;
     ringsPerceived = false;
@@ -165,19 +168,50 @@ Molecule::Molecule(const Molecule &molecule)
 
     d->name = molecule.name();
 
-    std::map<const Atom *, Atom *> oldToNew;
+    setAtomCapacity(molecule.atomCount());
+    setBondCapacity(molecule.bondCount());
 
     foreach(const Atom *atom, molecule.atoms()){
-        Atom *newAtom = addAtomCopy(atom);
-        oldToNew[atom] = newAtom;
+        createAtom(atom->element());
     }
 
+    // copy atom properties
+    d->partialCharges = molecule.d->partialCharges;
+
+    for(std::map<const Atom *, Isotope>::const_iterator iter = molecule.d->isotopes.begin();
+        iter != molecule.d->isotopes.end();
+        ++iter){
+        d->isotopes[m_atoms[iter->first->index()]] = iter->second;
+    }
+
+    if(!molecule.isEmpty()){
+        const CartesianCoordinates *coordinates = molecule.coordinates();
+        CartesianCoordinates *newCoordinates = this->coordinates();
+
+        for(size_t i = 0; i < coordinates->size(); i++){
+            newCoordinates->setPosition(i, coordinates->position(i));
+        }
+    }
+
+    foreach(const Atom *atom, molecule.atoms()){
+        if(atom->chirality() != Stereochemistry::None){
+            m_atoms[atom->index()]->setChirality(atom->chirality());
+        }
+    }
+
+    // the atoms in the copy have the same indices as in the original
+    // so the bonds can be added directly and packed together at once
     foreach(const Bond *bond, molecule.bonds()){
-        Bond *newBond = addBond(oldToNew[bond->atom1()], oldToNew[bond->atom2()]);
-        newBond->setOrder(bond->order());
+        createBond(m_atoms[bond->atom1()->index()],
+                   m_atoms[bond->atom2()->index()],
+                   bond->order());
+    }
+
+    packBonds();
 
+    foreach(const Bond *bond, molecule.bonds()){
         if(bond->stereochemistry() != Stereochemistry::None){
-            newBond->setStereochemistry(bond->stereochemistry());
+            d->bonds[bond->index()]->setStereochemistry(bond->stereochemistry());
         }
     }
 }
@@ -186,10 +220,14 @@ Molecule::Molecule(const Molecule &molecule)
 /// bonds that the molecule contains.
 Molecule::~Molecule()
 {
+    // the memory for the atoms and bonds is released along with
+    // their pools
     foreach(Atom *atom, m_atoms)
-        delete atom;
+        atom->~Atom();
     foreach(Bond *bond, d->bonds)
-        delete bond;
+        bond->~Bond();
+    foreach(std::vector<Bond *> *bonds, d->atomBonds)
+        delete bonds;
     foreach(Ring *ring, d->rings)
         delete ring;
     foreach(Fragment *fragment, d->fragments)
@@ -382,20 +420,8 @@ Variant Molecule::data(const std::string &name) const
 /// \endcode
 Atom* Molecule::addAtom(const Element &element)
 {
-    Atom *atom = new Atom(this, m_atoms.size());
-    m_atoms.push_back(atom);
+    Atom *atom = createAtom(element);
 
-    // add atom properties
-    m_elements.push_back(element);
-    d->atomBonds.push_back(std::vector<Bond *>());
-    d->partialCharges.push_back(0);
-
-    // set atom position
-    if(m_coordinates){
-        m_coordinates->append(0, 0, 0);
-    }
-
-    setFragmentsPerceived(false);
     notifyWatchers(atom, MoleculeWatcher::AtomAdded);
 
     return atom;
@@ -434,7 +460,9 @@ void Molecule::removeAtom(Atom *atom)
     // remove atom properties
     m_elements.erase(m_elements.begin() + atom->index());
     d->isotopes.erase(atom);
+    delete d->atomBonds[atom->index()];
     d->atomBonds.erase(d->atomBonds.begin() + atom->index());
+    d->packedBondRanges.erase(d->packedBondRanges.begin() + atom->index());
     d->partialCharges.erase(d->partialCharges.begin() + atom->index());
 
     if(atom->index() < d->atomTypes.size()){
@@ -454,7 +482,8 @@ void Molecule::removeAtom(Atom *atom)
     setFragmentsPerceived(false);
     notifyWatchers(atom, MoleculeWatcher::AtomRemoved);
 
-    delete atom;
+    atom->~Atom();
+    d->atomPool.free(atom);
 }
 
 /// Removes each atom in \p atoms from the molecule.
@@ -481,7 +510,12 @@ void Molecule::setAtomCapacity(size_t capacity)
     m_atoms.reserve(capacity);
     m_elements.reserve(capacity);
     d->atomBonds.reserve(capacity);
+    d->packedBondRanges.reserve(capacity);
     d->partialCharges.reserve(capacity);
+
+    if(capacity > m_atoms.size()){
+        d->atomPool.set_next_size(capacity - m_atoms.size());
+    }
 }
 
 /// Returns the atom capacity for the molecule.
@@ -524,17 +558,8 @@ Bond* Molecule::addBond(Atom *a, Atom *b, int order)
         return bond(a, b);
     }
 
-    Bond *bond = new Bond(this, d->bonds.size());
-    d->atomBonds[a->index()].push_back(bond);
-    d->atomBonds[b->index()].push_back(bond);
-    d->bonds.push_back(bond);
-
-    // add bond properties
-    d->bondAtoms.push_back(std::make_pair(a, b));
-    d->bondOrders.push_back(order);
-
-    setRingsPerceived(false);
-    setFragmentsPerceived(false);
+    Bond *bond = createBond(a, b, order);
+    insertPendingBonds();
 
     notifyWatchers(bond, MoleculeWatcher::BondAdded);
 
@@ -552,11 +577,15 @@ void Molecule::removeBond(Bond *bond)
 {
     assert(bond->molecule() == this);
 
+    insertPendingBonds();
+
     d->bonds.erase(d->bonds.begin() + bond->index());
 
     // remove bond from atom bond vectors
-    std::vector<Bond *> &bondsA = d->atomBonds[bond->atom1()->index()];
-    std::vector<Bond *> &bondsB = d->atomBonds[bond->atom2()->index()];
+    unpackBonds(bond->atom1()->index());
+    unpackBonds(bond->atom2()->index());
+    std::vector<Bond *> &bondsA = *d->atomBonds[bond->atom1()->index()];
+    std::vector<Bond *> &bondsB = *d->atomBonds[bond->atom2()->index()];
 
     bondsA.erase(std::find(bondsA.begin(), bondsA.end(), bond));
     bondsB.erase(std::find(bondsB.begin(), bondsB.end(), bond));
@@ -575,7 +604,8 @@ void Molecule::removeBond(Bond *bond)
 
     notifyWatchers(bond, MoleculeWatcher::BondRemoved);
 
-    delete bond;
+    bond->~Bond();
+    d->bondPool.free(bond);
 }
 
 /// Removes the bond between atoms \p a and \p b. Does nothing if
@@ -645,6 +675,10 @@ void Molecule::setBondCapacity(size_t capacity)
     d->bonds.reserve(capacity);
     d->bondOrders.reserve(capacity);
     d->bondAtoms.reserve(capacity);
+
+    if(capacity > d->bonds.size()){
+        d->bondPool.set_next_size(capacity - d->bonds.size());
+    }
 }
 
 /// Returns the bond capacity for the molecule.
@@ -1079,23 +1113,23 @@ Molecule& Molecule::operator=(const Molecule &molecule)
         // set new name
         setName(molecule.name());
 
-        std::map<const Atom *, Atom *> oldToNew;
-
         // add new atoms
         foreach(const Atom *atom, molecule.atoms()){
-            Atom *newAtom = addAtomCopy(atom);
-            oldToNew[atom] = newAtom;
+            addAtomCopy(atom);
         }
 
         // add new bonds
         foreach(const Bond *bond, molecule.bonds()){
-            Bond *newBond = addBond(oldToNew[bond->atom1()], oldToNew[bond->atom2()]);
+            Bond *newBond = addBond(m_atoms[bond->atom1()->index()],
+                                    m_atoms[bond->atom2()->index()]);
             newBond->setOrder(bond->order());
 
             if(bond->stereochemistry() != Stereochemistry::None){
                 newBond->setStereochemistry(bond->stereochemistry());
             }
         }
+
+        packBonds();
     }
 
     return *this;
@@ -1134,6 +1168,138 @@ void Molecule::notifyWatchers(const Bond *bond, MoleculeWatcher::ChangeType type
     }
 }
 
+// Adds a new atom without notifying any watchers.
+Atom* Molecule::createAtom(const Element &element)
+{
+    Atom *atom = new (d->atomPool.malloc()) Atom(this, m_atoms.size());
+    m_atoms.push_back(atom);
+
+    // add atom properties
+    m_elements.push_back(element);
+    d->atomBonds.push_back(0);
+    d->packedBondRanges.push_back(std::make_pair(0u, 0u));
+    d->partialCharges.push_back(0);
+
+    // set atom position
+    if(m_coordinates){
+        m_coordinates->append(0, 0, 0);
+    }
+
+    setFragmentsPerceived(false);
+
+    return atom;
+}
+
+// Adds a new bond between atoms a and b without notifying any
+// watchers. The atoms must be distinct, belong to this molecule and
+// not already be bonded.
+//
+// The bond is not added to the atoms' bond lists until either
+// insertPendingBonds() or packBonds() is called.
+Bond* Molecule::createBond(Atom *a, Atom *b, int order)
+{
+    Bond *bond = new (d->bondPool.malloc()) Bond(this, d->bonds.size());
+    d->bonds.push_back(bond);
+    d->pendingBonds.push_back(bond);
+
+    // add bond properties
+    d->bondAtoms.push_back(std::make_pair(a, b));
+    d->bondOrders.push_back(order);
+
+    setRingsPerceived(false);
+    setFragmentsPerceived(false);
+
+    return bond;
+}
+
+// Returns the bonds for the atom at index. Pending bonds are not
+// included.
+Molecule::BondRange Molecule::atomBonds(size_t index) const
+{
+    const std::vector<Bond *> *bonds = d->atomBonds[index];
+    if(bonds){
+        return boost::make_iterator_range(bonds->begin(), bonds->end());
+    }
+
+    const std::pair<unsigned int, unsigned int> &range = d->packedBondRanges[index];
+
+    return boost::make_iterator_range(d->packedBonds.begin() + range.first,
+                                      d->packedBonds.begin() + range.second);
+}
+
+// Moves the packed bonds for the atom at index to its own bond
+// vector so that they can be modified.
+void Molecule::unpackBonds(size_t index) const
+{
+    if(d->atomBonds[index]){
+        return;
+    }
+
+    std::pair<unsigned int, unsigned int> &range = d->packedBondRanges[index];
+
+    d->atomBonds[index] = new std::vector<Bond *>(d->packedBonds.begin() + range.first,
+                                                  d->packedBonds.begin() + range.second);
+    range.second = range.first;
+}
+
+// Adds each pending bond to the bond vectors of its atoms.
+void Molecule::insertPendingBonds() const
+{
+    if(d->pendingBonds.empty()){
+        return;
+    }
+
+    foreach(Bond *bond, d->pendingBonds){
+        size_t a = bond->atom1()->index();
+        size_t b = bond->atom2()->index();
+
+        unpackBonds(a);
+        unpackBonds(b);
+        d->atomBonds[a]->push_back(bond);
+        d->atomBonds[b]->push_back(bond);
+    }
+
+    d->pendingBonds.clear();
+}
+
+// Rebuilds the packed bond lists for every atom, including any
+// pending bonds. The bonds for each atom are stored in the order of
+// their indices.
+void Molecule::packBonds() const
+{
+    size_t atomCount = m_atoms.size();
+
+    std::vector<std::pair<unsigned int, unsigned int> > ranges(atomCount);
+    foreach(const Bond *bond, d->bonds){
+        ranges[bond->atom1()->index()].second++;
+        ranges[bond->atom2()->index()].second++;
+    }
+
+    unsigned int offset = 0;
+    for(size_t i = 0; i < atomCount; i++){
+        unsigned int count = ranges[i].second;
+        ranges[i].first = offset;
+        ranges[i].second = offset;
+        offset += count;
+    }
+
+    std::vector<Bond *> bonds(offset);
+    foreach(Bond *bond, d->bonds){
+        bonds[ranges[bond->atom1()->index()].second++] = bond;
+        bonds[ranges[bond->atom2()->index()].second++] = bond;
+    }
+
+    d->packedBonds.swap(bonds);
+    d->packedBondRanges.swap(ranges);
+
+    for(size_t i = 0; i < atomCount; i++){
+        delete d->atomBonds[i];
+        d->atomBonds[i] = 0;
+    }
+
+    d->pendingBonds.clear();
+}
+
 void Molecule::addWatcher(MoleculeWatcher *watcher) const
 {
     d->watchers.push_back(watcher);
@@ -167,6 +167,12 @@ public:
 
 private:
     // internal methods
+    Atom* createAtom(const Element &element);
+    Bond* createBond(Atom *a, Atom *b, int order);
+    BondRange atomBonds(size_t index) const;
+    void unpackBonds(size_t index) const;
+    void insertPendingBonds() const;
+    void packBonds() const;
     void setRingsPerceived(bool perceived) const;
     bool ringsPerceived() const;
     void setFragmentsPerceived(bool perceived) const;
@@ -182,6 +188,7 @@ private:
 
     friend class Atom;
     friend class Bond;
+    friend class MoleculeBuilder;
     friend class MoleculeWatcher;
 
 private:
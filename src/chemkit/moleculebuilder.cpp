@@ -0,0 +1,353 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculebuilder.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "atom.h"
+#include "bond.h"
+#include "foreach.h"
+#include "molecule.h"
+#include "moleculeprivate.h"
+#include "cartesiancoordinates.h"
+
+namespace chemkit {
+
+// === MoleculeBuilderPrivate ============================================== //
+class MoleculeBuilderPrivate
+{
+public:
+    Molecule *molecule;
+    bool changed;
+
+    // linked lists of the pending bonds for each atom. entry 2i is
+    // for the first atom of the i'th pending bond and entry 2i + 1
+    // is for its second atom.
+    std::vector<int> pendingHead;
+    std::vector<int> pendingNext;
+};
+
+// === MoleculeBuilder ===================================================== //
+/// \class MoleculeBuilder moleculebuilder.h chemkit/moleculebuilder.h
+/// \ingroup chemkit
+/// \brief The MoleculeBuilder class adds atoms and bonds to a
+///        molecule in bulk.
+///
+/// The molecule builder is intended for code that creates a large
+/// number of atoms and bonds at once, such as file format readers.
+/// Storage can be reserved up front with reserve() and atoms, bonds
+/// and atom positions can be added either one at a time or from
+/// arrays.
+///
+/// Unlike Molecule::addAtom() and Molecule::addBond(), the builder
+/// does not notify the molecule's watchers for each new atom and
+/// bond. Instead, a single MoleculeWatcher::structureChanged() signal
+/// is emitted when the changes are committed with commit().
+///
+/// Bonds added with the builder are stored in the molecule's compact
+/// bond lists when they are committed. Querying the bonds of an atom
+/// before then is supported but less efficient.
+///
+/// For example, to add a water molecule:
+/// \code
+/// MoleculeBuilder builder(molecule);
+/// builder.reserve(3, 2);
+/// Atom *O = builder.addAtom("O");
+/// builder.addBond(O, builder.addAtom("H"));
+/// builder.addBond(O, builder.addAtom("H"));
+/// builder.commit();
+/// \endcode
+///
+/// \see Molecule, MoleculeWatcher
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new molecule builder for \p molecule.
+MoleculeBuilder::MoleculeBuilder(Molecule *molecule)
+    : d(new MoleculeBuilderPrivate)
+{
+    assert(molecule != 0);
+
+    d->molecule = molecule;
+    d->changed = false;
+}
+
+/// Destroys the molecule builder. Atoms and bonds added since the
+/// last call to commit() remain in the molecule but its watchers are
+/// not notified of them.
+MoleculeBuilder::~MoleculeBuilder()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the molecule for the builder.
+Molecule* MoleculeBuilder::molecule() const
+{
+    return d->molecule;
+}
+
+/// Reserves storage in the molecule for \p atomCount additional
+/// atoms and \p bondCount additional bonds.
+void MoleculeBuilder::reserve(size_t atomCount, size_t bondCount)
+{
+    d->molecule->setAtomCapacity(d->molecule->atomCount() + atomCount);
+    d->molecule->setBondCapacity(d->molecule->bondCount() + bondCount);
+
+    if(d->molecule->m_coordinates){
+        d->molecule->m_coordinates->reserve(d->molecule->atomCapacity());
+    }
+}
+
+// --- Structure ----------------------------------------------------------- //
+/// Adds a new atom of \p element to the molecule and returns it.
+Atom* MoleculeBuilder::addAtom(const Element &element)
+{
+    d->changed = true;
+
+    return d->molecule->createAtom(element);
+}
+
+/// Adds a new atom of \p element at \p position to the molecule and
+/// returns it.
+Atom* MoleculeBuilder::addAtom(const Element &element, const Point3 &position)
+{
+    reserveCoordinates();
+
+    Atom *atom = d->molecule->createAtom(element);
+    d->molecule->m_coordinates->setPosition(atom->index(), position);
+    d->changed = true;
+
+    return atom;
+}
+
+/// Adds a new atom to the molecule for each element in \p elements.
+void MoleculeBuilder::addAtoms(const std::vector<Element> &elements)
+{
+    growCapacity(elements.size(), 0);
+
+    for(size_t i = 0; i < elements.size(); i++){
+        addAtom(elements[i]);
+    }
+}
+
+/// Adds a new atom to the molecule for each element in \p elements
+/// positioned at the corresponding point in \p positions.
+void MoleculeBuilder::addAtoms(const std::vector<Element> &elements,
+                               const std::vector<Point3> &positions)
+{
+    assert(elements.size() == positions.size());
+
+    growCapacity(elements.size(), 0);
+
+    for(size_t i = 0; i < elements.size(); i++){
+        addAtom(elements[i], positions[i]);
+    }
+}
+
+/// Adds a new bond between atoms \p a and \p b with \p order and
+/// returns it. If the atoms are already bonded the existing bond is
+/// returned.
+Bond* MoleculeBuilder::addBond(Atom *a, Atom *b, int order)
+{
+    if(a == b){
+        return 0;
+    }
+    else if(!d->molecule->contains(a) || !d->molecule->contains(b)){
+        return 0;
+    }
+
+    Bond *bond = findBond(a, b);
+    if(bond){
+        return bond;
+    }
+
+    bond = d->molecule->createBond(a, b, order);
+    linkPendingBond(d->molecule->d->pendingBonds.size() - 1);
+    d->changed = true;
+
+    return bond;
+}
+
+/// Adds a single bond between each pair of atom indices in
+/// \p bonds. Pairs containing an index that is out of range are
+/// ignored.
+void MoleculeBuilder::addBonds(const std::vector<std::pair<size_t, size_t> > &bonds)
+{
+    addBonds(bonds, std::vector<int>(bonds.size(), 1));
+}
+
+/// Adds a bond between each pair of atom indices in \p bonds with
+/// the corresponding bond order in \p orders. Pairs containing an
+/// index that is out of range are ignored.
+void MoleculeBuilder::addBonds(const std::vector<std::pair<size_t, size_t> > &bonds,
+                               const std::vector<int> &orders)
+{
+    assert(bonds.size() == orders.size());
+
+    growCapacity(0, bonds.size());
+
+    size_t atomCount = d->molecule->atomCount();
+
+    for(size_t i = 0; i < bonds.size(); i++){
+        size_t a = bonds[i].first;
+        size_t b = bonds[i].second;
+
+        if(a < atomCount && b < atomCount){
+            addBond(d->molecule->atom(a), d->molecule->atom(b), orders[i]);
+        }
+    }
+}
+
+// --- Editing ------------------------------------------------------------- //
+/// Notifies the molecule's watchers of the atoms and bonds added
+/// since the last call to commit(). This emits a single
+/// MoleculeWatcher::structureChanged() signal.
+///
+/// Committing rebuilds the bond lists for every atom in the molecule
+/// so any ranges previously returned from Atom::bonds() or
+/// Atom::neighbors() are invalidated.
+void MoleculeBuilder::commit()
+{
+    if(!d->molecule->d->pendingBonds.empty()){
+        d->molecule->packBonds();
+    }
+
+    std::vector<int>().swap(d->pendingHead);
+    std::vector<int>().swap(d->pendingNext);
+
+    if(!d->changed){
+        return;
+    }
+
+    d->molecule->notifyWatchers(MoleculeWatcher::StructureChanged);
+    d->changed = false;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+// Ensures there is room for atomCount more atoms and bondCount more
+// bonds. Storage grows at least geometrically so that adding many
+// small batches stays linear.
+void MoleculeBuilder::growCapacity(size_t atomCount, size_t bondCount)
+{
+    const Molecule *molecule = d->molecule;
+
+    if(molecule->atomCount() + atomCount > molecule->atomCapacity()){
+        atomCount = std::max(atomCount, molecule->atomCount());
+    }
+    else{
+        atomCount = 0;
+    }
+
+    if(molecule->bondCount() + bondCount > molecule->bondCapacity()){
+        bondCount = std::max(bondCount, molecule->bondCount());
+    }
+    else{
+        bondCount = 0;
+    }
+
+    if(atomCount || bondCount){
+        reserve(atomCount, bondCount);
+    }
+}
+
+// Returns the bond between atoms a and b, including bonds that have
+// been added by the builder but not yet committed.
+Bond* MoleculeBuilder::findBond(const Atom *a, const Atom *b)
+{
+    foreach(Bond *bond, d->molecule->atomBonds(a->index())){
+        if(bond->otherAtom(a) == b){
+            return bond;
+        }
+    }
+
+    const std::vector<Bond *> &pendingBonds = d->molecule->d->pendingBonds;
+
+    // rebuild the pending bond lists if the molecule has inserted
+    // its pending bonds since they were last updated
+    if(d->pendingNext.size() != 2 * pendingBonds.size()){
+        d->pendingHead.clear();
+        d->pendingNext.clear();
+
+        for(size_t i = 0; i < pendingBonds.size(); i++){
+            linkPendingBond(i);
+        }
+    }
+
+    if(a->index() < d->pendingHead.size()){
+        for(int entry = d->pendingHead[a->index()]; entry != -1; entry = d->pendingNext[entry]){
+            Bond *bond = pendingBonds[entry / 2];
+
+            if(bond->otherAtom(a) == b){
+                return bond;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Adds the pending bond at index to the pending bond lists for its
+// atoms.
+void MoleculeBuilder::linkPendingBond(size_t index)
+{
+    const Bond *bond = d->molecule->d->pendingBonds[index];
+    size_t a = bond->atom1()->index();
+    size_t b = bond->atom2()->index();
+
+    if(d->pendingHead.size() < d->molecule->atomCount()){
+        d->pendingHead.resize(d->molecule->atomCount(), -1);
+    }
+
+    d->pendingNext.push_back(d->pendingHead[a]);
+    d->pendingHead[a] = static_cast<int>(2 * index);
+    d->pendingNext.push_back(d->pendingHead[b]);
+    d->pendingHead[b] = static_cast<int>(2 * index + 1);
+}
+
+// Creates the molecule's coordinates if they do not exist yet with
+// room for as many positions as the molecule has atom capacity.
+void MoleculeBuilder::reserveCoordinates()
+{
+    if(d->molecule->m_coordinates){
+        return;
+    }
+
+    CartesianCoordinates *coordinates = d->molecule->coordinates();
+    coordinates->reserve(d->molecule->atomCapacity());
+}
+
+} // end chemkit namespace
@@ -0,0 +1,91 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_MOLECULEBUILDER_H
+#define CHEMKIT_MOLECULEBUILDER_H
+
+#include "chemkit.h"
+
+#include <vector>
+#include <utility>
+
+#include "point3.h"
+#include "element.h"
+
+namespace chemkit {
+
+class Atom;
+class Bond;
+class Molecule;
+class MoleculeBuilderPrivate;
+
+class CHEMKIT_EXPORT MoleculeBuilder
+{
+public:
+    // construction and destruction
+    MoleculeBuilder(Molecule *molecule);
+    ~MoleculeBuilder();
+
+    // properties
+    Molecule* molecule() const;
+    void reserve(size_t atomCount, size_t bondCount);
+
+    // structure
+    Atom* addAtom(const Element &element);
+    Atom* addAtom(const Element &element, const Point3 &position);
+    void addAtoms(const std::vector<Element> &elements);
+    void addAtoms(const std::vector<Element> &elements, const std::vector<Point3> &positions);
+    Bond* addBond(Atom *a, Atom *b, int order = 1);
+    void addBonds(const std::vector<std::pair<size_t, size_t> > &bonds);
+    void addBonds(const std::vector<std::pair<size_t, size_t> > &bonds, const std::vector<int> &orders);
+
+    // editing
+    void commit();
+
+private:
+    Bond* findBond(const Atom *a, const Atom *b);
+    void linkPendingBond(size_t index);
+    void growCapacity(size_t atomCount, size_t bondCount);
+    void reserveCoordinates();
+
+private:
+    MoleculeBuilderPrivate* const d;
+
+    CHEMKIT_DISABLE_COPY(MoleculeBuilder)
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_MOLECULEBUILDER_H
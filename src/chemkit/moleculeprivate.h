@@ -42,6 +42,8 @@
 #include <string>
 #include <vector>
 
+#include <boost/pool/pool.hpp>
+
 #include "bond.h"
 #include "point3.h"
 #include "isotope.h"
@@ -73,8 +75,22 @@ public:
     std::vector<std::string> atomTypes;
     std::vector<Real> partialCharges;
     std::vector<std::pair<Atom*, Atom*> > bondAtoms;
-    std::vector<std::vector<Bond *> > atomBonds;
     std::vector<Bond::BondOrderType> bondOrders;
+
+    // storage for the atom and bond objects
+    boost::pool<> atomPool;
+    boost::pool<> bondPool;
+
+    // the bonds for each atom are stored contiguously in packedBonds
+    // (compressed sparse row layout) with the range for atom i given
+    // by packedBondRanges[i]. once the bonds for an atom are modified
+    // they are moved to a vector of its own in atomBonds. bonds added
+    // by a MoleculeBuilder are kept in pendingBonds until they are
+    // packed.
+    std::vector<Bond *> packedBonds;
+    std::vector<std::pair<unsigned int, unsigned int> > packedBondRanges;
+    std::vector<std::vector<Bond *> *> atomBonds;
+    std::vector<Bond *> pendingBonds;
     std::vector<boost::shared_ptr<CoordinateSet> > coordinateSets;
 };
 
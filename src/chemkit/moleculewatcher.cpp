@@ -128,6 +128,12 @@ const Molecule* MoleculeWatcher::molecule() const
 ///
 /// This signal is emitted when the molecule's name changes.
 
+/// \fn void MoleculeWatcher::structureChanged(const Molecule *molecule)
+///
+/// This signal is emitted once when a MoleculeBuilder commits the
+/// atoms and bonds it has added to the molecule. The atomAdded() and
+/// bondAdded() signals are not emitted for each of them.
+
 // --- Events ---------------------------------------------------- //
 void MoleculeWatcher::moleculeChanged(const Molecule *molecule, ChangeType changeType)
 {
@@ -135,6 +141,9 @@ void MoleculeWatcher::moleculeChanged(const Molecule *molecule, ChangeType chang
         case NameChanged:
             nameChanged(molecule);
             break;
+        case StructureChanged:
+            structureChanged(molecule);
+            break;
         default:
             break;
     }
@@ -38,8 +38,9 @@
 
 #include "chemkit.h"
 
-#include <set>
 #include <limits>
+#include <cassert>
+#include <utility>
 #include <algorithm>
 
 #include <boost/bind.hpp>
@@ -48,6 +49,7 @@
 
 #include "atom.h"
 #include "graph.h"
+#include "bitset.h"
 #include "foreach.h"
 #include "fragment.h"
 #include "molecule.h"
@@ -56,6 +58,60 @@ namespace chemkit {
 namespace algorithm {
 namespace detail {
 
+template<typename T> class PidMatrix;
+
+// === PathSet ============================================================= //
+// The PathSet class contains the paths between a pair of vertices. All
+// of the paths in a set have the same length so their vertices are
+// stored back-to-back in a single vector instead of one vector per path.
+template<typename T>
+class PathSet
+{
+public:
+    // construction and destruction
+    PathSet() : m_size(0), m_length(0) { }
+
+    // properties
+    T size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    T length() const { return m_length; }
+
+    // paths
+    typename std::vector<T>::const_iterator begin(T index) const { return m_vertices.begin() + index * m_length; }
+    typename std::vector<T>::const_iterator end(T index) const { return begin(index) + m_length; }
+    void append(const PathSet &paths);
+    void clear();
+
+private:
+    template<typename U> friend class PidMatrix;
+
+    T m_size;
+    T m_length;
+    std::vector<T> m_vertices;
+};
+
+template<typename T>
+inline void PathSet<T>::append(const PathSet &paths)
+{
+    if(isEmpty()){
+        *this = paths;
+        return;
+    }
+
+    assert(paths.isEmpty() || paths.m_length == m_length);
+
+    m_vertices.insert(m_vertices.end(), paths.m_vertices.begin(), paths.m_vertices.end());
+    m_size += paths.m_size;
+}
+
+template<typename T>
+inline void PathSet<T>::clear()
+{
+    m_vertices.clear();
+    m_size = 0;
+    m_length = 0;
+}
+
 // === PidMatrix =========================================================== //
 // The PidMatrix class implements a path-included distance matrix.
 template<typename T>
@@ -64,95 +120,70 @@ class PidMatrix
 public:
     // construction and destruction
     PidMatrix(T size);
-    ~PidMatrix();
 
     // paths
-    std::vector<std::vector<T> >& paths(T i, T j);
-    void addPaths(T i, T j, const std::vector<std::vector<T> > &paths);
-    std::vector<std::vector<T> > splice(T i, T j, T k);
+    PathSet<T>& paths(T i, T j);
+    void splice(T i, T j, T k, PathSet<T> &splicedPaths);
 
     // operators
-    std::vector<std::vector<T> >& operator()(T i, T j);
+    PathSet<T>& operator()(T i, T j);
 
 private:
     T m_size;
-    std::vector<std::vector<T> > *m_values;
+    std::vector<PathSet<T> > m_values;
 };
 
 // --- Construction and Destruction ---------------------------------------- //
 template<typename T>
 inline PidMatrix<T>::PidMatrix(T size)
+    : m_size(size),
+      m_values(size * size)
 {
-    m_size = size;
-    m_values = new std::vector<std::vector<T> >[size*size];
-}
-
-template<typename T>
-inline PidMatrix<T>::~PidMatrix()
-{
-    delete [] m_values;
 }
 
 // --- Paths --------------------------------------------------------------- //
 template<typename T>
-inline std::vector<std::vector<T> >& PidMatrix<T>::paths(T i, T j)
+inline PathSet<T>& PidMatrix<T>::paths(T i, T j)
 {
     return m_values[i * m_size + j];
 }
 
 template<typename T>
-inline void PidMatrix<T>::addPaths(T i, T j, const std::vector<std::vector<T> > &paths)
-{
-    std::vector<std::vector<T> > &current = m_values[i * m_size + j];
-    current.insert(current.end(), paths.begin(), paths.end());
-}
-
-template<typename T>
-inline std::vector<std::vector<T> >& PidMatrix<T>::operator()(T i, T j)
+inline PathSet<T>& PidMatrix<T>::operator()(T i, T j)
 {
     return paths(i, j);
 }
 
+// Joins each path from i to j with each path from j to k and places
+// the results in splicedPaths. An empty set of paths between adjacent
+// vertices is treated as a single path with no intermediate vertices.
 template<typename T>
-inline std::vector<std::vector<T> > PidMatrix<T>::splice(T i, T j, T k)
+inline void PidMatrix<T>::splice(T i, T j, T k, PathSet<T> &splicedPaths)
 {
-    std::vector<std::vector<T> > splicedPaths;
+    const PathSet<T> &ijPaths = paths(i, j);
+    const PathSet<T> &jkPaths = paths(j, k);
 
-    const std::vector<std::vector<T> > &ijPaths = paths(i, j);
-    const std::vector<std::vector<T> > &jkPaths = paths(j, k);
+    T ijCount = std::max<T>(ijPaths.size(), 1);
+    T jkCount = std::max<T>(jkPaths.size(), 1);
 
-    if(ijPaths.empty() && jkPaths.empty()){
-        std::vector<T> path;
-        path.push_back(j);
-        splicedPaths.push_back(path);
-    }
-    else if(ijPaths.empty()){
-        foreach(const std::vector<T> &jkPath, jkPaths){
-            std::vector<T> path;
-            path.push_back(j);
-            path.insert(path.end(), jkPath.begin(), jkPath.end());
-            splicedPaths.push_back(path);
-        }
-    }
-    else if(jkPaths.empty()){
-        foreach(const std::vector<T> &ijPath, ijPaths){
-            std::vector<T> path = ijPath;
-            path.push_back(j);
-            splicedPaths.push_back(path);
-        }
-    }
-    else{
-        foreach(const std::vector<T> &ijPath, ijPaths){
-            foreach(const std::vector<T> &jkPath, jkPaths){
-                std::vector<T> path = ijPath;
-                path.push_back(j);
-                path.insert(path.end(), jkPath.begin(), jkPath.end());
-                splicedPaths.push_back(path);
+    splicedPaths.clear();
+    splicedPaths.m_size = ijCount * jkCount;
+    splicedPaths.m_length = ijPaths.length() + 1 + jkPaths.length();
+    splicedPaths.m_vertices.reserve(splicedPaths.m_size * splicedPaths.m_length);
+
+    for(T a = 0; a < ijCount; a++){
+        for(T b = 0; b < jkCount; b++){
+            if(!ijPaths.isEmpty()){
+                splicedPaths.m_vertices.insert(splicedPaths.m_vertices.end(), ijPaths.begin(a), ijPaths.end(a));
+            }
+
+            splicedPaths.m_vertices.push_back(j);
+
+            if(!jkPaths.isEmpty()){
+                splicedPaths.m_vertices.insert(splicedPaths.m_vertices.end(), jkPaths.begin(b), jkPaths.end(b));
             }
         }
     }
-
-    return splicedPaths;
 }
 
 // === RingCandidate ======================================================= //
@@ -178,26 +209,71 @@ private:
 };
 
 // === Sssr ================================================================ //
+// The Sssr class contains the rings found so far. Each ring is also
+// stored as a vector of the graph's edges reduced against the previous
+// rings so that rings which are a combination of rings already in the
+// set can be rejected.
 template<typename T>
 class Sssr
 {
 public:
+    // construction and destruction
+    Sssr(const Graph<T> &graph);
+
     // properties
     size_t size() const { return m_rings.size(); }
     bool isEmpty() const { return m_rings.empty(); }
 
     // rings
     const std::vector<std::vector<T> >& rings() const { return m_rings; }
-    void append(const std::vector<T> &ring) { m_rings.push_back(ring); }
+    void append(const std::vector<T> &ring);
 
     // ring checks
     bool isValid(const std::vector<T> &ring) const;
-    bool isUnique(const std::vector<T> &ring) const;
+    bool isIndependent(const std::vector<T> &ring) const;
 
 private:
+    Bitset reducedEdges(const std::vector<T> &ring) const;
+
+private:
+    T m_size;
+    std::vector<size_t> m_edgeIndices;
+    size_t m_edgeCount;
     std::vector<std::vector<T> > m_rings;
+    std::vector<Bitset> m_basis;
+    std::vector<size_t> m_pivots;
 };
 
+// --- Construction and Destruction ---------------------------------------- //
+template<typename T>
+inline Sssr<T>::Sssr(const Graph<T> &graph)
+    : m_size(graph.size()),
+      m_edgeIndices(graph.size() * graph.size()),
+      m_edgeCount(0)
+{
+    for(T i = 0; i < m_size; i++){
+        foreach(T j, graph.neighbors(i)){
+            if(j > i){
+                m_edgeIndices[i * m_size + j] = m_edgeCount;
+                m_edgeIndices[j * m_size + i] = m_edgeCount;
+                m_edgeCount++;
+            }
+        }
+    }
+}
+
+// --- Rings --------------------------------------------------------------- //
+template<typename T>
+inline void Sssr<T>::append(const std::vector<T> &ring)
+{
+    Bitset edges = reducedEdges(ring);
+    assert(edges.any());
+
+    m_rings.push_back(ring);
+    m_pivots.push_back(edges.find_first());
+    m_basis.push_back(edges);
+}
+
 // --- Ring Checks --------------------------------------------------------- //
 template<typename T>
 inline bool Sssr<T>::isValid(const std::vector<T> &ring) const
@@ -214,101 +290,165 @@ inline bool Sssr<T>::isValid(const std::vector<T> &ring) const
     return true;
 }
 
+// Returns true if the ring's edges are linearly independent (over
+// GF(2)) of the edges of the rings already in the set.
 template<typename T>
-inline bool Sssr<T>::isUnique(const std::vector<T> &path) const
+inline bool Sssr<T>::isIndependent(const std::vector<T> &ring) const
 {
-    // must be unique if sssr is empty
-    if(isEmpty()){
-        return true;
+    return reducedEdges(ring).any();
+}
+
+// Returns the ring's edges with every ring already in the set whose
+// pivot edge they contain removed. Each ring in the basis was reduced
+// against the rings before it so a single pass is enough.
+template<typename T>
+inline Bitset Sssr<T>::reducedEdges(const std::vector<T> &ring) const
+{
+    Bitset edges(m_edgeCount);
+
+    for(T i = 0; i < ring.size(); i++){
+        T a = ring[i];
+        T b = ring[(i + 1) % ring.size()];
+        edges.flip(m_edgeIndices[a * m_size + b]);
     }
 
-    // check if a ring with the same atoms is already in the sssr
-    std::set<T> pathSet;
-    pathSet.insert(path.begin(), path.end());
+    for(size_t i = 0; i < m_basis.size(); i++){
+        if(edges[m_pivots[i]]){
+            edges ^= m_basis[i];
+        }
+    }
 
-    foreach(const std::vector<T> &ring, m_rings){
-        std::set<T> ringSet;
-        ringSet.insert(ring.begin(), ring.end());
+    return edges;
+}
 
-        std::vector<T> sortedRing(ring.begin(), ring.end());
-        std::sort(sortedRing.begin(), sortedRing.end());
+// Returns the vertices of each biconnected component in the graph
+// that contains at least one cycle. Vertices that cannot be part of
+// a cycle are pruned first and the remaining graph is split with an
+// iterative version of Tarjan's algorithm. The vertices in each
+// component are sorted in ascending order.
+template<typename T>
+inline std::vector<std::vector<T> > cyclicComponents(const Graph<T> &graph)
+{
+    T n = graph.size();
 
-        std::set<T> intersection;
-        std::set_intersection(pathSet.begin(), pathSet.end(),
-                              ringSet.begin(), ringSet.end(),
-                              std::inserter(intersection, intersection.begin()));
+    // repeatedly prune vertices with fewer than two neighbors
+    std::vector<T> degree(n);
+    std::vector<T> prunable;
+    std::vector<bool> pruned(n, false);
 
-        if(intersection.size() == ring.size()){
-            return false;
+    for(T i = 0; i < n; i++){
+        degree[i] = graph.neighbors(i).size();
+
+        if(degree[i] < 2){
+            prunable.push_back(i);
         }
     }
 
-    // build set of bonds in the path
-    std::set<std::pair<T, T> > pathBonds;
-    for(T i = 0; i < path.size() - 1; i++){
-        pathBonds.insert(std::make_pair(std::min(path[i], path[i+1]),
-                                        std::max(path[i], path[i+1])));
+    while(!prunable.empty()){
+        T vertex = prunable.back();
+        prunable.pop_back();
+        pruned[vertex] = true;
+
+        foreach(T neighbor, graph.neighbors(vertex)){
+            if(!pruned[neighbor] && --degree[neighbor] == 1){
+                prunable.push_back(neighbor);
+            }
+        }
     }
 
-    pathBonds.insert(std::make_pair(std::min(path.front(), path.back()),
-                                    std::max(path.front(), path.back())));
+    // split the remaining vertices into biconnected components
+    std::vector<std::vector<T> > components;
 
-    // remove bonds from path bonds that are already in a smaller ring
-    foreach(const std::vector<T> &ring, m_rings){
-        if(ring.size() >= path.size()){
+    std::vector<T> order(n, 0);
+    std::vector<T> low(n, 0);
+    T counter = 0;
+
+    std::vector<std::pair<T, T> > edges;
+    std::vector<std::pair<T, T> > stack;
+
+    for(T root = 0; root < n; root++){
+        if(pruned[root] || order[root] != 0){
             continue;
         }
 
-        for(T i = 0; i < ring.size() - 1; i++){
-            pathBonds.erase(std::make_pair(std::min(ring[i], ring[i+1]),
-                                           std::max(ring[i], ring[i+1])));
-        }
+        order[root] = low[root] = ++counter;
+        stack.push_back(std::make_pair(root, T(0)));
 
-        pathBonds.erase(std::make_pair(std::min(ring.front(), ring.back()),
-                                       std::max(ring.front(), ring.back())));
-    }
+        while(!stack.empty()){
+            T vertex = stack.back().first;
+            T position = stack.back().second;
+            const std::vector<T> &neighbors = graph.neighbors(vertex);
 
-    // check if any other ring contains the same bonds
-    foreach(const std::vector<T> &ring, m_rings){
-        std::set<std::pair<T, T> > ringBonds;
+            if(position < neighbors.size()){
+                stack.back().second++;
 
-        // add ring bonds
-        for(T i = 0; i < ring.size() - 1; i++){
-            ringBonds.insert(std::make_pair(std::min(ring[i], ring[i+1]),
-                                            std::max(ring[i], ring[i+1])));
-        }
+                T neighbor = neighbors[position];
+                if(pruned[neighbor]){
+                    continue;
+                }
 
-        // add closure bond
-        ringBonds.insert(std::make_pair(std::min(ring.front(), ring.back()),
-                                        std::max(ring.front(), ring.back())));
+                if(order[neighbor] == 0){
+                    // tree edge
+                    edges.push_back(std::make_pair(vertex, neighbor));
+                    order[neighbor] = low[neighbor] = ++counter;
+                    stack.push_back(std::make_pair(neighbor, T(0)));
+                }
+                else if(order[neighbor] < order[vertex] &&
+                        !(stack.size() > 1 && stack[stack.size() - 2].first == neighbor)){
+                    // back edge
+                    edges.push_back(std::make_pair(vertex, neighbor));
+                    low[vertex] = std::min(low[vertex], order[neighbor]);
+                }
+            }
+            else{
+                stack.pop_back();
+                if(stack.empty()){
+                    break;
+                }
 
-        // check intersection
-        std::set<std::pair<T, T> > intersection;
-        std::set_intersection(pathBonds.begin(), pathBonds.end(),
-                              ringBonds.begin(), ringBonds.end(),
-                              std::inserter(intersection, intersection.begin()));
+                T parent = stack.back().first;
+                low[parent] = std::min(low[parent], low[vertex]);
+
+                if(low[vertex] >= order[parent]){
+                    // parent is an articulation point so every edge above
+                    // (parent, vertex) on the edge stack forms a component
+                    std::vector<T> component;
+                    size_t edgeCount = 0;
+
+                    for(;;){
+                        std::pair<T, T> edge = edges.back();
+                        edges.pop_back();
+                        component.push_back(edge.first);
+                        component.push_back(edge.second);
+                        edgeCount++;
+
+                        if(edge.first == parent && edge.second == vertex){
+                            break;
+                        }
+                    }
 
-        if(intersection.size() == pathBonds.size()){
-            return false;
+                    // a single edge is a bridge and not part of any ring
+                    if(edgeCount > 1){
+                        std::sort(component.begin(), component.end());
+                        component.erase(std::unique(component.begin(), component.end()), component.end());
+                        components.push_back(component);
+                    }
+                }
+            }
         }
     }
 
-    return true;
+    return components;
 }
 
-} // end detail namespace
-
-// Returns the smallest set of smallest rings in a graph using the
-// RP-Path algorithm.
+// Returns the smallest set of smallest rings in a connected graph
+// using the RP-Path algorithm.
 //
 // For a description of the algorithm see [Lee 2009].
 template<typename T>
-inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
+inline std::vector<std::vector<T> > sssr(const Graph<T> &graph)
 {
     typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> DistanceMatrix;
-    using chemkit::algorithm::detail::PidMatrix;
-    using chemkit::algorithm::detail::RingCandidate;
-    using chemkit::algorithm::detail::Sssr;
 
     T n = graph.size();
 
@@ -321,6 +461,7 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
     DistanceMatrix D(n, n);
     PidMatrix<T> P(n);
     PidMatrix<T> Pt(n);
+    PathSet<T> splicedPaths;
 
     for(T i = 0; i < n; i++){
         for(T j = 0; j < n; j++){
@@ -352,13 +493,16 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
                     }
 
                     D(i, j) = D(i, k) + D(k, j);
-                    P(i, j) = P.splice(i, k, j);
+                    P.splice(i, k, j, splicedPaths);
+                    P(i, j) = splicedPaths;
                 }
                 else if(D(i, j) == D(i, k) + D(k, j)){
-                    P.addPaths(i, j, P.splice(i, k, j));
+                    P.splice(i, k, j, splicedPaths);
+                    P(i, j).append(splicedPaths);
                 }
                 else if(D(i, j) == D(i, k) + D(k, j) - 1){
-                    Pt.addPaths(i, j, P.splice(i, k, j));
+                    P.splice(i, k, j, splicedPaths);
+                    Pt(i, j).append(splicedPaths);
                 }
             }
         }
@@ -392,24 +536,27 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
     std::sort(candidates.begin(), candidates.end(), RingCandidate<T>::compareSize);
 
     // algorithm 3 - find sssr from the ring candidate set
-    Sssr<T> sssr;
+    Sssr<T> sssr(graph);
 
     foreach(const RingCandidate<T> &candidate, candidates){
+        const PathSet<T> &forwardPaths = P(candidate.start(), candidate.end());
+        const PathSet<T> &reversePaths = P(candidate.end(), candidate.start());
+
         // odd sized ring
         if(candidate.size() & 1){
-            for(size_t i = 0; i < Pt(candidate.start(), candidate.end()).size(); i++){
+            const PathSet<T> &longerPaths = Pt(candidate.start(), candidate.end());
+
+            for(T i = 0; i < longerPaths.size(); i++){
                 std::vector<T> ring;
                 ring.push_back(candidate.start());
-                std::vector<T> &path = Pt(candidate.start(), candidate.end())[i];
-                ring.insert(ring.end(), path.begin(), path.end());
+                ring.insert(ring.end(), longerPaths.begin(i), longerPaths.end(i));
                 ring.push_back(candidate.end());
-                if(!P(candidate.end(), candidate.start()).empty()){
-                    path = P(candidate.end(), candidate.start())[0];
-                    ring.insert(ring.end(), path.begin(), path.end());
+                if(!reversePaths.isEmpty()){
+                    ring.insert(ring.end(), reversePaths.begin(0), reversePaths.end(0));
                 }
 
-                // check if ring is valid and unique
-                if(sssr.isValid(ring) && sssr.isUnique(ring)){
+                // check if ring is valid and independent
+                if(sssr.isValid(ring) && sssr.isIndependent(ring)){
                     sssr.append(ring);
                     break;
                 }
@@ -417,17 +564,15 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
         }
         // even sized ring
         else{
-            for(size_t i = 0; i < P(candidate.start(), candidate.end()).size() - 1; i++){
+            for(T i = 0; i < forwardPaths.size() - 1; i++){
                 std::vector<T> ring;
                 ring.push_back(candidate.start());
-                std::vector<T> &path = P(candidate.start(), candidate.end())[i];
-                ring.insert(ring.end(), path.begin(), path.end());
+                ring.insert(ring.end(), forwardPaths.begin(i), forwardPaths.end(i));
                 ring.push_back(candidate.end());
-                path = P(candidate.end(), candidate.start())[i+1];
-                ring.insert(ring.end(), path.begin(), path.end());
+                ring.insert(ring.end(), reversePaths.begin(i+1), reversePaths.end(i+1));
 
-                // check if ring is valid and unique
-                if(sssr.isValid(ring) && sssr.isUnique(ring)){
+                // check if ring is valid and independent
+                if(sssr.isValid(ring) && sssr.isIndependent(ring)){
                     sssr.append(ring);
                     break;
                 }
@@ -442,6 +587,72 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
     return sssr.rings();
 }
 
+template<typename T>
+inline bool compareRingSize(const std::vector<T> &a, const std::vector<T> &b)
+{
+    return a.size() < b.size();
+}
+
+inline bool compareAtomIndex(const Atom *a, const Atom *b)
+{
+    return a->index() < b->index();
+}
+
+} // end detail namespace
+
+// Returns the smallest set of smallest rings in a graph.
+//
+// Every ring lies entirely within a single biconnected component of
+// the graph so the rings are perceived separately for each component
+// that contains a cycle. This keeps the cost of the RP-Path algorithm
+// proportional to the size of the ring systems rather than to the size
+// of the whole graph. The rings are returned in order of increasing size.
+template<typename T>
+inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
+{
+    std::vector<std::vector<T> > rings;
+
+    // maps from graph vertices to component vertices
+    const T none = graph.size();
+    std::vector<T> localIndices(graph.size(), none);
+
+    foreach(const std::vector<T> &component, detail::cyclicComponents(graph)){
+        for(T i = 0; i < component.size(); i++){
+            localIndices[component[i]] = i;
+        }
+
+        // build component graph
+        Graph<T> subgraph(component.size());
+
+        for(T i = 0; i < component.size(); i++){
+            foreach(T neighbor, graph.neighbors(component[i])){
+                if(neighbor > component[i] && localIndices[neighbor] != none){
+                    subgraph.addEdge(i, localIndices[neighbor]);
+                }
+            }
+        }
+
+        // perceive rings and map them back to the graph's vertices
+        foreach(const std::vector<T> &cycle, detail::sssr(subgraph)){
+            std::vector<T> ring(cycle.size());
+
+            for(T i = 0; i < cycle.size(); i++){
+                ring[i] = component[cycle[i]];
+            }
+
+            rings.push_back(ring);
+        }
+
+        foreach(T vertex, component){
+            localIndices[vertex] = none;
+        }
+    }
+
+    std::stable_sort(rings.begin(), rings.end(), detail::compareRingSize<T>);
+
+    return rings;
+}
+
 inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
 {
     std::vector<Atom *> atoms = fragment->atoms();
@@ -449,21 +660,28 @@ inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
     // remove any terminal atoms
     atoms.erase(std::remove_if(atoms.begin(), atoms.end(), boost::bind(&Atom::isTerminal, _1)), atoms.end());
 
+    // sort atoms by index so that their neighbors can be found with a
+    // binary search
+    std::sort(atoms.begin(), atoms.end(), detail::compareAtomIndex);
+
     // create graph
     Graph<size_t> graph(atoms.size());
 
     for(size_t i = 0; i < atoms.size(); i++){
-        for(size_t j = i + 1; j < atoms.size(); j++){
-            if(atoms[i]->isBondedTo(atoms[j])){
-                graph.addEdge(i, j);
+        foreach(Atom *neighbor, atoms[i]->neighbors()){
+            if(neighbor->index() < atoms[i]->index()){
+                continue;
+            }
+
+            std::vector<Atom *>::const_iterator iter =
+                std::lower_bound(atoms.begin(), atoms.end(), neighbor, detail::compareAtomIndex);
+
+            if(iter != atoms.end() && *iter == neighbor){
+                graph.addEdge(i, iter - atoms.begin());
             }
         }
     }
 
-    // cyclize graph
-    std::vector<size_t> originalIndices;
-    graph.cyclize(originalIndices);
-
     // perceive rings
     std::vector<std::vector<size_t> > sssr = rppath(graph);
 
@@ -474,7 +692,7 @@ inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
         std::vector<Atom *> ring(cycle.size());
 
         for(size_t i = 0; i < cycle.size(); i++){
-            ring[i] = atoms[originalIndices[cycle[i]]];
+            ring[i] = atoms[cycle[i]];
         }
 
         rings.push_back(ring);
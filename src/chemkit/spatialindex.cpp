@@ -0,0 +1,633 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "spatialindex.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include <Eigen/LU>
+
+#include <boost/math/special_functions/fpclassify.hpp>
+
+#include "unitcell.h"
+#include "cartesiancoordinates.h"
+
+namespace chemkit {
+
+namespace {
+
+typedef boost::array<long, 3> CellCoordinates;
+typedef std::pair<Real, size_t> Candidate;
+
+// Returns the largest integer not greater than value / divisor.
+long floorDivide(long value, long divisor)
+{
+    long quotient = value / divisor;
+    if(value % divisor != 0 && value < 0){
+        quotient--;
+    }
+
+    return quotient;
+}
+
+// Returns true if each coordinate of position is finite.
+bool isFinite(const Point3 &position)
+{
+    for(int k = 0; k < 3; k++){
+        if(!(boost::math::isfinite)(position[k])){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Returns floor(value) as a grid coordinate. Values too large to be
+// stored are limited to a coordinate just outside of a grid with
+// dimension cells and NaN values are placed in cell zero.
+long gridCoordinate(Real value, size_t dimension)
+{
+    if((boost::math::isnan)(value)){
+        return 0;
+    }
+
+    Real limit = static_cast<Real>(dimension) + 1;
+
+    return static_cast<long>(std::floor(std::max(-limit, std::min(value, limit))));
+}
+
+} // end anonymous namespace
+
+// === SpatialIndexPrivate ================================================= //
+class SpatialIndexPrivate
+{
+public:
+    CellCoordinates cellCoordinates(const Point3 &position) const;
+    size_t cellIndex(const CellCoordinates &coordinates) const;
+    Point3 wrap(const Point3 &position) const;
+    void collect(const Point3 &point, Real radius, std::vector<Candidate> &candidates) const;
+    void insert(size_t index);
+    void remove(size_t index);
+
+    Real cellSize;
+    bool periodic;
+    Eigen::Matrix<Real, 3, 3> box;
+    Eigen::Matrix<Real, 3, 3> inverseBox;
+    Vector3 widths;
+    Point3 origin;
+    Real cellWidth;
+    boost::array<size_t, 3> dimensions;
+    std::vector<Point3> positions;
+    std::vector<Point3> wrappedPositions;
+    std::vector<size_t> atomCells;
+    std::vector<std::vector<size_t> > cells;
+    size_t nonFiniteCount;
+};
+
+// Returns the unclamped grid coordinates of the cell containing
+// position. For periodic indices position should already be wrapped.
+// Positions with non-finite coordinates are placed in cell zero.
+CellCoordinates SpatialIndexPrivate::cellCoordinates(const Point3 &position) const
+{
+    CellCoordinates coordinates;
+
+    if(periodic){
+        Vector3 fractional = inverseBox * position;
+        for(int k = 0; k < 3; k++){
+            coordinates[k] = gridCoordinate(fractional[k] * dimensions[k], dimensions[k]);
+        }
+    }
+    else{
+        for(int k = 0; k < 3; k++){
+            coordinates[k] = gridCoordinate((position[k] - origin[k]) / cellWidth, dimensions[k]);
+        }
+    }
+
+    return coordinates;
+}
+
+// Returns the index of the cell with the given coordinates. Atoms
+// outside of the grid are placed in the closest cell on its border.
+size_t SpatialIndexPrivate::cellIndex(const CellCoordinates &coordinates) const
+{
+    boost::array<size_t, 3> clamped;
+    for(int k = 0; k < 3; k++){
+        long maximum = static_cast<long>(dimensions[k]) - 1;
+        clamped[k] = static_cast<size_t>(std::max(0L, std::min(coordinates[k], maximum)));
+    }
+
+    return (clamped[2] * dimensions[1] + clamped[1]) * dimensions[0] + clamped[0];
+}
+
+// Returns the image of position inside the unit cell.
+Point3 SpatialIndexPrivate::wrap(const Point3 &position) const
+{
+    if(!periodic){
+        return position;
+    }
+
+    Vector3 fractional = inverseBox * position;
+    for(int k = 0; k < 3; k++){
+        fractional[k] -= std::floor(fractional[k]);
+    }
+
+    return box * fractional;
+}
+
+// Adds each atom within radius of point to candidates along with its
+// squared distance. For periodic indices an atom is added once for
+// every one of its images within radius.
+void SpatialIndexPrivate::collect(const Point3 &point, Real radius, std::vector<Candidate> &candidates) const
+{
+    // no atom is within a finite distance of a non-finite point
+    if(!isFinite(point)){
+        return;
+    }
+
+    Real radiusSquared = radius * radius;
+
+    if(!periodic){
+        CellCoordinates lower = cellCoordinates(point - Vector3::Constant(radius));
+        CellCoordinates upper = cellCoordinates(point + Vector3::Constant(radius));
+
+        // clamp the search to the grid, atoms outside of it are kept
+        // in the border cells
+        for(int k = 0; k < 3; k++){
+            long maximum = static_cast<long>(dimensions[k]) - 1;
+            lower[k] = std::max(0L, std::min(lower[k], maximum));
+            upper[k] = std::max(0L, std::min(upper[k], maximum));
+        }
+
+        for(long z = lower[2]; z <= upper[2]; z++){
+            for(long y = lower[1]; y <= upper[1]; y++){
+                for(long x = lower[0]; x <= upper[0]; x++){
+                    const std::vector<size_t> &cell = cells[(z * dimensions[1] + y) * dimensions[0] + x];
+
+                    for(size_t i = 0; i < cell.size(); i++){
+                        Real distanceSquared = (positions[cell[i]] - point).squaredNorm();
+                        if(distanceSquared <= radiusSquared){
+                            candidates.push_back(std::make_pair(distanceSquared, cell[i]));
+                        }
+                    }
+                }
+            }
+        }
+
+        return;
+    }
+
+    // a point within radius differs by at most radius / width in
+    // each fractional coordinate
+    Point3 wrapped = wrap(point);
+    Vector3 fractional = inverseBox * wrapped;
+    CellCoordinates lower;
+    CellCoordinates upper;
+    for(int k = 0; k < 3; k++){
+        lower[k] = static_cast<long>(std::floor((fractional[k] - radius / widths[k]) * dimensions[k]));
+        upper[k] = static_cast<long>(std::floor((fractional[k] + radius / widths[k]) * dimensions[k]));
+    }
+
+    for(long z = lower[2]; z <= upper[2]; z++){
+        for(long y = lower[1]; y <= upper[1]; y++){
+            for(long x = lower[0]; x <= upper[0]; x++){
+                CellCoordinates raw = {{ x, y, z }};
+                CellCoordinates cell;
+                Vector3 shift;
+                for(int k = 0; k < 3; k++){
+                    long n = static_cast<long>(dimensions[k]);
+                    long image = floorDivide(raw[k], n);
+                    cell[k] = raw[k] - image * n;
+                    shift[k] = static_cast<Real>(image);
+                }
+
+                // the query point relative to this image of the cell
+                Point3 relative = wrapped - box * shift;
+
+                const std::vector<size_t> &atoms = cells[cellIndex(cell)];
+                for(size_t i = 0; i < atoms.size(); i++){
+                    Real distanceSquared = (wrappedPositions[atoms[i]] - relative).squaredNorm();
+                    if(distanceSquared <= radiusSquared){
+                        candidates.push_back(std::make_pair(distanceSquared, atoms[i]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Adds the atom at index to the cell containing its position.
+void SpatialIndexPrivate::insert(size_t index)
+{
+    size_t cell = cellIndex(cellCoordinates(wrappedPositions[index]));
+
+    atomCells[index] = cell;
+    cells[cell].push_back(index);
+}
+
+// Removes the atom at index from its cell.
+void SpatialIndexPrivate::remove(size_t index)
+{
+    std::vector<size_t> &cell = cells[atomCells[index]];
+
+    std::vector<size_t>::iterator iter = std::find(cell.begin(), cell.end(), index);
+    *iter = cell.back();
+    cell.pop_back();
+}
+
+// === SpatialIndex ======================================================== //
+/// \class SpatialIndex spatialindex.h chemkit/spatialindex.h
+/// \ingroup chemkit
+/// \brief The SpatialIndex class provides fast spatial queries over a
+///        set of coordinates.
+///
+/// The spatial index sorts the points into a grid of cells so that
+/// queries only need to look at the points in nearby cells. Finding
+/// the points within a radius, the nearest neighbors of a point and
+/// all pairs of points within a cutoff distance take time linear in
+/// the number of points found rather than in the number of points
+/// in the index.
+///
+/// The following example finds every pair of atoms within four
+/// Angstroms of each other:
+/// \code
+/// SpatialIndex index(molecule->coordinates());
+///
+/// foreach(const SpatialIndex::Pair &pair, index.pairs(4.0)){
+///     ...
+/// }
+/// \endcode
+///
+/// If a unit cell is given the index is periodic. Distances are then
+/// measured between the closest periodic images of two points.
+///
+/// When the points move the index can be updated in place with the
+/// setPosition() and update() methods. Only points which move to a
+/// different cell require any work.
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new spatial index for \p coordinates with cells at least
+/// \p cellSize Angstroms wide. Queries are fastest when \p cellSize
+/// is close to the typical query radius. If \p unitCell is not \c 0
+/// the index is periodic.
+SpatialIndex::SpatialIndex(const CartesianCoordinates *coordinates, Real cellSize, const UnitCell *unitCell)
+    : d(new SpatialIndexPrivate)
+{
+    d->cellSize = std::max(cellSize, Real(0.1));
+    d->periodic = false;
+    d->cellWidth = d->cellSize;
+
+    if(unitCell){
+        d->box.col(0) = unitCell->x();
+        d->box.col(1) = unitCell->y();
+        d->box.col(2) = unitCell->z();
+
+        Real volume = std::abs(d->box.determinant());
+        if(volume > 0){
+            d->periodic = true;
+            d->inverseBox = d->box.inverse();
+
+            // distances between opposite faces of the unit cell
+            d->widths[0] = volume / unitCell->y().cross(unitCell->z()).norm();
+            d->widths[1] = volume / unitCell->z().cross(unitCell->x()).norm();
+            d->widths[2] = volume / unitCell->x().cross(unitCell->y()).norm();
+        }
+    }
+
+    rebuild(coordinates);
+}
+
+/// Destroys the spatial index.
+SpatialIndex::~SpatialIndex()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of points in the index.
+size_t SpatialIndex::size() const
+{
+    return d->positions.size();
+}
+
+/// Returns \c true if the index contains no points.
+bool SpatialIndex::isEmpty() const
+{
+    return d->positions.empty();
+}
+
+/// Returns the minimum width of the cells in the index.
+Real SpatialIndex::cellSize() const
+{
+    return d->cellSize;
+}
+
+/// Returns \c true if the index uses periodic boundary conditions.
+bool SpatialIndex::isPeriodic() const
+{
+    return d->periodic;
+}
+
+/// Returns the position of the point at \p index.
+Point3 SpatialIndex::position(size_t index) const
+{
+    return d->positions[index];
+}
+
+// --- Queries ------------------------------------------------------------- //
+/// Returns the indices of each point within \p radius of \p point
+/// in increasing order.
+std::vector<size_t> SpatialIndex::within(const Point3 &point, Real radius) const
+{
+    std::vector<Candidate> candidates;
+    d->collect(point, radius, candidates);
+
+    std::vector<size_t> indices(candidates.size());
+    for(size_t i = 0; i < candidates.size(); i++){
+        indices[i] = candidates[i].second;
+    }
+
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    return indices;
+}
+
+/// Returns the indices of the \p count points closest to \p point
+/// ordered by their distance. Points with non-finite coordinates are
+/// never returned.
+std::vector<size_t> SpatialIndex::nearest(const Point3 &point, size_t count) const
+{
+    // points with non-finite coordinates are not within any distance
+    count = std::min(count, size() - d->nonFiniteCount);
+    if(count == 0 || !isFinite(point)){
+        return std::vector<size_t>();
+    }
+
+    // search with increasing radius until enough points are found
+    std::vector<Candidate> candidates;
+    for(Real radius = d->cellSize; ; radius *= 2){
+        candidates.clear();
+        d->collect(point, radius, candidates);
+
+        if(d->periodic){
+            // keep only the closest image of each point
+            std::vector<std::pair<size_t, Real> > images(candidates.size());
+            for(size_t i = 0; i < candidates.size(); i++){
+                images[i] = std::make_pair(candidates[i].second, candidates[i].first);
+            }
+
+            std::sort(images.begin(), images.end());
+
+            candidates.clear();
+            for(size_t i = 0; i < images.size(); i++){
+                if(i == 0 || images[i].first != images[i-1].first){
+                    candidates.push_back(std::make_pair(images[i].second, images[i].first));
+                }
+            }
+        }
+
+        if(candidates.size() >= count){
+            break;
+        }
+    }
+
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+    std::vector<size_t> indices(count);
+    for(size_t i = 0; i < count; i++){
+        indices[i] = candidates[i].second;
+    }
+
+    return indices;
+}
+
+/// Returns each pair of points within \p cutoff of each other. The
+/// first index in each pair is less than the second and the pairs
+/// are sorted.
+std::vector<SpatialIndex::Pair> SpatialIndex::pairs(Real cutoff) const
+{
+    std::vector<Pair> pairs;
+    std::vector<Candidate> candidates;
+    std::vector<size_t> neighbors;
+
+    for(size_t i = 0; i < size(); i++){
+        candidates.clear();
+        d->collect(d->wrappedPositions[i], cutoff, candidates);
+
+        neighbors.clear();
+        for(size_t k = 0; k < candidates.size(); k++){
+            if(candidates[k].second > i){
+                neighbors.push_back(candidates[k].second);
+            }
+        }
+
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        for(size_t k = 0; k < neighbors.size(); k++){
+            Pair pair = {{ i, neighbors[k] }};
+            pairs.push_back(pair);
+        }
+    }
+
+    return pairs;
+}
+
+/// Returns the distance between \p a and \p b. For periodic indices
+/// this is the distance between their closest images.
+Real SpatialIndex::distance(const Point3 &a, const Point3 &b) const
+{
+    Vector3 delta = b - a;
+
+    if(!d->periodic){
+        return delta.norm();
+    }
+
+    // reduce to the nearest image and then check its neighbors which
+    // may be closer in skewed unit cells
+    Vector3 fractional = d->inverseBox * delta;
+    for(int k = 0; k < 3; k++){
+        fractional[k] -= std::floor(fractional[k] + 0.5);
+    }
+
+    Real minimum = std::numeric_limits<Real>::max();
+    for(int x = -1; x <= 1; x++){
+        for(int y = -1; y <= 1; y++){
+            for(int z = -1; z <= 1; z++){
+                Vector3 image = d->box * (fractional + Vector3(x, y, z));
+                minimum = std::min(minimum, image.squaredNorm());
+            }
+        }
+    }
+
+    return std::sqrt(minimum);
+}
+
+// --- Update -------------------------------------------------------------- //
+/// Moves the point at \p index to \p position.
+void SpatialIndex::setPosition(size_t index, const Point3 &position)
+{
+    d->nonFiniteCount -= !isFinite(d->positions[index]);
+    d->nonFiniteCount += !isFinite(position);
+
+    d->positions[index] = position;
+    d->wrappedPositions[index] = d->wrap(position);
+
+    size_t cell = d->cellIndex(d->cellCoordinates(d->wrappedPositions[index]));
+    if(cell != d->atomCells[index]){
+        d->remove(index);
+        d->insert(index);
+    }
+}
+
+/// Updates the index with the positions in \p coordinates. Only the
+/// points which have moved are updated unless the number of points
+/// has changed or the points have moved far outside of the grid, in
+/// which case the index is rebuilt.
+void SpatialIndex::update(const CartesianCoordinates *coordinates)
+{
+    if(coordinates->size() != size()){
+        rebuild(coordinates);
+        return;
+    }
+
+    if(!d->periodic){
+        Vector3 lower = d->origin.array() - d->cellWidth;
+        Vector3 upper = lower.array() + (Vector3(d->dimensions[0], d->dimensions[1], d->dimensions[2]).array() + 2) * d->cellWidth;
+
+        for(size_t i = 0; i < coordinates->size(); i++){
+            const Point3 &position = (*coordinates)[i];
+
+            if((position.array() < lower.array()).any() || (position.array() > upper.array()).any()){
+                rebuild(coordinates);
+                return;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < coordinates->size(); i++){
+        if((*coordinates)[i] != d->positions[i]){
+            setPosition(i, (*coordinates)[i]);
+        }
+    }
+}
+
+/// Rebuilds the index from the positions in \p coordinates. Points
+/// with non-finite coordinates are kept in the index but are never
+/// returned by queries.
+void SpatialIndex::rebuild(const CartesianCoordinates *coordinates)
+{
+    size_t size = coordinates->size();
+
+    d->positions.resize(size);
+    d->wrappedPositions.resize(size);
+    d->nonFiniteCount = 0;
+    for(size_t i = 0; i < size; i++){
+        d->positions[i] = (*coordinates)[i];
+        d->wrappedPositions[i] = d->wrap(d->positions[i]);
+        d->nonFiniteCount += !isFinite(d->positions[i]);
+    }
+
+    // limit the number of cells for sparse systems
+    size_t maximumCellCount = 8 * size + 27;
+
+    if(d->periodic){
+        for(int k = 0; k < 3; k++){
+            d->dimensions[k] = std::max<size_t>(1, static_cast<size_t>(d->widths[k] / d->cellSize));
+        }
+
+        while(d->dimensions[0] * d->dimensions[1] * d->dimensions[2] > maximumCellCount){
+            for(int k = 0; k < 3; k++){
+                d->dimensions[k] = std::max<size_t>(1, d->dimensions[k] / 2);
+            }
+        }
+    }
+    else{
+        // atoms with non-finite coordinates do not contribute to the
+        // extent of the grid, they are all placed in the first cell
+        bool empty = true;
+        Point3 minimum = Point3::Zero();
+        Point3 maximum = Point3::Zero();
+        for(size_t i = 0; i < size; i++){
+            const Point3 &position = d->positions[i];
+            if(!isFinite(position)){
+                continue;
+            }
+
+            minimum = empty ? position : Point3(minimum.cwiseMin(position));
+            maximum = empty ? position : Point3(maximum.cwiseMax(position));
+            empty = false;
+        }
+
+        Vector3 extent = maximum - minimum;
+
+        d->origin = minimum;
+        d->cellWidth = d->cellSize;
+
+        if(!isFinite(extent)){
+            // the extent overflowed, fall back to a single cell
+            d->dimensions[0] = d->dimensions[1] = d->dimensions[2] = 1;
+        }
+        else{
+            for(;;){
+                Real cellCount = 1;
+                for(int k = 0; k < 3; k++){
+                    cellCount *= std::floor(extent[k] / d->cellWidth) + 1;
+                }
+
+                if(cellCount <= maximumCellCount){
+                    break;
+                }
+
+                d->cellWidth *= 2;
+            }
+
+            for(int k = 0; k < 3; k++){
+                d->dimensions[k] = static_cast<size_t>(extent[k] / d->cellWidth) + 1;
+            }
+        }
+    }
+
+    d->cells.assign(d->dimensions[0] * d->dimensions[1] * d->dimensions[2], std::vector<size_t>());
+    d->atomCells.resize(size);
+    for(size_t i = 0; i < size; i++){
+        d->insert(i);
+    }
+}
+
+} // end chemkit namespace
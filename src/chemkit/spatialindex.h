@@ -0,0 +1,90 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_SPATIALINDEX_H
+#define CHEMKIT_SPATIALINDEX_H
+
+#include "chemkit.h"
+
+#include <vector>
+
+#include <boost/array.hpp>
+
+#include "point3.h"
+
+namespace chemkit {
+
+class UnitCell;
+class SpatialIndexPrivate;
+class CartesianCoordinates;
+
+class CHEMKIT_EXPORT SpatialIndex
+{
+public:
+    // typedefs
+    typedef boost::array<size_t, 2> Pair;
+
+    // construction and destruction
+    SpatialIndex(const CartesianCoordinates *coordinates, Real cellSize = 4.0, const UnitCell *unitCell = 0);
+    ~SpatialIndex();
+
+    // properties
+    size_t size() const;
+    bool isEmpty() const;
+    Real cellSize() const;
+    bool isPeriodic() const;
+    Point3 position(size_t index) const;
+
+    // queries
+    std::vector<size_t> within(const Point3 &point, Real radius) const;
+    std::vector<size_t> nearest(const Point3 &point, size_t count) const;
+    std::vector<Pair> pairs(Real cutoff) const;
+    Real distance(const Point3 &a, const Point3 &b) const;
+
+    // update
+    void setPosition(size_t index, const Point3 &position);
+    void update(const CartesianCoordinates *coordinates);
+    void rebuild(const CartesianCoordinates *coordinates);
+
+private:
+    CHEMKIT_DISABLE_COPY(SpatialIndex)
+
+private:
+    SpatialIndexPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_SPATIALINDEX_H
@@ -35,6 +35,8 @@
 
 #include "substructurequery.h"
 
+#include <algorithm>
+
 #include <boost/make_shared.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/mcgregor_common_subgraphs.hpp>
@@ -50,65 +52,263 @@ namespace chemkit {
 
 namespace {
 
+// Returns a score for how selective matching atom is. Atoms other
+// than carbon and hydrogen and atoms with more neighbors are less
+// likely to match so trying them first allows mismatches to be
+// rejected earlier.
+size_t atomSelectivity(const Atom *atom)
+{
+    size_t score = atom->neighborCount();
+
+    if(!atom->is(Atom::Carbon) && !atom->is(Atom::Hydrogen)){
+        score += 16;
+    }
+
+    return score;
+}
+
+struct SelectivityGreater
+{
+    bool operator()(const std::pair<size_t, Atom *> &a, const std::pair<size_t, Atom *> &b) const
+    {
+        return a.first > b.first;
+    }
+};
+
+// The MoleculeGraph class contains the graph representation of a
+// molecule used by the vf2 algorithm along with the atomic numbers
+// and bonds for each vertex.
+class MoleculeGraph
+{
+public:
+    struct Edge
+    {
+        size_t vertex;
+        const Bond *bond;
+        int order;
+        bool aromatic;
+    };
+
+    void clear();
+    void setAtoms(const Molecule *molecule, int flags);
+    void orderAtoms();
+    void addBonds(const Molecule *molecule, int flags);
+    const Edge* edge(size_t a, size_t b) const;
+
+    Graph<size_t> graph;
+    std::vector<Atom *> atoms;
+    std::vector<Atom::AtomicNumberType> atomicNumbers;
+    std::vector<std::vector<Edge> > edges;
+    std::vector<size_t> vertices;
+};
+
+// Removes all atoms from the graph while keeping the storage.
+void MoleculeGraph::clear()
+{
+    graph.resize(0);
+    atoms.clear();
+    atomicNumbers.clear();
+    edges.clear();
+}
+
+// Sets the atoms in the graph to the atoms in the molecule. Terminal
+// hydrogens are skipped unless CompareHydrogens is set.
+void MoleculeGraph::setAtoms(const Molecule *molecule, int flags)
+{
+    clear();
+
+    if(flags & SubstructureQuery::CompareHydrogens){
+        atoms.assign(molecule->atoms().begin(), molecule->atoms().end());
+    }
+    else{
+        foreach(Atom *atom, molecule->atoms()){
+            if(!atom->isTerminalHydrogen()){
+                atoms.push_back(atom);
+            }
+        }
+    }
+}
+
+// Reorders the atoms so that the vf2 algorithm visits them in a
+// breadth-first order starting from the most selective atom.
+void MoleculeGraph::orderAtoms()
+{
+    if(atoms.empty()){
+        return;
+    }
+
+    std::vector<std::pair<size_t, Atom *> > scores;
+    foreach(Atom *atom, atoms){
+        scores.push_back(std::make_pair(atomSelectivity(atom), atom));
+    }
+
+    // sort by descending score keeping the original order for ties
+    std::stable_sort(scores.begin(), scores.end(), SelectivityGreater());
+
+    std::vector<bool> included(atoms.front()->molecule()->size(), false);
+    foreach(const Atom *atom, atoms){
+        included[atom->index()] = true;
+    }
+
+    std::vector<bool> visited(included.size(), false);
+    std::vector<Atom *> ordered;
+    ordered.reserve(atoms.size());
+
+    for(size_t i = 0; i < scores.size(); i++){
+        Atom *root = scores[i].second;
+        if(visited[root->index()]){
+            continue;
+        }
+
+        visited[root->index()] = true;
+        ordered.push_back(root);
+
+        // breadth-first search from the root visiting the neighbors
+        // of each atom in order of their score
+        for(size_t j = ordered.size() - 1; j < ordered.size(); j++){
+            std::vector<std::pair<size_t, Atom *> > neighbors;
+
+            foreach(Atom *neighbor, ordered[j]->neighbors()){
+                if(included[neighbor->index()] && !visited[neighbor->index()]){
+                    neighbors.push_back(std::make_pair(atomSelectivity(neighbor), neighbor));
+                }
+            }
+
+            std::stable_sort(neighbors.begin(), neighbors.end(), SelectivityGreater());
+
+            for(size_t k = 0; k < neighbors.size(); k++){
+                visited[neighbors[k].second->index()] = true;
+                ordered.push_back(neighbors[k].second);
+            }
+        }
+    }
+
+    atoms.swap(ordered);
+}
+
+// Builds the graph for the atoms from the bonds in the molecule. This
+// requires only a single pass over the bonds.
+void MoleculeGraph::addBonds(const Molecule *molecule, int flags)
+{
+    graph.resize(atoms.size());
+
+    atomicNumbers.resize(atoms.size());
+    for(size_t i = 0; i < atoms.size(); i++){
+        atomicNumbers[i] = atoms[i]->atomicNumber();
+    }
+
+    edges.resize(atoms.size());
+
+    if(flags & SubstructureQuery::CompareAtomsOnly){
+        return;
+    }
+
+    // map from atom index to vertex index
+    vertices.assign(molecule->size(), size_t(-1));
+    for(size_t i = 0; i < atoms.size(); i++){
+        vertices[atoms[i]->index()] = i;
+    }
+
+    foreach(const Bond *bond, molecule->bonds()){
+        size_t a = vertices[bond->atom1()->index()];
+        size_t b = vertices[bond->atom2()->index()];
+
+        if(a == size_t(-1) || b == size_t(-1)){
+            continue;
+        }
+
+        graph.addEdge(a, b);
+
+        Edge edge;
+        edge.bond = bond;
+        edge.order = bond->order();
+        edge.aromatic = false;
+
+        edge.vertex = b;
+        edges[a].push_back(edge);
+        edge.vertex = a;
+        edges[b].push_back(edge);
+    }
+}
+
+// Returns the edge between vertices a and b or 0 if they are not
+// bonded.
+const MoleculeGraph::Edge* MoleculeGraph::edge(size_t a, size_t b) const
+{
+    const std::vector<Edge> &vertexEdges = edges[a];
+
+    for(size_t i = 0; i < vertexEdges.size(); i++){
+        if(vertexEdges[i].vertex == b){
+            return &vertexEdges[i];
+        }
+    }
+
+    return 0;
+}
+
 struct AtomComparator
 {
-    AtomComparator(const std::vector<Atom *> &sourceAtoms, const std::vector<Atom *> &targetAtoms)
-        : m_sourceAtoms(sourceAtoms),
-          m_targetAtoms(targetAtoms)
+    AtomComparator(const MoleculeGraph &source, const MoleculeGraph &target)
+        : m_source(source),
+          m_target(target)
     {
     }
 
     AtomComparator(const AtomComparator &other)
-        : m_sourceAtoms(other.m_sourceAtoms),
-          m_targetAtoms(other.m_targetAtoms)
+        : m_source(other.m_source),
+          m_target(other.m_target)
     {
     }
 
     bool operator()(size_t a, size_t b) const
     {
-        return m_sourceAtoms[a]->atomicNumber() == m_targetAtoms[b]->atomicNumber();
+        return m_source.atomicNumbers[a] == m_target.atomicNumbers[b];
     }
 
-    const std::vector<Atom *> &m_sourceAtoms;
-    const std::vector<Atom *> &m_targetAtoms;
+    const MoleculeGraph &m_source;
+    const MoleculeGraph &m_target;
 };
 
 struct BondComparator
 {
-    BondComparator(const std::vector<Atom *> &sourceAtoms, const std::vector<Atom *> &targetAtoms, int flags)
-        : m_sourceAtoms(sourceAtoms),
-          m_targetAtoms(targetAtoms),
+    BondComparator(const MoleculeGraph &source, const MoleculeGraph &target, int flags)
+        : m_source(source),
+          m_target(target),
           m_flags(flags)
     {
     }
 
     BondComparator(const BondComparator &other)
-        : m_sourceAtoms(other.m_sourceAtoms),
-          m_targetAtoms(other.m_targetAtoms),
+        : m_source(other.m_source),
+          m_target(other.m_target),
           m_flags(other.m_flags)
     {
     }
 
     bool operator()(size_t a1, size_t a2, size_t b1, size_t b2) const
     {
-        const Bond *bondA = m_sourceAtoms[a1]->bondTo(m_sourceAtoms[a2]);
-        const Bond *bondB = m_targetAtoms[b1]->bondTo(m_targetAtoms[b2]);
+        const MoleculeGraph::Edge *edgeA = m_source.edge(a1, a2);
+        const MoleculeGraph::Edge *edgeB = m_target.edge(b1, b2);
 
-        if(!bondA || !bondB){
+        if(!edgeA || !edgeB){
             return false;
         }
 
-        if(m_flags & SubstructureQuery::CompareAromaticity){
-            return (bondA->order() == bondB->order()) ||
-                   (bondA->isAromatic() && bondB->isAromatic());
+        if(edgeA->order == edgeB->order){
+            return true;
+        }
+        else if(m_flags & SubstructureQuery::CompareAromaticity){
+            // aromaticity for the query bonds is perceived when the
+            // query is compiled, target bonds are checked on demand
+            return edgeA->aromatic && edgeB->bond->isAromatic();
         }
         else{
-            return bondA->order() == bondB->order();
+            return false;
         }
     }
 
-    const std::vector<Atom *> &m_sourceAtoms;
-    const std::vector<Atom *> &m_targetAtoms;
+    const MoleculeGraph &m_source;
+    const MoleculeGraph &m_target;
     int m_flags;
 };
 
@@ -243,14 +443,97 @@ struct McgregorCommonSubgraphsCallback
 
 } // end anonymous namespace
 
+// === SubstructureQueryContextPrivate ===================================== //
+class SubstructureQueryContextPrivate
+{
+public:
+    MoleculeGraph target;
+    algorithm::Vf2Context<size_t> vf2;
+};
+
 // === SubstructureQueryPrivate ============================================ //
 class SubstructureQueryPrivate
 {
 public:
+    void compile();
+    bool match(const Molecule *molecule, SubstructureQueryContextPrivate *context) const;
+
     boost::shared_ptr<Molecule> molecule;
     int flags;
+    MoleculeGraph graph;
 };
 
+// Builds the query graph for the molecule. This is done once when the
+// molecule or flags are set rather than for each query.
+void SubstructureQueryPrivate::compile()
+{
+    graph.clear();
+
+    if(!molecule){
+        return;
+    }
+
+    graph.setAtoms(molecule.get(), flags);
+    graph.orderAtoms();
+    graph.addBonds(molecule.get(), flags);
+
+    if(flags & SubstructureQuery::CompareAromaticity){
+        for(size_t i = 0; i < graph.edges.size(); i++){
+            for(size_t j = 0; j < graph.edges[i].size(); j++){
+                graph.edges[i][j].aromatic = graph.edges[i][j].bond->isAromatic();
+            }
+        }
+    }
+}
+
+// Runs the vf2 algorithm to find a mapping from the query molecule to
+// molecule. The mapping is stored in the context.
+bool SubstructureQueryPrivate::match(const Molecule *molecule, SubstructureQueryContextPrivate *context) const
+{
+    MoleculeGraph &target = context->target;
+    target.setAtoms(molecule, flags);
+    target.addBonds(molecule, flags);
+
+    AtomComparator atomComparator(graph, target);
+    BondComparator bondComparator(graph, target, flags);
+
+    bool found = chemkit::algorithm::vf2(graph.graph,
+                                         target.graph,
+                                         atomComparator,
+                                         bondComparator,
+                                         context->vf2);
+
+    // check for exact match
+    if(flags & SubstructureQuery::CompareExact && context->vf2.mapping().size() != graph.graph.size()){
+        return false;
+    }
+
+    return found;
+}
+
+// === SubstructureQuery::Context ========================================== //
+/// \class SubstructureQuery::Context substructurequery.h chemkit/substructurequery.h
+/// \ingroup chemkit
+/// \brief The SubstructureQuery::Context class contains the working
+///        storage used while matching a substructure query.
+///
+/// A context can be passed to SubstructureQuery::matches() and
+/// SubstructureQuery::mapping() to reuse its storage between queries.
+/// Contexts are not thread-safe and each thread running queries
+/// should create its own.
+
+/// Creates a new, empty match context.
+SubstructureQuery::Context::Context()
+    : d(new SubstructureQueryContextPrivate)
+{
+}
+
+/// Destroys the match context.
+SubstructureQuery::Context::~Context()
+{
+    delete d;
+}
+
 // === SubstructureQuery =================================================== //
 /// \class SubstructureQuery substructurequery.h chemkit/substructurequery.h
 /// \ingroup chemkit
@@ -271,6 +554,7 @@ SubstructureQuery::SubstructureQuery(const boost::shared_ptr<Molecule> &molecule
 {
     d->molecule = molecule;
     d->flags = 0;
+    d->compile();
 }
 
 /// Creates a new substructure query with \p formula in \p format as
@@ -280,6 +564,7 @@ SubstructureQuery::SubstructureQuery(const std::string &formula, const std::stri
 {
     d->molecule = boost::make_shared<Molecule>(formula, format);
     d->flags = 0;
+    d->compile();
 }
 
 /// Destroys the substructure query object.
@@ -290,9 +575,13 @@ SubstructureQuery::~SubstructureQuery()
 
 // --- Properties ---------------------------------------------------------- //
 /// Sets the substructure molecule to \p molecule.
+///
+/// The query is compiled from the molecule when it is set. If the
+/// molecule is modified afterwards this method must be called again.
 void SubstructureQuery::setMolecule(const boost::shared_ptr<Molecule> &molecule)
 {
     d->molecule = molecule;
+    d->compile();
 }
 
 /// Sets the substructure molecule to \p formula with \p format.
@@ -311,6 +600,7 @@ boost::shared_ptr<Molecule> SubstructureQuery::molecule() const
 void SubstructureQuery::setFlags(int flags)
 {
     d->flags = flags;
+    d->compile();
 }
 
 /// Returns the query flags.
@@ -337,6 +627,20 @@ int SubstructureQuery::flags() const
 /// }
 /// \endcode
 bool SubstructureQuery::matches(const Molecule *molecule) const
+{
+    Context context;
+
+    return matches(molecule, context);
+}
+
+/// Returns \c true if the substructure molecule matches \p molecule.
+///
+/// The working storage for the match is kept in \p context and
+/// reused by later queries passed the same context. This avoids
+/// reallocating it when running many queries in a row. A context
+/// must not be used by more than one thread at a time, so each
+/// thread running queries should have its own.
+bool SubstructureQuery::matches(const Molecule *molecule, Context &context) const
 {
     if(!d->molecule){
         return false;
@@ -346,92 +650,38 @@ bool SubstructureQuery::matches(const Molecule *molecule) const
         return true;
     }
 
-    return !mapping(molecule).empty();
+    return d->match(molecule, context.d) && !d->graph.atoms.empty();
 }
 
 /// Returns a mapping (also known as an isomorphism) between the
 /// atoms in the substructure molecule and the atoms in \p molecule.
 std::map<Atom *, Atom *> SubstructureQuery::mapping(const Molecule *molecule) const
 {
-    Graph<size_t> source;
-    Graph<size_t> target;
-
-    std::vector<Atom *> sourceAtoms;
-    std::vector<Atom *> targetAtoms;
-
-    if(d->flags & CompareHydrogens){
-        source.resize(d->molecule->size());
-        sourceAtoms = std::vector<Atom *>(d->molecule->atoms().begin(), d->molecule->atoms().end());
+    Context context;
 
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, d->molecule->bonds()){
-                source.addEdge(bond->atom1()->index(), bond->atom2()->index());
-            }
-        }
-
-        target.resize(molecule->size());
-        targetAtoms = std::vector<Atom *>(molecule->atoms().begin(), molecule->atoms().end());
-
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, molecule->bonds()){
-                target.addEdge(bond->atom1()->index(), bond->atom2()->index());
-            }
-        }
-    }
-    else{
-        foreach(Atom *atom, d->molecule->atoms()){
-            if(!atom->isTerminalHydrogen()){
-                sourceAtoms.push_back(atom);
-            }
-        }
-
-        foreach(Atom *atom, molecule->atoms()){
-            if(!atom->isTerminalHydrogen()){
-                targetAtoms.push_back(atom);
-            }
-        }
-
-        source.resize(sourceAtoms.size());
-        target.resize(targetAtoms.size());
+    return mapping(molecule, context);
+}
 
-        if(!(d->flags & CompareAtomsOnly)){
-            for(size_t i = 0; i < sourceAtoms.size(); i++){
-                for(size_t j = i + 1; j < sourceAtoms.size(); j++){
-                    if(sourceAtoms[i]->isBondedTo(sourceAtoms[j])){
-                        source.addEdge(i, j);
-                    }
-                }
-            }
+/// Returns a mapping (also known as an isomorphism) between the
+/// atoms in the substructure molecule and the atoms in \p molecule
+/// using the working storage in \p context.
+std::map<Atom *, Atom *> SubstructureQuery::mapping(const Molecule *molecule, Context &context) const
+{
+    std::map<Atom *, Atom *> atomMapping;
 
-            for(size_t i = 0; i < targetAtoms.size(); i++){
-                for(size_t j = i + 1; j < targetAtoms.size(); j++){
-                    if(targetAtoms[i]->isBondedTo(targetAtoms[j])){
-                        target.addEdge(i, j);
-                    }
-                }
-            }
-        }
+    if(!d->molecule){
+        return atomMapping;
     }
 
-    AtomComparator atomComparator(sourceAtoms, targetAtoms);
-    BondComparator bondComparator(sourceAtoms, targetAtoms, d->flags);
-
-    // run vf2 isomorphism algorithm
-    std::map<size_t, size_t> mapping = chemkit::algorithm::vf2(source,
-                                                               target,
-                                                               atomComparator,
-                                                               bondComparator);
-
-    // check for exact match
-    if(d->flags & CompareExact && mapping.size() != source.size()){
-        return std::map<Atom *, Atom *>();
+    if(!d->match(molecule, context.d)){
+        return atomMapping;
     }
 
     // convert index mapping to an atom mapping
-    std::map<Atom *, Atom *> atomMapping;
+    const std::vector<size_t> &mapping = context.d->vf2.mapping();
 
-    for(std::map<size_t, size_t>::iterator i = mapping.begin(); i != mapping.end(); ++i){
-        atomMapping[sourceAtoms[i->first]] = targetAtoms[i->second];
+    for(size_t i = 0; i < mapping.size(); i++){
+        atomMapping[d->graph.atoms[i]] = context.d->target.atoms[mapping[i]];
     }
 
     return atomMapping;
@@ -540,9 +790,10 @@ std::map<Atom *, Atom *> SubstructureQuery::maximumMapping(const Molecule *molec
 std::vector<Molecule *> SubstructureQuery::filter(const std::vector<Molecule *> &molecules) const
 {
     std::vector<Molecule *> matchingMolecules;
+    Context context;
 
     foreach(Molecule *molecule, molecules){
-        if(matches(molecule)){
+        if(matches(molecule, context)){
             matchingMolecules.push_back(molecule);
         }
     }
@@ -50,16 +50,32 @@ namespace chemkit {
 class Atom;
 class Molecule;
 class SubstructureQueryPrivate;
+class SubstructureQueryContextPrivate;
 
 class CHEMKIT_EXPORT SubstructureQuery
 {
 public:
     // enumerations
     enum Flag {
-        CompareAtomsOnly = 0x00,
         CompareHydrogens = 0x01,
         CompareAromaticity = 0x02,
-        CompareExact = 0x04
+        CompareExact = 0x04,
+        CompareAtomsOnly = 0x08
+    };
+
+    // match context
+    class CHEMKIT_EXPORT Context
+    {
+    public:
+        Context();
+        ~Context();
+
+    private:
+        SubstructureQueryContextPrivate* const d;
+
+        friend class SubstructureQuery;
+
+        CHEMKIT_DISABLE_COPY(Context)
     };
 
     // construction and destruction
@@ -77,7 +93,9 @@ public:
 
     // queries
     bool matches(const Molecule *molecule) const;
+    bool matches(const Molecule *molecule, Context &context) const;
     std::map<Atom *, Atom *> mapping(const Molecule *molecule) const;
+    std::map<Atom *, Atom *> mapping(const Molecule *molecule, Context &context) const;
     std::map<Atom *, Atom *> maximumMapping(const Molecule *molecule) const;
     std::vector<Molecule *> filter(const std::vector<Molecule *> &molecules) const;
     Moiety find(const Molecule *molecule) const;
@@ -0,0 +1,451 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "substructurescreen.h"
+
+#include <map>
+#include <deque>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "molecule.h"
+#include "substructurequery.h"
+
+namespace chemkit {
+
+namespace {
+
+// Shared state for a single parallel screening run. Molecules flow
+// from the reader thread through the input queue to the worker
+// threads and then through the output queue to the calling thread.
+class ScreenPipeline
+{
+public:
+    typedef std::pair<size_t, boost::shared_ptr<Molecule> > Item;
+
+    ScreenPipeline(const SubstructureQuery &query,
+                   const SubstructureScreen::SourceFunction &source,
+                   size_t queueSize,
+                   bool ordered,
+                   bool inverted);
+
+    void read();
+    void screen();
+    size_t write(const SubstructureScreen::MatchFunction &match);
+
+private:
+    bool nextOutput(Item &item);
+
+private:
+    const SubstructureQuery &m_query;
+    const SubstructureScreen::SourceFunction &m_source;
+    size_t m_queueSize;
+    bool m_ordered;
+    bool m_inverted;
+
+    boost::mutex m_mutex;
+    boost::condition_variable m_inputCondition;
+    boost::condition_variable m_outputCondition;
+    boost::condition_variable m_spaceCondition;
+    std::deque<Item> m_input;
+    std::map<size_t, Item> m_output;
+    size_t m_readCount;
+    size_t m_writeCount;
+    bool m_readDone;
+};
+
+ScreenPipeline::ScreenPipeline(const SubstructureQuery &query,
+                               const SubstructureScreen::SourceFunction &source,
+                               size_t queueSize,
+                               bool ordered,
+                               bool inverted)
+    : m_query(query),
+      m_source(source),
+      m_queueSize(queueSize),
+      m_ordered(ordered),
+      m_inverted(inverted),
+      m_readCount(0),
+      m_writeCount(0),
+      m_readDone(false)
+{
+}
+
+// Reads molecules from the source and places them in the input
+// queue. At most queueSize molecules are in flight at once so that
+// memory use stays bounded regardless of the size of the input.
+void ScreenPipeline::read()
+{
+    for(;;){
+        {
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            while(m_readCount - m_writeCount >= m_queueSize){
+                m_spaceCondition.wait(lock);
+            }
+        }
+
+        boost::shared_ptr<Molecule> molecule = m_source();
+
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        if(!molecule){
+            m_readDone = true;
+            m_inputCondition.notify_all();
+            m_outputCondition.notify_one();
+            return;
+        }
+
+        m_input.push_back(Item(m_readCount++, molecule));
+        m_inputCondition.notify_one();
+    }
+}
+
+// Takes molecules from the input queue and runs the query against
+// them. Non-matching molecules are passed on with a null pointer so
+// that the writer can keep track of the input order.
+void ScreenPipeline::screen()
+{
+    SubstructureQuery::Context context;
+
+    for(;;){
+        Item item;
+
+        {
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            while(m_input.empty() && !m_readDone){
+                m_inputCondition.wait(lock);
+            }
+
+            if(m_input.empty()){
+                return;
+            }
+
+            item = m_input.front();
+            m_input.pop_front();
+        }
+
+        bool match = m_query.matches(item.second.get(), context);
+        if(match == m_inverted){
+            item.second.reset();
+        }
+
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        m_output[item.first] = item;
+        m_outputCondition.notify_one();
+    }
+}
+
+// Returns the next screened molecule ready for output. In ordered mode
+// this is the molecule following the last one written, otherwise it is
+// whichever finished first. Must be called with the mutex locked.
+bool ScreenPipeline::nextOutput(Item &item)
+{
+    if(m_output.empty()){
+        return false;
+    }
+
+    std::map<size_t, Item>::iterator iter = m_ordered ? m_output.find(m_writeCount) : m_output.begin();
+    if(iter == m_output.end()){
+        return false;
+    }
+
+    item = iter->second;
+    m_output.erase(iter);
+    return true;
+}
+
+// Passes matching molecules to the match function from the calling
+// thread until every molecule read from the source has been handled.
+size_t ScreenPipeline::write(const SubstructureScreen::MatchFunction &match)
+{
+    size_t matchCount = 0;
+
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+
+    for(;;){
+        Item item;
+
+        while(!nextOutput(item)){
+            if(m_readDone && m_writeCount == m_readCount){
+                return matchCount;
+            }
+
+            m_outputCondition.wait(lock);
+        }
+
+        if(item.second){
+            lock.unlock();
+            match(item.second);
+            matchCount++;
+            lock.lock();
+        }
+
+        m_writeCount++;
+        m_spaceCondition.notify_one();
+    }
+}
+
+void appendMolecule(std::vector<boost::shared_ptr<Molecule> > &molecules,
+                    const boost::shared_ptr<Molecule> &molecule)
+{
+    molecules.push_back(molecule);
+}
+
+// Returns each molecule in a vector one at a time and then null.
+class VectorSource
+{
+public:
+    VectorSource(const std::vector<boost::shared_ptr<Molecule> > &molecules)
+        : m_molecules(molecules),
+          m_index(0)
+    {
+    }
+
+    boost::shared_ptr<Molecule> operator()()
+    {
+        if(m_index < m_molecules.size()){
+            return m_molecules[m_index++];
+        }
+
+        return boost::shared_ptr<Molecule>();
+    }
+
+private:
+    const std::vector<boost::shared_ptr<Molecule> > &m_molecules;
+    size_t m_index;
+};
+
+} // end anonymous namespace
+
+// === SubstructureScreenPrivate =========================================== //
+class SubstructureScreenPrivate
+{
+public:
+    SubstructureQuery query;
+    size_t threadCount;
+    size_t queueSize;
+    bool ordered;
+    bool inverted;
+};
+
+// === SubstructureScreen ================================================== //
+/// \class SubstructureScreen substructurescreen.h chemkit/substructurescreen.h
+/// \ingroup chemkit
+/// \brief The SubstructureScreen class screens a stream of molecules
+///        against a substructure query in parallel.
+///
+/// Molecules are read from a source function by a reader thread,
+/// matched against the query by a pool of worker threads and then
+/// passed to the match function from the calling thread.
+///
+/// For example, to print the names of all the molecules in a file
+/// which contain a benzene ring:
+/// \code
+/// void printMatch(const boost::shared_ptr<Molecule> &molecule)
+/// {
+///     std::cout << molecule->name() << std::endl;
+/// }
+///
+/// MoleculeFileReader reader("molecules.sdf");
+/// reader.open();
+///
+/// SubstructureScreen screen(SubstructureQuery("c1ccccc1", "smiles"));
+/// screen.run(boost::bind(&MoleculeFileReader::readNext, &reader), printMatch);
+/// \endcode
+///
+/// \see SubstructureQuery
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new substructure screen.
+SubstructureScreen::SubstructureScreen()
+    : d(new SubstructureScreenPrivate)
+{
+    d->threadCount = 0;
+    d->queueSize = 256;
+    d->ordered = true;
+    d->inverted = false;
+}
+
+/// Creates a new substructure screen for \p query.
+SubstructureScreen::SubstructureScreen(const SubstructureQuery &query)
+    : d(new SubstructureScreenPrivate)
+{
+    d->threadCount = 0;
+    d->queueSize = 256;
+    d->ordered = true;
+    d->inverted = false;
+
+    setQuery(query);
+}
+
+/// Destroys the substructure screen object.
+SubstructureScreen::~SubstructureScreen()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Sets the query to screen molecules against to \p query. The
+/// query's molecule and flags are copied into the screen.
+void SubstructureScreen::setQuery(const SubstructureQuery &query)
+{
+    d->query.setMolecule(query.molecule());
+    d->query.setFlags(query.flags());
+}
+
+/// Returns the query used to screen molecules.
+const SubstructureQuery& SubstructureScreen::query() const
+{
+    return d->query;
+}
+
+/// Sets the number of worker threads to \p count. If \p count is
+/// \c 0 (the default) one thread per available processor is used.
+void SubstructureScreen::setThreadCount(size_t count)
+{
+    d->threadCount = count;
+}
+
+/// Returns the number of worker threads used to screen molecules.
+size_t SubstructureScreen::threadCount() const
+{
+    if(d->threadCount == 0){
+        return std::max(size_t(1), size_t(boost::thread::hardware_concurrency()));
+    }
+
+    return d->threadCount;
+}
+
+/// Sets the maximum number of molecules which may be in flight at
+/// once to \p size. The default is \c 256.
+void SubstructureScreen::setQueueSize(size_t size)
+{
+    d->queueSize = std::max(size_t(1), size);
+}
+
+/// Returns the maximum number of molecules which may be in flight
+/// at once.
+size_t SubstructureScreen::queueSize() const
+{
+    return d->queueSize;
+}
+
+/// Sets whether matching molecules are reported in the same order
+/// they were read from the source. If \c false, molecules are
+/// reported as soon as they have been screened. The default is
+/// \c true.
+void SubstructureScreen::setOrdered(bool ordered)
+{
+    d->ordered = ordered;
+}
+
+/// Returns \c true if matching molecules are reported in input order.
+bool SubstructureScreen::isOrdered() const
+{
+    return d->ordered;
+}
+
+/// Sets whether the screen reports the molecules which do not match
+/// the query instead of those which do.
+void SubstructureScreen::setInverted(bool inverted)
+{
+    d->inverted = inverted;
+}
+
+/// Returns \c true if the screen reports non-matching molecules.
+bool SubstructureScreen::isInverted() const
+{
+    return d->inverted;
+}
+
+// --- Screening ----------------------------------------------------------- //
+/// Screens each molecule returned by \p source against the query
+/// and calls \p match for each one that matches. The source is
+/// called from a separate reader thread until it returns a null
+/// pointer. The match function is always called from the calling
+/// thread. Returns the number of matching molecules.
+size_t SubstructureScreen::run(const SourceFunction &source, const MatchFunction &match)
+{
+    size_t threadCount = this->threadCount();
+
+    if(threadCount == 1){
+        size_t matchCount = 0;
+        SubstructureQuery::Context context;
+
+        for(;;){
+            boost::shared_ptr<Molecule> molecule = source();
+            if(!molecule){
+                break;
+            }
+
+            if(d->query.matches(molecule.get(), context) != d->inverted){
+                match(molecule);
+                matchCount++;
+            }
+        }
+
+        return matchCount;
+    }
+
+    ScreenPipeline pipeline(d->query, source, d->queueSize, d->ordered, d->inverted);
+
+    boost::thread reader(boost::bind(&ScreenPipeline::read, &pipeline));
+
+    boost::thread_group workers;
+    for(size_t i = 0; i < threadCount; i++){
+        workers.create_thread(boost::bind(&ScreenPipeline::screen, &pipeline));
+    }
+
+    size_t matchCount = pipeline.write(match);
+
+    reader.join();
+    workers.join_all();
+
+    return matchCount;
+}
+
+/// Screens each molecule in \p molecules against the query and
+/// returns the matching molecules.
+std::vector<boost::shared_ptr<Molecule> > SubstructureScreen::run(const std::vector<boost::shared_ptr<Molecule> > &molecules)
+{
+    std::vector<boost::shared_ptr<Molecule> > matches;
+
+    VectorSource source(molecules);
+    run(boost::ref(source), boost::bind(appendMolecule, boost::ref(matches), _1));
+
+    return matches;
+}
+
+} // end chemkit namespace
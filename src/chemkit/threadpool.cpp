@@ -0,0 +1,493 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "threadpool.h"
+
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include "foreach.h"
+
+namespace chemkit {
+
+namespace {
+
+// Runs task unless token has been canceled.
+void runUnlessCanceled(const ThreadPool::Task &task, const CancellationToken *token)
+{
+    if(!token->isCanceled()){
+        task();
+    }
+}
+
+// Shared state for a single parallelFor() call.
+struct ParallelForState
+{
+    boost::mutex mutex;
+    boost::condition_variable finished;
+    ThreadPool::IndexFunction function;
+    const CancellationToken *token;
+    size_t next;
+    size_t end;
+    size_t chunkSize;
+    size_t running;
+    bool canceled;
+    boost::exception_ptr exception;
+};
+
+// Processes chunks from state until the range is exhausted. Returns
+// without doing anything if all chunks have already been taken.
+void runChunks(const boost::shared_ptr<ParallelForState> &state)
+{
+    boost::unique_lock<boost::mutex> lock(state->mutex);
+    if(state->next >= state->end){
+        return;
+    }
+
+    state->running++;
+
+    for(;;){
+        if(state->token && state->token->isCanceled()){
+            state->canceled = true;
+            state->next = state->end;
+        }
+
+        if(state->next >= state->end){
+            break;
+        }
+
+        size_t first = state->next;
+        size_t last = std::min(first + state->chunkSize, state->end);
+        state->next = last;
+
+        lock.unlock();
+
+        try {
+            for(size_t i = first; i < last; i++){
+                state->function(i);
+            }
+
+            lock.lock();
+        }
+        catch(...){
+            lock.lock();
+
+            if(!state->exception){
+                state->exception = boost::current_exception();
+            }
+
+            // stop handing out chunks
+            state->next = state->end;
+        }
+    }
+
+    state->running--;
+    if(state->running == 0){
+        state->finished.notify_all();
+    }
+}
+
+} // end anonymous namespace
+
+// === CancellationToken =================================================== //
+/// \class CancellationToken threadpool.h chemkit/threadpool.h
+/// \ingroup chemkit
+/// \brief The CancellationToken class is used to cancel tasks
+///        running in a thread pool.
+///
+/// Tasks and parallel loops check the token before doing any more
+/// work. Work that has already started is not interrupted.
+///
+/// \see ThreadPool
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, uncanceled token.
+CancellationToken::CancellationToken()
+    : m_canceled(false)
+{
+}
+
+// --- Cancellation -------------------------------------------------------- //
+/// Requests cancellation of all work associated with the token.
+void CancellationToken::cancel()
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_canceled = true;
+}
+
+/// Returns \c true if cancel() has been called.
+bool CancellationToken::isCanceled() const
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    return m_canceled;
+}
+
+/// Resets the token so that it can be reused.
+void CancellationToken::reset()
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_canceled = false;
+}
+
+// === ThreadPoolPrivate =================================================== //
+class ThreadPoolPrivate
+{
+public:
+    struct Worker
+    {
+        boost::mutex mutex;
+        std::deque<ThreadPool::Task> tasks;
+    };
+
+    void run(size_t index);
+    bool takeTask(size_t index, ThreadPool::Task &task);
+    void finishTask();
+
+    std::vector<Worker *> workers;
+    std::vector<boost::thread *> threads;
+    boost::thread_specific_ptr<size_t> workerIndex;
+    boost::mutex mutex;
+    boost::condition_variable taskAvailable;
+    boost::condition_variable done;
+    size_t queued;
+    size_t pending;
+    size_t nextWorker;
+    bool stopping;
+};
+
+// Main loop for the worker thread at index.
+void ThreadPoolPrivate::run(size_t index)
+{
+    workerIndex.reset(new size_t(index));
+
+    for(;;){
+        ThreadPool::Task task;
+
+        if(takeTask(index, task)){
+            try {
+                task();
+            }
+            catch(...){
+                // exceptions are not propagated from submitted tasks
+            }
+
+            finishTask();
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        while(queued == 0 && !stopping){
+            taskAvailable.wait(lock);
+        }
+
+        if(queued == 0 && stopping){
+            break;
+        }
+    }
+}
+
+// Takes the next task for the worker at index. Workers take from the
+// back of their own queue and steal from the front of the others. An
+// index past the last worker steals only.
+bool ThreadPoolPrivate::takeTask(size_t index, ThreadPool::Task &task)
+{
+    bool found = false;
+
+    if(index < workers.size()){
+        Worker *worker = workers[index];
+        boost::lock_guard<boost::mutex> lock(worker->mutex);
+        if(!worker->tasks.empty()){
+            task.swap(worker->tasks.back());
+            worker->tasks.pop_back();
+            found = true;
+        }
+    }
+
+    for(size_t i = 1; !found && i <= workers.size(); i++){
+        Worker *victim = workers[(index + i) % workers.size()];
+        boost::lock_guard<boost::mutex> lock(victim->mutex);
+        if(!victim->tasks.empty()){
+            task.swap(victim->tasks.front());
+            victim->tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if(found){
+        boost::lock_guard<boost::mutex> lock(mutex);
+        queued--;
+    }
+
+    return found;
+}
+
+// Marks a task taken with takeTask() as finished.
+void ThreadPoolPrivate::finishTask()
+{
+    boost::lock_guard<boost::mutex> lock(mutex);
+    pending--;
+    if(pending == 0){
+        done.notify_all();
+    }
+}
+
+// === ThreadPool ========================================================== //
+/// \class ThreadPool threadpool.h chemkit/threadpool.h
+/// \ingroup chemkit
+/// \brief The ThreadPool class manages a set of worker threads.
+///
+/// Each worker owns a task queue. Tasks submitted from inside a worker
+/// are added to that worker's queue and idle workers steal tasks from
+/// the queues of busy ones. This keeps recursively spawned work local
+/// while still balancing the load across all threads.
+///
+/// Most code should use the shared pool returned by globalInstance()
+/// instead of creating its own threads. The functions in the
+/// concurrent namespace (e.g. concurrent::run()) all use it.
+///
+/// \see CancellationToken
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new thread pool with \p threadCount worker threads. If
+/// \p threadCount is \c 0 one thread per hardware thread is created.
+ThreadPool::ThreadPool(size_t threadCount)
+    : d(new ThreadPoolPrivate)
+{
+    if(threadCount == 0){
+        threadCount = std::max(1u, boost::thread::hardware_concurrency());
+    }
+
+    d->queued = 0;
+    d->pending = 0;
+    d->nextWorker = 0;
+    d->stopping = false;
+
+    for(size_t i = 0; i < threadCount; i++){
+        d->workers.push_back(new ThreadPoolPrivate::Worker);
+    }
+
+    for(size_t i = 0; i < threadCount; i++){
+        d->threads.push_back(new boost::thread(boost::bind(&ThreadPoolPrivate::run, d, i)));
+    }
+}
+
+/// Destroys the thread pool. Waits for all submitted tasks to finish
+/// before the worker threads are stopped.
+ThreadPool::~ThreadPool()
+{
+    waitForDone();
+
+    {
+        boost::lock_guard<boost::mutex> lock(d->mutex);
+        d->stopping = true;
+    }
+    d->taskAvailable.notify_all();
+
+    foreach(boost::thread *thread, d->threads){
+        thread->join();
+        delete thread;
+    }
+
+    foreach(ThreadPoolPrivate::Worker *worker, d->workers){
+        delete worker;
+    }
+
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of worker threads in the pool.
+size_t ThreadPool::threadCount() const
+{
+    return d->threads.size();
+}
+
+/// Returns \c true if the calling thread is one of the pool's worker
+/// threads.
+bool ThreadPool::isWorkerThread() const
+{
+    return d->workerIndex.get() != 0;
+}
+
+// --- Tasks --------------------------------------------------------------- //
+/// Submits \p task for execution in the pool. If \p token is not
+/// \c 0 the task is skipped if the token has been canceled before it
+/// starts.
+///
+/// Exceptions thrown by \p task are discarded. Use concurrent::run()
+/// to retrieve the result or exception of a task.
+void ThreadPool::submit(const Task &task, const CancellationToken *token)
+{
+    size_t index;
+
+    {
+        boost::lock_guard<boost::mutex> lock(d->mutex);
+        d->queued++;
+        d->pending++;
+
+        if(d->workerIndex.get()){
+            index = *d->workerIndex;
+        }
+        else{
+            index = d->nextWorker++ % d->workers.size();
+        }
+    }
+
+    {
+        ThreadPoolPrivate::Worker *worker = d->workers[index];
+        boost::lock_guard<boost::mutex> lock(worker->mutex);
+
+        if(token){
+            worker->tasks.push_back(boost::bind(&runUnlessCanceled, task, token));
+        }
+        else{
+            worker->tasks.push_back(task);
+        }
+    }
+
+    d->taskAvailable.notify_one();
+}
+
+/// Waits until all submitted tasks have finished. While waiting the
+/// calling thread helps to execute queued tasks.
+///
+/// This must not be called from one of the pool's worker threads.
+void ThreadPool::waitForDone()
+{
+    for(;;){
+        Task task;
+
+        if(d->takeTask(d->workers.size(), task)){
+            try {
+                task();
+            }
+            catch(...){
+            }
+
+            d->finishTask();
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> lock(d->mutex);
+        if(d->pending == 0){
+            break;
+        }
+        else if(d->queued == 0){
+            d->done.wait(lock);
+        }
+    }
+}
+
+/// Calls \p function for each index in the range [\p begin, \p end).
+/// The range is divided into chunks which are processed by the
+/// calling thread and by the pool's workers. Returns once all indices
+/// have been processed.
+///
+/// If \p token is canceled no further chunks are started and \c false
+/// is returned. If \p function throws, the remaining chunks are
+/// skipped and the exception is rethrown in the calling thread.
+///
+/// Calls to parallelFor() may be nested. Because the calling thread
+/// takes part in the loop it never waits for work that has not yet
+/// started.
+bool ThreadPool::parallelFor(size_t begin, size_t end, const IndexFunction &function, const CancellationToken *token)
+{
+    if(begin >= end){
+        return !(token && token->isCanceled());
+    }
+
+    size_t count = end - begin;
+    size_t threads = threadCount();
+
+    boost::shared_ptr<ParallelForState> state = boost::make_shared<ParallelForState>();
+    state->function = function;
+    state->token = token;
+    state->next = begin;
+    state->end = end;
+    state->chunkSize = std::max<size_t>(1, count / (threads * 4));
+    state->running = 0;
+    state->canceled = false;
+
+    // one helper task per worker, the calling thread does the rest
+    size_t chunks = (count + state->chunkSize - 1) / state->chunkSize;
+    size_t helpers = std::min(threads, chunks - 1);
+    for(size_t i = 0; i < helpers; i++){
+        submit(boost::bind(&runChunks, state));
+    }
+
+    runChunks(state);
+
+    boost::unique_lock<boost::mutex> lock(state->mutex);
+    while(state->running > 0){
+        state->finished.wait(lock);
+    }
+
+    if(state->exception){
+        boost::rethrow_exception(state->exception);
+    }
+
+    return !state->canceled;
+}
+
+// --- Static Methods ------------------------------------------------------ //
+namespace {
+
+ThreadPool *globalThreadPool = 0;
+boost::once_flag globalThreadPoolFlag = BOOST_ONCE_INIT;
+
+void createGlobalThreadPool()
+{
+    globalThreadPool = new ThreadPool;
+}
+
+} // end anonymous namespace
+
+/// Returns the shared thread pool used by chemkit. The pool contains
+/// one thread per hardware thread and lives until the program exits.
+ThreadPool* ThreadPool::globalInstance()
+{
+    boost::call_once(&createGlobalThreadPool, globalThreadPoolFlag);
+
+    return globalThreadPool;
+}
+
+} // end chemkit namespace
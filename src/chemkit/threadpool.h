@@ -0,0 +1,99 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_THREADPOOL_H
+#define CHEMKIT_THREADPOOL_H
+
+#include "chemkit.h"
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace chemkit {
+
+class ThreadPoolPrivate;
+
+class CHEMKIT_EXPORT CancellationToken
+{
+public:
+    // construction and destruction
+    CancellationToken();
+
+    // cancellation
+    void cancel();
+    bool isCanceled() const;
+    void reset();
+
+private:
+    CHEMKIT_DISABLE_COPY(CancellationToken)
+
+private:
+    mutable boost::mutex m_mutex;
+    bool m_canceled;
+};
+
+class CHEMKIT_EXPORT ThreadPool
+{
+public:
+    // typedefs
+    typedef boost::function<void ()> Task;
+    typedef boost::function<void (size_t)> IndexFunction;
+
+    // construction and destruction
+    ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    // properties
+    size_t threadCount() const;
+    bool isWorkerThread() const;
+
+    // tasks
+    void submit(const Task &task, const CancellationToken *token = 0);
+    void waitForDone();
+    bool parallelFor(size_t begin, size_t end, const IndexFunction &function, const CancellationToken *token = 0);
+
+    // static methods
+    static ThreadPool* globalInstance();
+
+private:
+    CHEMKIT_DISABLE_COPY(ThreadPool)
+
+private:
+    ThreadPoolPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_THREADPOOL_H
@@ -0,0 +1,357 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "topologicaldistancematrix.h"
+
+#include <limits>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+
+#include "atom.h"
+#include "foreach.h"
+#include "molecule.h"
+#include "moleculewatcher.h"
+
+namespace chemkit {
+
+namespace {
+
+// Stores the distances between each pair of atoms as the lower
+// triangle of a symmetric matrix. The smallest integer type that can
+// hold every distance (and the value used for unconnected atoms) is
+// used to keep the matrix compact.
+template<typename T>
+class DistanceStorage
+{
+public:
+    static T unconnected()
+    {
+        return static_cast<T>(~T(0));
+    }
+
+    void resize(size_t size)
+    {
+        m_values.assign(size * (size - 1) / 2, unconnected());
+    }
+
+    size_t offset(size_t i, size_t j) const
+    {
+        if(i < j){
+            std::swap(i, j);
+        }
+
+        return i * (i - 1) / 2 + j;
+    }
+
+    T value(size_t i, size_t j) const
+    {
+        return m_values[offset(i, j)];
+    }
+
+    void setValue(size_t i, size_t j, size_t value)
+    {
+        m_values[offset(i, j)] = static_cast<T>(value);
+    }
+
+    void clear()
+    {
+        std::vector<T>().swap(m_values);
+    }
+
+private:
+    std::vector<T> m_values;
+};
+
+} // end anonymous namespace
+
+// === TopologicalDistanceMatrixPrivate ==================================== //
+class TopologicalDistanceMatrixPrivate
+{
+public:
+    const Molecule *molecule;
+    MoleculeWatcher watcher;
+    size_t size;
+    bool calculated;
+    DistanceStorage<boost::uint8_t> distances8;
+    DistanceStorage<boost::uint16_t> distances16;
+    DistanceStorage<boost::uint32_t> distances32;
+
+    size_t distance(size_t i, size_t j) const;
+    bool isConnected(size_t i, size_t j) const;
+    void setDistance(size_t i, size_t j, size_t distance);
+};
+
+// Returns the distance between atoms i and j (which must be different)
+// or zero if they are not connected.
+size_t TopologicalDistanceMatrixPrivate::distance(size_t i, size_t j) const
+{
+    if(size <= std::numeric_limits<boost::uint8_t>::max()){
+        boost::uint8_t value = distances8.value(i, j);
+        return value == DistanceStorage<boost::uint8_t>::unconnected() ? 0 : value;
+    }
+    else if(size <= std::numeric_limits<boost::uint16_t>::max()){
+        boost::uint16_t value = distances16.value(i, j);
+        return value == DistanceStorage<boost::uint16_t>::unconnected() ? 0 : value;
+    }
+    else{
+        boost::uint32_t value = distances32.value(i, j);
+        return value == DistanceStorage<boost::uint32_t>::unconnected() ? 0 : value;
+    }
+}
+
+bool TopologicalDistanceMatrixPrivate::isConnected(size_t i, size_t j) const
+{
+    if(size <= std::numeric_limits<boost::uint8_t>::max()){
+        return distances8.value(i, j) != DistanceStorage<boost::uint8_t>::unconnected();
+    }
+    else if(size <= std::numeric_limits<boost::uint16_t>::max()){
+        return distances16.value(i, j) != DistanceStorage<boost::uint16_t>::unconnected();
+    }
+    else{
+        return distances32.value(i, j) != DistanceStorage<boost::uint32_t>::unconnected();
+    }
+}
+
+void TopologicalDistanceMatrixPrivate::setDistance(size_t i, size_t j, size_t distance)
+{
+    if(size <= std::numeric_limits<boost::uint8_t>::max()){
+        distances8.setValue(i, j, distance);
+    }
+    else if(size <= std::numeric_limits<boost::uint16_t>::max()){
+        distances16.setValue(i, j, distance);
+    }
+    else{
+        distances32.setValue(i, j, distance);
+    }
+}
+
+// === TopologicalDistanceMatrix =========================================== //
+/// \class TopologicalDistanceMatrix topologicaldistancematrix.h chemkit/topologicaldistancematrix.h
+/// \ingroup chemkit
+/// \brief The TopologicalDistanceMatrix class contains the
+///        topological distance between each pair of atoms in a
+///        molecule.
+///
+/// The topological distance between two atoms is the number of
+/// bonds in the shortest path between them.
+///
+/// The distances are calculated with a breadth-first search from
+/// each atom the first time they are requested and then stored until
+/// atoms or bonds are added to or removed from the molecule.
+///
+/// \see MolecularDescriptorContext::distanceMatrix()
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new topological distance matrix for \p molecule.
+TopologicalDistanceMatrix::TopologicalDistanceMatrix(const Molecule *molecule)
+    : d(new TopologicalDistanceMatrixPrivate)
+{
+    d->molecule = 0;
+    d->size = 0;
+    d->calculated = false;
+
+    d->watcher.atomAdded.connect(boost::bind(&TopologicalDistanceMatrix::structureChanged, this));
+    d->watcher.atomRemoved.connect(boost::bind(&TopologicalDistanceMatrix::structureChanged, this));
+    d->watcher.bondAdded.connect(boost::bind(&TopologicalDistanceMatrix::structureChanged, this));
+    d->watcher.bondRemoved.connect(boost::bind(&TopologicalDistanceMatrix::structureChanged, this));
+    d->watcher.structureChanged.connect(boost::bind(&TopologicalDistanceMatrix::structureChanged, this));
+
+    setMolecule(molecule);
+}
+
+/// Destroys the topological distance matrix.
+TopologicalDistanceMatrix::~TopologicalDistanceMatrix()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Sets the molecule for the matrix to \p molecule.
+void TopologicalDistanceMatrix::setMolecule(const Molecule *molecule)
+{
+    d->molecule = molecule;
+    d->watcher.setMolecule(molecule);
+
+    structureChanged();
+}
+
+/// Returns the molecule for the matrix.
+const Molecule* TopologicalDistanceMatrix::molecule() const
+{
+    return d->molecule;
+}
+
+/// Returns the number of rows (and columns) in the matrix. This is
+/// equal to the number of atoms in the molecule.
+size_t TopologicalDistanceMatrix::size() const
+{
+    return d->molecule ? d->molecule->size() : 0;
+}
+
+// --- Distances ----------------------------------------------------------- //
+/// Returns the topological distance between the atoms at indices
+/// \p i and \p j. Returns \c 0 if \p i and \p j are the same atom or
+/// if the atoms are not connected.
+size_t TopologicalDistanceMatrix::distance(size_t i, size_t j) const
+{
+    assert(i < size());
+    assert(j < size());
+
+    if(i == j){
+        return 0;
+    }
+
+    calculate();
+
+    return d->distance(i, j);
+}
+
+/// Returns the topological distance between atoms \p a and \p b.
+size_t TopologicalDistanceMatrix::distance(const Atom *a, const Atom *b) const
+{
+    return distance(a->index(), b->index());
+}
+
+/// Returns \c true if there is a path of bonds between the atoms at
+/// indices \p i and \p j.
+bool TopologicalDistanceMatrix::isConnected(size_t i, size_t j) const
+{
+    assert(i < size());
+    assert(j < size());
+
+    if(i == j){
+        return true;
+    }
+
+    calculate();
+
+    return d->isConnected(i, j);
+}
+
+/// Returns the eccentricity of the atom at \p index. This is the
+/// largest distance from the atom to any other atom it is connected
+/// to.
+size_t TopologicalDistanceMatrix::eccentricity(size_t index) const
+{
+    size_t eccentricity = 0;
+
+    for(size_t i = 0; i < size(); i++){
+        eccentricity = std::max(eccentricity, distance(index, i));
+    }
+
+    return eccentricity;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+void TopologicalDistanceMatrix::structureChanged()
+{
+    d->calculated = false;
+    d->size = 0;
+    d->distances8.clear();
+    d->distances16.clear();
+    d->distances32.clear();
+}
+
+// Runs a breadth-first search from each atom to find its distance to
+// every atom with a higher index.
+void TopologicalDistanceMatrix::calculate() const
+{
+    if(d->calculated){
+        return;
+    }
+
+    d->size = size();
+
+    if(d->size <= std::numeric_limits<boost::uint8_t>::max()){
+        d->distances8.resize(d->size);
+    }
+    else if(d->size <= std::numeric_limits<boost::uint16_t>::max()){
+        d->distances16.resize(d->size);
+    }
+    else{
+        d->distances32.resize(d->size);
+    }
+
+    // neighbor indices for each atom
+    std::vector<size_t> neighborOffsets(d->size + 1, 0);
+    std::vector<size_t> neighbors;
+    neighbors.reserve(2 * d->molecule->bondCount());
+    for(size_t i = 0; i < d->size; i++){
+        foreach(const Atom *neighbor, d->molecule->atom(i)->neighbors()){
+            neighbors.push_back(neighbor->index());
+        }
+
+        neighborOffsets[i + 1] = neighbors.size();
+    }
+
+    std::vector<size_t> queue(d->size);
+    std::vector<size_t> distances(d->size);
+    std::vector<size_t> visited(d->size, d->size);
+
+    for(size_t source = 0; source < d->size; source++){
+        size_t head = 0;
+        size_t tail = 0;
+
+        queue[tail++] = source;
+        distances[source] = 0;
+        visited[source] = source;
+
+        while(head < tail){
+            size_t atom = queue[head++];
+
+            if(atom > source){
+                d->setDistance(source, atom, distances[atom]);
+            }
+
+            for(size_t k = neighborOffsets[atom]; k < neighborOffsets[atom + 1]; k++){
+                size_t neighbor = neighbors[k];
+
+                if(visited[neighbor] != source){
+                    visited[neighbor] = source;
+                    distances[neighbor] = distances[atom] + 1;
+                    queue[tail++] = neighbor;
+                }
+            }
+        }
+    }
+
+    d->calculated = true;
+}
+
+} // end chemkit namespace
@@ -57,7 +57,9 @@ public:
     typedef T SizeType;
     enum { NullIndex = SizeType(-1) }; // represents an invalid vertex index
 
-    SharedState(T sourceSize, T targetSize);
+    SharedState(T sourceSize = 0, T targetSize = 0);
+
+    void reset(T sourceSize, T targetSize);
 
     std::vector<T> sourceMapping;
     std::vector<T> targetMapping;
@@ -74,6 +76,17 @@ inline SharedState<T>::SharedState(T sourceSize, T targetSize)
 {
 }
 
+// Resets the shared state for graphs of the given sizes. The existing
+// storage is reused so that repeated searches do not reallocate.
+template<typename T>
+inline void SharedState<T>::reset(T sourceSize, T targetSize)
+{
+    sourceMapping.assign(sourceSize, NullIndex);
+    targetMapping.assign(targetSize, NullIndex);
+    sourceTerminalSet.assign(sourceSize, 0);
+    targetTerminalSet.assign(targetSize, 0);
+}
+
 // The State class represents a single state in the isomorphism detection
 // algorithm. Every state uses and modifies the same SharedState object.
 template<typename T, typename VertexComparator, typename EdgeComparator>
@@ -84,6 +97,7 @@ public:
     enum { NullIndex = SizeType(-1) }; // represents an invalid vertex index
 
     State(const Graph<T> &source, const Graph<T> &target, VertexComparator compareVertices, EdgeComparator compareEdges);
+    State(const Graph<T> &source, const Graph<T> &target, VertexComparator compareVertices, EdgeComparator compareEdges, SharedState<T> *sharedState);
     State(const State *state);
     ~State();
 
@@ -91,6 +105,8 @@ public:
     const Graph<T>& source() const { return m_source; }
     const Graph<T>& target() const { return m_target; }
     std::map<T, T> mapping() const;
+    void mapping(std::map<T, T> &mapping) const;
+    void mapping(std::vector<T> &mapping) const;
     bool succeeded() const;
     void addPair(const std::pair<T, T> &candidate);
     std::pair<T, T> nextCandidate(const std::pair<T, T> &lastCandidate);
@@ -130,6 +146,26 @@ inline State<T, VertexComparator, EdgeComparator>::State(const Graph<T> &source,
 {
 }
 
+template<typename T, typename VertexComparator, typename EdgeComparator>
+inline State<T, VertexComparator, EdgeComparator>::State(const Graph<T> &source,
+                                                         const Graph<T> &target,
+                                                         VertexComparator compareVertices,
+                                                         EdgeComparator compareEdges,
+                                                         SharedState<T> *sharedState)
+    : m_size(0),
+      m_sourceTerminalSize(0),
+      m_targetTerminalSize(0),
+      m_source(source),
+      m_target(target),
+      m_lastAddition(NullIndex, NullIndex),
+      m_sharedState(sharedState),
+      m_ownSharedState(false),
+      m_compareVertices(compareVertices),
+      m_compareEdges(compareEdges)
+{
+    m_sharedState->reset(source.size(), target.size());
+}
+
 template<typename T, typename VertexComparator, typename EdgeComparator>
 inline State<T, VertexComparator, EdgeComparator>::State(const State *state)
     : m_size(state->m_size),
@@ -172,6 +208,22 @@ inline std::map<T, T> State<T, VertexComparator, EdgeComparator>::mapping() cons
     return mapping;
 }
 
+// Stores the current isomorphism for the state in \p mapping.
+template<typename T, typename VertexComparator, typename EdgeComparator>
+inline void State<T, VertexComparator, EdgeComparator>::mapping(std::map<T, T> &mapping) const
+{
+    mapping = this->mapping();
+}
+
+// Stores the current isomorphism for the state in \p mapping where
+// mapping[i] is the target vertex for source vertex i.
+template<typename T, typename VertexComparator, typename EdgeComparator>
+inline void State<T, VertexComparator, EdgeComparator>::mapping(std::vector<T> &mapping) const
+{
+    mapping.assign(m_sharedState->sourceMapping.begin(),
+                   m_sharedState->sourceMapping.begin() + m_size);
+}
+
 // Returns the next candidate pair (sourceAtom, targetAtom) to be added to the
 // state. The candidate should be checked for feasibility and then added using
 // the addPair() method.
@@ -351,15 +403,19 @@ inline bool State<T, VertexComparator, EdgeComparator>::isFeasible(const std::pa
         }
     }
 
+    // the target may contain additional bonds not in the source so an
+    // unmapped source neighbor outside of the terminal set may still be
+    // mapped to a target neighbor inside of the terminal set
     return (sourceTerminalNeighborCount <= targetTerminalNeighborCount) &&
-           (sourceNewNeighborCount <= targetNewNeighborCount);
+           (sourceTerminalNeighborCount + sourceNewNeighborCount <=
+            targetTerminalNeighborCount + targetNewNeighborCount);
 }
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline bool match(State<T, VertexComparator, EdgeComparator> *state, std::map<T, T> &mapping)
+template<typename T, typename VertexComparator, typename EdgeComparator, typename MappingType>
+inline bool match(State<T, VertexComparator, EdgeComparator> *state, MappingType &mapping)
 {
     if(state->succeeded()){
-        mapping = state->mapping();
+        state->mapping(mapping);
         return true;
     }
 
@@ -388,6 +444,29 @@ inline bool match(State<T, VertexComparator, EdgeComparator> *state, std::map<T,
 
 } // end detail namespace
 
+// The Vf2Context class holds the state used by the vf2() algorithm.
+// Passing the same context to multiple searches allows the storage to
+// be reused rather than reallocated for each search.
+template<typename T = size_t>
+class Vf2Context
+{
+public:
+    // Returns the mapping found by the last search where mapping()[i]
+    // is the target vertex for source vertex i.
+    const std::vector<T>& mapping() const { return m_mapping; }
+
+private:
+    template<typename U, typename VertexComparator, typename EdgeComparator>
+    friend bool vf2(const Graph<U> &a,
+                    const Graph<U> &b,
+                    VertexComparator vertexComparator,
+                    EdgeComparator edgeComparator,
+                    Vf2Context<U> &context);
+
+    detail::SharedState<T> m_sharedState;
+    std::vector<T> m_mapping;
+};
+
 template<typename T, typename VertexComparator, typename EdgeComparator>
 std::map<T, T> vf2(const Graph<T> &a,
                    const Graph<T> &b,
@@ -413,6 +492,32 @@ std::map<T, T> vf2(const Graph<T> &a,
     return mapping;
 }
 
+// Runs the vf2 algorithm using the storage in \p context. Returns
+// \c true if an isomorphism was found in which case it is available
+// from context.mapping().
+template<typename T, typename VertexComparator, typename EdgeComparator>
+bool vf2(const Graph<T> &a,
+         const Graph<T> &b,
+         VertexComparator vertexComparator,
+         EdgeComparator edgeComparator,
+         Vf2Context<T> &context)
+{
+    using detail::State;
+    using detail::match;
+
+    // create initial empty state using the shared state in the context
+    State<T, VertexComparator, EdgeComparator> state(a,
+                                                     b,
+                                                     vertexComparator,
+                                                     edgeComparator,
+                                                     &context.m_sharedState);
+
+    context.m_mapping.clear();
+
+    // run vf2 match algorithm
+    return match(&state, context.m_mapping);
+}
+
 } // end algorithm namespace
 } // end chemkit namespace
 
@@ -114,6 +114,7 @@ GraphicsMoleculeItem::GraphicsMoleculeItem(const Molecule *molecule)
     d->watcher->bondAdded.connect(boost::bind(&GraphicsMoleculeItem::bondAdded, this, _1));
     d->watcher->bondRemoved.connect(boost::bind(&GraphicsMoleculeItem::bondRemoved, this, _1));
     d->watcher->bondOrderChanged.connect(boost::bind(&GraphicsMoleculeItem::bondOrderChanged, this, _1));
+    d->watcher->structureChanged.connect(boost::bind(&GraphicsMoleculeItem::structureChanged, this, _1));
 
     setMolecule(molecule);
 }
@@ -508,4 +509,22 @@ void GraphicsMoleculeItem::bondOrderChanged(const Bond *bond)
     update();
 }
 
+void GraphicsMoleculeItem::structureChanged(const Molecule *molecule)
+{
+    // recreate the items for every atom and bond in the molecule
+    qDeleteAll(d->atomItems);
+    d->atomItems.clear();
+    qDeleteAll(d->bondItems);
+    d->bondItems.clear();
+
+    foreach(const Atom *atom, molecule->atoms()){
+        atomAdded(atom);
+    }
+    foreach(const Bond *bond, molecule->bonds()){
+        bondAdded(bond);
+    }
+
+    update();
+}
+
 } // end chemkit namespace
@@ -0,0 +1,1097 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fingerprintdatabase.h"
+
+#include <fstream>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <chemkit/foreach.h>
+#include <chemkit/concurrent.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHEMKIT_FINGERPRINT_POPCNT_DISPATCH
+#endif
+
+namespace chemkit {
+
+namespace {
+
+typedef boost::uint64_t Block;
+typedef FingerprintDatabase::Hit Hit;
+
+const size_t BlockSize = 64;
+
+// identifies fingerprint database files, the last character is the
+// version of the file format
+const char DatabaseFileMagic[8] = { 'C', 'K', 'F', 'P', 'D', 'B', 'S', '1' };
+
+// written to the header to detect files from platforms with a
+// different byte order
+const boost::uint32_t DatabaseFileByteOrder = 0x01020304;
+
+// The database file consists of a header followed by arrays of 64-bit
+// values. The fingerprints are stored in the same order as the buckets
+// in memory (sorted by the number of bits set) so that a file can be
+// searched directly from a read-only memory mapping:
+//
+//   DatabaseFileHeader header
+//   uint64 bucketOffsets[bitCount + 2]   first position of each bucket
+//   uint64 blocks[size * blockCount]     fingerprints in bucket order
+//   uint64 indices[size]                 index of each fingerprint
+//   uint64 positions[size]               position of each index
+//   uint64 idOffsets[size + 1]           start of each id in idData
+//   char idData[idDataSize]
+struct DatabaseFileHeader
+{
+    char magic[8];
+    boost::uint32_t byteOrder;
+    boost::uint32_t bitCount;
+    boost::uint64_t size;
+    boost::uint64_t idDataSize;
+};
+
+// the number of fingerprints compared by each task when searching
+// in parallel
+const size_t ChunkSize = 4096;
+
+// Fingerprints with the same number of bits set are stored together
+// in a bucket. Given the number of bits set in the query, the upper
+// bound on the tanimoto coefficient for every fingerprint in a bucket
+// is known before comparing any of them, which allows whole buckets
+// to be skipped (the "BitBound" algorithm from Swamidass and Baldi,
+// J. Chem. Inf. Model. 2007, 47, 302-317).
+struct Bucket
+{
+    std::vector<Block> blocks;
+    std::vector<boost::uint64_t> indices;
+};
+
+// The fingerprints in a bucket, either from memory or from a mapped
+// database file.
+struct BucketView
+{
+    const Block *blocks;
+    const boost::uint64_t *indices;
+    size_t size;
+};
+
+struct Query
+{
+    std::vector<Block> blocks;
+    size_t count;
+};
+
+// A range of fingerprints from a single bucket to be compared with
+// the query.
+struct ScanRange
+{
+    BucketView bucket;
+    size_t count;
+    size_t begin;
+    size_t end;
+};
+
+#ifdef CHEMKIT_FINGERPRINT_POPCNT_DISPATCH
+#define CHEMKIT_FINGERPRINT_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define CHEMKIT_FINGERPRINT_ALWAYS_INLINE inline
+#endif
+
+// Counts bits using only integer arithmetic.
+struct SoftwarePopcount
+{
+    static CHEMKIT_FINGERPRINT_ALWAYS_INLINE size_t count(Block block)
+    {
+        block = block - ((block >> 1) & 0x5555555555555555ULL);
+        block = (block & 0x3333333333333333ULL) + ((block >> 2) & 0x3333333333333333ULL);
+        block = (block + (block >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return (block * 0x0101010101010101ULL) >> 56;
+    }
+};
+
+#ifdef CHEMKIT_FINGERPRINT_POPCNT_DISPATCH
+// Counts bits with the popcnt instruction when inlined into a
+// function compiled for it.
+struct HardwarePopcount
+{
+    static CHEMKIT_FINGERPRINT_ALWAYS_INLINE size_t count(Block block)
+    {
+        return __builtin_popcountll(block);
+    }
+};
+#endif
+
+inline Real tanimoto(size_t a, size_t b, size_t intersection)
+{
+    size_t union_ = a + b - intersection;
+
+    return union_ ? Real(intersection) / Real(union_) : Real(0);
+}
+
+// Returns the largest possible tanimoto coefficient between
+// fingerprints with a and b bits set.
+inline Real tanimotoBound(size_t a, size_t b)
+{
+    return tanimoto(a, b, std::min(a, b));
+}
+
+// Returns true if a is more similar than b. Hits with the same
+// similarity are ordered by their index.
+bool hitLessThan(const Hit &a, const Hit &b)
+{
+    if(a.second != b.second){
+        return a.second > b.second;
+    }
+
+    return a.first < b.first;
+}
+
+// Adds hit to hits. If limit is not zero hits is kept as a heap
+// containing only the limit best hits with the worst hit on top.
+inline void addHit(std::vector<Hit> &hits, const Hit &hit, size_t limit)
+{
+    if(!limit){
+        hits.push_back(hit);
+    }
+    else if(hits.size() < limit){
+        hits.push_back(hit);
+        std::push_heap(hits.begin(), hits.end(), hitLessThan);
+    }
+    else if(hitLessThan(hit, hits.front())){
+        std::pop_heap(hits.begin(), hits.end(), hitLessThan);
+        hits.back() = hit;
+        std::push_heap(hits.begin(), hits.end(), hitLessThan);
+    }
+}
+
+// --- Scanning ------------------------------------------------------------ //
+// Compares the query with each fingerprint in range and adds those
+// with a similarity of at least threshold to hits.
+template<typename Popcount>
+CHEMKIT_FINGERPRINT_ALWAYS_INLINE void scanRange(const Query &query,
+                                                 size_t blockCount,
+                                                 const ScanRange &range,
+                                                 Real threshold,
+                                                 size_t limit,
+                                                 std::vector<Hit> &hits)
+{
+    const Block *queryBlocks = &query.blocks[0];
+    const Block *blocks = range.bucket.blocks + range.begin * blockCount;
+
+    for(size_t i = range.begin; i < range.end; i++){
+        size_t intersection = 0;
+        for(size_t j = 0; j < blockCount; j++){
+            intersection += Popcount::count(queryBlocks[j] & blocks[j]);
+        }
+        blocks += blockCount;
+
+        Real similarity = tanimoto(query.count, range.count, intersection);
+        if(similarity >= threshold){
+            addHit(hits, Hit(range.bucket.indices[i], similarity), limit);
+
+            // once the heap is full only better hits can be added
+            if(limit && hits.size() == limit){
+                threshold = std::max(threshold, hits.front().second);
+            }
+        }
+    }
+}
+
+typedef void (*ScanFunction)(const Query &, size_t, const ScanRange &, Real, size_t, std::vector<Hit> &);
+
+void scanRangeDefault(const Query &query,
+                      size_t blockCount,
+                      const ScanRange &range,
+                      Real threshold,
+                      size_t limit,
+                      std::vector<Hit> &hits)
+{
+    scanRange<SoftwarePopcount>(query, blockCount, range, threshold, limit, hits);
+}
+
+#ifdef CHEMKIT_FINGERPRINT_POPCNT_DISPATCH
+// Same as scanRangeDefault() but compiled to use the popcnt
+// instruction. Only called if the processor supports it.
+__attribute__((target("popcnt")))
+void scanRangePopcnt(const Query &query,
+                     size_t blockCount,
+                     const ScanRange &range,
+                     Real threshold,
+                     size_t limit,
+                     std::vector<Hit> &hits)
+{
+    scanRange<HardwarePopcount>(query, blockCount, range, threshold, limit, hits);
+}
+#endif
+
+ScanFunction selectScanFunction()
+{
+#ifdef CHEMKIT_FINGERPRINT_POPCNT_DISPATCH
+    if(__builtin_cpu_supports("popcnt")){
+        return scanRangePopcnt;
+    }
+#endif
+
+    return scanRangeDefault;
+}
+
+// Scans one range for each index and stores the hits found in
+// results at the same index.
+struct ScanTask
+{
+    ScanFunction function;
+    const Query *query;
+    size_t blockCount;
+    const std::vector<ScanRange> *ranges;
+    Real threshold;
+    size_t limit;
+    std::vector<std::vector<Hit> > *results;
+
+    void operator()(size_t index) const
+    {
+        function(*query, blockCount, (*ranges)[index], threshold, limit, (*results)[index]);
+    }
+};
+
+// Returns true if the count values are in non-decreasing order and
+// none of them is greater than bound.
+bool isSortedWithin(const boost::uint64_t *values, size_t count, boost::uint64_t bound)
+{
+    for(size_t i = 0; i < count; i++){
+        if(values[i] > bound || (i > 0 && values[i] < values[i - 1])){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Returns true if each of the count values is less than bound.
+bool isEachLessThan(const boost::uint64_t *values, size_t count, boost::uint64_t bound)
+{
+    for(size_t i = 0; i < count; i++){
+        if(values[i] >= bound){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // end anonymous namespace
+
+// === FingerprintDatabasePrivate ========================================== //
+class FingerprintDatabasePrivate
+{
+public:
+    void setBitCount(size_t count);
+    size_t size() const;
+    BucketView bucket(size_t count) const;
+    const Block* blocks(size_t index, size_t &count) const;
+    bool map(const std::string &fileName);
+    void detach();
+    Query query(const Bitset &fingerprint) const;
+    size_t add(const Block *blocks, const std::string &id);
+    void scan(const Query &query, const std::vector<size_t> &counts, Real threshold, size_t limit, std::vector<Hit> &hits) const;
+
+    size_t bitCount;
+    size_t blockCount;
+    std::vector<Bucket> buckets;
+    std::vector<std::pair<size_t, size_t> > locations;
+    std::vector<std::string> ids;
+    ScanFunction scanFunction;
+    std::string errorString;
+
+    // mapped database file
+    boost::iostreams::mapped_file_source file;
+    size_t mappedSize;
+    const boost::uint64_t *mappedBucketOffsets;
+    const Block *mappedBlocks;
+    const boost::uint64_t *mappedIndices;
+    const boost::uint64_t *mappedPositions;
+    const boost::uint64_t *mappedIdOffsets;
+    const char *mappedIdData;
+};
+
+// Removes all of the fingerprints and sets the number of bits to
+// count.
+void FingerprintDatabasePrivate::setBitCount(size_t count)
+{
+    if(file.is_open()){
+        file.close();
+    }
+
+    bitCount = count;
+    blockCount = (count + BlockSize - 1) / BlockSize;
+    buckets.assign(count + 1, Bucket());
+    locations.clear();
+    ids.clear();
+    mappedSize = 0;
+}
+
+size_t FingerprintDatabasePrivate::size() const
+{
+    return file.is_open() ? mappedSize : ids.size();
+}
+
+// Returns the fingerprints with count bits set.
+BucketView FingerprintDatabasePrivate::bucket(size_t count) const
+{
+    BucketView view;
+
+    if(file.is_open()){
+        size_t begin = mappedBucketOffsets[count];
+        view.blocks = mappedBlocks + begin * blockCount;
+        view.indices = mappedIndices + begin;
+        view.size = mappedBucketOffsets[count + 1] - begin;
+    }
+    else{
+        const Bucket &bucket = buckets[count];
+        view.blocks = bucket.blocks.empty() ? 0 : &bucket.blocks[0];
+        view.indices = bucket.indices.empty() ? 0 : &bucket.indices[0];
+        view.size = bucket.indices.size();
+    }
+
+    return view;
+}
+
+// Returns the blocks for the fingerprint at index and sets count to
+// the number of bits set in it.
+const Block* FingerprintDatabasePrivate::blocks(size_t index, size_t &count) const
+{
+    if(file.is_open()){
+        boost::uint64_t position = mappedPositions[index];
+        count = std::upper_bound(mappedBucketOffsets,
+                                 mappedBucketOffsets + bitCount + 2,
+                                 position) - mappedBucketOffsets - 1;
+
+        return mappedBlocks + position * blockCount;
+    }
+    else{
+        count = locations[index].first;
+
+        return &buckets[count].blocks[locations[index].second * blockCount];
+    }
+}
+
+// Maps the database file with fileName into memory.
+bool FingerprintDatabasePrivate::map(const std::string &fileName)
+{
+    try {
+        file.open(fileName);
+    }
+    catch(std::exception &){
+        errorString = "Failed to map '" + fileName + "' into memory.";
+        return false;
+    }
+
+    const char *data = file.data();
+    const DatabaseFileHeader *header = reinterpret_cast<const DatabaseFileHeader *>(data);
+
+    if(file.size() < sizeof(DatabaseFileHeader) ||
+       !std::equal(DatabaseFileMagic, DatabaseFileMagic + sizeof(DatabaseFileMagic), header->magic)){
+        errorString = "File is not a fingerprint database.";
+        file.close();
+        return false;
+    }
+    else if(header->byteOrder != DatabaseFileByteOrder){
+        errorString = "Database was written on an incompatible platform.";
+        file.close();
+        return false;
+    }
+
+    boost::uint64_t bitCount = header->bitCount;
+    boost::uint64_t size = header->size;
+    boost::uint64_t blockCount = (bitCount + BlockSize - 1) / BlockSize;
+
+    // check each array against the number of values that fit in the
+    // file before computing its size so that corrupt counts in the
+    // header cannot overflow the calculation
+    boost::uint64_t availableValues = (file.size() - sizeof(DatabaseFileHeader)) / sizeof(boost::uint64_t);
+
+    if(bitCount + 2 > availableValues ||
+       blockCount + 3 > availableValues ||
+       size > availableValues / (blockCount + 3) ||
+       header->idDataSize > file.size()){
+        errorString = "Fingerprint database file is truncated.";
+        file.close();
+        return false;
+    }
+
+    boost::uint64_t valueCount = (bitCount + 2) + size * blockCount + size * 3 + 1;
+    boost::uint64_t fileSize = sizeof(DatabaseFileHeader) + valueCount * sizeof(boost::uint64_t) + header->idDataSize;
+
+    if(file.size() < fileSize){
+        errorString = "Fingerprint database file is truncated.";
+        file.close();
+        return false;
+    }
+
+    const boost::uint64_t *values = reinterpret_cast<const boost::uint64_t *>(data + sizeof(DatabaseFileHeader));
+    const boost::uint64_t *bucketOffsets = values;
+    const boost::uint64_t *indices = bucketOffsets + bitCount + 2 + size * blockCount;
+    const boost::uint64_t *positions = indices + size;
+    const boost::uint64_t *idOffsets = positions + size;
+
+    // the offsets and positions are used to index the other arrays
+    // while searching so they must be checked before being trusted
+    if(bucketOffsets[0] != 0 ||
+       bucketOffsets[bitCount + 1] != size ||
+       !isSortedWithin(bucketOffsets, bitCount + 2, size) ||
+       !isEachLessThan(indices, size, size) ||
+       !isEachLessThan(positions, size, size) ||
+       !isSortedWithin(idOffsets, size + 1, header->idDataSize)){
+        errorString = "Fingerprint database file is corrupt.";
+        file.close();
+        return false;
+    }
+
+    this->bitCount = bitCount;
+    this->blockCount = blockCount;
+    buckets.clear();
+    locations.clear();
+    ids.clear();
+    mappedSize = size;
+
+    mappedBucketOffsets = values;
+    values += bitCount + 2;
+    mappedBlocks = values;
+    values += size * blockCount;
+    mappedIndices = values;
+    values += size;
+    mappedPositions = values;
+    values += size;
+    mappedIdOffsets = values;
+    values += size + 1;
+    mappedIdData = reinterpret_cast<const char *>(values);
+
+    return true;
+}
+
+// Copies the fingerprints from the mapped file into memory so that
+// they can be modified.
+void FingerprintDatabasePrivate::detach()
+{
+    if(!file.is_open()){
+        return;
+    }
+
+    std::vector<Bucket> buckets(bitCount + 1);
+    std::vector<std::pair<size_t, size_t> > locations(mappedSize);
+    std::vector<std::string> ids(mappedSize);
+
+    for(size_t count = 0; count < buckets.size(); count++){
+        BucketView view = bucket(count);
+
+        buckets[count].blocks.assign(view.blocks, view.blocks + view.size * blockCount);
+        buckets[count].indices.assign(view.indices, view.indices + view.size);
+
+        for(size_t i = 0; i < view.size; i++){
+            locations[view.indices[i]] = std::make_pair(count, i);
+        }
+    }
+
+    for(size_t i = 0; i < mappedSize; i++){
+        ids[i].assign(mappedIdData + mappedIdOffsets[i], mappedIdData + mappedIdOffsets[i + 1]);
+    }
+
+    file.close();
+    mappedSize = 0;
+
+    this->buckets.swap(buckets);
+    this->locations.swap(locations);
+    this->ids.swap(ids);
+}
+
+// Converts fingerprint to blocks, ignoring any bits past bitCount.
+Query FingerprintDatabasePrivate::query(const Bitset &fingerprint) const
+{
+    Query query;
+    query.blocks.resize(std::max(blockCount, size_t(1)), 0);
+    query.count = 0;
+
+    for(size_t i = fingerprint.find_first(); i < bitCount; i = fingerprint.find_next(i)){
+        query.blocks[i / BlockSize] |= Block(1) << (i % BlockSize);
+        query.count++;
+    }
+
+    return query;
+}
+
+// Adds the fingerprint stored in blocks and returns its index.
+size_t FingerprintDatabasePrivate::add(const Block *blocks, const std::string &id)
+{
+    detach();
+
+    size_t count = 0;
+    for(size_t i = 0; i < blockCount; i++){
+        count += SoftwarePopcount::count(blocks[i]);
+    }
+
+    Bucket &bucket = buckets[count];
+    locations.push_back(std::make_pair(count, bucket.indices.size()));
+    bucket.indices.push_back(ids.size());
+    bucket.blocks.insert(bucket.blocks.end(), blocks, blocks + blockCount);
+    ids.push_back(id);
+
+    return ids.size() - 1;
+}
+
+// Compares the query with every fingerprint in the buckets for counts
+// and appends those with a similarity of at least threshold to hits.
+// If limit is not zero at most limit hits are added from each range
+// of ChunkSize fingerprints. Large scans are split between the threads
+// in the global thread pool.
+void FingerprintDatabasePrivate::scan(const Query &query,
+                                      const std::vector<size_t> &counts,
+                                      Real threshold,
+                                      size_t limit,
+                                      std::vector<Hit> &hits) const
+{
+    std::vector<ScanRange> ranges;
+
+    foreach(size_t count, counts){
+        BucketView bucket = this->bucket(count);
+
+        for(size_t begin = 0; begin < bucket.size; begin += ChunkSize){
+            ScanRange range;
+            range.bucket = bucket;
+            range.count = count;
+            range.begin = begin;
+            range.end = std::min(begin + ChunkSize, bucket.size);
+            ranges.push_back(range);
+        }
+    }
+
+    if(ranges.empty()){
+        return;
+    }
+
+    std::vector<std::vector<Hit> > results(ranges.size());
+
+    ScanTask task;
+    task.function = scanFunction;
+    task.query = &query;
+    task.blockCount = blockCount;
+    task.ranges = &ranges;
+    task.threshold = threshold;
+    task.limit = limit;
+    task.results = &results;
+
+    if(ranges.size() == 1){
+        task(0);
+    }
+    else{
+        concurrent::parallel_for(0, ranges.size(), task);
+    }
+
+    foreach(const std::vector<Hit> &result, results){
+        hits.insert(hits.end(), result.begin(), result.end());
+    }
+}
+
+// === FingerprintDatabase ================================================= //
+/// \class FingerprintDatabase fingerprintdatabase.h chemkit/fingerprintdatabase.h
+/// \ingroup chemkit-io
+/// \brief The FingerprintDatabase class provides fast similarity
+///        searching of a collection of fingerprints.
+///
+/// Each fingerprint in the database has the same number of bits and
+/// is stored in contiguous 64-bit blocks along with an optional
+/// identifier. Fingerprints are grouped by the number of bits they
+/// have set so that search() and nearest() only compare the query
+/// with fingerprints that could possibly be similar enough to it.
+/// Large searches are split between the threads in the global
+/// ThreadPool.
+///
+/// Databases can be read from FPS files or written to a binary file
+/// with write(). Binary files are memory mapped when read, so large
+/// databases can be searched without first loading them into memory.
+///
+/// For example, to find the ten molecules in a FPS file which are
+/// most similar to aspirin:
+/// \code
+/// FingerprintDatabase database;
+/// database.read("compounds.fps");
+///
+/// Molecule aspirin("CC(=O)Oc1ccccc1C(=O)O", "smiles");
+/// Bitset query = aspirin.fingerprint("fp2");
+///
+/// foreach(const FingerprintDatabase::Hit &hit, database.nearest(query, 10)){
+///     std::cout << database.id(hit.first) << " " << hit.second << std::endl;
+/// }
+/// \endcode
+///
+/// \see Fingerprint
+
+/// \typedef FingerprintDatabase::Hit
+/// Contains the index of a fingerprint in the database and its
+/// tanimoto coefficient with the query.
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty fingerprint database for fingerprints with
+/// \p bitCount bits. If \p bitCount is \c 0 the size of the first
+/// fingerprint added is used.
+FingerprintDatabase::FingerprintDatabase(size_t bitCount)
+    : d(new FingerprintDatabasePrivate)
+{
+    d->setBitCount(bitCount);
+    d->scanFunction = selectScanFunction();
+}
+
+/// Destroys the fingerprint database.
+FingerprintDatabase::~FingerprintDatabase()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of fingerprints in the database.
+size_t FingerprintDatabase::size() const
+{
+    return d->size();
+}
+
+/// Returns \c true if the database contains no fingerprints.
+bool FingerprintDatabase::isEmpty() const
+{
+    return size() == 0;
+}
+
+/// Returns the number of bits in each fingerprint.
+size_t FingerprintDatabase::bitCount() const
+{
+    return d->bitCount;
+}
+
+// --- Fingerprints -------------------------------------------------------- //
+/// Adds \p fingerprint to the database with \p id and returns its
+/// index. Bits past bitCount() are ignored.
+size_t FingerprintDatabase::addFingerprint(const Bitset &fingerprint, const std::string &id)
+{
+    if(isEmpty() && d->bitCount == 0){
+        d->setBitCount(fingerprint.size());
+    }
+
+    Query blocks = d->query(fingerprint);
+
+    return d->add(&blocks.blocks[0], id);
+}
+
+/// Returns the fingerprint at \p index.
+Bitset FingerprintDatabase::fingerprint(size_t index) const
+{
+    if(index >= size()){
+        return Bitset();
+    }
+
+    size_t count;
+    const Block *blocks = d->blocks(index, count);
+
+    Bitset fingerprint(d->bitCount);
+    for(size_t i = 0; i < d->bitCount; i++){
+        if(blocks[i / BlockSize] & (Block(1) << (i % BlockSize))){
+            fingerprint.set(i);
+        }
+    }
+
+    return fingerprint;
+}
+
+/// Returns the identifier for the fingerprint at \p index.
+std::string FingerprintDatabase::id(size_t index) const
+{
+    if(index >= size()){
+        return std::string();
+    }
+
+    if(d->file.is_open()){
+        return std::string(d->mappedIdData + d->mappedIdOffsets[index],
+                           d->mappedIdData + d->mappedIdOffsets[index + 1]);
+    }
+
+    return d->ids[index];
+}
+
+/// Reserves space for \p size fingerprints.
+void FingerprintDatabase::reserve(size_t size)
+{
+    d->detach();
+    d->locations.reserve(size);
+    d->ids.reserve(size);
+}
+
+/// Removes all of the fingerprints from the database.
+void FingerprintDatabase::clear()
+{
+    d->setBitCount(d->bitCount);
+}
+
+// --- Similarity ---------------------------------------------------------- //
+/// Returns the tanimoto coefficient between \p query and the
+/// fingerprint at \p index.
+///
+/// \see Fingerprint::tanimotoCoefficient()
+Real FingerprintDatabase::tanimotoCoefficient(const Bitset &query, size_t index) const
+{
+    if(index >= size()){
+        return 0;
+    }
+
+    Query blocks = d->query(query);
+    boost::uint64_t indexValue = index;
+
+    ScanRange range;
+    range.bucket.blocks = d->blocks(index, range.count);
+    range.bucket.indices = &indexValue;
+    range.bucket.size = 1;
+    range.begin = 0;
+    range.end = 1;
+
+    std::vector<Hit> hits;
+    d->scanFunction(blocks, d->blockCount, range, 0, 0, hits);
+
+    return hits.front().second;
+}
+
+/// Returns each fingerprint with a tanimoto coefficient of at least
+/// \p threshold with \p query. The hits are sorted from most to least
+/// similar.
+std::vector<FingerprintDatabase::Hit> FingerprintDatabase::search(const Bitset &query, Real threshold) const
+{
+    Query blocks = d->query(query);
+
+    std::vector<size_t> counts;
+    for(size_t count = 0; count <= d->bitCount; count++){
+        if(tanimotoBound(blocks.count, count) >= threshold){
+            counts.push_back(count);
+        }
+    }
+
+    std::vector<Hit> hits;
+    d->scan(blocks, counts, threshold, 0, hits);
+    std::sort(hits.begin(), hits.end(), hitLessThan);
+
+    return hits;
+}
+
+/// Returns the \p count fingerprints which are most similar to
+/// \p query. The hits are sorted from most to least similar.
+/// Fingerprints with the same similarity are ordered by index.
+std::vector<FingerprintDatabase::Hit> FingerprintDatabase::nearest(const Bitset &query, size_t count) const
+{
+    std::vector<Hit> hits;
+    if(count == 0){
+        return hits;
+    }
+
+    Query blocks = d->query(query);
+
+    // visit the buckets from the highest to the lowest bound
+    std::vector<std::pair<Real, size_t> > bounds;
+    for(size_t i = 0; i <= d->bitCount; i++){
+        if(d->bucket(i).size){
+            bounds.push_back(std::make_pair(-tanimotoBound(blocks.count, i), i));
+        }
+    }
+    std::sort(bounds.begin(), bounds.end());
+
+    size_t next = 0;
+    while(next < bounds.size()){
+        Real threshold = 0;
+        if(hits.size() == count){
+            threshold = hits.back().second;
+
+            // no fingerprint in the remaining buckets can be more
+            // similar than the current hits
+            if(-bounds[next].first < threshold){
+                break;
+            }
+        }
+
+        // scan the next buckets until there is enough work to share
+        // between the threads
+        std::vector<size_t> counts;
+        size_t fingerprintCount = 0;
+        while(next < bounds.size() && fingerprintCount < ChunkSize * 16){
+            counts.push_back(bounds[next].second);
+            fingerprintCount += d->bucket(bounds[next].second).size;
+            next++;
+        }
+
+        d->scan(blocks, counts, threshold, count, hits);
+
+        std::sort(hits.begin(), hits.end(), hitLessThan);
+        if(hits.size() > count){
+            hits.resize(count);
+        }
+    }
+
+    return hits;
+}
+
+// --- Input and Output ---------------------------------------------------- //
+/// Reads the fingerprints from \p fileName. Any fingerprints already
+/// in the database are removed. Returns \c false if an error occurs.
+///
+/// Files written with write() are mapped into memory rather than
+/// read. This makes opening even very large databases nearly
+/// instantaneous and only the parts of the file which are searched
+/// are loaded from disk. The mapping is kept until the database is
+/// modified or cleared. Any other file is read as an FPS file.
+///
+/// \see read(std::istream&)
+bool FingerprintDatabase::read(const std::string &fileName)
+{
+    d->setBitCount(0);
+
+    std::ifstream input(fileName.c_str(), std::ios::in | std::ios::binary);
+    if(!input.is_open()){
+        d->errorString = "Failed to open '" + fileName + "' for reading.";
+        return false;
+    }
+
+    char magic[sizeof(DatabaseFileMagic)];
+    input.read(magic, sizeof(magic));
+    if(input.gcount() == sizeof(magic) &&
+       std::equal(magic, magic + sizeof(magic), DatabaseFileMagic)){
+        input.close();
+
+        return d->map(fileName);
+    }
+
+    input.clear();
+    input.seekg(0);
+
+    return read(input);
+}
+
+/// Reads the fingerprints in the FPS format from \p input. Any
+/// fingerprints already in the database are removed. The number of
+/// bits is taken from the "num_bits" header if present and otherwise
+/// from the length of the first fingerprint. Returns \c false if an
+/// error occurs.
+///
+/// Reference:
+///   http://code.google.com/p/chem-fingerprints/wiki/FPS
+bool FingerprintDatabase::read(std::istream &input)
+{
+    d->setBitCount(0);
+
+    std::string line;
+    size_t lineNumber = 0;
+    size_t byteCount = 0;
+    bool header = true;
+    std::vector<Block> blocks;
+
+    while(std::getline(input, line)){
+        lineNumber++;
+
+        if(!line.empty() && line[line.size() - 1] == '\r'){
+            line.resize(line.size() - 1);
+        }
+
+        if(line.empty()){
+            continue;
+        }
+        else if(line[0] == '#'){
+            if(header && boost::starts_with(line, "#num_bits=")){
+                try {
+                    d->setBitCount(boost::lexical_cast<size_t>(line.substr(10)));
+                }
+                catch(boost::bad_lexical_cast &){
+                    d->errorString = "Invalid num_bits header.";
+                    clear();
+                    return false;
+                }
+            }
+
+            continue;
+        }
+
+        size_t hexLength = std::min(line.find('\t'), line.size());
+
+        if(header){
+            // without a num_bits header the size is taken from the
+            // length of the first fingerprint
+            if(d->bitCount == 0){
+                d->setBitCount(hexLength * 4);
+            }
+
+            byteCount = (d->bitCount + 7) / 8;
+            blocks.resize(std::max(d->blockCount, size_t(1)));
+            header = false;
+        }
+
+        if(hexLength < byteCount * 2 || hexLength % 2){
+            d->errorString = "Invalid fingerprint on line " + boost::lexical_cast<std::string>(lineNumber) + ".";
+            clear();
+            return false;
+        }
+
+        std::fill(blocks.begin(), blocks.end(), 0);
+
+        for(size_t i = 0; i < byteCount; i++){
+            Block byte = 0;
+
+            for(size_t j = 0; j < 2; j++){
+                char c = line[i * 2 + j];
+
+                int value;
+                if(c >= '0' && c <= '9'){
+                    value = c - '0';
+                }
+                else if(c >= 'a' && c <= 'f'){
+                    value = c - 'a' + 10;
+                }
+                else if(c >= 'A' && c <= 'F'){
+                    value = c - 'A' + 10;
+                }
+                else{
+                    d->errorString = "Invalid fingerprint on line " + boost::lexical_cast<std::string>(lineNumber) + ".";
+                    clear();
+                    return false;
+                }
+
+                byte = (byte << 4) | value;
+            }
+
+            blocks[i / 8] |= byte << ((i % 8) * 8);
+        }
+
+        // clear any bits past the end of the fingerprint
+        if(d->bitCount % BlockSize){
+            blocks[d->blockCount - 1] &= (Block(1) << (d->bitCount % BlockSize)) - 1;
+        }
+
+        // the identifier is the second column
+        std::string id;
+        if(hexLength < line.size()){
+            size_t end = std::min(line.find('\t', hexLength + 1), line.size());
+            id = line.substr(hexLength + 1, end - hexLength - 1);
+        }
+
+        d->add(&blocks[0], id);
+    }
+
+    return true;
+}
+
+/// Writes the database to \p fileName in a binary format which can
+/// be mapped into memory by read(). Returns \c false if an error
+/// occurs.
+///
+/// The file must not be the one the database is currently mapped
+/// from.
+bool FingerprintDatabase::write(const std::string &fileName) const
+{
+    std::ofstream output(fileName.c_str(), std::ios::out | std::ios::binary);
+    if(!output.is_open()){
+        d->errorString = "Failed to open '" + fileName + "' for writing.";
+        return false;
+    }
+
+    size_t size = d->size();
+
+    std::vector<boost::uint64_t> bucketOffsets(d->bitCount + 2, 0);
+    for(size_t count = 0; count <= d->bitCount; count++){
+        bucketOffsets[count + 1] = bucketOffsets[count] + d->bucket(count).size;
+    }
+
+    std::vector<boost::uint64_t> positions(size);
+    for(size_t count = 0; count <= d->bitCount; count++){
+        BucketView bucket = d->bucket(count);
+
+        for(size_t i = 0; i < bucket.size; i++){
+            positions[bucket.indices[i]] = bucketOffsets[count] + i;
+        }
+    }
+
+    std::vector<boost::uint64_t> idOffsets(size + 1, 0);
+    for(size_t i = 0; i < size; i++){
+        idOffsets[i + 1] = idOffsets[i] + id(i).size();
+    }
+
+    DatabaseFileHeader header;
+    std::copy(DatabaseFileMagic, DatabaseFileMagic + sizeof(DatabaseFileMagic), header.magic);
+    header.byteOrder = DatabaseFileByteOrder;
+    header.bitCount = d->bitCount;
+    header.size = size;
+    header.idDataSize = idOffsets.back();
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    output.write(reinterpret_cast<const char *>(&bucketOffsets[0]), bucketOffsets.size() * sizeof(boost::uint64_t));
+
+    for(size_t count = 0; count <= d->bitCount; count++){
+        BucketView bucket = d->bucket(count);
+        output.write(reinterpret_cast<const char *>(bucket.blocks), bucket.size * d->blockCount * sizeof(Block));
+    }
+
+    for(size_t count = 0; count <= d->bitCount; count++){
+        BucketView bucket = d->bucket(count);
+        output.write(reinterpret_cast<const char *>(bucket.indices), bucket.size * sizeof(boost::uint64_t));
+    }
+
+    if(size){
+        output.write(reinterpret_cast<const char *>(&positions[0]), size * sizeof(boost::uint64_t));
+    }
+    output.write(reinterpret_cast<const char *>(&idOffsets[0]), idOffsets.size() * sizeof(boost::uint64_t));
+
+    for(size_t i = 0; i < size; i++){
+        output << id(i);
+    }
+
+    if(!output){
+        d->errorString = "Failed to write fingerprint database file.";
+        return false;
+    }
+
+    return true;
+}
+
+// --- Error Handling ------------------------------------------------------ //
+/// Returns a string describing the last error that occurred.
+std::string FingerprintDatabase::errorString() const
+{
+    return d->errorString;
+}
+
+} // end chemkit namespace
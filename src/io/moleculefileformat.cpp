@@ -141,6 +141,34 @@ bool MoleculeFileFormat::readMappedFile(const boost::iostreams::mapped_file_sour
     return false;
 }
 
+/// Returns \c true if the format supports reading molecules one at
+/// a time with readNext().
+///
+/// The default implementation returns \c false.
+bool MoleculeFileFormat::supportsReadNext() const
+{
+    return false;
+}
+
+/// Reads the next molecule from \p input and stores it in
+/// \p molecule. If the end of \p input has been reached \p molecule
+/// is set to a null pointer. Returns \c false if an error occurs.
+///
+/// Unlike read(), this only parses a single record from the input
+/// which allows very large files to be processed with memory bounded
+/// by the size of one molecule.
+///
+/// \see MoleculeFileReader
+bool MoleculeFileFormat::readNext(std::istream &input, boost::shared_ptr<Molecule> &molecule)
+{
+    CHEMKIT_UNUSED(input);
+
+    molecule.reset();
+
+    setErrorString((boost::format("'%s' incremental reading not supported.") % name()).str());
+    return false;
+}
+
 /// Write the contents of \p file to \p output.
 bool MoleculeFileFormat::write(const MoleculeFile *file, std::ostream &output)
 {
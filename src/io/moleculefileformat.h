@@ -43,6 +43,7 @@
 #include <istream>
 #include <ostream>
 
+#include <boost/shared_ptr.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
 
 #include <chemkit/plugin.h>
@@ -50,6 +51,7 @@
 
 namespace chemkit {
 
+class Molecule;
 class MoleculeFile;
 class MoleculeFileFormatPrivate;
 
@@ -69,6 +71,8 @@ public:
     // input and output
     virtual bool read(std::istream &input, MoleculeFile *file);
     virtual bool readMappedFile(const boost::iostreams::mapped_file_source &input, MoleculeFile *file);
+    virtual bool supportsReadNext() const;
+    virtual bool readNext(std::istream &input, boost::shared_ptr<Molecule> &molecule);
     virtual bool write(const MoleculeFile *file, std::ostream &output);
 
     // error handling
@@ -71,6 +71,28 @@ inline MoleculeFileFormatAdaptor<LineFormat>::~MoleculeFileFormatAdaptor()
 
 inline bool MoleculeFileFormatAdaptor<LineFormat>::read(std::istream &input, MoleculeFile *file)
 {
+    for(;;){
+        boost::shared_ptr<Molecule> molecule;
+        readNext(input, molecule);
+        if(!molecule){
+            break;
+        }
+
+        file->addMolecule(molecule);
+    }
+
+    return true;
+}
+
+inline bool MoleculeFileFormatAdaptor<LineFormat>::supportsReadNext() const
+{
+    return true;
+}
+
+inline bool MoleculeFileFormatAdaptor<LineFormat>::readNext(std::istream &input, boost::shared_ptr<Molecule> &molecule)
+{
+    molecule.reset();
+
     while(!input.eof()){
         std::string line;
         std::getline(input, line);
@@ -85,7 +107,7 @@ inline bool MoleculeFileFormatAdaptor<LineFormat>::read(std::istream &input, Mol
         }
 
         std::string formula = lineItems[0];
-        boost::shared_ptr<Molecule> molecule(m_format->read(formula));
+        molecule.reset(m_format->read(formula));
         if(!molecule){
             continue;
         }
@@ -94,7 +116,7 @@ inline bool MoleculeFileFormatAdaptor<LineFormat>::read(std::istream &input, Mol
             molecule->setName(lineItems[1]);
         }
 
-        file->addMolecule(molecule);
+        break;
     }
 
     return true;
@@ -57,6 +57,8 @@ public:
     virtual ~MoleculeFileFormatAdaptor();
 
     virtual bool read(std::istream &input, MoleculeFile *file) CHEMKIT_OVERRIDE;
+    virtual bool supportsReadNext() const CHEMKIT_OVERRIDE;
+    virtual bool readNext(std::istream &input, boost::shared_ptr<Molecule> &molecule) CHEMKIT_OVERRIDE;
     virtual bool write(const MoleculeFile *file, std::ostream &output) CHEMKIT_OVERRIDE;
 
 private:
@@ -0,0 +1,440 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculefilereader.h"
+
+#include <fstream>
+
+#include <boost/iostreams/filtering_stream.hpp>
+
+#ifndef CHEMKIT_OS_WIN32
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#endif
+
+#include <chemkit/molecule.h>
+
+#include "moleculefile.h"
+#include "moleculefileformat.h"
+
+namespace chemkit {
+
+// === MoleculeFileReaderPrivate =========================================== //
+class MoleculeFileReaderPrivate
+{
+public:
+    bool openStream(std::istream &input);
+
+    MoleculeFile file;
+    std::ifstream fileStream;
+    boost::iostreams::filtering_istream inputStream;
+    std::istream *stream;
+    bool isOpen;
+    bool atEnd;
+    bool readAll;
+    size_t position;
+    std::string errorString;
+};
+
+// Sets up the input stream for reading from \p input. If the format
+// cannot read molecules incrementally the entire input is read into
+// the file and the molecules are returned from there.
+bool MoleculeFileReaderPrivate::openStream(std::istream &input)
+{
+    MoleculeFileFormat *format = file.format();
+    if(!format){
+        errorString = "No file format set for reading.";
+        return false;
+    }
+
+    isOpen = true;
+    atEnd = false;
+    errorString.clear();
+    position = 0;
+    readAll = !format->supportsReadNext();
+
+    if(readAll){
+        bool ok = file.read(input);
+        if(!ok){
+            errorString = file.errorString();
+            atEnd = true;
+        }
+
+        return ok;
+    }
+
+    // uncompressed input is read directly so that it remains seekable
+    if(file.compressionFormat().empty()){
+        stream = &input;
+        return true;
+    }
+
+    // insert stream decompressor
+#ifndef CHEMKIT_OS_WIN32
+    if(file.compressionFormat() == "gz"){
+        inputStream.push(boost::iostreams::gzip_decompressor());
+    }
+    else if(file.compressionFormat() == "bz2"){
+        inputStream.push(boost::iostreams::bzip2_decompressor());
+    }
+#endif
+
+    // insert input stream
+    inputStream.push(input);
+    stream = &inputStream;
+
+    return true;
+}
+
+// === MoleculeFileReader ================================================== //
+/// \class MoleculeFileReader moleculefilereader.h chemkit/moleculefilereader.h
+/// \ingroup chemkit-io
+/// \brief The MoleculeFileReader class reads molecules from a file
+///        one at a time.
+///
+/// Unlike MoleculeFile, which reads every molecule in a file into
+/// memory before returning, the molecule file reader parses a single
+/// record each time readNext() is called. This allows very large
+/// files to be processed with memory bounded by the size of one
+/// molecule. Compressed files (e.g. "compounds.sdf.gz") are
+/// decompressed as they are read.
+///
+/// The following example shows how to read each molecule from an
+/// SDF file:
+/// \code
+/// MoleculeFileReader reader("compounds.sdf");
+/// if(!reader.open()){
+///     std::cerr << reader.errorString() << std::endl;
+/// }
+///
+/// while(boost::shared_ptr<Molecule> molecule = reader.readNext()){
+///     std::cout << molecule->formula() << std::endl;
+/// }
+/// \endcode
+///
+/// The reader also provides a single-pass iterator so the molecules
+/// can be visited using foreach:
+/// \code
+/// foreach(const boost::shared_ptr<Molecule> &molecule, reader){
+///     ...
+/// }
+/// \endcode
+///
+/// Formats which do not support incremental reading (see
+/// MoleculeFileFormat::supportsReadNext()) are read completely when
+/// the reader is opened.
+///
+/// \see MoleculeFile
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new molecule file reader.
+MoleculeFileReader::MoleculeFileReader()
+    : d(new MoleculeFileReaderPrivate)
+{
+    d->stream = 0;
+    d->isOpen = false;
+    d->atEnd = true;
+    d->readAll = false;
+    d->position = 0;
+}
+
+/// Creates a new molecule file reader for \p fileName. The file
+/// format is determined from the suffix of \p fileName.
+MoleculeFileReader::MoleculeFileReader(const std::string &fileName)
+    : d(new MoleculeFileReaderPrivate)
+{
+    d->stream = 0;
+    d->isOpen = false;
+    d->atEnd = true;
+    d->readAll = false;
+    d->position = 0;
+    d->file.setFileName(fileName);
+}
+
+/// Destroys the molecule file reader.
+MoleculeFileReader::~MoleculeFileReader()
+{
+    close();
+
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the file name for the reader.
+std::string MoleculeFileReader::fileName() const
+{
+    return d->file.fileName();
+}
+
+/// Sets the format for the reader to \p formatName. Returns \c false
+/// if \p formatName is not supported.
+bool MoleculeFileReader::setFormat(const std::string &formatName)
+{
+    bool ok = d->file.setFormat(formatName);
+    if(!ok){
+        d->errorString = d->file.errorString();
+    }
+
+    return ok;
+}
+
+/// Returns the format for the reader.
+MoleculeFileFormat* MoleculeFileReader::format() const
+{
+    return d->file.format();
+}
+
+/// Returns the name of the format for the reader.
+std::string MoleculeFileReader::formatName() const
+{
+    return d->file.formatName();
+}
+
+/// Sets the compression format for the reader to \p name.
+bool MoleculeFileReader::setCompressionFormat(const std::string &name)
+{
+    return d->file.setCompressionFormat(name);
+}
+
+/// Returns the compression format for the reader.
+std::string MoleculeFileReader::compressionFormat() const
+{
+    return d->file.compressionFormat();
+}
+
+// --- Input --------------------------------------------------------------- //
+/// Opens the file for reading. Returns \c false if no file name is
+/// set or if the file could not be opened.
+bool MoleculeFileReader::open()
+{
+    close();
+
+    if(d->file.fileName().empty()){
+        d->errorString = "No file name set for reading.";
+        return false;
+    }
+
+    d->fileStream.open(d->file.fileName().c_str(), std::ios::in | std::ios::binary);
+    if(!d->fileStream.is_open()){
+        d->errorString = "Failed to open file for reading.";
+        return false;
+    }
+
+    return d->openStream(d->fileStream);
+}
+
+/// Opens \p fileName for reading. The file format is determined from
+/// the suffix of \p fileName.
+bool MoleculeFileReader::open(const std::string &fileName)
+{
+    close();
+
+    d->file.setFormat(0);
+    if(!d->file.setFileName(fileName)){
+        d->errorString = d->file.errorString();
+        return false;
+    }
+
+    return open();
+}
+
+/// Opens \p input for reading. The format must be set with
+/// setFormat() before calling this method. The input stream must
+/// remain valid until the reader is closed.
+bool MoleculeFileReader::open(std::istream &input)
+{
+    close();
+
+    return d->openStream(input);
+}
+
+/// Closes the reader.
+void MoleculeFileReader::close()
+{
+    d->inputStream.reset();
+    d->stream = 0;
+    if(d->fileStream.is_open()){
+        d->fileStream.close();
+    }
+    d->fileStream.clear();
+    d->file.clear();
+
+    d->isOpen = false;
+    d->atEnd = true;
+    d->position = 0;
+}
+
+/// Returns \c true if the reader is open.
+bool MoleculeFileReader::isOpen() const
+{
+    return d->isOpen;
+}
+
+/// Returns \c true if the end of the input has been reached.
+bool MoleculeFileReader::atEnd() const
+{
+    return d->atEnd;
+}
+
+/// Reads and returns the next molecule. Returns a null pointer if
+/// the end of the input has been reached or an error occurred.
+///
+/// When a record cannot be read the error is available from
+/// errorString() until the next call to readNext(). Some formats
+/// (e.g. SDF) move past the invalid record, in which case atEnd()
+/// remains \c false and the following molecules can be read by
+/// calling readNext() again:
+/// \code
+/// while(!reader.atEnd()){
+///     boost::shared_ptr<Molecule> molecule = reader.readNext();
+///     if(molecule){
+///         ...
+///     }
+///     else if(!reader.errorString().empty()){
+///         std::cerr << reader.errorString() << std::endl;
+///     }
+/// }
+/// \endcode
+///
+/// Otherwise reading stops at the first invalid record.
+boost::shared_ptr<Molecule> MoleculeFileReader::readNext()
+{
+    boost::shared_ptr<Molecule> molecule;
+
+    if(d->atEnd){
+        return molecule;
+    }
+
+    if(d->readAll){
+        if(d->position < d->file.moleculeCount()){
+            molecule = d->file.molecule(d->position);
+        }
+    }
+    else{
+        d->errorString.clear();
+
+        bool ok = d->file.format()->readNext(*d->stream, molecule);
+        if(!ok){
+            d->errorString = d->file.format()->errorString();
+
+            // reading can continue if the format was able to skip
+            // past the invalid record
+            if(d->stream->good() && d->stream->peek() != std::char_traits<char>::eof()){
+                return boost::shared_ptr<Molecule>();
+            }
+
+            molecule.reset();
+        }
+    }
+
+    if(!molecule){
+        d->atEnd = true;
+        return molecule;
+    }
+
+    d->position++;
+
+    return molecule;
+}
+
+/// Returns the number of molecules read so far.
+size_t MoleculeFileReader::position() const
+{
+    return d->position;
+}
+
+/// Returns \c true if the reader supports tell() and seek(). This
+/// is the case for uncompressed input in formats which can be read
+/// incrementally.
+bool MoleculeFileReader::isSeekable() const
+{
+    return d->isOpen && !d->readAll && d->stream != &d->inputStream;
+}
+
+/// Returns the offset in the input of the next molecule to be read
+/// or \c -1 if the reader is not seekable.
+///
+/// \see seek()
+std::streamoff MoleculeFileReader::tell() const
+{
+    if(!isSeekable() || d->atEnd){
+        return -1;
+    }
+
+    return std::streamoff(d->stream->tellg());
+}
+
+/// Moves the reader to \p offset which must have been previously
+/// returned from tell(). The next call to readNext() will read the
+/// molecule at \p offset. Returns \c false if the reader is not
+/// seekable.
+bool MoleculeFileReader::seek(std::streamoff offset)
+{
+    if(!isSeekable()){
+        d->errorString = "Reader does not support seeking.";
+        return false;
+    }
+
+    d->stream->clear();
+    d->stream->seekg(offset);
+    if(d->stream->fail()){
+        d->errorString = "Failed to seek to offset.";
+        return false;
+    }
+
+    d->atEnd = false;
+    return true;
+}
+
+/// Returns an iterator which reads the molecules from the reader.
+MoleculeFileReader::iterator MoleculeFileReader::begin()
+{
+    return iterator(this);
+}
+
+/// Returns an iterator to the end of the input.
+MoleculeFileReader::iterator MoleculeFileReader::end()
+{
+    return iterator();
+}
+
+// --- Error Handling ------------------------------------------------------ //
+/// Returns a string describing the last error that occurred.
+std::string MoleculeFileReader::errorString() const
+{
+    return d->errorString;
+}
+
+} // end chemkit namespace
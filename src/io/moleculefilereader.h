@@ -0,0 +1,127 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_MOLECULEFILEREADER_H
+#define CHEMKIT_MOLECULEFILEREADER_H
+
+#include "io.h"
+
+#include <string>
+#include <istream>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+namespace chemkit {
+
+class Molecule;
+class MoleculeFileFormat;
+class MoleculeFileReaderPrivate;
+
+class CHEMKIT_IO_EXPORT MoleculeFileReader
+{
+public:
+    // iterator
+    class iterator : public boost::iterator_facade<iterator,
+                                                   const boost::shared_ptr<Molecule>,
+                                                   boost::single_pass_traversal_tag>
+    {
+    public:
+        iterator() : m_reader(0) { }
+        explicit iterator(MoleculeFileReader *reader) : m_reader(reader) { increment(); }
+
+    private:
+        friend class boost::iterator_core_access;
+
+        void increment()
+        {
+            m_molecule = m_reader->readNext();
+            if(!m_molecule){
+                m_reader = 0;
+            }
+        }
+
+        bool equal(const iterator &other) const { return m_reader == other.m_reader; }
+        const boost::shared_ptr<Molecule>& dereference() const { return m_molecule; }
+
+    private:
+        MoleculeFileReader *m_reader;
+        boost::shared_ptr<Molecule> m_molecule;
+    };
+
+    // typedefs
+    typedef iterator const_iterator;
+
+    // construction and destruction
+    MoleculeFileReader();
+    MoleculeFileReader(const std::string &fileName);
+    ~MoleculeFileReader();
+
+    // properties
+    std::string fileName() const;
+    bool setFormat(const std::string &formatName);
+    MoleculeFileFormat* format() const;
+    std::string formatName() const;
+    bool setCompressionFormat(const std::string &name);
+    std::string compressionFormat() const;
+
+    // input
+    bool open();
+    bool open(const std::string &fileName);
+    bool open(std::istream &input);
+    void close();
+    bool isOpen() const;
+    bool atEnd() const;
+    boost::shared_ptr<Molecule> readNext();
+    size_t position() const;
+    bool isSeekable() const;
+    std::streamoff tell() const;
+    bool seek(std::streamoff offset);
+    iterator begin();
+    iterator end();
+
+    // error handling
+    std::string errorString() const;
+
+private:
+    CHEMKIT_DISABLE_COPY(MoleculeFileReader)
+
+private:
+    MoleculeFileReaderPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_MOLECULEFILEREADER_H
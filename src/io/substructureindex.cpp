@@ -0,0 +1,548 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "substructureindex.h"
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/filesystem.hpp>
+
+#include <chemkit/foreach.h>
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+#include <chemkit/substructurequery.h>
+
+#include "moleculefilereader.h"
+
+namespace chemkit {
+
+namespace {
+
+// identifies substructure index files, the last character is the
+// version of the file format
+const char IndexFileMagic[8] = { 'C', 'K', 'S', 'S', 'I', 'D', 'X', '1' };
+
+template<typename T>
+void writeValue(std::ostream &output, const T &value)
+{
+    output.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::istream &input, T &value)
+{
+    input.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return input.good();
+}
+
+void writeString(std::ostream &output, const std::string &string)
+{
+    writeValue(output, boost::uint32_t(string.size()));
+    output.write(string.c_str(), string.size());
+}
+
+bool readString(std::istream &input, std::string &string)
+{
+    boost::uint32_t size;
+    if(!readValue(input, size)){
+        return false;
+    }
+
+    string.resize(size);
+    if(size){
+        input.read(&string[0], size);
+    }
+
+    return input.good();
+}
+
+} // end anonymous namespace
+
+// === SubstructureIndexPrivate ============================================ //
+class SubstructureIndexPrivate
+{
+public:
+    bool updateFileStatus(boost::uint64_t &size, boost::int64_t &time) const;
+
+    std::string fileName;
+    std::string fingerprintName;
+    size_t fingerprintSize;
+    size_t blockCount;
+    std::vector<Bitset::block_type> blocks;
+    std::vector<boost::int64_t> offsets;
+    boost::uint64_t fileSize;
+    boost::int64_t fileTime;
+    MoleculeFileReader reader;
+    std::string errorString;
+};
+
+// Gets the current size and modification time of the indexed file.
+bool SubstructureIndexPrivate::updateFileStatus(boost::uint64_t &size, boost::int64_t &time) const
+{
+    boost::system::error_code error;
+
+    size = boost::filesystem::file_size(fileName, error);
+    if(error){
+        return false;
+    }
+
+    time = boost::filesystem::last_write_time(fileName, error);
+    if(error){
+        return false;
+    }
+
+    return true;
+}
+
+// === SubstructureIndex =================================================== //
+/// \class SubstructureIndex substructureindex.h chemkit/substructureindex.h
+/// \ingroup chemkit-io
+/// \brief The SubstructureIndex class provides a fingerprint index
+///        for fast substructure searching of molecule files.
+///
+/// The index stores a screening fingerprint for each molecule in a
+/// file. Before running the full isomorphism test for a query, the
+/// molecules whose fingerprints do not contain every bit from the
+/// query's fingerprint are rejected. The fingerprint must have the
+/// property that the bits for a substructure are a subset of the bits
+/// for any molecule which contains it. The default "screening"
+/// fingerprint satisfies this for each SubstructureQuery mode.
+///
+/// Once built, the index can be written to disk with write() and
+/// loaded with read() so that later searches of the same file do not
+/// need to parse the file to create the fingerprints. For uncompressed
+/// files the offset of each molecule is also stored which allows the
+/// candidates to be read directly without parsing the rest of the
+/// file.
+///
+/// For example, to search a file for molecules containing a phenol
+/// group:
+/// \code
+/// SubstructureIndex index;
+/// if(!index.read("compounds.idx") || !index.isCurrent()){
+///     index.build("compounds.sdf");
+///     index.write("compounds.idx");
+/// }
+///
+/// SubstructureQuery query("c1ccccc1O", "smiles");
+/// std::vector<boost::shared_ptr<Molecule> > matches = index.search(query);
+/// \endcode
+///
+/// \see SubstructureQuery
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty substructure index.
+SubstructureIndex::SubstructureIndex()
+    : d(new SubstructureIndexPrivate)
+{
+    d->fingerprintName = "screening";
+    d->fingerprintSize = 0;
+    d->blockCount = 0;
+    d->fileSize = 0;
+    d->fileTime = 0;
+}
+
+/// Destroys the substructure index.
+SubstructureIndex::~SubstructureIndex()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the name of the indexed file.
+std::string SubstructureIndex::fileName() const
+{
+    return d->fileName;
+}
+
+/// Returns the number of molecules in the index.
+size_t SubstructureIndex::size() const
+{
+    return d->offsets.size();
+}
+
+/// Returns \c true if the index contains no molecules.
+bool SubstructureIndex::isEmpty() const
+{
+    return size() == 0;
+}
+
+/// Sets the name of the fingerprint used by the index to \p name.
+/// This takes effect the next time the index is built.
+void SubstructureIndex::setFingerprintName(const std::string &name)
+{
+    d->fingerprintName = name;
+}
+
+/// Returns the name of the fingerprint used by the index.
+std::string SubstructureIndex::fingerprintName() const
+{
+    return d->fingerprintName;
+}
+
+/// Returns the fingerprint for the molecule at \p index.
+Bitset SubstructureIndex::fingerprint(size_t index) const
+{
+    if(index >= size()){
+        return Bitset();
+    }
+
+    std::vector<Bitset::block_type>::const_iterator begin = d->blocks.begin() + index * d->blockCount;
+
+    Bitset fingerprint(d->fingerprintSize);
+    boost::from_block_range(begin, begin + d->blockCount, fingerprint);
+
+    return fingerprint;
+}
+
+// --- Index --------------------------------------------------------------- //
+/// Builds the index for the molecules in \p fileName. Returns
+/// \c false if an error occurs.
+bool SubstructureIndex::build(const std::string &fileName)
+{
+    clear();
+
+    boost::scoped_ptr<Fingerprint> fingerprint(Fingerprint::create(d->fingerprintName));
+    if(!fingerprint){
+        d->errorString = "Fingerprint '" + d->fingerprintName + "' is not supported.";
+        return false;
+    }
+
+    MoleculeFileReader reader(fileName);
+    if(!reader.open()){
+        d->errorString = reader.errorString();
+        return false;
+    }
+
+    d->fileName = fileName;
+    d->fingerprintSize = fingerprint->size();
+    d->blockCount = Bitset(d->fingerprintSize).num_blocks();
+
+    for(;;){
+        boost::int64_t offset = reader.tell();
+
+        boost::shared_ptr<Molecule> molecule = reader.readNext();
+        if(!molecule){
+            break;
+        }
+
+        Bitset value = fingerprint->value(molecule.get());
+        value.resize(d->fingerprintSize);
+        boost::to_block_range(value, std::back_inserter(d->blocks));
+
+        d->offsets.push_back(offset);
+    }
+
+    if(!reader.errorString().empty()){
+        d->errorString = reader.errorString();
+        clear();
+        return false;
+    }
+
+    d->updateFileStatus(d->fileSize, d->fileTime);
+
+    return true;
+}
+
+/// Reads the index from \p indexFileName. Returns \c false if an
+/// error occurs.
+bool SubstructureIndex::read(const std::string &indexFileName)
+{
+    clear();
+
+    std::ifstream input(indexFileName.c_str(), std::ios::in | std::ios::binary);
+    if(!input.is_open()){
+        d->errorString = "Failed to open index file for reading.";
+        return false;
+    }
+
+    char magic[sizeof(IndexFileMagic)];
+    input.read(magic, sizeof(magic));
+    if(!input.good() || !std::equal(magic, magic + sizeof(magic), IndexFileMagic)){
+        d->errorString = "File is not a substructure index.";
+        return false;
+    }
+
+    std::string fingerprintName;
+    std::string fileName;
+    boost::uint64_t fileSize;
+    boost::int64_t fileTime;
+    boost::uint32_t fingerprintSize;
+    boost::uint32_t blockSize;
+    boost::uint64_t count;
+
+    if(!readString(input, fingerprintName) ||
+       !readString(input, fileName) ||
+       !readValue(input, fileSize) ||
+       !readValue(input, fileTime) ||
+       !readValue(input, fingerprintSize) ||
+       !readValue(input, blockSize) ||
+       !readValue(input, count)){
+        d->errorString = "Failed to read index header.";
+        return false;
+    }
+
+    if(blockSize != sizeof(Bitset::block_type)){
+        d->errorString = "Index was written on an incompatible platform.";
+        return false;
+    }
+
+    size_t blockCount = Bitset(fingerprintSize).num_blocks();
+
+    d->offsets.resize(count);
+    d->blocks.resize(count * blockCount);
+
+    if(count){
+        input.read(reinterpret_cast<char *>(&d->offsets[0]), count * sizeof(boost::int64_t));
+        input.read(reinterpret_cast<char *>(&d->blocks[0]), d->blocks.size() * sizeof(Bitset::block_type));
+    }
+
+    if(!input){
+        clear();
+        d->errorString = "Failed to read index data.";
+        return false;
+    }
+
+    d->fileName = fileName;
+    d->fingerprintName = fingerprintName;
+    d->fingerprintSize = fingerprintSize;
+    d->blockCount = blockCount;
+    d->fileSize = fileSize;
+    d->fileTime = fileTime;
+
+    return true;
+}
+
+/// Writes the index to \p indexFileName. Returns \c false if an
+/// error occurs.
+bool SubstructureIndex::write(const std::string &indexFileName) const
+{
+    std::ofstream output(indexFileName.c_str(), std::ios::out | std::ios::binary);
+    if(!output.is_open()){
+        d->errorString = "Failed to open index file for writing.";
+        return false;
+    }
+
+    output.write(IndexFileMagic, sizeof(IndexFileMagic));
+    writeString(output, d->fingerprintName);
+    writeString(output, d->fileName);
+    writeValue(output, d->fileSize);
+    writeValue(output, d->fileTime);
+    writeValue(output, boost::uint32_t(d->fingerprintSize));
+    writeValue(output, boost::uint32_t(sizeof(Bitset::block_type)));
+    writeValue(output, boost::uint64_t(size()));
+
+    if(!isEmpty()){
+        output.write(reinterpret_cast<const char *>(&d->offsets[0]), d->offsets.size() * sizeof(boost::int64_t));
+        output.write(reinterpret_cast<const char *>(&d->blocks[0]), d->blocks.size() * sizeof(Bitset::block_type));
+    }
+
+    if(!output){
+        d->errorString = "Failed to write index file.";
+        return false;
+    }
+
+    return true;
+}
+
+/// Returns \c true if the indexed file has not been modified since
+/// the index was built.
+bool SubstructureIndex::isCurrent() const
+{
+    if(d->fileName.empty()){
+        return false;
+    }
+
+    boost::uint64_t size;
+    boost::int64_t time;
+    if(!d->updateFileStatus(size, time)){
+        return false;
+    }
+
+    return size == d->fileSize && time == d->fileTime;
+}
+
+/// Removes all of the molecules from the index.
+void SubstructureIndex::clear()
+{
+    d->reader.close();
+    d->fileName.clear();
+    d->fingerprintSize = 0;
+    d->blockCount = 0;
+    d->blocks.clear();
+    d->offsets.clear();
+    d->fileSize = 0;
+    d->fileTime = 0;
+}
+
+// --- Screening ----------------------------------------------------------- //
+/// Returns the indices of the molecules which may match \p query.
+/// Molecules which are not in the returned list are guaranteed not
+/// to match.
+///
+/// The fingerprints encode the bonds between atoms so queries with
+/// the SubstructureQuery::CompareAtomsOnly flag cannot be screened
+/// and every molecule is returned as a candidate.
+std::vector<size_t> SubstructureIndex::candidates(const SubstructureQuery &query) const
+{
+    std::vector<size_t> candidates;
+
+    const boost::shared_ptr<Molecule> &queryMolecule = query.molecule();
+    if(!queryMolecule){
+        return candidates;
+    }
+
+    if(query.flags() & SubstructureQuery::CompareAtomsOnly){
+        for(size_t i = 0; i < size(); i++){
+            candidates.push_back(i);
+        }
+
+        return candidates;
+    }
+
+    // calculate the fingerprint for the query
+    Bitset queryFingerprint;
+    boost::scoped_ptr<Fingerprint> fingerprint(Fingerprint::create(d->fingerprintName));
+    if(fingerprint){
+        queryFingerprint = fingerprint->value(queryMolecule.get());
+    }
+
+    // every molecule is a candidate if the query cannot be screened
+    if(queryFingerprint.size() != d->fingerprintSize){
+        for(size_t i = 0; i < size(); i++){
+            candidates.push_back(i);
+        }
+
+        return candidates;
+    }
+
+    std::vector<Bitset::block_type> queryBlocks;
+    boost::to_block_range(queryFingerprint, std::back_inserter(queryBlocks));
+
+    // only the blocks with bits set in the query need to be checked
+    std::vector<size_t> queryBlockIndices;
+    for(size_t i = 0; i < queryBlocks.size(); i++){
+        if(queryBlocks[i]){
+            queryBlockIndices.push_back(i);
+        }
+    }
+
+    for(size_t i = 0; i < size(); i++){
+        const Bitset::block_type *blocks = &d->blocks[i * d->blockCount];
+
+        bool candidate = true;
+        for(size_t j = 0; j < queryBlockIndices.size(); j++){
+            size_t block = queryBlockIndices[j];
+
+            if(queryBlocks[block] & ~blocks[block]){
+                candidate = false;
+                break;
+            }
+        }
+
+        if(candidate){
+            candidates.push_back(i);
+        }
+    }
+
+    return candidates;
+}
+
+/// Reads and returns the molecule at \p index from the indexed file.
+/// Returns a null pointer if an error occurs.
+boost::shared_ptr<Molecule> SubstructureIndex::molecule(size_t index)
+{
+    if(index >= size()){
+        return boost::shared_ptr<Molecule>();
+    }
+
+    if(!d->reader.isOpen() && !d->reader.open(d->fileName)){
+        d->errorString = d->reader.errorString();
+        return boost::shared_ptr<Molecule>();
+    }
+
+    // read the molecule directly from its offset
+    if(d->reader.isSeekable() && d->offsets[index] >= 0){
+        if(!d->reader.seek(d->offsets[index])){
+            d->errorString = d->reader.errorString();
+            return boost::shared_ptr<Molecule>();
+        }
+
+        return d->reader.readNext();
+    }
+
+    // otherwise read up to the molecule from the start of the file
+    if(d->reader.position() > index || d->reader.atEnd()){
+        d->reader.open(d->fileName);
+    }
+
+    while(d->reader.position() < index){
+        if(!d->reader.readNext()){
+            d->errorString = d->reader.errorString();
+            return boost::shared_ptr<Molecule>();
+        }
+    }
+
+    return d->reader.readNext();
+}
+
+/// Returns each molecule in the indexed file which matches \p query.
+std::vector<boost::shared_ptr<Molecule> > SubstructureIndex::search(const SubstructureQuery &query)
+{
+    std::vector<boost::shared_ptr<Molecule> > matches;
+
+    foreach(size_t index, candidates(query)){
+        boost::shared_ptr<Molecule> molecule = this->molecule(index);
+
+        if(molecule && query.matches(molecule.get())){
+            matches.push_back(molecule);
+        }
+    }
+
+    return matches;
+}
+
+// --- Error Handling ------------------------------------------------------ //
+/// Returns a string describing the last error that occurred.
+std::string SubstructureIndex::errorString() const
+{
+    return d->errorString;
+}
+
+} // end chemkit namespace
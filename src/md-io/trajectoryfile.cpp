@@ -35,18 +35,150 @@
 
 #include "trajectoryfile.h"
 
+#include <fstream>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/filesystem.hpp>
+
+#include <chemkit/topology.h>
 #include <chemkit/trajectory.h>
+#include <chemkit/trajectoryframe.h>
+#include <chemkit/trajectorystore.h>
 
 namespace chemkit {
 
+namespace {
+
+// identifies frame index files, the last character is the version
+// of the file format
+const char FrameIndexMagic[8] = { 'C', 'K', 'T', 'R', 'I', 'D', 'X', '1' };
+
+// Reads frames on demand from a memory mapped trajectory file.
+class TrajectoryFileStore : public TrajectoryStore
+{
+public:
+    TrajectoryFileStore(const boost::iostreams::mapped_file_source &file,
+                        TrajectoryFileFormat *format,
+                        const std::vector<size_t> &offsets,
+                        size_t size)
+        : m_file(file),
+          m_format(format),
+          m_offsets(offsets),
+          m_size(size)
+    {
+    }
+
+    ~TrajectoryFileStore()
+    {
+        delete m_format;
+    }
+
+    size_t size() const CHEMKIT_OVERRIDE
+    {
+        return m_size;
+    }
+
+    size_t frameCount() const CHEMKIT_OVERRIDE
+    {
+        return m_offsets.size();
+    }
+
+    bool readFrame(size_t index, TrajectoryFrame *frame) CHEMKIT_OVERRIDE
+    {
+        return m_format->readFrame(m_file, m_offsets[index], frame);
+    }
+
+private:
+    boost::iostreams::mapped_file_source m_file;
+    TrajectoryFileFormat *m_format;
+    std::vector<size_t> m_offsets;
+    size_t m_size;
+};
+
+} // end anonymous namespace
+
 // === TrajectoryFilePrivate =============================================== //
 class TrajectoryFilePrivate
 {
 public:
+    bool readFrameIndex(const std::string &fileName, boost::uint64_t fileSize, boost::int64_t fileTime);
+    void writeFrameIndex(const std::string &fileName, boost::uint64_t fileSize, boost::int64_t fileTime) const;
+
     boost::shared_ptr<Trajectory> trajectory;
     boost::shared_ptr<Topology> topology;
+    boost::iostreams::mapped_file_source mappedFile;
+    std::vector<size_t> frameOffsets;
+    bool frameIndexCacheEnabled;
 };
 
+// Reads the frame offsets from the index in fileName. Returns false
+// if the index does not exist or was built for a different version
+// of the trajectory file.
+bool TrajectoryFilePrivate::readFrameIndex(const std::string &fileName,
+                                           boost::uint64_t fileSize,
+                                           boost::int64_t fileTime)
+{
+    std::ifstream input(fileName.c_str(), std::ios::in | std::ios::binary);
+    if(!input.is_open()){
+        return false;
+    }
+
+    char magic[sizeof(FrameIndexMagic)];
+    boost::uint64_t indexFileSize = 0;
+    boost::int64_t indexFileTime = 0;
+    boost::uint64_t count = 0;
+
+    input.read(magic, sizeof(magic));
+    input.read(reinterpret_cast<char *>(&indexFileSize), sizeof(indexFileSize));
+    input.read(reinterpret_cast<char *>(&indexFileTime), sizeof(indexFileTime));
+    input.read(reinterpret_cast<char *>(&count), sizeof(count));
+
+    if(!input ||
+       !std::equal(magic, magic + sizeof(magic), FrameIndexMagic) ||
+       indexFileSize != fileSize ||
+       indexFileTime != fileTime){
+        return false;
+    }
+
+    std::vector<boost::uint64_t> offsets(count);
+    if(count){
+        input.read(reinterpret_cast<char *>(&offsets[0]), count * sizeof(boost::uint64_t));
+    }
+
+    if(!input){
+        return false;
+    }
+
+    frameOffsets.assign(offsets.begin(), offsets.end());
+
+    return true;
+}
+
+// Writes the frame offsets to the index in fileName. Failing to write
+// the index is not an error as it can always be rebuilt.
+void TrajectoryFilePrivate::writeFrameIndex(const std::string &fileName,
+                                            boost::uint64_t fileSize,
+                                            boost::int64_t fileTime) const
+{
+    std::ofstream output(fileName.c_str(), std::ios::out | std::ios::binary);
+    if(!output.is_open()){
+        return;
+    }
+
+    std::vector<boost::uint64_t> offsets(frameOffsets.begin(), frameOffsets.end());
+    boost::uint64_t count = offsets.size();
+
+    output.write(FrameIndexMagic, sizeof(FrameIndexMagic));
+    output.write(reinterpret_cast<const char *>(&fileSize), sizeof(fileSize));
+    output.write(reinterpret_cast<const char *>(&fileTime), sizeof(fileTime));
+    output.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    if(count){
+        output.write(reinterpret_cast<const char *>(&offsets[0]), count * sizeof(boost::uint64_t));
+    }
+}
+
 // === TrajectoryFile ====================================================== //
 /// \class TrajectoryFile trajectoryfile.h chemkit/trajectoryfile.h
 /// \ingroup chemkit-md-io
@@ -55,6 +187,24 @@ public:
 /// A list of supported trajectory file formats is available at:
 /// http://wiki.chemkit.org/Features#Trajectory_File_Formats
 ///
+/// Trajectory files can either be read completely into memory with
+/// read() or opened with open() which allows individual frames to
+/// be read on demand with readFrame() and readFrames() or through
+/// the file's trajectory(). The latter memory maps the file and only
+/// decodes the requested frames which makes it possible to work with
+/// trajectories larger than the available memory. Frame access is
+/// only available for formats which support it (e.g. xtc and mdcrd)
+/// and for uncompressed files.
+///
+/// \code
+/// chemkit::TrajectoryFile file("md.xtc");
+/// file.open();
+///
+/// // read every tenth frame
+/// boost::shared_ptr<chemkit::Trajectory> trajectory =
+///     file.readFrames(0, file.frameCount(), 10);
+/// \endcode
+///
 /// \see Trajectory, TrajectoryFileFormat
 
 // --- Construction and Destruction ---------------------------------------- //
@@ -62,6 +212,7 @@ public:
 TrajectoryFile::TrajectoryFile()
     : d(new TrajectoryFilePrivate)
 {
+    d->frameIndexCacheEnabled = false;
 }
 
 /// Creates a new trajectory file with \p fileName.
@@ -69,11 +220,14 @@ TrajectoryFile::TrajectoryFile(const std::string &fileName)
     : GenericFile<TrajectoryFile, TrajectoryFileFormat>(fileName),
       d(new TrajectoryFilePrivate)
 {
+    d->frameIndexCacheEnabled = false;
 }
 
 /// Destroys the trajectory file object.
 TrajectoryFile::~TrajectoryFile()
 {
+    close();
+
     delete d;
 }
 
@@ -110,4 +264,202 @@ boost::shared_ptr<Trajectory> TrajectoryFile::trajectory() const
     return d->trajectory;
 }
 
+// --- Frame Access -------------------------------------------------------- //
+/// Opens the file for frame access. The file is memory mapped and
+/// the offset of each frame is located without decoding the frames.
+/// Returns \c false if the file cannot be opened or if its format
+/// does not support frame access.
+///
+/// Once open, trajectory() returns a trajectory which reads its
+/// frames from the file as they are accessed and keeps at most
+/// Trajectory::cacheSize() bytes of them in memory. The trajectory
+/// remains usable after the file is closed.
+///
+/// If the frame index cache is enabled the frame offsets are read
+/// from (or written to) frameIndexFileName() so that subsequent
+/// opens do not need to scan the file.
+///
+/// \see readFrame(), readFrames(), close()
+bool TrajectoryFile::open()
+{
+    close();
+
+    if(fileName().empty()){
+        setErrorString("No file name set for reading.");
+        return false;
+    }
+    else if(!format()){
+        setErrorString("No file format set for reading.");
+        return false;
+    }
+    else if(!format()->supportsFrameAccess()){
+        setErrorString("Frame access is not supported by the '" + formatName() + "' format.");
+        return false;
+    }
+    else if(!compressionFormat().empty()){
+        setErrorString("Frame access is not supported for compressed files.");
+        return false;
+    }
+
+    try {
+        d->mappedFile.open(fileName());
+    }
+    catch(std::exception &e){
+        setErrorString(std::string("Failed to map file: ") + e.what());
+        return false;
+    }
+
+    boost::system::error_code error;
+    boost::uint64_t fileSize = d->mappedFile.size();
+    boost::int64_t fileTime = boost::filesystem::last_write_time(fileName(), error);
+
+    if(!d->frameIndexCacheEnabled ||
+       !d->readFrameIndex(frameIndexFileName(), fileSize, fileTime)){
+        if(!format()->readFrameOffsets(d->mappedFile, this, d->frameOffsets)){
+            setErrorString(format()->errorString());
+            close();
+            return false;
+        }
+
+        if(d->frameIndexCacheEnabled){
+            d->writeFrameIndex(frameIndexFileName(), fileSize, fileTime);
+        }
+    }
+
+    // the number of particles is taken from the topology or else
+    // from the first frame
+    size_t size = 0;
+    if(d->topology){
+        size = d->topology->size();
+    }
+    else if(!d->frameOffsets.empty()){
+        Trajectory first;
+        if(!readFrame(0, first.addFrame())){
+            close();
+            return false;
+        }
+
+        size = first.size();
+    }
+
+    // create a trajectory which reads its frames from the file
+    TrajectoryFileFormat *storeFormat = TrajectoryFileFormat::create(formatName());
+    boost::shared_ptr<TrajectoryStore> store(new TrajectoryFileStore(d->mappedFile, storeFormat, d->frameOffsets, size));
+    d->trajectory = boost::make_shared<Trajectory>(store);
+
+    return true;
+}
+
+/// Opens the file with \p fileName for frame access.
+///
+/// Equivalent to:
+/// \code
+/// file.setFileName(fileName);
+/// file.open();
+/// \endcode
+bool TrajectoryFile::open(const std::string &fileName)
+{
+    setFileName(fileName);
+
+    return open();
+}
+
+/// Returns \c true if the file is open for frame access.
+bool TrajectoryFile::isOpen() const
+{
+    return d->mappedFile.is_open();
+}
+
+/// Closes the file.
+void TrajectoryFile::close()
+{
+    // the mapping is shared with the trajectory's store so it is
+    // released rather than closed
+    d->mappedFile = boost::iostreams::mapped_file_source();
+
+    d->frameOffsets.clear();
+}
+
+/// Returns the number of frames in the file. The file must be
+/// opened with open() first.
+size_t TrajectoryFile::frameCount() const
+{
+    return d->frameOffsets.size();
+}
+
+/// Reads the frame at \p index from the file into \p frame. Only
+/// the requested frame is decoded. Returns \c false if the file is
+/// not open, if \p index is out of range or if decoding fails.
+bool TrajectoryFile::readFrame(size_t index, TrajectoryFrame *frame)
+{
+    if(!isOpen()){
+        setErrorString("File is not open.");
+        return false;
+    }
+    else if(index >= d->frameOffsets.size()){
+        setErrorString("Frame index is out of range.");
+        return false;
+    }
+
+    bool ok = format()->readFrame(d->mappedFile, d->frameOffsets[index], frame);
+    if(!ok){
+        setErrorString(format()->errorString());
+    }
+
+    return ok;
+}
+
+/// Reads every \p stride frame from \p first up to (but not
+/// including) \p last into a new trajectory. Returns \c 0 if an
+/// error occurs.
+///
+/// \code
+/// // read only the last frame
+/// file.readFrames(file.frameCount() - 1, file.frameCount());
+/// \endcode
+boost::shared_ptr<Trajectory> TrajectoryFile::readFrames(size_t first, size_t last, size_t stride)
+{
+    if(!isOpen()){
+        setErrorString("File is not open.");
+        return boost::shared_ptr<Trajectory>();
+    }
+
+    stride = std::max(stride, size_t(1));
+    last = std::min(last, frameCount());
+
+    boost::shared_ptr<Trajectory> trajectory(new Trajectory);
+
+    for(size_t index = first; index < last; index += stride){
+        TrajectoryFrame *frame = trajectory->addFrame();
+
+        if(!readFrame(index, frame)){
+            return boost::shared_ptr<Trajectory>();
+        }
+    }
+
+    return trajectory;
+}
+
+/// Enables or disables caching of the frame index beside the
+/// trajectory file. The default is \c false.
+///
+/// \see frameIndexFileName()
+void TrajectoryFile::setFrameIndexCacheEnabled(bool enabled)
+{
+    d->frameIndexCacheEnabled = enabled;
+}
+
+/// Returns \c true if the frame index cache is enabled.
+bool TrajectoryFile::isFrameIndexCacheEnabled() const
+{
+    return d->frameIndexCacheEnabled;
+}
+
+/// Returns the name of the file used to cache the frame index. This
+/// is the trajectory file name with an \c .idx suffix appended.
+std::string TrajectoryFile::frameIndexFileName() const
+{
+    return fileName() + ".idx";
+}
+
 } // end chemkit namespace
@@ -39,6 +39,7 @@
 #include "md-io.h"
 
 #include <string>
+#include <vector>
 
 #include <boost/smart_ptr.hpp>
 
@@ -50,6 +51,7 @@ namespace chemkit {
 
 class Topology;
 class Trajectory;
+class TrajectoryFrame;
 class TrajectoryFilePrivate;
 
 class CHEMKIT_MD_IO_EXPORT TrajectoryFile : public GenericFile<TrajectoryFile, TrajectoryFileFormat>
@@ -71,6 +73,18 @@ public:
     void setTrajectory(const boost::shared_ptr<Trajectory> &trajectory);
     boost::shared_ptr<Trajectory> trajectory() const;
 
+    // frame access
+    bool open();
+    bool open(const std::string &fileName);
+    bool isOpen() const;
+    void close();
+    size_t frameCount() const;
+    bool readFrame(size_t index, TrajectoryFrame *frame);
+    boost::shared_ptr<Trajectory> readFrames(size_t first, size_t last, size_t stride = 1);
+    void setFrameIndexCacheEnabled(bool enabled);
+    bool isFrameIndexCacheEnabled() const;
+    std::string frameIndexFileName() const;
+
 private:
     TrajectoryFilePrivate* const d;
 };
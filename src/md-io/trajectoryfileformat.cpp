@@ -112,6 +112,52 @@ bool TrajectoryFileFormat::write(const TrajectoryFile *file, std::ostream &outpu
     return false;
 }
 
+// --- Frame Access -------------------------------------------------------- //
+/// Returns \c true if the format supports reading individual frames
+/// with readFrameOffsets() and readFrame().
+///
+/// The default implementation returns \c false.
+bool TrajectoryFileFormat::supportsFrameAccess() const
+{
+    return false;
+}
+
+/// Scans \p input and stores the byte offset of the start of each
+/// frame in \p offsets. This should only read as much of each frame
+/// as is needed to locate the next one. Formats which need additional
+/// information (e.g. the number of particles) may obtain it from the
+/// topology of \p file. Returns \c false if an error occurs.
+///
+/// \see readFrame()
+bool TrajectoryFileFormat::readFrameOffsets(const boost::iostreams::mapped_file_source &input,
+                                            const TrajectoryFile *file,
+                                            std::vector<size_t> &offsets)
+{
+    CHEMKIT_UNUSED(input);
+    CHEMKIT_UNUSED(file);
+    CHEMKIT_UNUSED(offsets);
+
+    setErrorString((boost::format("'%s' frame access not supported.") % name()).str());
+    return false;
+}
+
+/// Reads the frame starting at \p offset in \p input into \p frame.
+/// If the frame contains more particles than \p frame the frame's
+/// trajectory is resized. Returns \c false if an error occurs.
+///
+/// \see readFrameOffsets()
+bool TrajectoryFileFormat::readFrame(const boost::iostreams::mapped_file_source &input,
+                                     size_t offset,
+                                     TrajectoryFrame *frame)
+{
+    CHEMKIT_UNUSED(input);
+    CHEMKIT_UNUSED(offset);
+    CHEMKIT_UNUSED(frame);
+
+    setErrorString((boost::format("'%s' frame access not supported.") % name()).str());
+    return false;
+}
+
 // --- Error Handling ------------------------------------------------------ //
 /// Sets a string describing the last error that occurred.
 void TrajectoryFileFormat::setErrorString(const std::string &errorString)
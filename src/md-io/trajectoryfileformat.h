@@ -50,6 +50,7 @@
 namespace chemkit {
 
 class TrajectoryFile;
+class TrajectoryFrame;
 class TrajectoryFileFormatPrivate;
 
 class CHEMKIT_MD_IO_EXPORT TrajectoryFileFormat
@@ -66,6 +67,11 @@ public:
     virtual bool readMappedFile(const boost::iostreams::mapped_file_source &input, TrajectoryFile *file);
     virtual bool write(const TrajectoryFile *file, std::ostream &output);
 
+    // frame access
+    virtual bool supportsFrameAccess() const;
+    virtual bool readFrameOffsets(const boost::iostreams::mapped_file_source &input, const TrajectoryFile *file, std::vector<size_t> &offsets);
+    virtual bool readFrame(const boost::iostreams::mapped_file_source &input, size_t offset, TrajectoryFrame *frame);
+
     // error handling
     std::string errorString() const;
 
@@ -35,22 +35,67 @@
 
 #include "forcefield.h"
 
+#include <typeinfo>
+#include <algorithm>
+
+#include <boost/thread/mutex.hpp>
+
 #include <chemkit/foreach.h>
 #include <chemkit/constants.h>
 #include <chemkit/concurrent.h>
+#include <chemkit/threadpool.h>
 #include <chemkit/pluginmanager.h>
 #include <chemkit/cartesiancoordinates.h>
 
 #include "topology.h"
+#include "neighborlist.h"
 #include "topologybuilder.h"
 #include "forcefieldcalculation.h"
+#include "forcefieldcalculationbatch.h"
 
 namespace chemkit {
 
+namespace {
+
+// the number of calculations in each chunk evaluated by a thread. The
+// chunks do not depend on the number of threads so that the energy is
+// summed in the same order regardless of the thread count.
+const size_t CalculationChunkSize = 2048;
+
+} // end anonymous namespace
+
 // === ForceFieldPrivate =================================================== //
 class ForceFieldPrivate
 {
 public:
+    // a range of calculations in a batch
+    struct Chunk
+    {
+        const ForceFieldCalculationBatch *batch;
+        size_t begin;
+        size_t end;
+        size_t atomGradientsOffset;
+    };
+
+    ~ForceFieldPrivate();
+
+    void clearBatches();
+    void updateBatches();
+    void updateGradientGather();
+    void clearNeighborList();
+    size_t evaluationThreadCount() const;
+    Real parallelEnergy(const CartesianCoordinates *coordinates, size_t threads) const;
+    void chunkEnergies(const CartesianCoordinates *coordinates, size_t task, size_t threads, Real *energies) const;
+    void parallelGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const;
+    void chunkGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, size_t atomCount, std::vector<Vector3> *gradients) const;
+    void deterministicGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const;
+    void chunkAtomGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, Vector3 *atomGradients) const;
+    void gatherAtomGradients(const Vector3 *atomGradients, size_t task, size_t threads, std::vector<Vector3> *gradient) const;
+    Real parallelEnergyAndGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const;
+    void chunkEnergiesAndGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, size_t atomCount, Real *energies, std::vector<Vector3> *gradients) const;
+    Real deterministicEnergyAndGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const;
+    void chunkEnergiesAndAtomGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, Real *energies, Vector3 *atomGradients) const;
+
     std::string name;
     int flags;
     boost::shared_ptr<Topology> topology;
@@ -59,8 +104,427 @@ public:
     std::string parameterFile;
     std::map<std::string, std::string> parameterSets;
     std::string errorString;
+
+    // calculation batches
+    bool batchesValid;
+    boost::mutex batchesMutex;
+    std::vector<ForceFieldCalculationBatch *> batches;
+    std::vector<const ForceFieldCalculation *> unbatchedCalculations;
+
+    // parallel evaluation
+    size_t threadCount;
+    bool deterministic;
+    std::vector<Chunk> chunks;
+    size_t atomGradientsCount;
+    bool gatherValid;
+    std::vector<size_t> gatherOffsets;
+    std::vector<size_t> gatherIndices;
+
+    // nonbonded interactions
+    Real nonbondedCutoff;
+    Real nonbondedSwitchingDistance;
+    Real neighborListSkin;
+    boost::mutex neighborListMutex;
+    NeighborList *neighborList;
+    size_t neighborListCalculationsBegin;
 };
 
+ForceFieldPrivate::~ForceFieldPrivate()
+{
+    clearBatches();
+    delete neighborList;
+}
+
+void ForceFieldPrivate::clearBatches()
+{
+    foreach(ForceFieldCalculationBatch *batch, batches){
+        delete batch;
+    }
+
+    batches.clear();
+    unbatchedCalculations.clear();
+    chunks.clear();
+    atomGradientsCount = 0;
+    gatherValid = false;
+    std::vector<size_t>().swap(gatherOffsets);
+    std::vector<size_t>().swap(gatherIndices);
+    batchesValid = false;
+}
+
+// Groups the calculations by their class into batches. Calculations
+// which do not provide a batch are evaluated individually.
+void ForceFieldPrivate::updateBatches()
+{
+    boost::mutex::scoped_lock lock(batchesMutex);
+
+    if(batchesValid){
+        return;
+    }
+
+    clearBatches();
+
+    std::vector<const std::type_info *> batchTypes;
+
+    foreach(const ForceFieldCalculation *calculation, calculations){
+        const std::type_info &type = typeid(*calculation);
+
+        ForceFieldCalculationBatch *batch = 0;
+        for(size_t i = 0; i < batchTypes.size(); i++){
+            if(*batchTypes[i] == type){
+                batch = batches[i];
+                break;
+            }
+        }
+
+        if(!batch){
+            batch = calculation->createBatch();
+
+            if(!batch){
+                unbatchedCalculations.push_back(calculation);
+                continue;
+            }
+
+            if(batch->type() & (ForceFieldCalculation::VanDerWaals | ForceFieldCalculation::Electrostatic)){
+                batch->setCutoff(nonbondedCutoff);
+                batch->setSwitchingDistance(nonbondedSwitchingDistance);
+            }
+
+            batchTypes.push_back(&type);
+            batches.push_back(batch);
+        }
+
+        batch->addCalculation(calculation);
+    }
+
+    // split the batches into chunks for parallel evaluation
+    foreach(const ForceFieldCalculationBatch *batch, batches){
+        for(size_t begin = 0; begin < batch->size(); begin += CalculationChunkSize){
+            Chunk chunk;
+            chunk.batch = batch;
+            chunk.begin = begin;
+            chunk.end = std::min(begin + CalculationChunkSize, batch->size());
+            chunk.atomGradientsOffset = atomGradientsCount;
+            chunks.push_back(chunk);
+
+            atomGradientsCount += (chunk.end - chunk.begin) * batch->atomCount();
+        }
+    }
+
+    batchesValid = true;
+}
+
+// Builds the list of atom gradients for each atom used to reduce the
+// gradient deterministically. The atom gradients for each atom are
+// listed in the same order in which the serial evaluation adds them.
+void ForceFieldPrivate::updateGradientGather()
+{
+    boost::mutex::scoped_lock lock(batchesMutex);
+
+    if(gatherValid){
+        return;
+    }
+
+    size_t atomCount = topology ? topology->size() : 0;
+
+    gatherOffsets.assign(atomCount + 1, 0);
+    foreach(const Chunk &chunk, chunks){
+        for(size_t i = chunk.begin; i < chunk.end; i++){
+            const size_t *atoms = chunk.batch->atoms(i);
+
+            for(size_t j = 0; j < chunk.batch->atomCount(); j++){
+                gatherOffsets[atoms[j] + 1]++;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < atomCount; i++){
+        gatherOffsets[i + 1] += gatherOffsets[i];
+    }
+
+    gatherIndices.resize(atomGradientsCount);
+    std::vector<size_t> positions(gatherOffsets.begin(), gatherOffsets.end() - 1);
+    foreach(const Chunk &chunk, chunks){
+        size_t index = chunk.atomGradientsOffset;
+
+        for(size_t i = chunk.begin; i < chunk.end; i++){
+            const size_t *atoms = chunk.batch->atoms(i);
+
+            for(size_t j = 0; j < chunk.batch->atomCount(); j++){
+                gatherIndices[positions[atoms[j]]++] = index++;
+            }
+        }
+    }
+
+    gatherValid = true;
+}
+
+// Returns the number of threads to evaluate the calculations with.
+size_t ForceFieldPrivate::evaluationThreadCount() const
+{
+    if(threadCount == 0){
+        return std::max<size_t>(1, ThreadPool::globalInstance()->threadCount());
+    }
+
+    return threadCount;
+}
+
+// Evaluates the energy of each chunk in parallel and then sums the
+// chunk energies in order.
+Real ForceFieldPrivate::parallelEnergy(const CartesianCoordinates *coordinates, size_t threads) const
+{
+    std::vector<Real> energies(chunks.size());
+
+    if(!chunks.empty()){
+        concurrent::parallel_for(0, threads,
+                                 boost::bind(&ForceFieldPrivate::chunkEnergies,
+                                             this,
+                                             coordinates,
+                                             _1,
+                                             threads,
+                                             &energies[0]));
+    }
+
+    Real energy = 0;
+
+    foreach(Real chunkEnergy, energies){
+        energy += chunkEnergy;
+    }
+
+    return energy;
+}
+
+// Evaluates the energy of every threads'th chunk starting at task.
+void ForceFieldPrivate::chunkEnergies(const CartesianCoordinates *coordinates, size_t task, size_t threads, Real *energies) const
+{
+    for(size_t i = task; i < chunks.size(); i += threads){
+        const Chunk &chunk = chunks[i];
+
+        energies[i] = chunk.batch->energy(coordinates, chunk.begin, chunk.end);
+    }
+}
+
+// Evaluates the gradient with a separate gradient for each thread.
+// The per-thread gradients are then added together in order.
+void ForceFieldPrivate::parallelGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const
+{
+    std::vector<std::vector<Vector3> > gradients(threads);
+
+    concurrent::parallel_for(0, threads,
+                             boost::bind(&ForceFieldPrivate::chunkGradients,
+                                         this,
+                                         coordinates,
+                                         _1,
+                                         threads,
+                                         gradient.size(),
+                                         &gradients[0]));
+
+    foreach(const std::vector<Vector3> &threadGradient, gradients){
+        for(size_t i = 0; i < threadGradient.size(); i++){
+            gradient[i] += threadGradient[i];
+        }
+    }
+}
+
+// Adds the gradient of every threads'th chunk starting at task to
+// the gradient for the task.
+void ForceFieldPrivate::chunkGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, size_t atomCount, std::vector<Vector3> *gradients) const
+{
+    std::vector<Vector3> &gradient = gradients[task];
+
+    for(size_t i = task; i < chunks.size(); i += threads){
+        const Chunk &chunk = chunks[i];
+
+        if(gradient.empty()){
+            gradient.assign(atomCount, Vector3(0, 0, 0));
+        }
+
+        chunk.batch->gradient(coordinates, chunk.begin, chunk.end, &gradient[0]);
+    }
+}
+
+// Evaluates the atom gradients of each calculation in parallel and
+// then adds them to the gradient of each atom in the same order as
+// the serial evaluation. The result does not depend on the number of
+// threads.
+void ForceFieldPrivate::deterministicGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const
+{
+    if(chunks.empty()){
+        return;
+    }
+
+    const_cast<ForceFieldPrivate *>(this)->updateGradientGather();
+
+    std::vector<Vector3> atomGradients(atomGradientsCount);
+
+    concurrent::parallel_for(0, threads,
+                             boost::bind(&ForceFieldPrivate::chunkAtomGradients,
+                                         this,
+                                         coordinates,
+                                         _1,
+                                         threads,
+                                         &atomGradients[0]));
+
+    concurrent::parallel_for(0, threads,
+                             boost::bind(&ForceFieldPrivate::gatherAtomGradients,
+                                         this,
+                                         &atomGradients[0],
+                                         _1,
+                                         threads,
+                                         &gradient));
+}
+
+// Writes the atom gradients of every threads'th chunk starting at
+// task to atomGradients.
+void ForceFieldPrivate::chunkAtomGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, Vector3 *atomGradients) const
+{
+    for(size_t i = task; i < chunks.size(); i += threads){
+        const Chunk &chunk = chunks[i];
+
+        chunk.batch->atomGradients(coordinates, chunk.begin, chunk.end, &atomGradients[chunk.atomGradientsOffset]);
+    }
+}
+
+// Adds the atom gradients to the gradient of each atom in the task's
+// range of atoms.
+void ForceFieldPrivate::gatherAtomGradients(const Vector3 *atomGradients, size_t task, size_t threads, std::vector<Vector3> *gradient) const
+{
+    size_t atomCount = gatherOffsets.size() - 1;
+    size_t begin = task * atomCount / threads;
+    size_t end = (task + 1) * atomCount / threads;
+
+    for(size_t atom = begin; atom < end; atom++){
+        Vector3 &atomGradient = (*gradient)[atom];
+
+        for(size_t i = gatherOffsets[atom]; i < gatherOffsets[atom + 1]; i++){
+            atomGradient += atomGradients[gatherIndices[i]];
+        }
+    }
+}
+
+// Evaluates the energy and gradient with a separate gradient for each
+// thread. The energies and gradients are added together in the same
+// order as by parallelEnergy() and parallelGradient().
+Real ForceFieldPrivate::parallelEnergyAndGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const
+{
+    if(chunks.empty()){
+        return 0;
+    }
+
+    std::vector<Real> energies(chunks.size());
+    std::vector<std::vector<Vector3> > gradients(threads);
+
+    concurrent::parallel_for(0, threads,
+                             boost::bind(&ForceFieldPrivate::chunkEnergiesAndGradients,
+                                         this,
+                                         coordinates,
+                                         _1,
+                                         threads,
+                                         gradient.size(),
+                                         &energies[0],
+                                         &gradients[0]));
+
+    foreach(const std::vector<Vector3> &threadGradient, gradients){
+        for(size_t i = 0; i < threadGradient.size(); i++){
+            gradient[i] += threadGradient[i];
+        }
+    }
+
+    Real energy = 0;
+
+    foreach(Real chunkEnergy, energies){
+        energy += chunkEnergy;
+    }
+
+    return energy;
+}
+
+// Evaluates the energy of every threads'th chunk starting at task and
+// adds its gradient to the gradient for the task.
+void ForceFieldPrivate::chunkEnergiesAndGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, size_t atomCount, Real *energies, std::vector<Vector3> *gradients) const
+{
+    std::vector<Vector3> &gradient = gradients[task];
+
+    for(size_t i = task; i < chunks.size(); i += threads){
+        const Chunk &chunk = chunks[i];
+
+        if(gradient.empty()){
+            gradient.assign(atomCount, Vector3(0, 0, 0));
+        }
+
+        energies[i] = chunk.batch->energyAndGradient(coordinates, chunk.begin, chunk.end, &gradient[0]);
+    }
+}
+
+// Evaluates the energy and the atom gradients of each calculation in
+// parallel and then adds them together in the same order as
+// parallelEnergy() and deterministicGradient().
+Real ForceFieldPrivate::deterministicEnergyAndGradient(const CartesianCoordinates *coordinates, size_t threads, std::vector<Vector3> &gradient) const
+{
+    if(chunks.empty()){
+        return 0;
+    }
+
+    const_cast<ForceFieldPrivate *>(this)->updateGradientGather();
+
+    std::vector<Real> energies(chunks.size());
+    std::vector<Vector3> atomGradients(atomGradientsCount);
+
+    concurrent::parallel_for(0, threads,
+                             boost::bind(&ForceFieldPrivate::chunkEnergiesAndAtomGradients,
+                                         this,
+                                         coordinates,
+                                         _1,
+                                         threads,
+                                         &energies[0],
+                                         &atomGradients[0]));
+
+    concurrent::parallel_for(0, threads,
+                             boost::bind(&ForceFieldPrivate::gatherAtomGradients,
+                                         this,
+                                         &atomGradients[0],
+                                         _1,
+                                         threads,
+                                         &gradient));
+
+    Real energy = 0;
+
+    foreach(Real chunkEnergy, energies){
+        energy += chunkEnergy;
+    }
+
+    return energy;
+}
+
+// Evaluates the energy of every threads'th chunk starting at task and
+// writes its atom gradients to atomGradients.
+void ForceFieldPrivate::chunkEnergiesAndAtomGradients(const CartesianCoordinates *coordinates, size_t task, size_t threads, Real *energies, Vector3 *atomGradients) const
+{
+    for(size_t i = task; i < chunks.size(); i += threads){
+        const Chunk &chunk = chunks[i];
+
+        energies[i] = chunk.batch->energyAndAtomGradients(coordinates, chunk.begin, chunk.end, &atomGradients[chunk.atomGradientsOffset]);
+    }
+}
+
+// Removes the nonbonded calculations created from the neighbor list
+// along with the neighbor list itself.
+void ForceFieldPrivate::clearNeighborList()
+{
+    if(!neighborList){
+        return;
+    }
+
+    for(size_t i = neighborListCalculationsBegin; i < calculations.size(); i++){
+        delete calculations[i];
+    }
+    calculations.resize(neighborListCalculationsBegin);
+
+    delete neighborList;
+    neighborList = 0;
+
+    clearBatches();
+}
+
 // === ForceField ========================================================== //
 /// \class ForceField forcefield.h chemkit/forcefield.h
 /// \ingroup chemkit-md
@@ -86,6 +550,12 @@ public:
 /// // calculate the total energy
 /// double energy = forceField->energy(molecule->coordinates());
 /// \endcode
+///
+/// By default the force field contains a nonbonded calculation for
+/// every pair of atoms in the topology. For large systems a cutoff
+/// distance can be set with setNonbondedCutoff(). The nonbonded
+/// calculations are then created from a NeighborList and only pairs
+/// of atoms within the cutoff distance are evaluated.
 
 // --- Construction and Destruction ---------------------------------------- //
 ForceField::ForceField(const std::string &name)
@@ -93,6 +563,16 @@ ForceField::ForceField(const std::string &name)
 {
     d->name = name;
     d->flags = 0;
+    d->batchesValid = false;
+    d->threadCount = 1;
+    d->deterministic = false;
+    d->atomGradientsCount = 0;
+    d->gatherValid = false;
+    d->nonbondedCutoff = 0;
+    d->nonbondedSwitchingDistance = 0;
+    d->neighborListSkin = 2.0;
+    d->neighborList = 0;
+    d->neighborListCalculationsBegin = 0;
 }
 
 /// Destroys a force field.
@@ -142,20 +622,26 @@ void ForceField::setTopology(const boost::shared_ptr<Topology> &topology)
     d->topology = topology;
 
     // remove old calculations
+    d->clearNeighborList();
     foreach(ForceFieldCalculation *calculation, d->calculations){
         delete calculation;
     }
     d->calculations.clear();
+    d->clearBatches();
 }
 
 /// Builds a topology for the molecule and sets it with setTopology().
 ///
+/// If a nonbonded cutoff is set the topology is built without
+/// nonbonded interactions.
+///
 /// \see TopologyBuilder
 void ForceField::setTopologyFromMolecule(const Molecule *molecule)
 {
     TopologyBuilder builder;
     builder.setAtomTyper(name());
     builder.setPartialChargeModel(name());
+    builder.setNonbondedInteractionsEnabled(d->nonbondedCutoff == 0);
     builder.addMolecule(molecule);
     setTopology(builder.topology());
 }
@@ -233,17 +719,98 @@ std::string ForceField::parameterFile() const
     return d->parameterFile;
 }
 
+// --- Nonbonded Interactions --------------------------------------------- //
+/// Sets the cutoff distance for nonbonded interactions to \p cutoff
+/// (in Angstroms). A cutoff of \c 0 (the default) disables the cutoff
+/// and every nonbonded pair of atoms in the topology is evaluated.
+///
+/// With a cutoff the nonbonded calculations are created from a
+/// NeighborList when the energy or gradient is first calculated and
+/// are recreated whenever the neighbor list is rebuilt. This makes
+/// the cost of the nonbonded interactions scale linearly with the
+/// number of atoms.
+///
+/// The cutoff should be set before calling setTopologyFromMolecule()
+/// so that the topology is built without nonbonded interactions. If
+/// the cutoff is enabled or disabled after setup() the nonbonded
+/// calculations are recreated as setup() would have created them:
+/// enabling the cutoff removes the nonbonded calculations for the
+/// topology's nonbonded interactions and disabling it adds them back.
+///
+/// \see setNonbondedSwitchingDistance(), neighborList()
+void ForceField::setNonbondedCutoff(Real cutoff)
+{
+    bool enabled = d->nonbondedCutoff > 0;
+
+    d->clearNeighborList();
+    d->nonbondedCutoff = cutoff;
+
+    if((cutoff > 0) != enabled && !d->calculations.empty()){
+        rebuildNonbondedCalculations();
+    }
+}
+
+/// Returns the cutoff distance for nonbonded interactions.
+Real ForceField::nonbondedCutoff() const
+{
+    return d->nonbondedCutoff;
+}
+
+/// Sets the distance at which the nonbonded interactions begin to be
+/// smoothly switched off to \p distance. The energy of nonbonded
+/// interactions between the switching distance and the cutoff
+/// distance is scaled by a switching function so that it goes to zero
+/// at the cutoff. If the switching distance is \c 0 (the default) the
+/// interactions are truncated at the cutoff.
+void ForceField::setNonbondedSwitchingDistance(Real distance)
+{
+    d->nonbondedSwitchingDistance = distance;
+    d->clearBatches();
+}
+
+/// Returns the switching distance for nonbonded interactions.
+Real ForceField::nonbondedSwitchingDistance() const
+{
+    return d->nonbondedSwitchingDistance;
+}
+
+/// Sets the skin distance for the neighbor list to \p skin. The
+/// default skin distance is two Angstroms.
+///
+/// \see NeighborList::setSkin()
+void ForceField::setNeighborListSkin(Real skin)
+{
+    d->neighborListSkin = skin;
+    d->clearNeighborList();
+}
+
+/// Returns the skin distance for the neighbor list.
+Real ForceField::neighborListSkin() const
+{
+    return d->neighborListSkin;
+}
+
+/// Returns the neighbor list used to find nonbonded pairs. Returns
+/// \c 0 if no nonbonded cutoff is set or if the energy has not been
+/// calculated yet.
+const NeighborList* ForceField::neighborList() const
+{
+    return d->neighborList;
+}
+
 // --- Calculations -------------------------------------------------------- //
 void ForceField::addCalculation(ForceFieldCalculation *calculation)
 {
     calculation->setForceField(this);
 
     d->calculations.push_back(calculation);
+    d->batchesValid = false;
 }
 
 void ForceField::removeCalculation(ForceFieldCalculation *calculation)
 {
     d->calculations.erase(std::remove(d->calculations.begin(), d->calculations.end(), calculation));
+    d->clearBatches();
     delete calculation;
 }
 
@@ -264,12 +831,97 @@ void ForceField::setCalculationSetup(ForceFieldCalculation *calculation, bool se
     calculation->setSetup(setup);
 }
 
+/// Adds the nonbonded calculations between the atoms \p a and \p b.
+///
+/// This is called for each pair in the neighbor list when a nonbonded
+/// cutoff is set. Force fields should reimplement this method to add
+/// their van der waals and electrostatic calculations. The default
+/// implementation does nothing.
+void ForceField::addNonbondedCalculations(size_t a, size_t b)
+{
+    CHEMKIT_UNUSED(a);
+    CHEMKIT_UNUSED(b);
+}
+
+/// Sets up \p calculation. Returns \c false if the setup failed.
+///
+/// This is called for each calculation added by
+/// addNonbondedCalculations(). The default implementation returns
+/// \c false.
+bool ForceField::setupCalculation(ForceFieldCalculation *calculation)
+{
+    CHEMKIT_UNUSED(calculation);
+
+    return false;
+}
+
+/// Sets the number of threads used to evaluate the energy and
+/// gradient to \p count. If \p count is \c 0 one thread is used for
+/// each thread in the global thread pool. The default is \c 1.
+///
+/// The calculations are split into chunks which are evaluated in
+/// parallel with more than one thread. The energy of each chunk is
+/// summed in order, with one thread as well, so the energy does not
+/// depend on the number of threads. Each thread adds to its own copy
+/// of the gradient and the copies are then added together. This
+/// makes the gradient depend (by rounding error only) on the number
+/// of threads unless setDeterministic() is enabled.
+///
+/// \see ThreadPool::globalInstance()
+void ForceField::setThreadCount(size_t count)
+{
+    d->threadCount = count;
+}
+
+/// Returns the number of threads used to evaluate the energy and
+/// gradient.
+size_t ForceField::threadCount() const
+{
+    return d->threadCount;
+}
+
+/// Sets whether the energy and gradient are calculated
+/// deterministically to \p deterministic. The default is \c false.
+///
+/// When enabled, the energy and gradient are bit-identical for any
+/// number of threads. The gradient is then calculated by storing the
+/// gradient of each atom in each calculation and adding them
+/// together per atom. This uses more memory than the default
+/// per-thread gradients.
+///
+/// \see setThreadCount()
+void ForceField::setDeterministic(bool deterministic)
+{
+    d->deterministic = deterministic;
+}
+
+/// Returns \c true if the energy and gradient are calculated
+/// deterministically.
+bool ForceField::isDeterministic() const
+{
+    return d->deterministic;
+}
+
 /// \copydoc Potential::energy()
 Real ForceField::energy(const CartesianCoordinates *coordinates) const
 {
+    const_cast<ForceField *>(this)->updateNeighborList(coordinates);
+    d->updateBatches();
+
     Real energy = 0;
 
-    foreach(const ForceFieldCalculation *calculation, d->calculations){
+    size_t threads = d->evaluationThreadCount();
+    if(threads > 1 || d->deterministic){
+        energy += d->parallelEnergy(coordinates, threads);
+    }
+    else{
+        // sum the chunk energies in the same order as parallelEnergy()
+        foreach(const ForceFieldPrivate::Chunk &chunk, d->chunks){
+            energy += chunk.batch->energy(coordinates, chunk.begin, chunk.end);
+        }
+    }
+
+    foreach(const ForceFieldCalculation *calculation, d->unbatchedCalculations){
         energy += calculation->energy(coordinates);
     }
 
@@ -279,11 +931,28 @@ Real ForceField::energy(const CartesianCoordinates *coordinates) const
 /// \copydoc Potential::gradient()
 std::vector<Vector3> ForceField::gradient(const CartesianCoordinates *coordinates) const
 {
+    const_cast<ForceField *>(this)->updateNeighborList(coordinates);
+
     if(d->flags & AnalyticalGradient){
+        d->updateBatches();
+
         std::vector<Vector3> gradient(size());
         std::fill(gradient.begin(), gradient.end(), Vector3(0, 0, 0));
 
-        foreach(const ForceFieldCalculation *calculation, d->calculations){
+        size_t threads = d->evaluationThreadCount();
+        if(d->deterministic){
+            d->deterministicGradient(coordinates, threads, gradient);
+        }
+        else if(threads > 1){
+            d->parallelGradient(coordinates, threads, gradient);
+        }
+        else{
+            foreach(const ForceFieldCalculationBatch *batch, d->batches){
+                batch->gradient(coordinates, gradient);
+            }
+        }
+
+        foreach(const ForceFieldCalculation *calculation, d->unbatchedCalculations){
             std::vector<Vector3> atomGradients = calculation->gradient(coordinates);
 
             for(size_t i = 0; i < atomGradients.size(); i++){
@@ -298,6 +967,64 @@ std::vector<Vector3> ForceField::gradient(const CartesianCoordinates *coordinate
     }
 }
 
+/// \copydoc Potential::energyAndGradient()
+///
+/// The energy and gradient are identical to those returned by
+/// energy() and gradient() but each calculation is only evaluated
+/// once. When \p gradient already has enough capacity for the atoms
+/// in the force field no memory is allocated by the single-threaded
+/// evaluation.
+Real ForceField::energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const
+{
+    if(!(d->flags & AnalyticalGradient)){
+        return Potential::energyAndGradient(coordinates, gradient);
+    }
+
+    const_cast<ForceField *>(this)->updateNeighborList(coordinates);
+    d->updateBatches();
+
+    gradient.assign(size(), Vector3(0, 0, 0));
+
+    Real energy = 0;
+
+    size_t threads = d->evaluationThreadCount();
+    if(d->deterministic){
+        energy += d->deterministicEnergyAndGradient(coordinates, threads, gradient);
+    }
+    else if(threads > 1){
+        energy += d->parallelEnergyAndGradient(coordinates, threads, gradient);
+    }
+    else{
+        // sum the chunk energies in the same order as parallelEnergy()
+        foreach(const ForceFieldPrivate::Chunk &chunk, d->chunks){
+            energy += chunk.batch->energyAndGradient(coordinates, chunk.begin, chunk.end, &gradient[0]);
+        }
+    }
+
+    Vector3 atomGradients[ForceFieldCalculationBatch::MaxAtomCount];
+
+    foreach(const ForceFieldCalculation *calculation, d->unbatchedCalculations){
+        if(calculation->atomCount() > ForceFieldCalculationBatch::MaxAtomCount){
+            energy += calculation->energy(coordinates);
+
+            std::vector<Vector3> calculationGradients = calculation->gradient(coordinates);
+            for(size_t i = 0; i < calculationGradients.size(); i++){
+                gradient[calculation->atom(i)] += calculationGradients[i];
+            }
+
+            continue;
+        }
+
+        energy += calculation->energyAndGradient(coordinates, atomGradients);
+
+        for(size_t i = 0; i < calculation->atomCount(); i++){
+            gradient[calculation->atom(i)] += atomGradients[i];
+        }
+    }
+
+    return energy;
+}
+
 // --- Error Handling ------------------------------------------------------ //
 /// Sets a string that describes the last error that occurred.
 void ForceField::setErrorString(const std::string &errorString)
@@ -325,4 +1052,89 @@ std::vector<std::string> ForceField::forceFields()
     return PluginManager::instance()->pluginClassNames<ForceField>();
 }
 
+// --- Internal Methods ---------------------------------------------------- //
+// Called when the atoms or parameters of one of the calculations
+// change. This invalidates the calculation batches which are then
+// rebuilt on the next call to energy() or gradient().
+void ForceField::calculationChanged()
+{
+    d->batchesValid = false;
+}
+
+// Updates the neighbor list for the nonbonded cutoff. When the list
+// is rebuilt the previous nonbonded calculations are replaced with
+// new ones for each pair in the list.
+void ForceField::updateNeighborList(const CartesianCoordinates *coordinates)
+{
+    if(d->nonbondedCutoff <= 0 || !d->topology){
+        return;
+    }
+
+    boost::mutex::scoped_lock lock(d->neighborListMutex);
+
+    if(!d->neighborList){
+        d->neighborList = new NeighborList(d->topology.get(), d->nonbondedCutoff, d->neighborListSkin);
+        d->neighborListCalculationsBegin = d->calculations.size();
+    }
+
+    if(!d->neighborList->update(coordinates)){
+        return;
+    }
+
+    // remove previous nonbonded calculations
+    for(size_t i = d->neighborListCalculationsBegin; i < d->calculations.size(); i++){
+        delete d->calculations[i];
+    }
+    d->calculations.resize(d->neighborListCalculationsBegin);
+
+    // add new nonbonded calculations
+    foreach(const NeighborList::Pair &pair, d->neighborList->pairs()){
+        addNonbondedCalculations(pair[0], pair[1]);
+    }
+
+    for(size_t i = d->neighborListCalculationsBegin; i < d->calculations.size(); i++){
+        ForceFieldCalculation *calculation = d->calculations[i];
+
+        calculation->setSetup(setupCalculation(calculation));
+    }
+
+    d->batchesValid = false;
+}
+
+// Replaces the nonbonded calculations created by setup() after the
+// nonbonded cutoff has been enabled or disabled. With a cutoff the
+// nonbonded calculations are created from the neighbor list instead.
+void ForceField::rebuildNonbondedCalculations()
+{
+    // remove previous nonbonded calculations
+    std::vector<ForceFieldCalculation *> calculations;
+    foreach(ForceFieldCalculation *calculation, d->calculations){
+        if(calculation->type() & (ForceFieldCalculation::VanDerWaals | ForceFieldCalculation::Electrostatic)){
+            delete calculation;
+        }
+        else{
+            calculations.push_back(calculation);
+        }
+    }
+    d->calculations.swap(calculations);
+    d->clearBatches();
+
+    if(d->nonbondedCutoff > 0 || !d->topology){
+        return;
+    }
+
+    // add nonbonded calculations for the topology
+    size_t begin = d->calculations.size();
+
+    foreach(const Topology::NonbondedInteraction &interaction, d->topology->nonbondedInteractions()){
+        addNonbondedCalculations(interaction[0], interaction[1]);
+    }
+
+    for(size_t i = begin; i < d->calculations.size(); i++){
+        ForceFieldCalculation *calculation = d->calculations[i];
+
+        calculation->setSetup(setupCalculation(calculation));
+    }
+}
+
 } // end chemkit namespace
@@ -54,6 +54,7 @@ namespace chemkit {
 
 class Molecule;
 class Topology;
+class NeighborList;
 class ForceFieldPrivate;
 class CartesianCoordinates;
 
@@ -87,11 +88,25 @@ public:
     void setParameterFile(const std::string &fileName);
     std::string parameterFile() const;
 
+    // nonbonded interactions
+    void setNonbondedCutoff(Real cutoff);
+    Real nonbondedCutoff() const;
+    void setNonbondedSwitchingDistance(Real distance);
+    Real nonbondedSwitchingDistance() const;
+    void setNeighborListSkin(Real skin);
+    Real neighborListSkin() const;
+    const NeighborList* neighborList() const;
+
     // calculations
     std::vector<ForceFieldCalculation *> calculations() const;
     size_t calculationCount() const;
+    void setThreadCount(size_t count);
+    size_t threadCount() const;
+    void setDeterministic(bool deterministic);
+    bool isDeterministic() const;
     Real energy(const CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<Vector3> gradient(const CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    Real energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const CHEMKIT_OVERRIDE;
 
     // error handling
     std::string errorString() const;
@@ -106,10 +121,19 @@ protected:
     void addCalculation(ForceFieldCalculation *calculation);
     void removeCalculation(ForceFieldCalculation *calculation);
     void setCalculationSetup(ForceFieldCalculation *calculation, bool setup);
+    virtual void addNonbondedCalculations(size_t a, size_t b);
+    virtual bool setupCalculation(ForceFieldCalculation *calculation);
     void addParameterSet(const std::string &name, const std::string &fileName);
     void removeParameterSet(const std::string &name);
     void setErrorString(const std::string &errorString);
 
+private:
+    void calculationChanged();
+    void updateNeighborList(const CartesianCoordinates *coordinates);
+    void rebuildNonbondedCalculations();
+
+    friend class ForceFieldCalculation;
+
 private:
     ForceFieldPrivate* const d;
 };
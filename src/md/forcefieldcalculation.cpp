@@ -35,10 +35,13 @@
 
 #include "forcefieldcalculation.h"
 
+#include <algorithm>
+
 #include <chemkit/cartesiancoordinates.h>
 
 #include "topology.h"
 #include "forcefield.h"
+#include "forcefieldcalculationbatch.h"
 
 namespace chemkit {
 
@@ -108,6 +111,10 @@ boost::shared_ptr<Topology> ForceFieldCalculation::topology() const
 void ForceFieldCalculation::setAtom(size_t index, size_t atom)
 {
     d->atoms[index] = atom;
+
+    if(d->forceField){
+        d->forceField->calculationChanged();
+    }
 }
 
 /// Returns the atom at index in the calculation.
@@ -133,11 +140,21 @@ std::string ForceFieldCalculation::atomType(size_t index) const
     return topology()->type(atom(index));
 }
 
+/// Returns a pointer to the atom indices for the calculation.
+const size_t* ForceFieldCalculation::atomData() const
+{
+    return d->atoms.empty() ? 0 : &d->atoms[0];
+}
+
 // --- Parameters ---------------------------------------------------------- //
 /// Sets the parameter at index to value.
 void ForceFieldCalculation::setParameter(int index, Real value)
 {
     d->parameters[index] = value;
+
+    if(d->forceField){
+        d->forceField->calculationChanged();
+    }
 }
 
 /// Returns the parameter at index.
@@ -158,6 +175,12 @@ int ForceFieldCalculation::parameterCount() const
     return d->parameters.size();
 }
 
+/// Returns a pointer to the parameters for the calculation.
+const Real* ForceFieldCalculation::parameterData() const
+{
+    return d->parameters.empty() ? 0 : &d->parameters[0];
+}
+
 // --- Calculations -------------------------------------------------------- //
 /// Returns the energy of the calculation. Energy is in kcal/mol.
 Real ForceFieldCalculation::energy(const CartesianCoordinates *coordinates) const
@@ -193,6 +216,22 @@ std::vector<Vector3> ForceFieldCalculation::gradient(const CartesianCoordinates
     return numericalGradient(coordinates);
 }
 
+/// Returns the energy of the calculation and writes the gradient
+/// for each of its atoms to \p gradient which must have space for
+/// atomCount() vectors.
+///
+/// Calculations should reimplement this method to compute the energy
+/// and gradient from a single evaluation of their geometry without
+/// allocating memory. The default implementation calls energy() and
+/// gradient().
+Real ForceFieldCalculation::energyAndGradient(const CartesianCoordinates *coordinates, Vector3 *gradient) const
+{
+    std::vector<Vector3> atomGradients = this->gradient(coordinates);
+    std::copy(atomGradients.begin(), atomGradients.end(), gradient);
+
+    return energy(coordinates);
+}
+
 /// Returns the gradient of the energy with respect to the
 /// coordinates of each atom for the calculation. This method
 /// is used when analytical gradients are not available.
@@ -234,6 +273,22 @@ std::vector<Vector3> ForceFieldCalculation::numericalGradient(const CartesianCoo
     return gradient;
 }
 
+/// Returns a new, empty batch capable of evaluating calculations
+/// of the same class as this calculation. The force field groups its
+/// calculations into batches and evaluates each batch in a single
+/// loop instead of calling energy() and gradient() for every
+/// calculation.
+///
+/// The default implementation returns \c 0 which means that the
+/// calculation can not be batched and will be evaluated through its
+/// virtual energy() and gradient() methods.
+///
+/// \see ForceFieldCalculationBatchAdaptor
+ForceFieldCalculationBatch* ForceFieldCalculation::createBatch() const
+{
+    return 0;
+}
+
 // --- Internal Methods ---------------------------------------------------- //
 void ForceFieldCalculation::setSetup(bool setup)
 {
@@ -49,6 +49,7 @@ namespace chemkit {
 class Topology;
 class ForceField;
 class CartesianCoordinates;
+class ForceFieldCalculationBatch;
 class ForceFieldCalculationPrivate;
 
 class CHEMKIT_MD_EXPORT ForceFieldCalculation
@@ -85,18 +86,23 @@ public:
     // calculations
     virtual Real energy(const CartesianCoordinates *coordinates) const;
     virtual std::vector<Vector3> gradient(const CartesianCoordinates *coordinates) const;
+    virtual Real energyAndGradient(const CartesianCoordinates *coordinates, Vector3 *gradient) const;
     std::vector<Vector3> numericalGradient(const CartesianCoordinates *coordinates) const;
 
 protected:
     ForceFieldCalculation(int type, size_t atomCount, size_t parameterCount);
     virtual ~ForceFieldCalculation();
     void setAtom(size_t index, size_t atom);
+    const size_t* atomData() const;
+    const Real* parameterData() const;
+    virtual ForceFieldCalculationBatch* createBatch() const;
 
 private:
     void setSetup(bool setup);
     void setForceField(ForceField *forceField);
 
     friend class ForceField;
+    friend class ForceFieldPrivate;
 
 private:
     ForceFieldCalculationPrivate* const d;
@@ -0,0 +1,296 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_FORCEFIELDCALCULATIONBATCH_INLINE_H
+#define CHEMKIT_FORCEFIELDCALCULATIONBATCH_INLINE_H
+
+#include "forcefieldcalculationbatch.h"
+
+#include <algorithm>
+
+#include <chemkit/cartesiancoordinates.h>
+
+namespace chemkit {
+
+// === ForceFieldCalculationBatch ========================================== //
+/// Returns a pointer to the atomCount() atom indices for the
+/// calculation at \p index.
+inline const size_t* ForceFieldCalculationBatch::atoms(size_t index) const
+{
+    return &m_atoms[index * m_atomCount];
+}
+
+/// Returns a pointer to the parameterCount() parameters for the
+/// calculation at \p index.
+inline const Real* ForceFieldCalculationBatch::parameters(size_t index) const
+{
+    return &m_parameters[index * m_parameterCount];
+}
+
+// === ForceFieldCalculationBatchAdaptor =================================== //
+/// \class ForceFieldCalculationBatchAdaptor forcefieldcalculationbatch.h chemkit/forcefieldcalculationbatch.h
+/// \ingroup chemkit-md
+/// \brief The ForceFieldCalculationBatchAdaptor class evaluates a
+///        batch of calculations using the static kernels provided
+///        by the \c Calculation class.
+///
+/// The \c Calculation class must provide the following three static
+/// methods:
+/// \code
+/// static Real energy(const CartesianCoordinates *coordinates,
+///                    const size_t *atoms,
+///                    const Real *parameters);
+/// static void gradient(const CartesianCoordinates *coordinates,
+///                      const size_t *atoms,
+///                      const Real *parameters,
+///                      Vector3 *gradient);
+/// static Real energyAndGradient(const CartesianCoordinates *coordinates,
+///                               const size_t *atoms,
+///                               const Real *parameters,
+///                               Vector3 *gradient);
+/// \endcode
+///
+/// The energyAndGradient() method must return the same energy as
+/// energy() and write the same gradient as gradient().
+///
+/// If a cutoff is set for a batch of two-atom calculations, the
+/// energy of each calculation is multiplied by the switching function
+/// and calculations beyond the cutoff distance are skipped.
+
+// --- Construction and Destruction ---------------------------------------- //
+template<typename Calculation>
+inline ForceFieldCalculationBatchAdaptor<Calculation>::ForceFieldCalculationBatchAdaptor(int type,
+                                                                                          size_t atomCount,
+                                                                                          size_t parameterCount)
+    : ForceFieldCalculationBatch(type, atomCount, parameterCount)
+{
+}
+
+// --- Calculations -------------------------------------------------------- //
+template<typename Calculation>
+inline Real ForceFieldCalculationBatchAdaptor<Calculation>::energy(const CartesianCoordinates *coordinates,
+                                                                   size_t begin,
+                                                                   size_t end) const
+{
+    Real energy = 0;
+
+    if(cutoff() > 0 && atomCount() == 2){
+        for(size_t i = begin; i < end; i++){
+            const size_t *atoms = this->atoms(i);
+
+            Real distance = coordinates->distance(atoms[0], atoms[1]);
+            if(distance >= cutoff()){
+                continue;
+            }
+
+            Real derivative;
+            Real switching = switchingFunction(distance, &derivative);
+
+            energy += switching * Calculation::energy(coordinates, atoms, parameters(i));
+        }
+    }
+    else{
+        for(size_t i = begin; i < end; i++){
+            energy += Calculation::energy(coordinates, atoms(i), parameters(i));
+        }
+    }
+
+    return energy;
+}
+
+template<typename Calculation>
+inline void ForceFieldCalculationBatchAdaptor<Calculation>::gradient(const CartesianCoordinates *coordinates,
+                                                                     size_t begin,
+                                                                     size_t end,
+                                                                     Vector3 *gradient) const
+{
+    Vector3 atomGradients[MaxAtomCount];
+
+    for(size_t i = begin; i < end; i++){
+        if(!calculationGradient(coordinates, i, atomGradients)){
+            continue;
+        }
+
+        const size_t *atoms = this->atoms(i);
+
+        for(size_t j = 0; j < atomCount(); j++){
+            gradient[atoms[j]] += atomGradients[j];
+        }
+    }
+}
+
+template<typename Calculation>
+inline void ForceFieldCalculationBatchAdaptor<Calculation>::atomGradients(const CartesianCoordinates *coordinates,
+                                                                          size_t begin,
+                                                                          size_t end,
+                                                                          Vector3 *atomGradients) const
+{
+    for(size_t i = begin; i < end; i++){
+        Vector3 *calculationGradients = &atomGradients[(i - begin) * atomCount()];
+
+        if(!calculationGradient(coordinates, i, calculationGradients)){
+            std::fill(calculationGradients, calculationGradients + atomCount(), Vector3(0, 0, 0));
+        }
+    }
+}
+
+template<typename Calculation>
+inline Real ForceFieldCalculationBatchAdaptor<Calculation>::energyAndGradient(const CartesianCoordinates *coordinates,
+                                                                              size_t begin,
+                                                                              size_t end,
+                                                                              Vector3 *gradient) const
+{
+    Real energy = 0;
+    Vector3 atomGradients[MaxAtomCount];
+
+    for(size_t i = begin; i < end; i++){
+        Real calculationEnergy;
+        if(!calculationEnergyAndGradient(coordinates, i, &calculationEnergy, atomGradients)){
+            continue;
+        }
+
+        energy += calculationEnergy;
+
+        const size_t *atoms = this->atoms(i);
+
+        for(size_t j = 0; j < atomCount(); j++){
+            gradient[atoms[j]] += atomGradients[j];
+        }
+    }
+
+    return energy;
+}
+
+template<typename Calculation>
+inline Real ForceFieldCalculationBatchAdaptor<Calculation>::energyAndAtomGradients(const CartesianCoordinates *coordinates,
+                                                                                   size_t begin,
+                                                                                   size_t end,
+                                                                                   Vector3 *atomGradients) const
+{
+    Real energy = 0;
+
+    for(size_t i = begin; i < end; i++){
+        Vector3 *calculationGradients = &atomGradients[(i - begin) * atomCount()];
+
+        Real calculationEnergy;
+        if(!calculationEnergyAndGradient(coordinates, i, &calculationEnergy, calculationGradients)){
+            std::fill(calculationGradients, calculationGradients + atomCount(), Vector3(0, 0, 0));
+            continue;
+        }
+
+        energy += calculationEnergy;
+    }
+
+    return energy;
+}
+
+// Calculates the gradient for each atom in the calculation at index.
+// Returns false if the calculation is beyond the cutoff distance.
+template<typename Calculation>
+inline bool ForceFieldCalculationBatchAdaptor<Calculation>::calculationGradient(const CartesianCoordinates *coordinates,
+                                                                                size_t index,
+                                                                                Vector3 *atomGradients) const
+{
+    const size_t *atoms = this->atoms(index);
+
+    if(cutoff() > 0 && atomCount() == 2){
+        Real distance = coordinates->distance(atoms[0], atoms[1]);
+        if(distance >= cutoff()){
+            return false;
+        }
+
+        Real derivative;
+        Real switching = switchingFunction(distance, &derivative);
+
+        Calculation::gradient(coordinates, atoms, parameters(index), atomGradients);
+
+        if(derivative != 0){
+            // product rule: d(S*E)/dx = S*dE/dx + E*dS/dr*dr/dx
+            Real energy = Calculation::energy(coordinates, atoms, parameters(index));
+            Vector3 distanceGradient = ((*coordinates)[atoms[0]] - (*coordinates)[atoms[1]]) / distance;
+
+            atomGradients[0] = switching * atomGradients[0] + energy * derivative * distanceGradient;
+            atomGradients[1] = switching * atomGradients[1] - energy * derivative * distanceGradient;
+        }
+    }
+    else{
+        Calculation::gradient(coordinates, atoms, parameters(index), atomGradients);
+    }
+
+    return true;
+}
+
+// Calculates the energy and the gradient for each atom in the
+// calculation at index. Returns false if the calculation is beyond
+// the cutoff distance.
+template<typename Calculation>
+inline bool ForceFieldCalculationBatchAdaptor<Calculation>::calculationEnergyAndGradient(const CartesianCoordinates *coordinates,
+                                                                                         size_t index,
+                                                                                         Real *energy,
+                                                                                         Vector3 *atomGradients) const
+{
+    const size_t *atoms = this->atoms(index);
+
+    if(cutoff() > 0 && atomCount() == 2){
+        Real distance = coordinates->distance(atoms[0], atoms[1]);
+        if(distance >= cutoff()){
+            return false;
+        }
+
+        Real derivative;
+        Real switching = switchingFunction(distance, &derivative);
+
+        Real calculationEnergy = Calculation::energyAndGradient(coordinates, atoms, parameters(index), atomGradients);
+
+        if(derivative != 0){
+            // product rule: d(S*E)/dx = S*dE/dx + E*dS/dr*dr/dx
+            Vector3 distanceGradient = ((*coordinates)[atoms[0]] - (*coordinates)[atoms[1]]) / distance;
+
+            atomGradients[0] = switching * atomGradients[0] + calculationEnergy * derivative * distanceGradient;
+            atomGradients[1] = switching * atomGradients[1] - calculationEnergy * derivative * distanceGradient;
+        }
+
+        *energy = switching * calculationEnergy;
+    }
+    else{
+        *energy = Calculation::energyAndGradient(coordinates, atoms, parameters(index), atomGradients);
+    }
+
+    return true;
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_FORCEFIELDCALCULATIONBATCH_INLINE_H
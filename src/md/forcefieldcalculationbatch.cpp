@@ -0,0 +1,264 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "forcefieldcalculationbatch.h"
+
+#include <cassert>
+
+#include "forcefieldcalculation.h"
+
+namespace chemkit {
+
+// === ForceFieldCalculationBatch ========================================== //
+/// \class ForceFieldCalculationBatch forcefieldcalculationbatch.h chemkit/forcefieldcalculationbatch.h
+/// \ingroup chemkit-md
+/// \brief The ForceFieldCalculationBatch class stores a set of
+///        force field calculations of the same type in contiguous
+///        arrays.
+///
+/// Batches store the atom indices and parameters for each of their
+/// calculations in flat arrays and evaluate them all in a single
+/// loop. This avoids a virtual function call and a temporary
+/// gradient allocation per calculation. Batches are created by the
+/// force field from the calculations returned by
+/// ForceFieldCalculation::createBatch().
+///
+/// \see ForceFieldCalculationBatchAdaptor
+
+/// \var ForceFieldCalculationBatch::MaxAtomCount
+/// The maximum number of atoms in a batched calculation. This allows
+/// the gradient of each calculation to be stored on the stack.
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty calculation batch.
+ForceFieldCalculationBatch::ForceFieldCalculationBatch(int type,
+                                                       size_t atomCount,
+                                                       size_t parameterCount)
+    : m_type(type),
+      m_atomCount(atomCount),
+      m_parameterCount(parameterCount),
+      m_cutoff(0),
+      m_switchingDistance(0)
+{
+    assert(atomCount <= MaxAtomCount);
+}
+
+/// Destroys the calculation batch.
+ForceFieldCalculationBatch::~ForceFieldCalculationBatch()
+{
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the type of the calculations in the batch.
+///
+/// \see ForceFieldCalculation::type()
+int ForceFieldCalculationBatch::type() const
+{
+    return m_type;
+}
+
+/// Returns the number of calculations in the batch.
+size_t ForceFieldCalculationBatch::size() const
+{
+    return m_atomCount ? m_atoms.size() / m_atomCount : 0;
+}
+
+/// Returns \c true if the batch contains no calculations.
+bool ForceFieldCalculationBatch::isEmpty() const
+{
+    return m_atoms.empty();
+}
+
+/// Returns the number of atoms in each calculation.
+size_t ForceFieldCalculationBatch::atomCount() const
+{
+    return m_atomCount;
+}
+
+/// Returns the number of parameters in each calculation.
+size_t ForceFieldCalculationBatch::parameterCount() const
+{
+    return m_parameterCount;
+}
+
+/// Sets the cutoff distance for the calculations in the batch to
+/// \p cutoff. Calculations between two atoms further apart than the
+/// cutoff distance do not contribute to the energy or gradient. A
+/// cutoff of \c 0 (the default) disables the cutoff.
+///
+/// The cutoff is only applied to batches of two-atom calculations.
+void ForceFieldCalculationBatch::setCutoff(Real cutoff)
+{
+    m_cutoff = cutoff;
+}
+
+/// Returns the cutoff distance for the batch.
+Real ForceFieldCalculationBatch::cutoff() const
+{
+    return m_cutoff;
+}
+
+/// Sets the switching distance to \p distance. Between the switching
+/// distance and the cutoff distance the energy is smoothly scaled to
+/// zero. If the switching distance is \c 0 or not less than the
+/// cutoff distance the energy is truncated at the cutoff.
+void ForceFieldCalculationBatch::setSwitchingDistance(Real distance)
+{
+    m_switchingDistance = distance;
+}
+
+/// Returns the switching distance for the batch.
+Real ForceFieldCalculationBatch::switchingDistance() const
+{
+    return m_switchingDistance;
+}
+
+// --- Calculations -------------------------------------------------------- //
+/// Appends the atoms and parameters of \p calculation to the batch.
+void ForceFieldCalculationBatch::addCalculation(const ForceFieldCalculation *calculation)
+{
+    assert(calculation->atomCount() == m_atomCount);
+    assert(static_cast<size_t>(calculation->parameterCount()) == m_parameterCount);
+
+    for(size_t i = 0; i < m_atomCount; i++){
+        m_atoms.push_back(calculation->atom(i));
+    }
+
+    for(size_t i = 0; i < m_parameterCount; i++){
+        m_parameters.push_back(calculation->parameter(i));
+    }
+}
+
+/// Removes all of the calculations from the batch.
+void ForceFieldCalculationBatch::clear()
+{
+    m_atoms.clear();
+    m_parameters.clear();
+}
+
+/// Returns the total energy of the calculations in the batch.
+Real ForceFieldCalculationBatch::energy(const CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, 0, size());
+}
+
+/// Adds the gradient of the energy of the calculations in the batch
+/// to \p gradient.
+void ForceFieldCalculationBatch::gradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const
+{
+    if(!isEmpty()){
+        this->gradient(coordinates, 0, size(), &gradient[0]);
+    }
+}
+
+/// Adds the gradient of the energy of the calculations in the batch
+/// to \p gradient and returns their total energy.
+Real ForceFieldCalculationBatch::energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const
+{
+    if(isEmpty()){
+        return 0;
+    }
+
+    return energyAndGradient(coordinates, 0, size(), &gradient[0]);
+}
+
+/// \fn Real ForceFieldCalculationBatch::energy(const CartesianCoordinates *coordinates, size_t begin, size_t end) const
+/// Returns the total energy of the calculations in the range
+/// [\p begin, \p end).
+
+/// \fn void ForceFieldCalculationBatch::gradient(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *gradient) const
+/// Adds the gradient of the energy of the calculations in the range
+/// [\p begin, \p end) to \p gradient which contains one vector for
+/// each atom in the force field.
+
+/// \fn void ForceFieldCalculationBatch::atomGradients(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *atomGradients) const
+/// Writes the gradient for each atom of the calculations in the range
+/// [\p begin, \p end) to \p atomGradients. The atomCount() vectors
+/// for each calculation are stored consecutively. Calculations beyond
+/// the cutoff distance have zero gradients.
+
+/// \fn Real ForceFieldCalculationBatch::energyAndGradient(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *gradient) const
+/// Adds the gradient of the energy of the calculations in the range
+/// [\p begin, \p end) to \p gradient and returns their total energy.
+/// This gives the same result as calling energy() and gradient() but
+/// evaluates each calculation only once.
+
+/// \fn Real ForceFieldCalculationBatch::energyAndAtomGradients(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *atomGradients) const
+/// Writes the gradient for each atom of the calculations in the range
+/// [\p begin, \p end) to \p atomGradients in the same layout as
+/// atomGradients() and returns their total energy.
+
+/// Returns the value of the switching function at \p distance and
+/// stores its derivative with respect to the distance in
+/// \p derivative. The switching function is given by:
+///
+/// \f[ S(r) = \frac{(r_c^2 - r^2)^2 (r_c^2 + 2r^2 - 3r_s^2)}{(r_c^2 - r_s^2)^3} \f]
+///
+/// for distances between the switching distance \f$ r_s \f$ and
+/// the cutoff distance \f$ r_c \f$. The function is one below the
+/// switching distance and zero beyond the cutoff.
+Real ForceFieldCalculationBatch::switchingFunction(Real distance, Real *derivative) const
+{
+    *derivative = 0;
+
+    if(distance >= m_cutoff){
+        return 0;
+    }
+    else if(m_switchingDistance <= 0 ||
+            m_switchingDistance >= m_cutoff ||
+            distance <= m_switchingDistance){
+        return 1;
+    }
+
+    Real r2 = distance * distance;
+    Real rc2 = m_cutoff * m_cutoff;
+    Real rs2 = m_switchingDistance * m_switchingDistance;
+    Real denominator = (rc2 - rs2) * (rc2 - rs2) * (rc2 - rs2);
+
+    *derivative = 12 * distance * (rc2 - r2) * (rs2 - r2) / denominator;
+
+    return (rc2 - r2) * (rc2 - r2) * (rc2 + 2 * r2 - 3 * rs2) / denominator;
+}
+
+/// \fn Real ForceFieldCalculationBatch::energy(const CartesianCoordinates *coordinates) const
+///
+/// Returns the total energy of all the calculations in the batch.
+
+/// \fn void ForceFieldCalculationBatch::gradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const
+///
+/// Adds the gradient of each calculation in the batch to the
+/// corresponding atoms in \p gradient.
+
+} // end chemkit namespace
@@ -0,0 +1,129 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_FORCEFIELDCALCULATIONBATCH_H
+#define CHEMKIT_FORCEFIELDCALCULATIONBATCH_H
+
+#include "md.h"
+
+#include <vector>
+
+#include <chemkit/vector3.h>
+
+namespace chemkit {
+
+class CartesianCoordinates;
+class ForceFieldCalculation;
+
+class CHEMKIT_MD_EXPORT ForceFieldCalculationBatch
+{
+public:
+    // constants
+    enum {
+        MaxAtomCount = 4
+    };
+
+    // construction and destruction
+    virtual ~ForceFieldCalculationBatch();
+
+    // properties
+    int type() const;
+    size_t size() const;
+    bool isEmpty() const;
+    size_t atomCount() const;
+    size_t parameterCount() const;
+    void setCutoff(Real cutoff);
+    Real cutoff() const;
+    void setSwitchingDistance(Real distance);
+    Real switchingDistance() const;
+
+    // calculations
+    void addCalculation(const ForceFieldCalculation *calculation);
+    void clear();
+    inline const size_t* atoms(size_t index) const;
+    inline const Real* parameters(size_t index) const;
+    Real energy(const CartesianCoordinates *coordinates) const;
+    void gradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const;
+    Real energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const;
+    virtual Real energy(const CartesianCoordinates *coordinates, size_t begin, size_t end) const = 0;
+    virtual void gradient(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *gradient) const = 0;
+    virtual void atomGradients(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *atomGradients) const = 0;
+    virtual Real energyAndGradient(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *gradient) const = 0;
+    virtual Real energyAndAtomGradients(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *atomGradients) const = 0;
+
+protected:
+    ForceFieldCalculationBatch(int type, size_t atomCount, size_t parameterCount);
+    Real switchingFunction(Real distance, Real *derivative) const;
+
+private:
+    CHEMKIT_DISABLE_COPY(ForceFieldCalculationBatch)
+
+private:
+    int m_type;
+    size_t m_atomCount;
+    size_t m_parameterCount;
+    Real m_cutoff;
+    Real m_switchingDistance;
+    std::vector<size_t> m_atoms;
+    std::vector<Real> m_parameters;
+};
+
+template<typename Calculation>
+class ForceFieldCalculationBatchAdaptor : public ForceFieldCalculationBatch
+{
+public:
+    // construction and destruction
+    ForceFieldCalculationBatchAdaptor(int type, size_t atomCount, size_t parameterCount);
+
+    // calculations
+    using ForceFieldCalculationBatch::energy;
+    using ForceFieldCalculationBatch::gradient;
+    using ForceFieldCalculationBatch::energyAndGradient;
+    virtual Real energy(const CartesianCoordinates *coordinates, size_t begin, size_t end) const CHEMKIT_OVERRIDE;
+    virtual void gradient(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *gradient) const CHEMKIT_OVERRIDE;
+    virtual void atomGradients(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *atomGradients) const CHEMKIT_OVERRIDE;
+    virtual Real energyAndGradient(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *gradient) const CHEMKIT_OVERRIDE;
+    virtual Real energyAndAtomGradients(const CartesianCoordinates *coordinates, size_t begin, size_t end, Vector3 *atomGradients) const CHEMKIT_OVERRIDE;
+
+private:
+    inline bool calculationGradient(const CartesianCoordinates *coordinates, size_t index, Vector3 *atomGradients) const;
+    inline bool calculationEnergyAndGradient(const CartesianCoordinates *coordinates, size_t index, Real *energy, Vector3 *atomGradients) const;
+};
+
+} // end chemkit namespace
+
+#include "forcefieldcalculationbatch-inline.h"
+
+#endif // CHEMKIT_FORCEFIELDCALCULATIONBATCH_H
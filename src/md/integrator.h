@@ -68,6 +68,7 @@ public:
     // energy
     Real energy() const;
     std::vector<Vector3> gradient() const;
+    Real energyAndGradient(std::vector<Vector3> &gradient) const;
     Real rmsg() const;
 
     // integration
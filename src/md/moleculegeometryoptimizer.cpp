@@ -35,6 +35,10 @@
 
 #include "moleculegeometryoptimizer.h"
 
+#include <deque>
+#include <cmath>
+#include <algorithm>
+
 #include <boost/make_shared.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
 
@@ -50,7 +54,303 @@ namespace chemkit {
 
 namespace {
 
-class SteepestDescentIntegrator : public Integrator
+// Returns the dot product of a and b.
+Real dot(const std::vector<Vector3> &a, const std::vector<Vector3> &b)
+{
+    Real sum = 0;
+
+    for(size_t i = 0; i < a.size(); i++){
+        sum += a[i].dot(b[i]);
+    }
+
+    return sum;
+}
+
+// === MinimizerIntegrator ================================================= //
+// Base class for the energy minimization algorithms. Counts the
+// number of potential evaluations and provides a line search for
+// the gradient based minimizers.
+class MinimizerIntegrator : public Integrator
+{
+public:
+    MinimizerIntegrator();
+
+    size_t evaluationCount() const;
+    bool isStalled() const;
+    virtual Real currentRmsg();
+    virtual void reset();
+
+protected:
+    Real evaluate(std::vector<Vector3> &gradient);
+    Real evaluateEnergy();
+    void evaluateGradient(std::vector<Vector3> &gradient);
+    void wiggle();
+    bool lineSearch(const std::vector<Vector3> &direction, Real initialStep, Real curvature);
+
+protected:
+    size_t m_evaluationCount;
+    bool m_stalled;
+    bool m_current;
+    Real m_energy;
+    std::vector<Vector3> m_gradient;
+    Real m_step;
+
+private:
+    Real evaluateAt(Real step, std::vector<Vector3> &gradient);
+    Real interpolate(Real a, Real fa, Real da, Real b, Real fb, Real db) const;
+
+private:
+    std::vector<Point3> m_origin;
+    const std::vector<Vector3> *m_direction;
+};
+
+MinimizerIntegrator::MinimizerIntegrator()
+    : m_evaluationCount(0),
+      m_stalled(false),
+      m_current(false),
+      m_energy(0),
+      m_step(0),
+      m_direction(0)
+{
+}
+
+// Returns the number of energy and gradient evaluations performed.
+size_t MinimizerIntegrator::evaluationCount() const
+{
+    return m_evaluationCount;
+}
+
+// Returns true if the minimizer is unable to lower the energy any
+// further.
+bool MinimizerIntegrator::isStalled() const
+{
+    return m_stalled;
+}
+
+// Returns the root-mean-square gradient at the current coordinates.
+Real MinimizerIntegrator::currentRmsg()
+{
+    m_evaluationCount++;
+
+    return rmsg();
+}
+
+// Discards any state kept from previous steps.
+void MinimizerIntegrator::reset()
+{
+    m_evaluationCount = 0;
+    m_stalled = false;
+    m_current = false;
+}
+
+// Returns the energy and calculates the gradient at the current
+// coordinates.
+Real MinimizerIntegrator::evaluate(std::vector<Vector3> &gradient)
+{
+    m_evaluationCount++;
+
+    return potential()->energyAndGradient(coordinates(), gradient);
+}
+
+// Returns the energy at the current coordinates.
+Real MinimizerIntegrator::evaluateEnergy()
+{
+    m_evaluationCount++;
+
+    return potential()->energy(coordinates());
+}
+
+// Calculates the gradient at the current coordinates.
+void MinimizerIntegrator::evaluateGradient(std::vector<Vector3> &gradient)
+{
+    m_evaluationCount++;
+
+    gradient = potential()->gradient(coordinates());
+}
+
+// Moves each atom by one Angstrom in a random direction. This is
+// used to recover when the energy or gradient is not a number, most
+// likely because the simulation exploded.
+void MinimizerIntegrator::wiggle()
+{
+    CartesianCoordinates *coordinates = this->coordinates();
+
+    for(size_t atomIndex = 0; atomIndex < coordinates->size(); atomIndex++){
+        (*coordinates)[atomIndex] += Vector3::Random().normalized();
+    }
+
+    m_current = false;
+}
+
+// Moves the coordinates along direction to a point satisfying the
+// strong Wolfe conditions. The energy and gradient at the accepted
+// point are stored in m_energy and m_gradient which must hold the
+// values for the current coordinates when called, and the step
+// length in m_step. Returns false if no such point was found, in
+// which case the coordinates are moved to the lowest energy point
+// seen if it is below the initial energy.
+bool MinimizerIntegrator::lineSearch(const std::vector<Vector3> &direction, Real initialStep, Real curvature)
+{
+    const Real decrease = 1e-4;
+    const size_t maximumEvaluations = 20;
+
+    CartesianCoordinates *coordinates = this->coordinates();
+
+    m_direction = &direction;
+    m_origin.resize(coordinates->size());
+    for(size_t i = 0; i < coordinates->size(); i++){
+        m_origin[i] = (*coordinates)[i];
+    }
+
+    // never move an atom by more than one angstrom
+    Real maximumDisplacement = 0;
+    for(size_t i = 0; i < direction.size(); i++){
+        maximumDisplacement = std::max(maximumDisplacement, direction[i].norm());
+    }
+    if(maximumDisplacement == 0){
+        return false;
+    }
+
+    Real maximumStep = 1.0 / maximumDisplacement;
+
+    Real f0 = m_energy;
+    Real d0 = dot(m_gradient, direction);
+    if(!(d0 < 0)){
+        return false;
+    }
+
+    // lower (lo) and upper (hi) bounds of the bracketing interval
+    Real lo = 0, loEnergy = f0, loSlope = d0;
+    Real hi = 0, hiEnergy = 0, hiSlope = 0;
+    std::vector<Vector3> loGradient = m_gradient;
+    std::vector<Vector3> gradient;
+
+    bool bracketed = false;
+    Real step = std::min(initialStep, maximumStep);
+
+    for(size_t i = 0; i < maximumEvaluations; i++){
+        if(bracketed){
+            step = interpolate(lo, loEnergy, loSlope, hi, hiEnergy, hiSlope);
+        }
+
+        Real energy = evaluateAt(step, gradient);
+        Real slope = dot(gradient, direction);
+
+        if(!(boost::math::isfinite)(energy) ||
+           energy > f0 + decrease * step * d0 ||
+           energy >= loEnergy){
+            // too far, shrink the interval
+            hi = step;
+            hiEnergy = energy;
+            hiSlope = slope;
+            bracketed = true;
+            continue;
+        }
+
+        if(std::abs(slope) <= -curvature * d0){
+            m_step = step;
+            m_energy = energy;
+            m_gradient.swap(gradient);
+            return true;
+        }
+
+        if(!bracketed && slope < 0){
+            // still descending, move further along the direction
+            lo = step;
+            loEnergy = energy;
+            loSlope = slope;
+            loGradient.swap(gradient);
+
+            if(step >= maximumStep){
+                break;
+            }
+
+            step = std::min(2 * step, maximumStep);
+            continue;
+        }
+
+        if(bracketed && slope * (hi - lo) >= 0){
+            hi = lo;
+            hiEnergy = loEnergy;
+            hiSlope = loSlope;
+        }
+        else if(!bracketed){
+            hi = lo;
+            hiEnergy = loEnergy;
+            hiSlope = loSlope;
+            bracketed = true;
+        }
+
+        lo = step;
+        loEnergy = energy;
+        loSlope = slope;
+        loGradient.swap(gradient);
+    }
+
+    // fall back to the best point found
+    for(size_t i = 0; i < coordinates->size(); i++){
+        (*coordinates)[i] = m_origin[i] + direction[i] * lo;
+    }
+
+    if(lo == 0){
+        return false;
+    }
+
+    m_step = lo;
+    m_energy = loEnergy;
+    m_gradient.swap(loGradient);
+    return true;
+}
+
+// Moves the coordinates to the given step along the line search
+// direction and returns the energy and gradient there.
+Real MinimizerIntegrator::evaluateAt(Real step, std::vector<Vector3> &gradient)
+{
+    CartesianCoordinates *coordinates = this->coordinates();
+    const std::vector<Vector3> &direction = *m_direction;
+
+    for(size_t i = 0; i < coordinates->size(); i++){
+        (*coordinates)[i] = m_origin[i] + direction[i] * step;
+    }
+
+    return evaluate(gradient);
+}
+
+// Returns the minimizer of the cubic interpolating the energy and
+// slope at a and b, kept safely inside the interval.
+Real MinimizerIntegrator::interpolate(Real a, Real fa, Real da, Real b, Real fb, Real db) const
+{
+    Real lower = std::min(a, b);
+    Real upper = std::max(a, b);
+    Real margin = 0.1 * (upper - lower);
+    Real step = 0.5 * (a + b);
+
+    if((boost::math::isfinite)(fb) && a != b){
+        Real d1 = da + db - 3 * (fa - fb) / (a - b);
+        Real d2 = d1 * d1 - da * db;
+
+        if(d2 >= 0){
+            d2 = std::sqrt(d2);
+            if(b < a){
+                d2 = -d2;
+            }
+
+            Real denominator = db - da + 2 * d2;
+            if(denominator != 0){
+                step = b - (b - a) * (db + d2 - d1) / denominator;
+            }
+        }
+    }
+
+    if(!(boost::math::isfinite)(step) || step < lower + margin || step > upper - margin){
+        step = 0.5 * (a + b);
+    }
+
+    return step;
+}
+
+// === SteepestDescentIntegrator =========================================== //
+class SteepestDescentIntegrator : public MinimizerIntegrator
 {
 public:
     void integrate() CHEMKIT_OVERRIDE;
@@ -71,8 +371,8 @@ void SteepestDescentIntegrator::integrate()
     size_t stepCount = 10;
 
     // calculate initial energy and gradient
-    Real initialEnergy = potential->energy(coordinates);
-    std::vector<Vector3> gradient = potential->gradient(coordinates);
+    std::vector<Vector3> gradient;
+    Real initialEnergy = evaluate(gradient);
 
     // perform line search
     for(size_t i = 0; i < stepCount; i++){
@@ -85,21 +385,18 @@ void SteepestDescentIntegrator::integrate()
         }
 
         // calculate new energy
-        Real finalEnergy = potential->energy(coordinates);
+        Real finalEnergy = evaluateEnergy();
 
         // if the final energy is NaN then most likely the
         // simulation exploded so we reset the initial atom
         // positions and then 'wiggle' each atom by one
         // Angstrom in a random direction
         if((boost::math::isnan)(finalEnergy)){
-            for(size_t atomIndex = 0; atomIndex < potential->size(); atomIndex++){
-                Point3 position = initialCoordinates.position(atomIndex);
-                position += Vector3::Random().normalized();
-                coordinates->setPosition(atomIndex, position);
-            }
+            *coordinates = initialCoordinates;
+            wiggle();
 
             // recalculate gradient
-            gradient = potential->gradient(coordinates);
+            evaluateGradient(gradient);
 
             // continue to next step
             continue;
@@ -131,6 +428,258 @@ void SteepestDescentIntegrator::integrate()
     }
 }
 
+// === GradientMinimizerIntegrator ========================================= //
+// Base class for minimizers which keep the energy and gradient of
+// the current coordinates between steps.
+class GradientMinimizerIntegrator : public MinimizerIntegrator
+{
+public:
+    Real currentRmsg() CHEMKIT_OVERRIDE;
+
+protected:
+    void update();
+};
+
+Real GradientMinimizerIntegrator::currentRmsg()
+{
+    if(!potential() || !potential()->size()){
+        return 0;
+    }
+
+    update();
+
+    return std::sqrt(dot(m_gradient, m_gradient) / (3.0 * potential()->size()));
+}
+
+// Evaluates the energy and gradient at the current coordinates
+// unless they are already known.
+void GradientMinimizerIntegrator::update()
+{
+    if(m_current){
+        return;
+    }
+
+    m_energy = evaluate(m_gradient);
+    m_current = true;
+}
+
+// === ConjugateGradientIntegrator ========================================= //
+// Nonlinear conjugate gradient minimizer using the Polak-Ribiere
+// formula with automatic restarts.
+class ConjugateGradientIntegrator : public GradientMinimizerIntegrator
+{
+public:
+    ConjugateGradientIntegrator();
+
+    void integrate() CHEMKIT_OVERRIDE;
+    void reset() CHEMKIT_OVERRIDE;
+
+private:
+    std::vector<Vector3> m_direction;
+    std::vector<Vector3> m_previousGradient;
+    Real m_previousSlope;
+    Real m_previousStep;
+    size_t m_iteration;
+};
+
+ConjugateGradientIntegrator::ConjugateGradientIntegrator()
+    : m_previousSlope(0),
+      m_previousStep(0),
+      m_iteration(0)
+{
+}
+
+void ConjugateGradientIntegrator::reset()
+{
+    GradientMinimizerIntegrator::reset();
+
+    m_direction.clear();
+    m_previousGradient.clear();
+    m_previousStep = 0;
+    m_previousSlope = 0;
+    m_iteration = 0;
+}
+
+void ConjugateGradientIntegrator::integrate()
+{
+    if(!potential() || !coordinates() || !potential()->size()){
+        return;
+    }
+
+    update();
+
+    if(!(boost::math::isfinite)(m_energy + dot(m_gradient, m_gradient))){
+        wiggle();
+        m_direction.clear();
+        m_previousStep = 0;
+        return;
+    }
+
+    // restart with steepest descent every 3N steps
+    size_t size = m_gradient.size();
+    bool restart = m_direction.size() != size || m_iteration % (3 * size) == 0;
+
+    if(!restart){
+        Real beta = (dot(m_gradient, m_gradient) - dot(m_gradient, m_previousGradient)) /
+                    dot(m_previousGradient, m_previousGradient);
+        beta = std::max(Real(0), beta);
+
+        for(size_t i = 0; i < size; i++){
+            m_direction[i] = -m_gradient[i] + beta * m_direction[i];
+        }
+
+        if(dot(m_direction, m_gradient) >= 0){
+            restart = true;
+        }
+    }
+
+    if(restart){
+        m_direction.resize(size);
+        for(size_t i = 0; i < size; i++){
+            m_direction[i] = -m_gradient[i];
+        }
+        m_iteration = 0;
+    }
+
+    // initial step assumes the same decrease as the previous step
+    Real slope = dot(m_gradient, m_direction);
+    Real initialStep = m_previousStep > 0 ? m_previousStep * m_previousSlope / slope : 0.1;
+
+    m_previousGradient = m_gradient;
+    m_previousSlope = slope;
+
+    if(!lineSearch(m_direction, initialStep, 0.1)){
+        // restart with steepest descent, unless that already failed
+        m_stalled = restart;
+        m_direction.clear();
+        m_previousStep = 0;
+        return;
+    }
+
+    m_previousStep = m_step;
+    m_iteration++;
+}
+
+// === LbfgsIntegrator ===================================================== //
+// Limited memory BFGS minimizer.
+class LbfgsIntegrator : public GradientMinimizerIntegrator
+{
+public:
+    void integrate() CHEMKIT_OVERRIDE;
+    void reset() CHEMKIT_OVERRIDE;
+
+private:
+    enum {
+        HistorySize = 8
+    };
+
+    std::deque<std::vector<Vector3> > m_s;
+    std::deque<std::vector<Vector3> > m_y;
+    std::deque<Real> m_rho;
+};
+
+void LbfgsIntegrator::reset()
+{
+    GradientMinimizerIntegrator::reset();
+
+    m_s.clear();
+    m_y.clear();
+    m_rho.clear();
+}
+
+void LbfgsIntegrator::integrate()
+{
+    if(!potential() || !coordinates() || !potential()->size()){
+        return;
+    }
+
+    update();
+
+    if(!(boost::math::isfinite)(m_energy + dot(m_gradient, m_gradient))){
+        wiggle();
+        m_s.clear();
+        m_y.clear();
+        m_rho.clear();
+        return;
+    }
+
+    size_t size = m_gradient.size();
+
+    // two-loop recursion for the search direction
+    std::vector<Vector3> direction(size);
+    for(size_t i = 0; i < size; i++){
+        direction[i] = -m_gradient[i];
+    }
+
+    std::vector<Real> alpha(m_s.size());
+    for(size_t k = m_s.size(); k-- > 0; ){
+        alpha[k] = m_rho[k] * dot(m_s[k], direction);
+        for(size_t i = 0; i < size; i++){
+            direction[i] -= alpha[k] * m_y[k][i];
+        }
+    }
+
+    Real initialStep = 1;
+    if(m_s.empty()){
+        // first step moves the atom with the largest gradient by 0.1 A
+        Real maximum = 0;
+        for(size_t i = 0; i < size; i++){
+            maximum = std::max(maximum, m_gradient[i].norm());
+        }
+        initialStep = maximum > 0 ? 0.1 / maximum : 1;
+    }
+    else{
+        Real gamma = dot(m_s.back(), m_y.back()) / dot(m_y.back(), m_y.back());
+        for(size_t i = 0; i < size; i++){
+            direction[i] *= gamma;
+        }
+    }
+
+    for(size_t k = 0; k < m_s.size(); k++){
+        Real beta = m_rho[k] * dot(m_y[k], direction);
+        for(size_t i = 0; i < size; i++){
+            direction[i] += (alpha[k] - beta) * m_s[k][i];
+        }
+    }
+
+    std::vector<Point3> origin(size);
+    for(size_t i = 0; i < size; i++){
+        origin[i] = (*coordinates())[i];
+    }
+    std::vector<Vector3> previousGradient = m_gradient;
+
+    if(!lineSearch(direction, initialStep, 0.9)){
+        // discard the curvature history and retry with steepest
+        // descent, unless that already failed
+        m_stalled = m_s.empty();
+        m_s.clear();
+        m_y.clear();
+        m_rho.clear();
+        return;
+    }
+
+    // update curvature history
+    std::vector<Vector3> s(size);
+    std::vector<Vector3> y(size);
+    for(size_t i = 0; i < size; i++){
+        s[i] = (*coordinates())[i] - origin[i];
+        y[i] = m_gradient[i] - previousGradient[i];
+    }
+
+    Real sy = dot(s, y);
+    if(sy > 1e-10){
+        if(m_s.size() == HistorySize){
+            m_s.pop_front();
+            m_y.pop_front();
+            m_rho.pop_front();
+        }
+
+        m_s.push_back(s);
+        m_y.push_back(y);
+        m_rho.push_back(1.0 / sy);
+    }
+}
+
 } // end anonymous namespace
 
 // === MoleculeGeometryOptimizerPrivate ==================================== //
@@ -141,9 +690,25 @@ public:
     boost::shared_ptr<ForceField> forceField;
     std::string forceFieldName;
     std::string errorString;
-    boost::shared_ptr<Integrator> integrator;
+    MoleculeGeometryOptimizer::Algorithm algorithm;
+    boost::shared_ptr<MinimizerIntegrator> integrator;
+
+    static boost::shared_ptr<MinimizerIntegrator> createIntegrator(MoleculeGeometryOptimizer::Algorithm algorithm);
 };
 
+// Returns a new integrator implementing algorithm.
+boost::shared_ptr<MinimizerIntegrator> MoleculeGeometryOptimizerPrivate::createIntegrator(MoleculeGeometryOptimizer::Algorithm algorithm)
+{
+    switch(algorithm){
+    case MoleculeGeometryOptimizer::SteepestDescent:
+        return boost::make_shared<SteepestDescentIntegrator>();
+    case MoleculeGeometryOptimizer::ConjugateGradient:
+        return boost::make_shared<ConjugateGradientIntegrator>();
+    default:
+        return boost::make_shared<LbfgsIntegrator>();
+    }
+}
+
 // === MoleculeGeometryOptimizer =========================================== //
 /// \class MoleculeGeometryOptimizer moleculegeometryoptimizer.h chemkit/moleculegeometryoptimizer.h
 /// \ingroup chemkit-md
@@ -156,6 +721,12 @@ public:
 ///
 /// By default the UFF force field is used.
 ///
+/// The minimization algorithm can be selected with setAlgorithm().
+/// The default, L-BFGS, typically converges with far fewer energy
+/// evaluations than steepest descent. Both L-BFGS and conjugate
+/// gradient use a line search satisfying the strong Wolfe
+/// conditions.
+///
 /// The easiest way to optimize the geometry for a molecule is to
 /// use the optimizeCoordinate() static method as follows:
 /// \code
@@ -179,6 +750,12 @@ public:
 ///
 /// \see ForceField
 
+/// \enum MoleculeGeometryOptimizer::Algorithm
+/// Provides the minimization algorithms:
+///     - \c SteepestDescent
+///     - \c ConjugateGradient
+///     - \c Lbfgs
+
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new geometry optimizer for \p molecule.
 MoleculeGeometryOptimizer::MoleculeGeometryOptimizer(Molecule *molecule)
@@ -186,7 +763,8 @@ MoleculeGeometryOptimizer::MoleculeGeometryOptimizer(Molecule *molecule)
 {
     d->molecule = molecule;
     d->forceFieldName = "uff";
-    d->integrator = boost::make_shared<SteepestDescentIntegrator>();
+    d->algorithm = Lbfgs;
+    d->integrator = d->createIntegrator(d->algorithm);
 }
 
 /// Destroys the geometry optmizer object.
@@ -228,6 +806,34 @@ std::string MoleculeGeometryOptimizer::forceField() const
     return d->forceFieldName;
 }
 
+/// Sets the minimization algorithm to \p algorithm. The default is
+/// \c Lbfgs.
+///
+/// \see Algorithm
+void MoleculeGeometryOptimizer::setAlgorithm(Algorithm algorithm)
+{
+    if(algorithm == d->algorithm){
+        return;
+    }
+
+    boost::shared_ptr<MinimizerIntegrator> integrator = d->createIntegrator(algorithm);
+
+    // continue from the current coordinates
+    if(d->forceField){
+        integrator->setPotential(d->forceField);
+        integrator->setCoordinates(d->integrator->coordinates());
+    }
+
+    d->algorithm = algorithm;
+    d->integrator = integrator;
+}
+
+/// Returns the minimization algorithm.
+MoleculeGeometryOptimizer::Algorithm MoleculeGeometryOptimizer::algorithm() const
+{
+    return d->algorithm;
+}
+
 // --- Energy -------------------------------------------------------------- //
 /// Returns the current energy of the force field.
 Real MoleculeGeometryOptimizer::energy() const
@@ -254,6 +860,7 @@ bool MoleculeGeometryOptimizer::setup()
         return false;
     }
 
+    d->integrator->reset();
     d->integrator->setPotential(d->forceField);
     d->integrator->setCoordinates(d->molecule->coordinates());
 
@@ -266,17 +873,21 @@ bool MoleculeGeometryOptimizer::setup()
     return true;
 }
 
-/// Performs a single geometry optimization step. Returns \c true if
-/// converged. The minimization is considered converged when the
-/// root mean square gradient is below the convergance value.
-void MoleculeGeometryOptimizer::step()
+/// Performs a single geometry optimization step. Returns \c false
+/// if the step could not be performed or if the algorithm has
+/// stalled and is unable to lower the energy any further. Further
+/// steps will not change the geometry once this happens so callers
+/// should stop stepping even if converged() is \c false.
+bool MoleculeGeometryOptimizer::step()
 {
     if(!d->molecule || !d->forceField){
-        return;
+        return false;
     }
 
     // perform a single integration step
     d->integrator->integrate();
+
+    return !d->integrator->isStalled();
 }
 
 /// Returns \c true if the optimization algorithm has converged. By
@@ -289,7 +900,7 @@ bool MoleculeGeometryOptimizer::converged()
     }
 
     // check for convergance
-    return d->integrator->rmsg() < 0.1;
+    return d->integrator->currentRmsg() < 0.1;
 }
 
 /// Optimizes the geometry of the molecule. Returns \c true if the
@@ -300,14 +911,17 @@ bool MoleculeGeometryOptimizer::optimize()
         return false;
     }
 
-    while(!converged()){
+    bool converged = this->converged();
+
+    while(!converged && !d->integrator->isStalled()){
         step();
+        converged = this->converged();
     }
 
     // write the optimized coordinates to the molecule
     writeCoordinates();
 
-    return true;
+    return converged;
 }
 
 /// Writes the optimized coordinates to the molecule.
@@ -324,6 +938,15 @@ void MoleculeGeometryOptimizer::writeCoordinates()
     }
 }
 
+/// Returns the number of energy and gradient evaluations performed
+/// since the last call to setup(). Evaluating both the energy and
+/// the gradient for the same coordinates counts as a single
+/// evaluation.
+size_t MoleculeGeometryOptimizer::evaluationCount() const
+{
+    return d->integrator->evaluationCount();
+}
+
 // --- Error Handling ------------------------------------------------------ //
 /// Returns a string describing the last error that occurred.
 std::string MoleculeGeometryOptimizer::errorString() const
@@ -50,6 +50,13 @@ class MoleculeGeometryOptimizerPrivate;
 class CHEMKIT_MD_EXPORT MoleculeGeometryOptimizer
 {
 public:
+    // enumerations
+    enum Algorithm {
+        SteepestDescent,
+        ConjugateGradient,
+        Lbfgs
+    };
+
     // construction and destruction
     MoleculeGeometryOptimizer(Molecule *molecule = 0);
     ~MoleculeGeometryOptimizer();
@@ -59,16 +66,19 @@ public:
     Molecule* molecule() const;
     bool setForceField(const std::string &forceField);
     std::string forceField() const;
+    void setAlgorithm(Algorithm algorithm);
+    Algorithm algorithm() const;
 
     // energy
     Real energy() const;
 
     // optimization
     bool setup();
-    void step();
+    bool step();
     bool converged();
     bool optimize();
     void writeCoordinates();
+    size_t evaluationCount() const;
 
     // error handling
     std::string errorString() const;
@@ -0,0 +1,310 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "neighborlist.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <chemkit/foreach.h>
+#include <chemkit/spatialindex.h>
+#include <chemkit/cartesiancoordinates.h>
+
+#include "topology.h"
+
+namespace chemkit {
+
+// === NeighborListPrivate ================================================= //
+class NeighborListPrivate
+{
+public:
+    void buildExclusions();
+
+    const Topology *topology;
+    Real cutoff;
+    Real skin;
+    std::vector<NeighborList::Pair> pairs;
+    std::vector<std::vector<size_t> > exclusions;
+    std::vector<Point3> referencePositions;
+};
+
+// Builds the list of excluded atom pairs. Pairs of atoms which are
+// bonded to each other or bonded to a common atom (1-2 and 1-3 pairs)
+// are excluded from the neighbor list.
+void NeighborListPrivate::buildExclusions()
+{
+    size_t size = topology->size();
+
+    std::vector<std::vector<size_t> > neighbors(size);
+    foreach(const Topology::BondedInteraction &interaction, topology->bondedInteractions()){
+        neighbors[interaction[0]].push_back(interaction[1]);
+        neighbors[interaction[1]].push_back(interaction[0]);
+    }
+
+    exclusions.assign(size, std::vector<size_t>());
+
+    for(size_t i = 0; i < size; i++){
+        const std::vector<size_t> &atomNeighbors = neighbors[i];
+
+        for(size_t j = 0; j < atomNeighbors.size(); j++){
+            size_t a = atomNeighbors[j];
+
+            // 1-2 pair
+            if(i < a){
+                exclusions[i].push_back(a);
+            }
+
+            // 1-3 pairs
+            for(size_t k = j + 1; k < atomNeighbors.size(); k++){
+                size_t b = atomNeighbors[k];
+
+                exclusions[std::min(a, b)].push_back(std::max(a, b));
+            }
+        }
+    }
+
+    for(size_t i = 0; i < size; i++){
+        std::vector<size_t> &atomExclusions = exclusions[i];
+
+        std::sort(atomExclusions.begin(), atomExclusions.end());
+        atomExclusions.erase(std::unique(atomExclusions.begin(), atomExclusions.end()),
+                             atomExclusions.end());
+    }
+}
+
+// === NeighborList ======================================================== //
+/// \class NeighborList neighborlist.h chemkit/neighborlist.h
+/// \ingroup chemkit-md
+/// \brief The NeighborList class maintains a list of nonbonded atom
+///        pairs within a cutoff distance.
+///
+/// The neighbor list contains each pair of atoms that are within
+/// cutoff() + skin() of each other. The pairs are found using a
+/// SpatialIndex which allows the list to be built in linear time
+/// with respect to the number of atoms.
+///
+/// Pairs of atoms that are bonded to each other or to a common atom
+/// in the topology are excluded from the list.
+///
+/// Because the list includes pairs up to the skin distance beyond the
+/// cutoff it only needs to be rebuilt once an atom has moved more than
+/// half of the skin distance. The update() method checks this and
+/// rebuilds the list only when necessary:
+/// \code
+/// NeighborList neighborList(topology, 8.0);
+///
+/// // the first call always builds the list
+/// neighborList.update(coordinates);
+///
+/// foreach(const NeighborList::Pair &pair, neighborList.pairs()){
+///     ...
+/// }
+/// \endcode
+///
+/// \see ForceField::setNonbondedCutoff()
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new neighbor list for \p topology with \p cutoff and
+/// \p skin distances (in Angstroms).
+NeighborList::NeighborList(const Topology *topology, Real cutoff, Real skin)
+    : d(new NeighborListPrivate)
+{
+    d->topology = topology;
+    d->cutoff = cutoff;
+    d->skin = skin;
+    d->buildExclusions();
+}
+
+/// Destroys the neighbor list object.
+NeighborList::~NeighborList()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the topology for the neighbor list.
+const Topology* NeighborList::topology() const
+{
+    return d->topology;
+}
+
+/// Sets the cutoff distance to \p cutoff. This invalidates the list.
+void NeighborList::setCutoff(Real cutoff)
+{
+    d->cutoff = cutoff;
+    invalidate();
+}
+
+/// Returns the cutoff distance.
+Real NeighborList::cutoff() const
+{
+    return d->cutoff;
+}
+
+/// Sets the skin distance to \p skin. This invalidates the list.
+void NeighborList::setSkin(Real skin)
+{
+    d->skin = skin;
+    invalidate();
+}
+
+/// Returns the skin distance. The default skin distance is two
+/// Angstroms.
+Real NeighborList::skin() const
+{
+    return d->skin;
+}
+
+// --- Pairs --------------------------------------------------------------- //
+/// Returns a range containing each pair of atoms in the neighbor
+/// list. Pairs are ordered by their first atom index and the first
+/// atom index is always less than the second.
+NeighborList::PairRange NeighborList::pairs() const
+{
+    return boost::make_iterator_range(d->pairs.begin(), d->pairs.end());
+}
+
+/// Returns the number of pairs in the neighbor list.
+size_t NeighborList::pairCount() const
+{
+    return d->pairs.size();
+}
+
+/// Returns \c true if the pair of atoms \p i and \p j is excluded
+/// from the neighbor list.
+bool NeighborList::isExcluded(size_t i, size_t j) const
+{
+    if(i > j){
+        std::swap(i, j);
+    }
+
+    const std::vector<size_t> &atomExclusions = d->exclusions[i];
+
+    return std::binary_search(atomExclusions.begin(), atomExclusions.end(), j);
+}
+
+// --- Update -------------------------------------------------------------- //
+/// Rebuilds the neighbor list from \p coordinates if necessary.
+/// Returns \c true if the list was rebuilt.
+///
+/// \see needsUpdate()
+bool NeighborList::update(const CartesianCoordinates *coordinates)
+{
+    if(!needsUpdate(coordinates)){
+        return false;
+    }
+
+    rebuild(coordinates);
+    return true;
+}
+
+/// Returns \c true if the neighbor list needs to be rebuilt for
+/// \p coordinates. This is the case if any atom has moved more than
+/// half of the skin distance since the list was last built.
+bool NeighborList::needsUpdate(const CartesianCoordinates *coordinates) const
+{
+    if(d->referencePositions.size() != coordinates->size()){
+        return true;
+    }
+
+    Real threshold = 0.25 * d->skin * d->skin;
+
+    for(size_t i = 0; i < coordinates->size(); i++){
+        if(((*coordinates)[i] - d->referencePositions[i]).squaredNorm() > threshold){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Rebuilds the neighbor list from \p coordinates.
+void NeighborList::rebuild(const CartesianCoordinates *coordinates)
+{
+    size_t size = std::min(coordinates->size(), d->topology->size());
+
+    d->pairs.clear();
+    d->referencePositions.resize(coordinates->size());
+    for(size_t i = 0; i < coordinates->size(); i++){
+        d->referencePositions[i] = (*coordinates)[i];
+    }
+
+    if(size == 0){
+        return;
+    }
+
+    Real range = d->cutoff + d->skin;
+
+    SpatialIndex index(coordinates, range);
+
+    // the pairs are sorted, so the exclusions for each atom can be
+    // skipped with a single pass over its sorted exclusion list
+    size_t current = size;
+    std::vector<size_t>::const_iterator exclusion;
+
+    foreach(const SpatialIndex::Pair &pair, index.pairs(range)){
+        size_t i = pair[0];
+        size_t j = pair[1];
+
+        if(j >= size){
+            continue;
+        }
+
+        if(i != current){
+            current = i;
+            exclusion = d->exclusions[i].begin();
+        }
+
+        const std::vector<size_t> &atomExclusions = d->exclusions[i];
+        while(exclusion != atomExclusions.end() && *exclusion < j){
+            ++exclusion;
+        }
+
+        if(exclusion != atomExclusions.end() && *exclusion == j){
+            continue;
+        }
+
+        d->pairs.push_back(pair);
+    }
+}
+
+/// Invalidates the neighbor list. The list will be rebuilt on the
+/// next call to update().
+void NeighborList::invalidate()
+{
+    d->referencePositions.clear();
+}
+
+} // end chemkit namespace
@@ -0,0 +1,90 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_NEIGHBORLIST_H
+#define CHEMKIT_NEIGHBORLIST_H
+
+#include "md.h"
+
+#include <vector>
+
+#include <boost/array.hpp>
+#include <boost/range/iterator_range.hpp>
+
+namespace chemkit {
+
+class Topology;
+class NeighborListPrivate;
+class CartesianCoordinates;
+
+class CHEMKIT_MD_EXPORT NeighborList
+{
+public:
+    // typedefs
+    typedef boost::array<size_t, 2> Pair;
+    typedef boost::iterator_range<std::vector<Pair>::const_iterator> PairRange;
+
+    // construction and destruction
+    NeighborList(const Topology *topology, Real cutoff, Real skin = 2.0);
+    ~NeighborList();
+
+    // properties
+    const Topology* topology() const;
+    void setCutoff(Real cutoff);
+    Real cutoff() const;
+    void setSkin(Real skin);
+    Real skin() const;
+
+    // pairs
+    PairRange pairs() const;
+    size_t pairCount() const;
+    bool isExcluded(size_t i, size_t j) const;
+
+    // update
+    bool update(const CartesianCoordinates *coordinates);
+    bool needsUpdate(const CartesianCoordinates *coordinates) const;
+    void rebuild(const CartesianCoordinates *coordinates);
+    void invalidate();
+
+private:
+    CHEMKIT_DISABLE_COPY(NeighborList)
+
+private:
+    NeighborListPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_NEIGHBORLIST_H
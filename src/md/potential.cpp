@@ -101,6 +101,22 @@ std::vector<Vector3> Potential::gradient(const CartesianCoordinates *coordinates
    return numericalGradient(coordinates);
 }
 
+/// Returns the potential energy of the system and stores its
+/// gradient with respect to \p coordinates in \p gradient.
+///
+/// This is equivalent to calling energy() and gradient() but allows
+/// potentials to share the work between the two and to reuse the
+/// memory in \p gradient. Minimizers and integrators which need both
+/// at every step should use this method.
+///
+/// The default implementation calls energy() and gradient().
+Real Potential::energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const
+{
+    gradient = this->gradient(coordinates);
+
+    return energy(coordinates);
+}
+
 /// Returns the gradient of the potential energy of the system with
 /// respect to \p coordinates. The gradient is calculated
 /// numerically.
@@ -61,6 +61,7 @@ public:
     virtual Real energy(const CartesianCoordinates *coordinates) const = 0;
     boost::shared_future<Real> energyAsync(const CartesianCoordinates *coordinates) const;
     virtual std::vector<Vector3> gradient(const CartesianCoordinates *coordinates) const;
+    virtual Real energyAndGradient(const CartesianCoordinates *coordinates, std::vector<Vector3> &gradient) const;
     std::vector<Vector3> numericalGradient(const CartesianCoordinates *coordinates) const;
     Real rmsg(const CartesianCoordinates *coordinates) const;
 };
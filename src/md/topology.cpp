@@ -58,8 +58,38 @@ public:
     std::vector<int> bondedInteractionTypes;
     std::vector<int> angleInteractionTypes;
     std::vector<int> torsionInteractionTypes;
+
+    // indices of the interactions containing each atom, these are
+    // updated as interactions are added so that the interaction
+    // lookup methods do not need to search every interaction
+    std::vector<std::vector<size_t> > atomBondedInteractions;
+    std::vector<std::vector<size_t> > atomAngleInteractions;
+    std::vector<std::vector<size_t> > atomTorsionInteractions;
+    std::vector<std::vector<size_t> > atomOneFourPartners;
 };
 
+namespace {
+
+// Adds value to the list for index, growing the lists if needed.
+void addToIndex(std::vector<std::vector<size_t> > &index, size_t key, size_t value)
+{
+    if(key >= index.size()){
+        index.resize(key + 1);
+    }
+
+    index[key].push_back(value);
+}
+
+// Returns the list for index or an empty list if there is none.
+const std::vector<size_t>& indexList(const std::vector<std::vector<size_t> > &index, size_t key)
+{
+    static const std::vector<size_t> empty;
+
+    return key < index.size() ? index[key] : empty;
+}
+
+} // end anonymous namespace
+
 // === Topology ============================================================ //
 /// \class Topology topology.h chemkit/topology.h
 /// \ingroup chemkit-md
@@ -169,6 +199,12 @@ void Topology::addBondedInteraction(size_t i, size_t j)
     interaction[1] = j;
     d->bondedInteractions.push_back(interaction);
     d->bondedInteractionTypes.push_back(0);
+
+    size_t index = d->bondedInteractions.size() - 1;
+    addToIndex(d->atomBondedInteractions, i, index);
+    if(j != i){
+        addToIndex(d->atomBondedInteractions, j, index);
+    }
 }
 
 Topology::BondedInteractionRange Topology::bondedInteractions() const
@@ -184,23 +220,18 @@ size_t Topology::bondedInteractionCount() const
 
 void Topology::setBondedInteractionType(size_t i, size_t j, int type)
 {
-    BondedInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-
-    BondedInteractionRange::const_iterator iter =
-        boost::find(d->bondedInteractions, interaction);
-
-    if(iter != d->bondedInteractions.end()){
-        size_t index = iter - d->bondedInteractions.begin();
-
-        d->bondedInteractionTypes[index] = type;
+    foreach(size_t index, indexList(d->atomBondedInteractions, i)){
+        const BondedInteraction &interaction = d->bondedInteractions[index];
+        if(interaction[0] == i && interaction[1] == j){
+            d->bondedInteractionTypes[index] = type;
+            return;
+        }
     }
 }
 
 int Topology::bondedInteractionType(size_t i, size_t j) const
 {
-    for(size_t index = 0; index < d->bondedInteractions.size(); index++){
+    foreach(size_t index, indexList(d->atomBondedInteractions, i)){
         const BondedInteraction &interaction = d->bondedInteractions[index];
         if((interaction[0] == i && interaction[1] == j) ||
            (interaction[1] == i && interaction[0] == j)){
@@ -219,6 +250,8 @@ void Topology::addAngleInteraction(size_t i, size_t j, size_t k)
     interaction[2] = k;
     d->angleInteractions.push_back(interaction);
     d->angleInteractionTypes.push_back(0);
+
+    addToIndex(d->atomAngleInteractions, j, d->angleInteractions.size() - 1);
 }
 
 Topology::AngleInteractionRange Topology::angleInteractions() const
@@ -234,42 +267,31 @@ size_t Topology::angleInteractionCount() const
 
 void Topology::setAngleInteractionType(size_t i, size_t j, size_t k, int type)
 {
-    AngleInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-
-    AngleInteractionRange::const_iterator iter =
-        boost::find(d->angleInteractions, interaction);
-
-    if(iter != d->angleInteractions.end()){
-        size_t index = iter - d->angleInteractions.begin();
-
-        d->angleInteractionTypes[index] = type;
+    foreach(size_t index, indexList(d->atomAngleInteractions, j)){
+        const AngleInteraction &interaction = d->angleInteractions[index];
+        if(interaction[0] == i && interaction[2] == k){
+            d->angleInteractionTypes[index] = type;
+            return;
+        }
     }
 }
 
 int Topology::angleInteractionType(size_t i, size_t j, size_t k) const
 {
-    AngleInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-
-    AngleInteractionRange::const_iterator iter =
-        boost::find(d->angleInteractions, interaction);
+    const std::vector<size_t> &indices = indexList(d->atomAngleInteractions, j);
 
-    if(iter == d->angleInteractions.end()){
-        interaction[0] = k;
-        interaction[2] = i;
-
-        iter = boost::find(d->angleInteractions, interaction);
+    foreach(size_t index, indices){
+        const AngleInteraction &interaction = d->angleInteractions[index];
+        if(interaction[0] == i && interaction[2] == k){
+            return d->angleInteractionTypes[index];
+        }
     }
 
-    if(iter != d->angleInteractions.end()){
-        size_t index = iter - d->angleInteractions.begin();
-
-        return d->angleInteractionTypes[index];
+    foreach(size_t index, indices){
+        const AngleInteraction &interaction = d->angleInteractions[index];
+        if(interaction[0] == k && interaction[2] == i){
+            return d->angleInteractionTypes[index];
+        }
     }
 
     return 0;
@@ -284,6 +306,12 @@ void Topology::addTorsionInteraction(size_t i, size_t j, size_t k, size_t l)
     interaction[3] = l;
     d->torsionInteractions.push_back(interaction);
     d->torsionInteractionTypes.push_back(0);
+
+    addToIndex(d->atomTorsionInteractions, j, d->torsionInteractions.size() - 1);
+    addToIndex(d->atomOneFourPartners, i, l);
+    if(l != i){
+        addToIndex(d->atomOneFourPartners, l, i);
+    }
 }
 
 Topology::TorsionInteractionRange Topology::torsionInteractions() const
@@ -299,46 +327,29 @@ size_t Topology::torsionInteractionCount() const
 
 void Topology::setTorsionInteractionType(size_t i, size_t j, size_t k, size_t l, int type)
 {
-    TorsionInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-    interaction[3] = l;
-
-    TorsionInteractionRange::const_iterator iter =
-        boost::find(d->torsionInteractions, interaction);
-
-    if(iter != d->torsionInteractions.end()){
-        size_t index = iter - d->torsionInteractions.begin();
-
-        d->torsionInteractionTypes[index] = type;
+    foreach(size_t index, indexList(d->atomTorsionInteractions, j)){
+        const TorsionInteraction &interaction = d->torsionInteractions[index];
+        if(interaction[0] == i && interaction[2] == k && interaction[3] == l){
+            d->torsionInteractionTypes[index] = type;
+            return;
+        }
     }
 }
 
 int Topology::torsionInteractionType(size_t i, size_t j, size_t k, size_t l) const
 {
-    TorsionInteraction interaction;
-    interaction[0] = i;
-    interaction[1] = j;
-    interaction[2] = k;
-    interaction[3] = l;
-
-    TorsionInteractionRange::const_iterator iter =
-        boost::find(d->torsionInteractions, interaction);
-
-    if(iter == d->torsionInteractions.end()){
-        interaction[0] = l;
-        interaction[1] = k;
-        interaction[2] = j;
-        interaction[3] = i;
-
-        iter = boost::find(d->torsionInteractions, interaction);
+    foreach(size_t index, indexList(d->atomTorsionInteractions, j)){
+        const TorsionInteraction &interaction = d->torsionInteractions[index];
+        if(interaction[0] == i && interaction[2] == k && interaction[3] == l){
+            return d->torsionInteractionTypes[index];
+        }
     }
 
-    if(iter != d->torsionInteractions.end()){
-        size_t index = iter - d->torsionInteractions.begin();
-
-        return d->torsionInteractionTypes[index];
+    foreach(size_t index, indexList(d->atomTorsionInteractions, k)){
+        const TorsionInteraction &interaction = d->torsionInteractions[index];
+        if(interaction[0] == l && interaction[2] == j && interaction[3] == i){
+            return d->torsionInteractionTypes[index];
+        }
     }
 
     return 0;
@@ -385,16 +396,11 @@ size_t Topology::nonbondedInteractionCount() const
 }
 
 /// Returns \c true if atoms \p i and \p j are in a one-four configuration.
-bool Topology::isOneFour(size_t i, size_t j)
+bool Topology::isOneFour(size_t i, size_t j) const
 {
-    foreach(const TorsionInteraction &torsion, d->torsionInteractions){
-        if((torsion[0] == i && torsion[3] == j) ||
-           (torsion[0] == j && torsion[3] == i)){
-            return true;
-        }
-    }
+    const std::vector<size_t> &partners = indexList(d->atomOneFourPartners, i);
 
-    return false;
+    return boost::find(partners, j) != partners.end();
 }
 
 } // end chemkit namespace
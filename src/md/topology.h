@@ -103,7 +103,7 @@ public:
     void addNonbondedInteraction(size_t i, size_t j);
     NonbondedInteractionRange nonbondedInteractions() const;
     size_t nonbondedInteractionCount() const;
-    bool isOneFour(size_t i, size_t j);
+    bool isOneFour(size_t i, size_t j) const;
 
 private:
     TopologyPrivate* const d;
@@ -42,6 +42,8 @@
 #include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
 #include <chemkit/atomtyper.h>
+#include <chemkit/spatialindex.h>
+#include <chemkit/cartesiancoordinates.h>
 #include <chemkit/partialchargemodel.h>
 
 #include "topology.h"
@@ -72,6 +74,8 @@ class TopologyBuilderPrivate
 public:
     std::string atomTyper;
     std::string partialChargeModel;
+    bool nonbondedInteractionsEnabled;
+    Real nonbondedCutoff;
     boost::shared_ptr<Topology> topology;
 };
 
@@ -106,6 +110,8 @@ TopologyBuilder::TopologyBuilder()
     : d(new TopologyBuilderPrivate)
 {
     d->topology = boost::make_shared<Topology>();
+    d->nonbondedInteractionsEnabled = true;
+    d->nonbondedCutoff = 0;
 }
 
 /// Destroys the topology builder object.
@@ -143,6 +149,45 @@ bool TopologyBuilder::setPartialChargeModel(const std::string &model)
     return true;
 }
 
+/// Sets whether nonbonded interactions are added to the topology.
+///
+/// By default a nonbonded interaction is added for every pair of
+/// atoms that are not within two bonds of each other. The number of
+/// these interactions grows quadratically with the number of atoms.
+/// For large systems this should be disabled and the nonbonded pairs
+/// determined from a NeighborList instead.
+///
+/// \see ForceField::setNonbondedCutoff()
+void TopologyBuilder::setNonbondedInteractionsEnabled(bool enabled)
+{
+    d->nonbondedInteractionsEnabled = enabled;
+}
+
+/// Returns \c true if nonbonded interactions are added to the
+/// topology.
+bool TopologyBuilder::nonbondedInteractionsEnabled() const
+{
+    return d->nonbondedInteractionsEnabled;
+}
+
+/// Sets the cutoff distance for nonbonded interactions to \p cutoff.
+///
+/// If the cutoff is greater than zero, nonbonded interactions are
+/// only added for pairs of atoms that are within \p cutoff Angstroms
+/// of each other in the coordinates of the molecule. These pairs are
+/// found with a SpatialIndex in linear time. The default cutoff is
+/// zero which adds an interaction for every pair of atoms.
+void TopologyBuilder::setNonbondedCutoff(Real cutoff)
+{
+    d->nonbondedCutoff = cutoff;
+}
+
+/// Returns the cutoff distance for nonbonded interactions.
+Real TopologyBuilder::nonbondedCutoff() const
+{
+    return d->nonbondedCutoff;
+}
+
 // --- Topology ------------------------------------------------------------ //
 /// Adds \p molecule to the topology.
 void TopologyBuilder::addMolecule(const Molecule *molecule)
@@ -288,7 +333,30 @@ void TopologyBuilder::addMolecule(const Molecule *molecule)
     }
 
     // add nonbonded interactions
+    if(!d->nonbondedInteractionsEnabled){
+        return;
+    }
+
     std::vector<const Atom *> atoms(molecule->atoms().begin(), molecule->atoms().end());
+
+    if(d->nonbondedCutoff > 0){
+        CartesianCoordinates coordinates(atoms.size());
+        for(size_t i = 0; i < atoms.size(); i++){
+            coordinates[i] = atoms[i]->position();
+        }
+
+        SpatialIndex index(&coordinates, d->nonbondedCutoff);
+
+        foreach(const SpatialIndex::Pair &pair, index.pairs(d->nonbondedCutoff)){
+            if(!atomsWithinTwoBonds(atoms[pair[0]], atoms[pair[1]])){
+                topology->addNonbondedInteraction(initialSize + atoms[pair[0]]->index(),
+                                                  initialSize + atoms[pair[1]]->index());
+            }
+        }
+
+        return;
+    }
+
     for(size_t i = 0; i < atoms.size(); i++){
         for(size_t j = i + 1; j < atoms.size(); j++){
             if(!atomsWithinTwoBonds(atoms[i], atoms[j])){
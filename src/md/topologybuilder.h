@@ -66,6 +66,10 @@ public:
     bool isEmpty() const;
     bool setAtomTyper(const std::string &atomTyper);
     bool setPartialChargeModel(const std::string &model);
+    void setNonbondedInteractionsEnabled(bool enabled);
+    bool nonbondedInteractionsEnabled() const;
+    void setNonbondedCutoff(Real cutoff);
+    Real nonbondedCutoff() const;
 
     // topology
     void addMolecule(const Molecule *molecule);
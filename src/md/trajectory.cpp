@@ -35,20 +35,41 @@
 
 #include "trajectory.h"
 
+#include <list>
 #include <algorithm>
 
+#include <boost/lexical_cast.hpp>
+
 #include <chemkit/foreach.h>
+#include <chemkit/unitcell.h>
+#include <chemkit/cartesiancoordinates.h>
 
 #include "trajectoryframe.h"
+#include "trajectorystore.h"
+#include "trajectoryframeprivate.h"
 
 namespace chemkit {
 
+namespace {
+
+// default frame cache size in bytes
+const size_t DefaultCacheSize = 64 * 1024 * 1024;
+
+} // end anonymous namespace
+
 // === TrajectoryPrivate =================================================== //
 class TrajectoryPrivate
 {
 public:
     size_t size;
     std::vector<TrajectoryFrame *> frames;
+    boost::shared_ptr<TrajectoryStore> store;
+    size_t cacheSize;
+    size_t cachedBytes;
+    std::string errorString;
+
+    // loaded store frames ordered from most to least recently used
+    std::list<TrajectoryFrame *> cache;
 };
 
 // === Trajectory ========================================================== //
@@ -63,7 +84,31 @@ public:
 /// Trajectories are usually associated with a Topology which contains
 /// the atomic properties and atomic interactions for a system.
 ///
-/// \see Topology, TrajectoryFrame, TrajectoryFile
+/// Trajectories created with a TrajectoryStore read their frames on
+/// demand. At most cacheSize() bytes of frame data are kept in memory,
+/// the least recently used frames are released first. This allows
+/// trajectories which are much larger than the available memory to
+/// be processed, e.g. one frame at a time:
+///
+/// \code
+/// chemkit::TrajectoryFile file("md.xtc");
+/// file.open();
+///
+/// boost::shared_ptr<chemkit::Trajectory> trajectory = file.trajectory();
+/// foreach(const chemkit::TrajectoryFrame *frame, trajectory->frames()){
+///     process(frame->coordinates());
+/// }
+/// \endcode
+///
+/// If a frame can not be read from the store its coordinates() are
+/// null and errorString() describes the error.
+///
+/// Accessing the frames of a trajectory backed by a store updates the
+/// frame cache, even through const methods. Frames of the same
+/// trajectory must therefore not be accessed from multiple threads at
+/// the same time.
+///
+/// \see Topology, TrajectoryFrame, TrajectoryFile, TrajectoryStore
 
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new trajectory with \p size.
@@ -71,6 +116,33 @@ Trajectory::Trajectory(size_t size)
     : d(new TrajectoryPrivate)
 {
     d->size = size;
+    d->cacheSize = DefaultCacheSize;
+    d->cachedBytes = 0;
+}
+
+/// Creates a new trajectory which reads its frames from \p store.
+Trajectory::Trajectory(const boost::shared_ptr<TrajectoryStore> &store)
+    : d(new TrajectoryPrivate)
+{
+    d->size = store->size();
+    d->store = store;
+    d->cacheSize = DefaultCacheSize;
+    d->cachedBytes = 0;
+
+    size_t frameCount = store->frameCount();
+    d->frames.reserve(frameCount);
+
+    for(size_t i = 0; i < frameCount; i++){
+        TrajectoryFrame *frame = new TrajectoryFrame(this, 0);
+
+        // store frames are not loaded until they are accessed
+        delete frame->d->coordinates;
+        frame->d->coordinates = 0;
+        frame->d->stored = true;
+        frame->d->storeIndex = i;
+
+        d->frames.push_back(frame);
+    }
 }
 
 /// Destroys the trajectory object.
@@ -92,6 +164,11 @@ void Trajectory::resize(size_t size)
     foreach(TrajectoryFrame *frame, d->frames){
         frame->resize(size);
     }
+
+    d->cachedBytes = 0;
+    foreach(const TrajectoryFrame *frame, d->cache){
+        d->cachedBytes += frame->byteCount();
+    }
 }
 
 /// Returns the number of particles in the trajectory.
@@ -123,9 +200,18 @@ bool Trajectory::removeFrame(TrajectoryFrame *frame)
         return false;
     }
 
-    d->frames.erase(location);
+    if(frame->d->stored){
+        unloadFrame(frame);
+    }
+
+    location = d->frames.erase(location);
     delete frame;
 
+    // update the indices of the following frames
+    for(; location != d->frames.end(); ++location){
+        (*location)->d->index--;
+    }
+
     return true;
 }
 
@@ -136,7 +222,7 @@ TrajectoryFrame* Trajectory::frame(size_t index) const
 }
 
 /// Returns a list of the frames in the trajectory.
-std::vector<TrajectoryFrame *> Trajectory::frames() const
+const std::vector<TrajectoryFrame *>& Trajectory::frames() const
 {
     return d->frames;
 }
@@ -147,4 +233,103 @@ size_t Trajectory::frameCount() const
     return d->frames.size();
 }
 
+// --- Frame Cache --------------------------------------------------------- //
+/// Returns the store that the trajectory reads its frames from or
+/// \c 0 if the trajectory is held completely in memory.
+boost::shared_ptr<TrajectoryStore> Trajectory::store() const
+{
+    return d->store;
+}
+
+/// Sets the maximum number of bytes of frame data to keep in memory
+/// for trajectories backed by a store. The most recently accessed
+/// frame is always kept. The default size is 64 MB.
+void Trajectory::setCacheSize(size_t size)
+{
+    d->cacheSize = size;
+
+    while(d->cachedBytes > d->cacheSize && d->cache.size() > 1){
+        unloadFrame(d->cache.back());
+    }
+}
+
+/// Returns the maximum number of bytes of frame data to keep in
+/// memory.
+size_t Trajectory::cacheSize() const
+{
+    return d->cacheSize;
+}
+
+/// Returns the number of frames currently loaded from the store.
+size_t Trajectory::cachedFrameCount() const
+{
+    return d->cache.size();
+}
+
+// --- Error Handling ------------------------------------------------------ //
+/// Returns a string describing the last error that occurred while
+/// reading a frame from the store.
+std::string Trajectory::errorString() const
+{
+    return d->errorString;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+// Reads frame from the store if it is not loaded and moves it to the
+// front of the cache. Least recently used frames are released if the
+// cache size is exceeded. Returns false and leaves the frame unloaded
+// if the store fails to read it.
+bool Trajectory::loadFrame(TrajectoryFrame *frame)
+{
+    TrajectoryFramePrivate *frameData = frame->d;
+
+    if(frameData->coordinates){
+        if(frameData->cacheEntry != d->cache.begin()){
+            d->cache.splice(d->cache.begin(), d->cache, frameData->cacheEntry);
+        }
+
+        return true;
+    }
+
+    // add the frame to the cache before reading so that accessors
+    // called by the store do not attempt to load it again
+    frameData->coordinates = new CartesianCoordinates(d->size);
+    d->cache.push_front(frame);
+    frameData->cacheEntry = d->cache.begin();
+
+    bool ok = d->store->readFrame(frameData->storeIndex, frame);
+    d->cachedBytes += frame->byteCount();
+
+    if(!ok){
+        unloadFrame(frame);
+        d->errorString = "Failed to read frame " +
+                         boost::lexical_cast<std::string>(frameData->storeIndex) +
+                         " from the trajectory store.";
+        return false;
+    }
+
+    while(d->cachedBytes > d->cacheSize && d->cache.size() > 1){
+        unloadFrame(d->cache.back());
+    }
+
+    return true;
+}
+
+// Releases the data for frame and removes it from the cache.
+void Trajectory::unloadFrame(TrajectoryFrame *frame)
+{
+    TrajectoryFramePrivate *frameData = frame->d;
+    if(!frameData->coordinates){
+        return;
+    }
+
+    d->cachedBytes -= std::min(d->cachedBytes, frame->byteCount());
+    d->cache.erase(frameData->cacheEntry);
+
+    delete frameData->coordinates;
+    frameData->coordinates = 0;
+    delete frameData->unitCell;
+    frameData->unitCell = 0;
+}
+
 } // end chemkit namespace
@@ -38,11 +38,15 @@
 
 #include "md.h"
 
+#include <string>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 namespace chemkit {
 
 class TrajectoryFrame;
+class TrajectoryStore;
 class TrajectoryPrivate;
 
 class CHEMKIT_MD_EXPORT Trajectory
@@ -50,6 +54,7 @@ class CHEMKIT_MD_EXPORT Trajectory
 public:
     // construction and destruction
     Trajectory(size_t size = 0);
+    Trajectory(const boost::shared_ptr<TrajectoryStore> &store);
     ~Trajectory();
 
     // properties
@@ -61,9 +66,24 @@ public:
     TrajectoryFrame* addFrame();
     bool removeFrame(TrajectoryFrame *frame);
     TrajectoryFrame* frame(size_t index) const;
-    std::vector<TrajectoryFrame *> frames() const;
+    const std::vector<TrajectoryFrame *>& frames() const;
     size_t frameCount() const;
 
+    // frame cache
+    boost::shared_ptr<TrajectoryStore> store() const;
+    void setCacheSize(size_t size);
+    size_t cacheSize() const;
+    size_t cachedFrameCount() const;
+
+    // error handling
+    std::string errorString() const;
+
+private:
+    bool loadFrame(TrajectoryFrame *frame);
+    void unloadFrame(TrajectoryFrame *frame);
+
+    friend class TrajectoryFrame;
+
 private:
     TrajectoryPrivate* const d;
 };
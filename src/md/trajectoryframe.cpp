@@ -35,26 +35,14 @@
 
 #include "trajectoryframe.h"
 
-#include <vector>
-#include <algorithm>
-
 #include <chemkit/unitcell.h>
 #include <chemkit/cartesiancoordinates.h>
 
 #include "trajectory.h"
+#include "trajectoryframeprivate.h"
 
 namespace chemkit {
 
-// === TrajectoryFramePrivate ============================================== //
-class TrajectoryFramePrivate
-{
-public:
-    Trajectory *trajectory;
-    Real time;
-    CartesianCoordinates *coordinates;
-    UnitCell *unitCell;
-};
-
 // === TrajectoryFrame ===================================================== //
 /// \class TrajectoryFrame trajectoryframe.h chemkit/trajectoryframe.h
 /// \ingroup chemkit-md
@@ -64,6 +52,17 @@ public:
 /// TrajectoryFrame objects are created with the
 /// Trajectory::addFrame() method and destroyed with the
 /// Trajectory::removeFrame() method.
+///
+/// For trajectories backed by a TrajectoryStore the frame's data is
+/// read from the store when it is first accessed and may be released
+/// again once the trajectory's frame cache is full. Changes made to
+/// such frames are lost when they are released. If the store fails to
+/// read the frame, coordinates() returns \c 0, position() returns the
+/// origin and Trajectory::errorString() describes the error.
+///
+/// Because every accessor may update the trajectory's frame cache,
+/// frames of the same trajectory are not safe to access from multiple
+/// threads at the same time, even through const methods.
 
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new trajectory frame.
@@ -71,9 +70,12 @@ TrajectoryFrame::TrajectoryFrame(Trajectory *trajectory, size_t size)
     : d(new TrajectoryFramePrivate)
 {
     d->trajectory = trajectory;
+    d->index = trajectory->frameCount();
     d->time = 0;
     d->coordinates = new CartesianCoordinates(size);
     d->unitCell = 0;
+    d->stored = false;
+    d->storeIndex = 0;
 }
 
 /// Destroys the trajectory frame object.
@@ -88,27 +90,31 @@ TrajectoryFrame::~TrajectoryFrame()
 /// Sets the number of coordinates in the frame to \p size.
 void TrajectoryFrame::resize(size_t size)
 {
-    d->coordinates->resize(size);
+    if(d->coordinates){
+        d->coordinates->resize(size);
+    }
 }
 
 /// Returns the number of coordinates in the frame.
 size_t TrajectoryFrame::size() const
 {
+    if(!d->coordinates){
+        return d->trajectory->size();
+    }
+
     return d->coordinates->size();
 }
 
 /// Returns \c true if the frame contains no coordinates.
 bool TrajectoryFrame::isEmpty() const
 {
-    return d->coordinates->isEmpty();
+    return size() == 0;
 }
 
 /// Returns the index of the frame in the trajectory.
 size_t TrajectoryFrame::index() const
 {
-    const std::vector<TrajectoryFrame *> &frames = trajectory()->frames();
-
-    return std::distance(frames.begin(), std::find(frames.begin(), frames.end(), this));
+    return d->index;
 }
 
 /// Returns the trajectory that the frame belongs to.
@@ -121,12 +127,16 @@ Trajectory* TrajectoryFrame::trajectory() const
 /// Sets the time for the trajectory frame to \p time.
 void TrajectoryFrame::setTime(Real time)
 {
+    load();
+
     d->time = time;
 }
 
 /// Returns the time of the trajectory frame.
 Real TrajectoryFrame::time() const
 {
+    load();
+
     return d->time;
 }
 
@@ -134,32 +144,87 @@ Real TrajectoryFrame::time() const
 /// Sets the coordinates at \p index to \p position.
 void TrajectoryFrame::setPosition(size_t index, const Point3 &position)
 {
+    if(!load()){
+        return;
+    }
+
     d->coordinates->setPosition(index, position);
 }
 
 /// Returns the position at \p index.
 Point3 TrajectoryFrame::position(size_t index) const
 {
+    if(!load()){
+        return Point3(0, 0, 0);
+    }
+
     return d->coordinates->position(index);
 }
 
 /// Returns the coordinates for the frame.
+///
+/// For trajectories backed by a TrajectoryStore the returned pointer
+/// is only valid until the frame is released from the trajectory's
+/// frame cache, which may happen when other frames are accessed. If
+/// the frame could not be read from the store \c 0 is returned.
 const CartesianCoordinates* TrajectoryFrame::coordinates() const
 {
+    load();
+
     return d->coordinates;
 }
 
 // --- Unit Cell ----------------------------------------------------------- //
-/// Sets the unit cell for the frame to \p cell.
+/// Sets the unit cell for the frame to \p cell. The frame takes
+/// ownership of \p cell.
 void TrajectoryFrame::setUnitCell(UnitCell *cell)
 {
+    if(!load()){
+        delete cell;
+        return;
+    }
+
+    if(cell != d->unitCell){
+        delete d->unitCell;
+    }
+
     d->unitCell = cell;
 }
 
 /// Returns the unit cell for the frame.
 UnitCell* TrajectoryFrame::unitCell() const
 {
+    load();
+
     return d->unitCell;
 }
 
+// --- Internal Methods ---------------------------------------------------- //
+// Loads the frame from the trajectory's store if it is not loaded and
+// marks it as the most recently used frame. Returns false if the frame
+// could not be read.
+bool TrajectoryFrame::load() const
+{
+    if(d->stored){
+        return d->trajectory->loadFrame(const_cast<TrajectoryFrame *>(this));
+    }
+
+    return true;
+}
+
+// Returns the approximate number of bytes used by the frame's data.
+size_t TrajectoryFrame::byteCount() const
+{
+    size_t count = 0;
+
+    if(d->coordinates){
+        count += sizeof(CartesianCoordinates) + 3 * sizeof(Real) * d->coordinates->size();
+    }
+    if(d->unitCell){
+        count += sizeof(UnitCell);
+    }
+
+    return count;
+}
+
 } // end chemkit namespace
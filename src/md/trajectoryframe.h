@@ -75,6 +75,8 @@ private:
     ~TrajectoryFrame();
 
     void resize(size_t size);
+    bool load() const;
+    size_t byteCount() const;
 
     friend class Trajectory;
 
@@ -0,0 +1,77 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "trajectorystore.h"
+
+namespace chemkit {
+
+// === TrajectoryStore ===================================================== //
+/// \class TrajectoryStore trajectorystore.h chemkit/trajectorystore.h
+/// \ingroup chemkit-md
+/// \brief The TrajectoryStore class provides the frames for a
+///        trajectory on demand.
+///
+/// Trajectories created with a store do not keep all of their frames
+/// in memory. Instead each frame is read from the store when it is
+/// first accessed and released again when the trajectory's frame
+/// cache is full. Stores are typically provided by a TrajectoryFile
+/// (see TrajectoryFile::open()).
+///
+/// \see Trajectory::setCacheSize()
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new trajectory store.
+TrajectoryStore::TrajectoryStore()
+{
+}
+
+/// Destroys the trajectory store.
+TrajectoryStore::~TrajectoryStore()
+{
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// \fn size_t TrajectoryStore::size() const
+/// Returns the number of particles in each frame.
+
+/// \fn size_t TrajectoryStore::frameCount() const
+/// Returns the number of frames in the store.
+
+// --- Frames -------------------------------------------------------------- //
+/// \fn bool TrajectoryStore::readFrame(size_t index, TrajectoryFrame *frame)
+/// Reads the frame at \p index into \p frame. Returns \c false if an
+/// error occurs.
+
+} // end chemkit namespace
@@ -71,37 +71,84 @@ bool AmberBondCalculation::setup(const AmberParameters *parameters)
     return true;
 }
 
-chemkit::Real AmberBondCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real AmberBondCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                           const size_t *atoms,
+                                           const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
     chemkit::Real r = coordinates->distance(a, b);
     chemkit::Real dr = r - r0;
 
     return kb * (dr*dr);
 }
 
-std::vector<chemkit::Vector3> AmberBondCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void AmberBondCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                    const size_t *atoms,
+                                    const chemkit::Real *parameters,
+                                    chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
-    chemkit::Real r = coordinates->distance(a, b);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
 
     // dE/dr
     chemkit::Real de_dr = 2.0 * kb * (r - r0);
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real AmberBondCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                      const size_t *atoms,
+                                                      const chemkit::Real *parameters,
+                                                      chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
+    chemkit::Real dr = r - r0;
+
+    // dE/dr
+    chemkit::Real de_dr = 2.0 * kb * dr;
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+
+    return kb * (dr*dr);
+}
+
+chemkit::Real AmberBondCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> AmberBondCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+chemkit::Real AmberBondCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::ForceFieldCalculationBatch* AmberBondCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<AmberBondCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === AmberAngleCalculation =============================================== //
@@ -130,40 +177,89 @@ bool AmberAngleCalculation::setup(const AmberParameters *parameters)
     return true;
 }
 
-chemkit::Real AmberAngleCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real AmberAngleCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                            const size_t *atoms,
+                                            const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real theta0 = parameter(1);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
     chemkit::Real theta = coordinates->angle(a, b, c);
     chemkit::Real dt = theta - theta0;
 
     return ka * (dt*dt);
 }
 
-std::vector<chemkit::Vector3> AmberAngleCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void AmberAngleCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                     const size_t *atoms,
+                                     const chemkit::Real *parameters,
+                                     chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real theta0 = parameter(1);
-    chemkit::Real theta = coordinates->angle(a, b, c);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real theta = coordinates->angleAndGradient(a, b, c, angleGradient);
 
     // dE/dtheta
     chemkit::Real de_dtheta = 2.0 * ka * (theta - theta0);
 
-    boost::array<chemkit::Vector3, 3> gradient = coordinates->angleGradient(a, b, c);
+    gradient[0] = angleGradient[0] * de_dtheta;
+    gradient[1] = angleGradient[1] * de_dtheta;
+    gradient[2] = angleGradient[2] * de_dtheta;
+}
+
+chemkit::Real AmberAngleCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                       const size_t *atoms,
+                                                       const chemkit::Real *parameters,
+                                                       chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real theta = coordinates->angleAndGradient(a, b, c, angleGradient);
+    chemkit::Real dt = theta - theta0;
+
+    // dE/dtheta
+    chemkit::Real de_dtheta = 2.0 * ka * dt;
+
+    gradient[0] = angleGradient[0] * de_dtheta;
+    gradient[1] = angleGradient[1] * de_dtheta;
+    gradient[2] = angleGradient[2] * de_dtheta;
 
-    gradient[0] *= de_dtheta;
-    gradient[1] *= de_dtheta;
-    gradient[2] *= de_dtheta;
+    return ka * (dt*dt);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::Real AmberAngleCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> AmberAngleCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(3);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real AmberAngleCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* AmberAngleCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<AmberAngleCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === AmberTorsionCalculation ============================================= //
@@ -203,21 +299,23 @@ bool AmberTorsionCalculation::setup(const AmberParameters *parameters)
     return true;
 }
 
-chemkit::Real AmberTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real AmberTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                              const size_t *atoms,
+                                              const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
-
-    chemkit::Real V1 = parameter(0);
-    chemkit::Real V2 = parameter(1);
-    chemkit::Real V3 = parameter(2);
-    chemkit::Real V4 = parameter(3);
-    chemkit::Real gamma1 = parameter(4);
-    chemkit::Real gamma2 = parameter(5);
-    chemkit::Real gamma3 = parameter(6);
-    chemkit::Real gamma4 = parameter(7);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
+
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
+    chemkit::Real V4 = parameters[3];
+    chemkit::Real gamma1 = parameters[4];
+    chemkit::Real gamma2 = parameters[5];
+    chemkit::Real gamma3 = parameters[6];
+    chemkit::Real gamma4 = parameters[7];
 
     chemkit::Real angle = coordinates->torsionAngle(a, b, c, d);
 
@@ -230,23 +328,69 @@ chemkit::Real AmberTorsionCalculation::energy(const chemkit::CartesianCoordinate
     return energy;
 }
 
-std::vector<chemkit::Vector3> AmberTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void AmberTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                       const size_t *atoms,
+                                       const chemkit::Real *parameters,
+                                       chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
+
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
+    chemkit::Real V4 = parameters[3];
+    chemkit::Real gamma1 = parameters[4];
+    chemkit::Real gamma2 = parameters[5];
+    chemkit::Real gamma3 = parameters[6];
+    chemkit::Real gamma4 = parameters[7];
+
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradient(a, b, c, d, torsionGradient);
 
-    chemkit::Real V1 = parameter(0);
-    chemkit::Real V2 = parameter(1);
-    chemkit::Real V3 = parameter(2);
-    chemkit::Real V4 = parameter(3);
-    chemkit::Real gamma1 = parameter(4);
-    chemkit::Real gamma2 = parameter(5);
-    chemkit::Real gamma3 = parameter(6);
-    chemkit::Real gamma4 = parameter(7);
+    // dE/dphi
+    chemkit::Real de_dphi = 0;
+    de_dphi += V1 * (-sin((1.0 * phi - gamma1) * chemkit::constants::DegreesToRadians) * 1.0);
+    de_dphi += V2 * (-sin((2.0 * phi - gamma2) * chemkit::constants::DegreesToRadians) * 2.0);
+    de_dphi += V3 * (-sin((3.0 * phi - gamma3) * chemkit::constants::DegreesToRadians) * 3.0);
+    de_dphi += V4 * (-sin((4.0 * phi - gamma4) * chemkit::constants::DegreesToRadians) * 4.0);
+    de_dphi *= chemkit::constants::DegreesToRadians;
+
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
+}
+
+chemkit::Real AmberTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                         const size_t *atoms,
+                                                         const chemkit::Real *parameters,
+                                                         chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
+
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
+    chemkit::Real V4 = parameters[3];
+    chemkit::Real gamma1 = parameters[4];
+    chemkit::Real gamma2 = parameters[5];
+    chemkit::Real gamma3 = parameters[6];
+    chemkit::Real gamma4 = parameters[7];
+
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradient(a, b, c, d, torsionGradient);
 
-    chemkit::Real phi = coordinates->torsionAngle(a, b, c, d);
+    chemkit::Real energy = 0;
+    energy += V1 * (1.0 + cos((1.0 * phi - gamma1) * chemkit::constants::DegreesToRadians));
+    energy += V2 * (1.0 + cos((2.0 * phi - gamma2) * chemkit::constants::DegreesToRadians));
+    energy += V3 * (1.0 + cos((3.0 * phi - gamma3) * chemkit::constants::DegreesToRadians));
+    energy += V4 * (1.0 + cos((4.0 * phi - gamma4) * chemkit::constants::DegreesToRadians));
 
     // dE/dphi
     chemkit::Real de_dphi = 0;
@@ -256,19 +400,39 @@ std::vector<chemkit::Vector3> AmberTorsionCalculation::gradient(const chemkit::C
     de_dphi += V4 * (-sin((4.0 * phi - gamma4) * chemkit::constants::DegreesToRadians) * 4.0);
     de_dphi *= chemkit::constants::DegreesToRadians;
 
-    boost::array<chemkit::Vector3, 4> gradient = coordinates->torsionAngleGradient(a, b, c, d);
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
 
-    gradient[0] *= de_dphi;
-    gradient[1] *= de_dphi;
-    gradient[2] *= de_dphi;
-    gradient[3] *= de_dphi;
+    return energy;
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::Real AmberTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> AmberTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(4);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real AmberTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* AmberTorsionCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<AmberTorsionCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === AmberNonbondedCalculation =========================================== //
 AmberNonbondedCalculation::AmberNonbondedCalculation(size_t a, size_t b)
-    : AmberCalculation(VanDerWaals | Electrostatic, 2, 2)
+    : AmberCalculation(VanDerWaals | Electrostatic, 2, 4)
 {
     setAtom(0, a);
     setAtom(1, b);
@@ -290,19 +454,23 @@ bool AmberNonbondedCalculation::setup(const AmberParameters *parameters)
 
     setParameter(0, epsilon);
     setParameter(1, sigma);
+    setParameter(2, topology()->charge(atom(0)));
+    setParameter(3, topology()->charge(atom(1)));
 
     return true;
 }
 
-chemkit::Real AmberNonbondedCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real AmberNonbondedCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                const size_t *atoms,
+                                                const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real epsilon = parameter(0);
-    chemkit::Real sigma = parameter(1);
-    chemkit::Real qa = topology()->charge(a);
-    chemkit::Real qb = topology()->charge(b);
+    chemkit::Real epsilon = parameters[0];
+    chemkit::Real sigma = parameters[1];
+    chemkit::Real qa = parameters[2];
+    chemkit::Real qb = parameters[3];
     chemkit::Real r = coordinates->distance(a, b);
     chemkit::Real e0 = 1;
 
@@ -312,28 +480,81 @@ chemkit::Real AmberNonbondedCalculation::energy(const chemkit::CartesianCoordina
     return vanDerWaalsTerm + electrostaticTerm;
 }
 
-std::vector<chemkit::Vector3> AmberNonbondedCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void AmberNonbondedCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                         const size_t *atoms,
+                                         const chemkit::Real *parameters,
+                                         chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real epsilon = parameter(0);
-    chemkit::Real sigma = parameter(1);
-    chemkit::Real qa = topology()->charge(a);
-    chemkit::Real qb = topology()->charge(b);
+    chemkit::Real epsilon = parameters[0];
+    chemkit::Real sigma = parameters[1];
+    chemkit::Real qa = parameters[2];
+    chemkit::Real qb = parameters[3];
     chemkit::Real e0 = 1;
     chemkit::Real pi = chemkit::constants::Pi;
 
-    chemkit::Real r = coordinates->distance(a, b);
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
+    chemkit::Real sr = sigma / r;
+
+    // dE/dr
+    chemkit::Real de_dr = (-12 * epsilon * sigma / pow(r, 2) * (pow(sr, 11) - pow(sr, 5))) - ((qa * qb) / (4.0 * pi * e0 * pow(r, 2)));
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real AmberNonbondedCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                           const size_t *atoms,
+                                                           const chemkit::Real *parameters,
+                                                           chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real epsilon = parameters[0];
+    chemkit::Real sigma = parameters[1];
+    chemkit::Real qa = parameters[2];
+    chemkit::Real qb = parameters[3];
+    chemkit::Real e0 = 1;
+    chemkit::Real pi = chemkit::constants::Pi;
+
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
     chemkit::Real sr = sigma / r;
 
+    chemkit::Real vanDerWaalsTerm = epsilon * (pow(sigma/r, 12) - 2 * pow(sigma/r, 6));
+    chemkit::Real electrostaticTerm = (qa * qb) / (4.0 * pi * e0 * r);
+
     // dE/dr
     chemkit::Real de_dr = (-12 * epsilon * sigma / pow(r, 2) * (pow(sr, 11) - pow(sr, 5))) - ((qa * qb) / (4.0 * pi * e0 * pow(r, 2)));
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+    return vanDerWaalsTerm + electrostaticTerm;
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::Real AmberNonbondedCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> AmberNonbondedCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real AmberNonbondedCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* AmberNonbondedCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<AmberNonbondedCalculation>(type(), atomCount(), parameterCount());
 }
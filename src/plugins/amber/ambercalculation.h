@@ -37,6 +37,7 @@
 #define AMBERCALCULATION_H
 
 #include <chemkit/forcefieldcalculation.h>
+#include <chemkit/forcefieldcalculationbatch.h>
 
 class AmberParameters;
 
@@ -57,6 +58,14 @@ public:
     bool setup(const AmberParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class AmberAngleCalculation : public AmberCalculation
@@ -67,6 +76,14 @@ public:
     bool setup(const AmberParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class AmberTorsionCalculation : public AmberCalculation
@@ -77,6 +94,14 @@ public:
     bool setup(const AmberParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class AmberNonbondedCalculation : public AmberCalculation
@@ -87,6 +112,14 @@ public:
     bool setup(const AmberParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 #endif // AMBERCALCULATION_H
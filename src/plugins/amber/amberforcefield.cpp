@@ -85,15 +85,18 @@ bool AmberForceField::setup()
                                                    interaction[3]));
     }
 
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        addCalculation(new AmberNonbondedCalculation(interaction[0],
-                                                     interaction[1]));
+    // with a nonbonded cutoff the nonbonded calculations are created
+    // from the neighbor list instead
+    if(nonbondedCutoff() == 0){
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            addNonbondedCalculations(interaction[0], interaction[1]);
+        }
     }
 
     bool ok = true;
 
     foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<AmberCalculation *>(calculation)->setup(m_parameters);
+        bool setup = setupCalculation(calculation);
 
         if(!setup){
             ok = false;
@@ -105,6 +108,16 @@ bool AmberForceField::setup()
     return ok;
 }
 
+void AmberForceField::addNonbondedCalculations(size_t a, size_t b)
+{
+    addCalculation(new AmberNonbondedCalculation(a, b));
+}
+
+bool AmberForceField::setupCalculation(chemkit::ForceFieldCalculation *calculation)
+{
+    return static_cast<AmberCalculation *>(calculation)->setup(m_parameters);
+}
+
 const AmberParameters* AmberForceField::parameters() const
 {
     return m_parameters;
@@ -51,6 +51,10 @@ public:
     virtual bool setup();
     const AmberParameters* parameters() const;
 
+protected:
+    void addNonbondedCalculations(size_t a, size_t b) CHEMKIT_OVERRIDE;
+    bool setupCalculation(chemkit::ForceFieldCalculation *calculation) CHEMKIT_OVERRIDE;
+
 private:
     AmberParameters *m_parameters;
 };
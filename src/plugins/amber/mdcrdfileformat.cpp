@@ -35,6 +35,10 @@
 
 #include "mdcrdfileformat.h"
 
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+
 #include <boost/make_shared.hpp>
 
 #include <chemkit/topology.h>
@@ -43,6 +47,31 @@
 #include <chemkit/trajectoryframe.h>
 #include <chemkit/cartesiancoordinates.h>
 
+namespace {
+
+// Returns a pointer to the first character of the next value in the
+// range [begin, end) or end if there are no more values.
+const char* nextValue(const char *begin, const char *end)
+{
+    while(begin != end && isspace(static_cast<unsigned char>(*begin))){
+        begin++;
+    }
+
+    return begin;
+}
+
+// Returns a pointer to the character after the value starting at begin.
+const char* valueEnd(const char *begin, const char *end)
+{
+    while(begin != end && !isspace(static_cast<unsigned char>(*begin))){
+        begin++;
+    }
+
+    return begin;
+}
+
+} // end anonymous namespace
+
 MdcrdFileFormat::MdcrdFileFormat()
     : chemkit::TrajectoryFileFormat("mdcrd")
 {
@@ -65,7 +94,7 @@ bool MdcrdFileFormat::read(std::istream &input, chemkit::TrajectoryFile *file)
     std::string comments;
     std::getline(input, comments);
 
-    while(!input.eof()){
+    for(;;){
         chemkit::TrajectoryFrame *frame = trajectory->addFrame();
 
         for(size_t i = 0; i < trajectory->size(); i++){
@@ -73,9 +102,105 @@ bool MdcrdFileFormat::read(std::istream &input, chemkit::TrajectoryFile *file)
             input >> x >> y >> z;
             frame->setPosition(i, chemkit::Point3(x, y, z));
         }
+
+        // discard incomplete frames at the end of the file
+        if(!input){
+            trajectory->removeFrame(frame);
+            break;
+        }
     }
 
     file->setTrajectory(trajectory);
 
     return true;
 }
+
+bool MdcrdFileFormat::supportsFrameAccess() const
+{
+    return true;
+}
+
+bool MdcrdFileFormat::readFrameOffsets(const boost::iostreams::mapped_file_source &input,
+                                       const chemkit::TrajectoryFile *file,
+                                       std::vector<size_t> &offsets)
+{
+    boost::shared_ptr<chemkit::Topology> topology = file->topology();
+    if(!topology){
+        setErrorString("Topology required to read 'mdcrd' trajectories.");
+        return false;
+    }
+
+    size_t valueCount = 3 * topology->size();
+    if(valueCount == 0){
+        setErrorString("Topology contains no atoms.");
+        return false;
+    }
+
+    offsets.clear();
+
+    const char *begin = input.data();
+    const char *end = begin + input.size();
+
+    // skip comments line
+    const char *position = std::find(begin, end, '\n');
+
+    // each frame starts at every valueCount'th value
+    size_t count = 0;
+    size_t frameOffset = 0;
+    for(;;){
+        position = nextValue(position, end);
+        if(position == end){
+            break;
+        }
+
+        if(count % valueCount == 0){
+            frameOffset = position - begin;
+        }
+
+        position = valueEnd(position, end);
+        count++;
+
+        if(count % valueCount == 0){
+            offsets.push_back(frameOffset);
+        }
+    }
+
+    return true;
+}
+
+bool MdcrdFileFormat::readFrame(const boost::iostreams::mapped_file_source &input,
+                                size_t offset,
+                                chemkit::TrajectoryFrame *frame)
+{
+    const char *position = input.data() + offset;
+    const char *end = input.data() + input.size();
+
+    for(size_t i = 0; i < frame->size(); i++){
+        chemkit::Real values[3];
+
+        for(int j = 0; j < 3; j++){
+            position = nextValue(position, end);
+            const char *valueEnd = ::valueEnd(position, end);
+
+            // copy the value so that strtod() does not read past the end
+            // of the mapped file
+            char buffer[64];
+            size_t length = std::min(size_t(valueEnd - position), sizeof(buffer) - 1);
+            std::copy(position, position + length, buffer);
+            buffer[length] = '\0';
+
+            char *parsed = 0;
+            values[j] = strtod(buffer, &parsed);
+            if(length == 0 || parsed == buffer){
+                setErrorString("Invalid coordinate value.");
+                return false;
+            }
+
+            position = valueEnd;
+        }
+
+        frame->setPosition(i, chemkit::Point3(values[0], values[1], values[2]));
+    }
+
+    return true;
+}
@@ -44,6 +44,9 @@ public:
     MdcrdFileFormat();
 
     virtual bool read(std::istream &input, chemkit::TrajectoryFile *file);
+    virtual bool supportsFrameAccess() const;
+    virtual bool readFrameOffsets(const boost::iostreams::mapped_file_source &input, const chemkit::TrajectoryFile *file, std::vector<size_t> &offsets);
+    virtual bool readFrame(const boost::iostreams::mapped_file_source &input, size_t offset, chemkit::TrajectoryFrame *frame);
 };
 
 #endif // MDCRDFILEFORMAT_H
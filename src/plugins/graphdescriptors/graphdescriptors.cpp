@@ -35,52 +35,11 @@
 
 #include "graphdescriptors.h"
 
-#include <set>
-#include <vector>
+#include <limits>
 
-#include <chemkit/atom.h>
-#include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
-
-namespace {
-
-// Returns the graph distance between the two atoms.
-int distanceBetween(const chemkit::Atom *a, const chemkit::Atom *b)
-{
-    int distance = 0;
-
-    std::set<const chemkit::Atom*> visited;
-
-    std::vector<const chemkit::Atom*> row;
-    row.push_back(a);
-
-    while(!row.empty()){
-        std::vector<const chemkit::Atom*> nextRow;
-
-        foreach(const chemkit::Atom *atom, row){
-            if(atom == b){
-                return distance;
-            }
-
-            visited.insert(atom);
-
-            foreach(const chemkit::Atom *neighbor, atom->neighbors()){
-                if(visited.find(neighbor) != visited.end()){
-                    continue;
-                }
-
-                nextRow.push_back(neighbor);
-            }
-        }
-
-        row = nextRow;
-        distance++;
-    }
-
-    return 0;
-}
-
-} // end anonymous namespace
+#include <chemkit/moleculardescriptorcontext.h>
+#include <chemkit/topologicaldistancematrix.h>
 
 // === GraphDensityDescriptor ============================================== //
 GraphDensityDescriptor::GraphDensityDescriptor()
@@ -110,15 +69,20 @@ GraphDiameterDescriptor::GraphDiameterDescriptor()
 
 chemkit::Variant GraphDiameterDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    int diameter = 0;
+    chemkit::MolecularDescriptorContext context(molecule);
 
-    for(size_t i = 0; i < molecule->size(); i++){
-        const chemkit::Atom *a = molecule->atom(i);
+    return value(&context);
+}
+
+chemkit::Variant GraphDiameterDescriptor::value(chemkit::MolecularDescriptorContext *context) const
+{
+    const chemkit::TopologicalDistanceMatrix *distances = context->distanceMatrix();
 
-        for(size_t j = i + 1; j < molecule->size(); j++){
-            const chemkit::Atom *b = molecule->atom(j);
+    int diameter = 0;
 
-            int distance = distanceBetween(a, b);
+    for(size_t i = 0; i < distances->size(); i++){
+        for(size_t j = i + 1; j < distances->size(); j++){
+            int distance = static_cast<int>(distances->distance(i, j));
 
             if(distance > diameter){
                 diameter = distance;
@@ -150,22 +114,19 @@ GraphRadiusDescriptor::GraphRadiusDescriptor()
 
 chemkit::Variant GraphRadiusDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    int radius = std::numeric_limits<int>::max();
-
-    for(size_t i = 0; i < molecule->size(); i++){
-        const chemkit::Atom *a = molecule->atom(i);
+    chemkit::MolecularDescriptorContext context(molecule);
 
-        int eccentricity = 0;
+    return value(&context);
+}
 
-        for(size_t j = 0; j < molecule->size(); j++){
-            const chemkit::Atom *b = molecule->atom(j);
+chemkit::Variant GraphRadiusDescriptor::value(chemkit::MolecularDescriptorContext *context) const
+{
+    const chemkit::TopologicalDistanceMatrix *distances = context->distanceMatrix();
 
-            int distance = distanceBetween(a, b);
+    int radius = std::numeric_limits<int>::max();
 
-            if(distance > eccentricity){
-                eccentricity = distance;
-            }
-        }
+    for(size_t i = 0; i < distances->size(); i++){
+        int eccentricity = static_cast<int>(distances->eccentricity(i));
 
         if(eccentricity < radius){
             radius = eccentricity;
@@ -52,6 +52,7 @@ public:
     GraphDiameterDescriptor();
     
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 class GraphOrderDescriptor : public chemkit::MolecularDescriptor
@@ -68,6 +69,7 @@ public:
     GraphRadiusDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 class GraphSizeDescriptor : public chemkit::MolecularDescriptor
@@ -40,6 +40,9 @@
 
 #include "mdlfileformat.h"
 
+#include <limits>
+#include <algorithm>
+
 #include <boost/algorithm/string.hpp>
 
 #include <chemkit/atom.h>
@@ -70,7 +73,8 @@ int readNumber(const char *s, int length)
 
 // --- Construction and Destruction ---------------------------------------- //
 MdlFileFormat::MdlFileFormat(const std::string &name)
-    : chemkit::MoleculeFileFormat(name)
+    : chemkit::MoleculeFileFormat(name),
+      m_recordEnded(false)
 {
 }
 
@@ -92,6 +96,52 @@ bool MdlFileFormat::read(std::istream &input, chemkit::MoleculeFile *file)
     }
 }
 
+bool MdlFileFormat::supportsReadNext() const
+{
+    return true;
+}
+
+bool MdlFileFormat::readNext(std::istream &input, boost::shared_ptr<chemkit::Molecule> &molecule)
+{
+    molecule.reset();
+
+    if(input.peek() == std::char_traits<char>::eof()){
+        return true;
+    }
+
+    bool atEnd = false;
+
+    if(name() == "mol" || name() == "mdl"){
+        molecule = readMolecule(input, atEnd);
+
+        // mol files contain a single molecule
+        input.ignore(std::numeric_limits<std::streamsize>::max());
+    }
+    else if(name() == "sdf" || name() == "sd"){
+        molecule = readMolecule(input, atEnd);
+
+        if(molecule){
+            readDataBlock(input, molecule.get());
+        }
+        else if(!atEnd){
+            // move to the start of the next record so that reading
+            // can continue after the error is reported
+            skipRecord(input);
+        }
+    }
+    else{
+        return false;
+    }
+
+    // a record which could not be parsed is an error unless only
+    // blank lines remained after the previous record
+    if(!molecule && !atEnd){
+        return false;
+    }
+
+    return true;
+}
+
 bool MdlFileFormat::write(const chemkit::MoleculeFile *file, std::ostream &output)
 {
     if(file->isEmpty()){
@@ -114,26 +164,101 @@ bool MdlFileFormat::write(const chemkit::MoleculeFile *file, std::ostream &outpu
 // --- Internal Methods ---------------------------------------------------- //
 bool MdlFileFormat::readMolFile(std::istream &input, chemkit::MoleculeFile *file)
 {
+    bool atEnd = false;
+    boost::shared_ptr<chemkit::Molecule> molecule = readMolecule(input, atEnd);
+    if(!molecule){
+        return false;
+    }
+
+    file->addMolecule(molecule);
+
+    return true;
+}
+
+// Reads each molecule in the sdf file. Records which cannot be read
+// are skipped and the remaining molecules are still added to the
+// file. Returns false if any record could not be read, in which case
+// the error string describes the first invalid record.
+bool MdlFileFormat::readSdfFile(std::istream &input, chemkit::MoleculeFile *file)
+{
+    std::string firstError;
+
+    while(!input.eof()){
+        // read molecule
+        bool atEnd = false;
+        boost::shared_ptr<chemkit::Molecule> molecule = readMolecule(input, atEnd);
+        if(!molecule){
+            if(atEnd){
+                break;
+            }
+
+            if(firstError.empty()){
+                firstError = errorString();
+            }
+
+            skipRecord(input);
+            continue;
+        }
+
+        // read data block
+        readDataBlock(input, molecule.get());
+
+        file->addMolecule(molecule);
+    }
+
+    if(!firstError.empty()){
+        setErrorString(firstError);
+        return false;
+    }
+
+    // return false if we failed to read any molecules
+    if(file->moleculeCount() == 0){
+        return false;
+    }
+
+    return true;
+}
+
+// Reads the next molecule from input. Returns a null pointer if the
+// molecule could not be read, in which case atEnd is set to true if
+// the input ended with only blank lines remaining.
+boost::shared_ptr<chemkit::Molecule> MdlFileFormat::readMolecule(std::istream &input, bool &atEnd)
+{
+    m_recordEnded = false;
+
     // title line
     std::string title;
-    std::getline(input, title);
+    readRecordLine(input, title);
 
      // creator line
     std::string creator;
-    std::getline(input, creator);
+    readRecordLine(input, creator);
 
     // comment line
     std::string comment;
-    std::getline(input, comment);
+    readRecordLine(input, comment);
 
     if(input.eof()){
-        setErrorString("File is empty");
-        return false;
+        atEnd = boost::algorithm::trim_copy(title + creator + comment).empty();
+
+        if(atEnd){
+            setErrorString("File is empty");
+        }
+        else{
+            setErrorString("Unexpected end of file in molecule header.");
+        }
+
+        return boost::shared_ptr<chemkit::Molecule>();
     }
 
     // read counts line
     std::string countsLine;
-    std::getline(input, countsLine);
+    readRecordLine(input, countsLine);
+
+    if(countsLine.size() < 6 || !isdigit(countsLine[2]) || !isdigit(countsLine[5])){
+        setErrorString("Invalid counts line for molecule '" + title + "'.");
+        return boost::shared_ptr<chemkit::Molecule>();
+    }
 
     int atomCount = readNumber(&countsLine[0], 3);
     int bondCount = readNumber(&countsLine[3], 3);
@@ -144,55 +269,45 @@ bool MdlFileFormat::readMolFile(std::istream &input, chemkit::MoleculeFile *file
         molecule->setName(title);
     }
 
+    chemkit::MoleculeBuilder builder(molecule.get());
+    builder.reserve(std::max(atomCount, 0), std::max(bondCount, 0));
+
     // read atoms
-    readAtomBlock(input, molecule.get(), atomCount);
+    if(!readAtomBlock(input, builder, atomCount)){
+        setErrorString("Invalid atom block for molecule '" + title + "'.");
+        return boost::shared_ptr<chemkit::Molecule>();
+    }
 
     // read bonds
-    readBondBlock(input, molecule.get(), bondCount);
+    if(!readBondBlock(input, builder, bondCount)){
+        setErrorString("Invalid bond block for molecule '" + title + "'.");
+        return boost::shared_ptr<chemkit::Molecule>();
+    }
+
+    builder.commit();
 
     // read properties
     readPropertyBlock(input, molecule.get());
 
-    file->addMolecule(molecule);
-
-    return true;
+    return molecule;
 }
 
-bool MdlFileFormat::readSdfFile(std::istream &input, chemkit::MoleculeFile *file)
-{
-    while(!input.eof()){
-        // read molecule
-        readMolFile(input, file);
-
-        // read data block
-        chemkit::Molecule *molecule = file->molecules().back().get();
-        readDataBlock(input, molecule);
-    }
-
-    // return false if we failed to read any molecules
-    if(file->moleculeCount() == 0){
-        return false;
-    }
-
-    return true;
-}
-
-bool MdlFileFormat::readAtomBlock(std::istream &input, chemkit::Molecule *molecule, int atomCount)
+bool MdlFileFormat::readAtomBlock(std::istream &input, chemkit::MoleculeBuilder &builder, int atomCount)
 {
     for(int i = 0; i < atomCount; i++){
         std::string line;
-        std::getline(input, line);
+        readRecordLine(input, line);
 
         if(line.size() < 33){
             // line too short
-            continue;
+            return false;
         }
 
         double x, y, z;
-        char symbol[3];
+        char symbol[4];
         sscanf(&line[0], "%10lf%10lf%10lf%3s", &x, &y, &z, symbol);
 
-        chemkit::Atom *atom = molecule->addAtom(symbol);
+        chemkit::Atom *atom = builder.addAtom(symbol, chemkit::Point3(x, y, z));
         if(!atom->element().isValid()){
             if(strcmp(symbol, "D") == 0){
                 atom->setIsotope(chemkit::Isotope(chemkit::Atom::Hydrogen, 2));
@@ -201,36 +316,38 @@ bool MdlFileFormat::readAtomBlock(std::istream &input, chemkit::Molecule *molecu
                 atom->setIsotope(chemkit::Isotope(chemkit::Atom::Hydrogen, 3));
             }
         }
-
-        atom->setPosition(x, y, z);
     }
 
     return true;
 }
 
-bool MdlFileFormat::readBondBlock(std::istream &input, chemkit::Molecule *molecule, int bondCount)
+bool MdlFileFormat::readBondBlock(std::istream &input, chemkit::MoleculeBuilder &builder, int bondCount)
 {
+    std::vector<std::pair<size_t, size_t> > bonds;
+    std::vector<int> bondOrders;
+    bonds.reserve(std::max(bondCount, 0));
+    bondOrders.reserve(std::max(bondCount, 0));
+
     for(int i = 0; i < bondCount; i++){
         std::string line;
-        std::getline(input, line);
+        readRecordLine(input, line);
         if(line.size() < 9){
             // line too short
+            builder.addBonds(bonds, bondOrders);
             return false;
         }
 
         int firstAtomIndex = readNumber(&line[0], 3);
         int secondAtomIndex = readNumber(&line[3], 3);
 
-        chemkit::Atom *firstAtom = molecule->atom(firstAtomIndex - 1);
-        chemkit::Atom *secondAtom = molecule->atom(secondAtomIndex - 1);
-        if(firstAtom && secondAtom){
-            chemkit::Bond *bond = molecule->addBond(firstAtom, secondAtom);
+        int bondOrder = line[8] - '0';
 
-            int bondOrder = line[8] - '0';
-            bond->setOrder(bondOrder);
-        }
+        bonds.push_back(std::make_pair(firstAtomIndex - 1, secondAtomIndex - 1));
+        bondOrders.push_back(bondOrder);
     }
 
+    builder.addBonds(bonds, bondOrders);
+
     return true;
 }
 
@@ -287,6 +404,28 @@ bool MdlFileFormat::readDataBlock(std::istream &input, chemkit::Molecule *molecu
     return false;
 }
 
+// Reads a line belonging to a molecule record. If the line is the
+// "$$$$" delimiter the record is marked as ended so that it is not
+// skipped past by skipRecord().
+void MdlFileFormat::readRecordLine(std::istream &input, std::string &line)
+{
+    std::getline(input, line);
+
+    if(boost::starts_with(line, "$$$$")){
+        m_recordEnded = true;
+    }
+}
+
+// Skips the remainder of an invalid record up to and including the
+// "$$$$" delimiter which separates it from the next record.
+void MdlFileFormat::skipRecord(std::istream &input)
+{
+    while(!m_recordEnded && !input.eof()){
+        std::string line;
+        readRecordLine(input, line);
+    }
+}
+
 void MdlFileFormat::writeMolFile(const chemkit::Molecule *molecule, std::ostream &output)
 {
     // name, creator, and comment lines
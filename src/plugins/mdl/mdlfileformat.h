@@ -37,6 +37,7 @@
 #define MDLFILEFORMAT_H
 
 #include <chemkit/molecule.h>
+#include <chemkit/moleculebuilder.h>
 #include <chemkit/moleculefileformat.h>
 
 class MdlFileFormat : public chemkit::MoleculeFileFormat
@@ -48,19 +49,27 @@ public:
 
     // input and output
     bool read(std::istream &input, chemkit::MoleculeFile *file) CHEMKIT_OVERRIDE;
+    bool supportsReadNext() const CHEMKIT_OVERRIDE;
+    bool readNext(std::istream &input, boost::shared_ptr<chemkit::Molecule> &molecule) CHEMKIT_OVERRIDE;
     bool write(const chemkit::MoleculeFile *file, std::ostream &output) CHEMKIT_OVERRIDE;
 
 private:
     bool readMolFile(std::istream &input, chemkit::MoleculeFile *file);
+    boost::shared_ptr<chemkit::Molecule> readMolecule(std::istream &input, bool &atEnd);
     bool readSdfFile(std::istream &input, chemkit::MoleculeFile *file);
-    bool readAtomBlock(std::istream &input, chemkit::Molecule *molecule, int atomCount);
-    bool readBondBlock(std::istream &input, chemkit::Molecule *molecule, int bondCount);
+    bool readAtomBlock(std::istream &input, chemkit::MoleculeBuilder &builder, int atomCount);
+    bool readBondBlock(std::istream &input, chemkit::MoleculeBuilder &builder, int bondCount);
     bool readPropertyBlock(std::istream &input, chemkit::Molecule *molecule);
     bool readDataBlock(std::istream &input, chemkit::Molecule *molecule);
+    void readRecordLine(std::istream &input, std::string &line);
+    void skipRecord(std::istream &input);
     void writeMolFile(const chemkit::Molecule *molecule, std::ostream &output);
     void writeSdfFile(const chemkit::MoleculeFile *file, std::ostream &output);
     void writeAtomBlock(const chemkit::Molecule *molecule, std::ostream &output);
     void writeBondBlock(const chemkit::Molecule *molecule, std::ostream &output);
+
+private:
+    bool m_recordEnded;
 };
 
 #endif // MDLFILEFORMAT_H
@@ -79,13 +79,15 @@ bool MmffBondStrechCalculation::setup(const MmffParameters *parameters)
     return false;
 }
 
-chemkit::Real MmffBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real MmffBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                const size_t *atoms,
+                                                const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
 
     chemkit::Real r = coordinates->distance(a, b);
     chemkit::Real dr = r - r0;
@@ -95,27 +97,75 @@ chemkit::Real MmffBondStrechCalculation::energy(const chemkit::CartesianCoordina
     return 143.9325 * (kb / 2) * (dr*dr) * (1 + cs * dr + ((7.0/12.0)*(cs*cs)) * (dr*dr));
 }
 
-std::vector<chemkit::Vector3> MmffBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void MmffBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                         const size_t *atoms,
+                                         const chemkit::Real *parameters,
+                                         chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
 
-    chemkit::Real r = coordinates->distance(a, b);
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
     chemkit::Real dr = r - r0;
     chemkit::Real cs = -2.0; // cubic strech constant
 
     // dE/dr
     chemkit::Real de_dr = 143.9325 * kb * dr * (1 + cs * dr + (7.0/12.0 * (cs*cs) * (dr*dr)) + 0.5 * dr * (cs + (14.0/12.0 * (cs*cs) * dr)));
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real MmffBondStrechCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                           const size_t *atoms,
+                                                           const chemkit::Real *parameters,
+                                                           chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
+    chemkit::Real dr = r - r0;
+    chemkit::Real cs = -2.0; // cubic strech constant
+
+    // dE/dr
+    chemkit::Real de_dr = 143.9325 * kb * dr * (1 + cs * dr + (7.0/12.0 * (cs*cs) * (dr*dr)) + 0.5 * dr * (cs + (14.0/12.0 * (cs*cs) * dr)));
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+
+    // equation 2
+    return 143.9325 * (kb / 2) * (dr*dr) * (1 + cs * dr + ((7.0/12.0)*(cs*cs)) * (dr*dr));
+}
+
+chemkit::Real MmffBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> MmffBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+chemkit::Real MmffBondStrechCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::ForceFieldCalculationBatch* MmffBondStrechCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<MmffBondStrechCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === MmffAngleBendCalculation ============================================ //
@@ -152,14 +202,16 @@ bool MmffAngleBendCalculation::setup(const MmffParameters *parameters)
     return false;
 }
 
-chemkit::Real MmffAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real MmffAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                               const size_t *atoms,
+                                               const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real t0 = parameter(1);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real t0 = parameters[1];
 
     chemkit::Real cb = -0.007; // cubic bend constant
     chemkit::Real t = coordinates->angle(a, b, c);
@@ -169,29 +221,79 @@ chemkit::Real MmffAngleBendCalculation::energy(const chemkit::CartesianCoordinat
     return 0.043844 * (ka / 2.0) * pow(dt, 2) * (1 + cb * dt);
 }
 
-std::vector<chemkit::Vector3> MmffAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void MmffAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                        const size_t *atoms,
+                                        const chemkit::Real *parameters,
+                                        chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real t0 = parameter(1);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real t0 = parameters[1];
 
     chemkit::Real cb = -0.007; // cubic bend constant
-    chemkit::Real t = coordinates->angle(a, b, c);
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real t = coordinates->angleAndGradient(a, b, c, angleGradient);
     chemkit::Real dt = t - t0;
 
     // dE/dt
     chemkit::Real de_dt = 0.043844 * ka * dt * (1 + cb * dt + 0.5 * cb * dt);
 
-    boost::array<chemkit::Vector3, 3> gradient = coordinates->angleGradient(a, b, c);
+    gradient[0] = angleGradient[0] * de_dt;
+    gradient[1] = angleGradient[1] * de_dt;
+    gradient[2] = angleGradient[2] * de_dt;
+}
 
-    gradient[0] *= de_dt;
-    gradient[1] *= de_dt;
-    gradient[2] *= de_dt;
+chemkit::Real MmffAngleBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                          const size_t *atoms,
+                                                          const chemkit::Real *parameters,
+                                                          chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+    chemkit::Real ka = parameters[0];
+    chemkit::Real t0 = parameters[1];
+
+    chemkit::Real cb = -0.007; // cubic bend constant
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real t = coordinates->angleAndGradient(a, b, c, angleGradient);
+    chemkit::Real dt = t - t0;
+
+    // dE/dt
+    chemkit::Real de_dt = 0.043844 * ka * dt * (1 + cb * dt + 0.5 * cb * dt);
+
+    gradient[0] = angleGradient[0] * de_dt;
+    gradient[1] = angleGradient[1] * de_dt;
+    gradient[2] = angleGradient[2] * de_dt;
+
+    // equation 3
+    return 0.043844 * (ka / 2.0) * pow(dt, 2) * (1 + cb * dt);
+}
+
+chemkit::Real MmffAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> MmffAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(3);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real MmffAngleBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* MmffAngleBendCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<MmffAngleBendCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === MmffStrechBendCalculation =========================================== //
@@ -268,17 +370,19 @@ bool MmffStrechBendCalculation::setup(const MmffParameters *parameters)
     return false;
 }
 
-chemkit::Real MmffStrechBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real MmffStrechBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                const size_t *atoms,
+                                                const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real kba_ijk = parameter(0);
-    chemkit::Real kba_kji = parameter(1);
-    chemkit::Real r0_ab = parameter(2);
-    chemkit::Real r0_bc = parameter(3);
-    chemkit::Real t0 = parameter(4);
+    chemkit::Real kba_ijk = parameters[0];
+    chemkit::Real kba_kji = parameters[1];
+    chemkit::Real r0_ab = parameters[2];
+    chemkit::Real r0_bc = parameters[3];
+    chemkit::Real t0 = parameters[4];
 
     chemkit::Real r_ab = coordinates->distance(a, b);
     chemkit::Real r_bc = coordinates->distance(b, c);
@@ -291,36 +395,90 @@ chemkit::Real MmffStrechBendCalculation::energy(const chemkit::CartesianCoordina
     return 2.51210 * (kba_ijk * dr_ab + kba_kji * dr_bc) * dt;
 }
 
-std::vector<chemkit::Vector3> MmffStrechBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void MmffStrechBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                         const size_t *atoms,
+                                         const chemkit::Real *parameters,
+                                         chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+
+    chemkit::Real kba_ijk = parameters[0];
+    chemkit::Real kba_kji = parameters[1];
+    chemkit::Real r0_ab = parameters[2];
+    chemkit::Real r0_bc = parameters[3];
+    chemkit::Real t0 = parameters[4];
+
+    boost::array<chemkit::Vector3, 2> distanceGradientAB;
+    chemkit::Real r_ab = coordinates->distanceAndGradient(a, b, distanceGradientAB);
+    boost::array<chemkit::Vector3, 2> distanceGradientBC;
+    chemkit::Real r_bc = coordinates->distanceAndGradient(b, c, distanceGradientBC);
+    chemkit::Real dr_ab = r_ab - r0_ab;
+    chemkit::Real dr_bc = r_bc - r0_bc;
+    boost::array<chemkit::Vector3, 3> angleGradientABC;
+    chemkit::Real t = coordinates->angleAndGradient(a, b, c, angleGradientABC);
+    chemkit::Real dt = t - t0;
 
-    chemkit::Real kba_ijk = parameter(0);
-    chemkit::Real kba_kji = parameter(1);
-    chemkit::Real r0_ab = parameter(2);
-    chemkit::Real r0_bc = parameter(3);
-    chemkit::Real t0 = parameter(4);
+    gradient[0] = (distanceGradientAB[0] * kba_ijk * dt + angleGradientABC[0] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
+    gradient[1] = ((distanceGradientAB[1] * kba_ijk + distanceGradientBC[0] * kba_kji) * dt + angleGradientABC[1] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
+    gradient[2] = ((distanceGradientBC[1] * kba_kji) * dt + angleGradientABC[2] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
+}
 
-    chemkit::Real r_ab = coordinates->distance(a, b);
-    chemkit::Real r_bc = coordinates->distance(b, c);
+chemkit::Real MmffStrechBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                           const size_t *atoms,
+                                                           const chemkit::Real *parameters,
+                                                           chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+
+    chemkit::Real kba_ijk = parameters[0];
+    chemkit::Real kba_kji = parameters[1];
+    chemkit::Real r0_ab = parameters[2];
+    chemkit::Real r0_bc = parameters[3];
+    chemkit::Real t0 = parameters[4];
+
+    boost::array<chemkit::Vector3, 2> distanceGradientAB;
+    chemkit::Real r_ab = coordinates->distanceAndGradient(a, b, distanceGradientAB);
+    boost::array<chemkit::Vector3, 2> distanceGradientBC;
+    chemkit::Real r_bc = coordinates->distanceAndGradient(b, c, distanceGradientBC);
     chemkit::Real dr_ab = r_ab - r0_ab;
     chemkit::Real dr_bc = r_bc - r0_bc;
-    chemkit::Real t = coordinates->angle(a, b, c);
+    boost::array<chemkit::Vector3, 3> angleGradientABC;
+    chemkit::Real t = coordinates->angleAndGradient(a, b, c, angleGradientABC);
     chemkit::Real dt = t - t0;
+    chemkit::Real strech = kba_ijk * dr_ab + kba_kji * dr_bc;
 
-    std::vector<chemkit::Vector3> gradient(3);
+    gradient[0] = (distanceGradientAB[0] * kba_ijk * dt + angleGradientABC[0] * strech) * 2.51210;
+    gradient[1] = ((distanceGradientAB[1] * kba_ijk + distanceGradientBC[0] * kba_kji) * dt + angleGradientABC[1] * strech) * 2.51210;
+    gradient[2] = ((distanceGradientBC[1] * kba_kji) * dt + angleGradientABC[2] * strech) * 2.51210;
 
-    boost::array<chemkit::Vector3, 2> distanceGradientAB = coordinates->distanceGradient(a, b);
-    boost::array<chemkit::Vector3, 2> distanceGradientBC = coordinates->distanceGradient(b, c);
-    boost::array<chemkit::Vector3, 3> angleGradientABC = coordinates->angleGradient(a, b, c);
+    // equation 5
+    return 2.51210 * strech * dt;
+}
 
-    gradient[0] = (distanceGradientAB[0] * kba_ijk * dt + angleGradientABC[0] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
-    gradient[1] = ((distanceGradientAB[1] * kba_ijk + distanceGradientBC[0] * kba_kji) * dt + angleGradientABC[1] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
-    gradient[2] = ((distanceGradientBC[1] * kba_kji) * dt + angleGradientABC[2] * (kba_ijk * dr_ab + kba_kji * dr_bc)) * 2.51210;
+chemkit::Real MmffStrechBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> MmffStrechBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(3);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real MmffStrechBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
 
-    return gradient;
+chemkit::ForceFieldCalculationBatch* MmffStrechBendCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<MmffStrechBendCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === MmffOutOfPlaneBendingCalculation ==================================== //
@@ -357,41 +515,91 @@ bool MmffOutOfPlaneBendingCalculation::setup(const MmffParameters *parameters)
     return true;
 }
 
-chemkit::Real MmffOutOfPlaneBendingCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real MmffOutOfPlaneBendingCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                       const size_t *atoms,
+                                                       const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
     chemkit::Real angle = coordinates->wilsonAngle(a, b, c, d);
-    chemkit::Real koop = parameter(0);
+    chemkit::Real koop = parameters[0];
 
     // equation 6
     return 0.043844 * (koop / 2.0) * (angle*angle);
 }
 
-std::vector<chemkit::Vector3> MmffOutOfPlaneBendingCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void MmffOutOfPlaneBendingCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                                const size_t *atoms,
+                                                const chemkit::Real *parameters,
+                                                chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real angle = coordinates->wilsonAngle(a, b, c, d);
-    chemkit::Real koop = parameter(0);
+    boost::array<chemkit::Vector3, 4> wilsonGradient;
+    chemkit::Real angle = coordinates->wilsonAngleAndGradient(a, b, c, d, wilsonGradient);
+    chemkit::Real koop = parameters[0];
+
+    // dE/dw
+    chemkit::Real de_dw = 0.043844 * koop * angle;
+
+    gradient[0] = wilsonGradient[0] * de_dw;
+    gradient[1] = wilsonGradient[1] * de_dw;
+    gradient[2] = wilsonGradient[2] * de_dw;
+    gradient[3] = wilsonGradient[3] * de_dw;
+}
+
+chemkit::Real MmffOutOfPlaneBendingCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                                  const size_t *atoms,
+                                                                  const chemkit::Real *parameters,
+                                                                  chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
+
+    boost::array<chemkit::Vector3, 4> wilsonGradient;
+    chemkit::Real angle = coordinates->wilsonAngleAndGradient(a, b, c, d, wilsonGradient);
+    chemkit::Real koop = parameters[0];
 
     // dE/dw
     chemkit::Real de_dw = 0.043844 * koop * angle;
 
-    boost::array<chemkit::Vector3, 4> gradient = coordinates->wilsonAngleGradient(a, b, c, d);
+    gradient[0] = wilsonGradient[0] * de_dw;
+    gradient[1] = wilsonGradient[1] * de_dw;
+    gradient[2] = wilsonGradient[2] * de_dw;
+    gradient[3] = wilsonGradient[3] * de_dw;
 
-    gradient[0] *= de_dw;
-    gradient[1] *= de_dw;
-    gradient[2] *= de_dw;
-    gradient[3] *= de_dw;
+    // equation 6
+    return 0.043844 * (koop / 2.0) * (angle*angle);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::Real MmffOutOfPlaneBendingCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> MmffOutOfPlaneBendingCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(4);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real MmffOutOfPlaneBendingCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* MmffOutOfPlaneBendingCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<MmffOutOfPlaneBendingCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === MmffTorsionCalculation ============================================== //
@@ -432,45 +640,97 @@ bool MmffTorsionCalculation::setup(const MmffParameters *parameters)
     return true;
 }
 
-chemkit::Real MmffTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real MmffTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                             const size_t *atoms,
+                                             const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
     chemkit::Real angle = coordinates->torsionAngleRadians(a, b, c, d);
-    chemkit::Real V1 = parameter(0);
-    chemkit::Real V2 = parameter(1);
-    chemkit::Real V3 = parameter(2);
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
 
     // equation 7
     return 0.5 * (V1 * (1.0 + cos(angle)) + V2 * (1.0 - cos(2.0 * angle)) + V3 * (1.0 + cos(3.0 * angle)));
 }
 
-std::vector<chemkit::Vector3> MmffTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void MmffTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                      const size_t *atoms,
+                                      const chemkit::Real *parameters,
+                                      chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real phi = coordinates->torsionAngleRadians(a, b, c, d);
-    chemkit::Real V1 = parameter(0);
-    chemkit::Real V2 = parameter(1);
-    chemkit::Real V3 = parameter(2);
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradientRadians(a, b, c, d, torsionGradient);
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
 
     // dE/dphi
     chemkit::Real de_dphi = 0.5 * (-V1 * sin(phi) + 2 * V2 * sin(2 * phi) - 3 * V3 * sin(3 * phi));
 
-    boost::array<chemkit::Vector3, 4> gradient = coordinates->torsionAngleGradientRadians(a, b, c, d);
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
+}
+
+chemkit::Real MmffTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                        const size_t *atoms,
+                                                        const chemkit::Real *parameters,
+                                                        chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    gradient[0] *= de_dphi;
-    gradient[1] *= de_dphi;
-    gradient[2] *= de_dphi;
-    gradient[3] *= de_dphi;
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradientRadians(a, b, c, d, torsionGradient);
+    chemkit::Real V1 = parameters[0];
+    chemkit::Real V2 = parameters[1];
+    chemkit::Real V3 = parameters[2];
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+    // dE/dphi
+    chemkit::Real de_dphi = 0.5 * (-V1 * sin(phi) + 2 * V2 * sin(2 * phi) - 3 * V3 * sin(3 * phi));
+
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
+
+    // equation 7
+    return 0.5 * (V1 * (1.0 + cos(phi)) + V2 * (1.0 - cos(2.0 * phi)) + V3 * (1.0 + cos(3.0 * phi)));
+}
+
+chemkit::Real MmffTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> MmffTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(4);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real MmffTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* MmffTorsionCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<MmffTorsionCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === MmffVanDerWaalsCalculation ========================================== //
@@ -539,39 +799,94 @@ bool MmffVanDerWaalsCalculation::setup(const MmffParameters *parameters)
     return true;
 }
 
-chemkit::Real MmffVanDerWaalsCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real MmffVanDerWaalsCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                 const size_t *atoms,
+                                                 const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real rs = parameter(0);
-    chemkit::Real eps = parameter(1);
+    chemkit::Real rs = parameters[0];
+    chemkit::Real eps = parameters[1];
     chemkit::Real r = coordinates->distance(a, b);
 
     // equation 8
     return eps * pow(((1.07 * rs) / (r + 0.07 * rs)), 7) * (((1.12 * pow(rs, 7)) / (pow(r, 7) + 0.12 * pow(rs, 7))) - 2);
 }
 
-std::vector<chemkit::Vector3> MmffVanDerWaalsCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void MmffVanDerWaalsCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                          const size_t *atoms,
+                                          const chemkit::Real *parameters,
+                                          chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real rs = parameter(0);
-    chemkit::Real eps = parameter(1);
-    chemkit::Real r = coordinates->distance(a, b);
+    chemkit::Real rs = parameters[0];
+    chemkit::Real eps = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
 
     // dE/dr
     chemkit::Real de_dr = 7 * eps * pow(1.07 * rs / (r + 0.07 * rs), 6) *
                            ((-1.07 * rs / pow(r + 0.07 * rs, 2)) * (1.12 * pow(rs, 7) / (pow(r, 7) + 0.12 * pow(rs, 7)) - 2) +
                            (-1.12 * pow(rs, 7) * pow(r, 6) / pow(pow(r, 7) + 0.12 * pow(rs, 7), 2)) * (1.07 * rs / (r + 0.07 * rs)));
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real MmffVanDerWaalsCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                            const size_t *atoms,
+                                                            const chemkit::Real *parameters,
+                                                            chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real rs = parameters[0];
+    chemkit::Real eps = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+    // terms shared by the energy and its derivative
+    chemkit::Real rs7 = pow(rs, 7);
+    chemkit::Real r7 = pow(r, 7);
+    chemkit::Real repulsion = 1.07 * rs / (r + 0.07 * rs);
+    chemkit::Real attraction = 1.12 * rs7 / (r7 + 0.12 * rs7) - 2;
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+    // dE/dr
+    chemkit::Real de_dr = 7 * eps * pow(repulsion, 6) *
+                           ((-1.07 * rs / pow(r + 0.07 * rs, 2)) * attraction +
+                           (-1.12 * rs7 * pow(r, 6) / pow(r7 + 0.12 * rs7, 2)) * repulsion);
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+
+    // equation 8
+    return eps * pow(repulsion, 7) * attraction;
+}
+
+chemkit::Real MmffVanDerWaalsCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> MmffVanDerWaalsCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real MmffVanDerWaalsCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* MmffVanDerWaalsCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<MmffVanDerWaalsCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === MmffElectrostaticCalculation ======================================== //
@@ -607,14 +922,16 @@ bool MmffElectrostaticCalculation::setup(const MmffParameters *parameters)
     return true;
 }
 
-chemkit::Real MmffElectrostaticCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real MmffElectrostaticCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                   const size_t *atoms,
+                                                   const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real qa = parameter(0);
-    chemkit::Real qb = parameter(1);
-    chemkit::Real oneFourScaling = parameter(2);
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real oneFourScaling = parameters[2];
 
     chemkit::Real r = coordinates->distance(a, b);
     chemkit::Real e = 1.0; // dielectric constant
@@ -624,25 +941,73 @@ chemkit::Real MmffElectrostaticCalculation::energy(const chemkit::CartesianCoord
     return ((332.0716 * qa * qb) / (e * (r + d))) * oneFourScaling;
 }
 
-std::vector<chemkit::Vector3> MmffElectrostaticCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void MmffElectrostaticCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                            const size_t *atoms,
+                                            const chemkit::Real *parameters,
+                                            chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real qa = parameter(0);
-    chemkit::Real qb = parameter(1);
-    chemkit::Real oneFourScaling = parameter(2);
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real oneFourScaling = parameters[2];
 
-    chemkit::Real r = coordinates->distance(a, b);
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
+    chemkit::Real e = 1.0; // dielectric constant
+    chemkit::Real d = 0.05; // electrostatic buffering constant
+
+    chemkit::Real de_dr = 332.0716 * qa * qb * oneFourScaling * (-1.0 / (e * pow(r + d, 2)));
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real MmffElectrostaticCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                              const size_t *atoms,
+                                                              const chemkit::Real *parameters,
+                                                              chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real oneFourScaling = parameters[2];
+
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
     chemkit::Real e = 1.0; // dielectric constant
     chemkit::Real d = 0.05; // electrostatic buffering constant
 
     chemkit::Real de_dr = 332.0716 * qa * qb * oneFourScaling * (-1.0 / (e * pow(r + d, 2)));
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+
+    // equation 13
+    return ((332.0716 * qa * qb) / (e * (r + d))) * oneFourScaling;
+}
+
+chemkit::Real MmffElectrostaticCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+std::vector<chemkit::Vector3> MmffElectrostaticCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::Real MmffElectrostaticCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* MmffElectrostaticCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<MmffElectrostaticCalculation>(type(), atomCount(), parameterCount());
 }
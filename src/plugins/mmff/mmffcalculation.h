@@ -37,6 +37,7 @@
 #define MMFFCALCULATION_H
 
 #include <chemkit/forcefieldcalculation.h>
+#include <chemkit/forcefieldcalculationbatch.h>
 
 class MmffParameters;
 
@@ -57,6 +58,14 @@ public:
     bool setup(const MmffParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class MmffAngleBendCalculation : public MmffCalculation
@@ -67,6 +76,14 @@ public:
     bool setup(const MmffParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class MmffStrechBendCalculation : public MmffCalculation
@@ -77,6 +94,14 @@ public:
     bool setup(const MmffParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class MmffOutOfPlaneBendingCalculation : public MmffCalculation
@@ -87,6 +112,14 @@ public:
     bool setup(const MmffParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class MmffTorsionCalculation : public MmffCalculation
@@ -97,6 +130,14 @@ public:
     bool setup(const MmffParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class MmffVanDerWaalsCalculation : public MmffCalculation
@@ -107,6 +148,14 @@ public:
     bool setup(const MmffParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class MmffElectrostaticCalculation : public MmffCalculation
@@ -117,6 +166,14 @@ public:
     bool setup(const MmffParameters *parameters);
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 #endif // MMFFCALCULATION_H
@@ -81,6 +81,7 @@ MmffForceField::~MmffForceField()
 bool MmffForceField::setup()
 {
     if(!m_parameters || m_parameters->fileName() != parameterFile()){
+        delete m_parameters;
         m_parameters = new MmffParameters;
         bool ok = m_parameters->read(parameterFile());
         if(!ok){
@@ -136,19 +137,18 @@ bool MmffForceField::setup()
         addCalculation(new MmffTorsionCalculation(a, b, c, d));
     }
 
-    // van der waals and electrostatic calculations
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        size_t a = interaction[0];
-        size_t b = interaction[1];
-
-        addCalculation(new MmffVanDerWaalsCalculation(a, b));
-        addCalculation(new MmffElectrostaticCalculation(a, b));
+    // van der waals and electrostatic calculations (with a nonbonded
+    // cutoff these are created from the neighbor list instead)
+    if(nonbondedCutoff() == 0){
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            addNonbondedCalculations(interaction[0], interaction[1]);
+        }
     }
 
     bool ok = true;
 
     foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<MmffCalculation *>(calculation)->setup(m_parameters);
+        bool setup = setupCalculation(calculation);
 
         if(!setup){
             ok = false;
@@ -160,6 +160,17 @@ bool MmffForceField::setup()
     return ok;
 }
 
+void MmffForceField::addNonbondedCalculations(size_t a, size_t b)
+{
+    addCalculation(new MmffVanDerWaalsCalculation(a, b));
+    addCalculation(new MmffElectrostaticCalculation(a, b));
+}
+
+bool MmffForceField::setupCalculation(chemkit::ForceFieldCalculation *calculation)
+{
+    return static_cast<MmffCalculation *>(calculation)->setup(m_parameters);
+}
+
 const MmffParameters* MmffForceField::parameters() const
 {
     return m_parameters;
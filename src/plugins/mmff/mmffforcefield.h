@@ -54,6 +54,10 @@ public:
     virtual bool setup();
     const MmffParameters* parameters() const;
 
+protected:
+    void addNonbondedCalculations(size_t a, size_t b) CHEMKIT_OVERRIDE;
+    bool setupCalculation(chemkit::ForceFieldCalculation *calculation) CHEMKIT_OVERRIDE;
+
 private:
     MmffParameters *m_parameters;
 };
@@ -36,7 +36,10 @@
 #include "mmffparameters.h"
 
 #include <fstream>
+#include <algorithm>
 
+#include <boost/cstdint.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -157,6 +160,7 @@ const struct MmffAtomParameters AtomParameters[] = {
 };
 
 // --- Equivalent Types ---------------------------------------------------- //
+// row (type - 1) contains the equivalent types for type
 const int EquivalentTypes[][5] = {
     {1, 1, 1, 1, 0},
     {2, 2, 2, 1, 0},
@@ -240,6 +244,10 @@ const int EquivalentTypes[][5] = {
     {80, 80, 2, 1, 0},
     {81, 81, 10, 8, 0},
     {82, 82, 9, 8, 0},
+    {0, 0, 0, 0, 0},
+    {0, 0, 0, 0, 0},
+    {0, 0, 0, 0, 0},
+    {0, 0, 0, 0, 0},
     {87, 87, 87, 87, 87},
     {88, 88, 88, 88, 88},
     {89, 89, 89, 89, 89},
@@ -257,6 +265,217 @@ const int EquivalentTypes[][5] = {
 
 int EquivalentTypesCount = sizeof(EquivalentTypes) / sizeof(*EquivalentTypes);
 
+// --- Compiled Parameters ------------------------------------------------- //
+// identifies compiled parameters files, the last character is the
+// version of the file format
+const char CompiledFileMagic[8] = { 'C', 'K', 'M', 'M', 'F', 'F', 'P', '1' };
+
+// written to the header to detect files from platforms with a
+// different byte order
+const boost::uint32_t CompiledFileByteOrder = 0x01020304;
+
+// The compiled parameters file consists of a header followed by the
+// offsets and entries for each parameters table and then the van der
+// waals and partial charge parameters for each atom type. Each array
+// is preceded by its length as a 64-bit value. The size and
+// modification time of the parameters file it was compiled from are
+// stored in the header to detect when it is out of date.
+struct CompiledFileHeader
+{
+    char magic[8];
+    boost::uint32_t byteOrder;
+    boost::uint32_t realSize;
+    boost::uint64_t sourceSize;
+    boost::int64_t sourceTime;
+};
+
+// the maximum length of an array in a compiled parameters file
+const boost::uint64_t MaxCompiledArraySize = 1 << 24;
+
+template<typename T>
+void writeArray(std::ostream &output, const std::vector<T> &values)
+{
+    boost::uint64_t size = values.size();
+    output.write(reinterpret_cast<const char *>(&size), sizeof(size));
+
+    if(size){
+        output.write(reinterpret_cast<const char *>(&values[0]), size * sizeof(T));
+    }
+}
+
+template<typename T>
+bool readArray(std::istream &input, std::vector<T> &values)
+{
+    boost::uint64_t size = 0;
+    input.read(reinterpret_cast<char *>(&size), sizeof(size));
+    if(!input || size > MaxCompiledArraySize){
+        return false;
+    }
+
+    values.resize(static_cast<size_t>(size));
+
+    if(size){
+        input.read(reinterpret_cast<char *>(&values[0]), size * sizeof(T));
+    }
+
+    return static_cast<bool>(input);
+}
+
+template<typename Parameters>
+void writeTable(std::ostream &output, const MmffParametersTable<Parameters> &table)
+{
+    writeArray(output, table.offsets);
+    writeArray(output, table.entries);
+}
+
+template<typename Parameters>
+bool readTable(std::istream &input, MmffParametersTable<Parameters> &table, size_t rowCount)
+{
+    if(!readArray(input, table.offsets) || !readArray(input, table.entries)){
+        return false;
+    }
+
+    if(table.offsets.size() != rowCount + 1 || table.offsets[0] != 0){
+        return false;
+    }
+
+    for(size_t i = 0; i < rowCount; i++){
+        if(table.offsets[i] > table.offsets[i + 1]){
+            return false;
+        }
+    }
+
+    return table.offsets.back() == table.entries.size();
+}
+
+// Returns the size and modification time of fileName in header.
+bool readSourceStamp(const std::string &fileName, CompiledFileHeader &header)
+{
+    boost::system::error_code error;
+
+    header.sourceSize = boost::filesystem::file_size(fileName, error);
+    if(error){
+        return false;
+    }
+
+    header.sourceTime = boost::filesystem::last_write_time(fileName, error);
+    if(error){
+        return false;
+    }
+
+    return true;
+}
+
+// Reads compiled parameters into data. If source is not null the
+// file must have been compiled from a parameters file with the same
+// size and modification time.
+bool readCompiled(std::istream &input, MmffParametersData *data, const CompiledFileHeader *source)
+{
+    CompiledFileHeader header;
+    input.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if(!input ||
+       !std::equal(CompiledFileMagic, CompiledFileMagic + sizeof(CompiledFileMagic), header.magic) ||
+       header.byteOrder != CompiledFileByteOrder ||
+       header.realSize != sizeof(chemkit::Real)){
+        return false;
+    }
+
+    if(source && (header.sourceSize != source->sourceSize ||
+                  header.sourceTime != source->sourceTime)){
+        return false;
+    }
+
+    const size_t typeRowCount = MmffParametersData::TypeCount * MmffParametersData::TypeCount;
+    const size_t periodicTableRowCount = MmffParametersData::PeriodicTableRowCount * MmffParametersData::PeriodicTableRowCount;
+
+    return readTable(input, data->bondStrechParameters, typeRowCount) &&
+           readTable(input, data->angleBendParameters, typeRowCount) &&
+           readTable(input, data->strechBendParameters, typeRowCount) &&
+           readTable(input, data->defaultStrechBendParameters, periodicTableRowCount) &&
+           readTable(input, data->outOfPlaneBendingParameters, typeRowCount) &&
+           readTable(input, data->torsionParameters, typeRowCount) &&
+           readTable(input, data->chargeParameters, typeRowCount) &&
+           readArray(input, data->vanDerWaalsParameters) &&
+           data->vanDerWaalsParameters.size() == MmffParametersData::TypeCount &&
+           readArray(input, data->partialChargeParameters) &&
+           data->partialChargeParameters.size() == MmffParametersData::TypeCount;
+}
+
+bool writeCompiled(std::ostream &output, const MmffParametersData *data, const CompiledFileHeader &source)
+{
+    CompiledFileHeader header;
+    std::copy(CompiledFileMagic, CompiledFileMagic + sizeof(CompiledFileMagic), header.magic);
+    header.byteOrder = CompiledFileByteOrder;
+    header.realSize = sizeof(chemkit::Real);
+    header.sourceSize = source.sourceSize;
+    header.sourceTime = source.sourceTime;
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    writeTable(output, data->bondStrechParameters);
+    writeTable(output, data->angleBendParameters);
+    writeTable(output, data->strechBendParameters);
+    writeTable(output, data->defaultStrechBendParameters);
+    writeTable(output, data->outOfPlaneBendingParameters);
+    writeTable(output, data->torsionParameters);
+    writeTable(output, data->chargeParameters);
+    writeArray(output, data->vanDerWaalsParameters);
+    writeArray(output, data->partialChargeParameters);
+
+    return static_cast<bool>(output);
+}
+
+// Writes the compiled parameters to fileName. The parameters are
+// written to a temporary file which is then renamed so that other
+// processes never read a partially written file.
+bool writeCompiled(const std::string &fileName, const MmffParametersData *data, const CompiledFileHeader &source)
+{
+    boost::system::error_code error;
+    boost::filesystem::path temporaryPath = boost::filesystem::unique_path(fileName + ".%%%%-%%%%-%%%%", error);
+    if(error){
+        return false;
+    }
+
+    std::ofstream file(temporaryPath.string().c_str(), std::ios::out | std::ios::binary);
+    if(!file.is_open()){
+        return false;
+    }
+
+    bool ok = writeCompiled(file, data, source);
+    file.close();
+
+    if(ok){
+        boost::filesystem::rename(temporaryPath, fileName, error);
+        ok = !error;
+    }
+
+    if(!ok){
+        boost::filesystem::remove(temporaryPath, error);
+    }
+
+    return ok;
+}
+
+// --- Table Indices ------------------------------------------------------- //
+bool isValidType(int type)
+{
+    return type >= 0 && type <= MmffParameters::MaxAtomType;
+}
+
+// Returns the table row for the pair of atom types.
+size_t typeRow(int typeA, int typeB)
+{
+    return static_cast<size_t>(typeA) * MmffParametersData::TypeCount + typeB;
+}
+
+// Returns the key for the remaining atom and interaction types in a
+// table row. Each must be less than 256.
+boost::uint32_t typeKey(int a, int b = 0, int c = 0)
+{
+    return (static_cast<boost::uint32_t>(a) << 16) |
+           (static_cast<boost::uint32_t>(b) << 8) |
+           static_cast<boost::uint32_t>(c);
+}
+
 } // end anonymous namespace
 
 // --- Construction and Destruction ---------------------------------------- //
@@ -275,6 +494,14 @@ std::string MmffParameters::fileName() const
     return m_fileName;
 }
 
+/// Reads the parameters from \p fileName. Returns \c false if an
+/// error occurs.
+///
+/// The parameters are compiled into tables indexed by atom type. The
+/// compiled tables are written next to the parameters file (with a
+/// ".bin" suffix) and read from there by later processes instead of
+/// parsing the parameters file again. \p fileName may also be a file
+/// written with write().
 bool MmffParameters::read(const std::string &fileName)
 {
     // try to load cached parameters
@@ -283,178 +510,56 @@ bool MmffParameters::read(const std::string &fileName)
         d = mmffPlugin->parameters(fileName);
 
         if(d){
+            m_fileName = fileName;
             return true;
         }
     }
 
-    // create new parameters data if we don't have a cached one
-    if(!d){
-        d = boost::make_shared<MmffParametersData>();
-    }
+    d = boost::make_shared<MmffParametersData>();
 
-    std::ifstream file(fileName.c_str());
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
     if(!file.is_open()){
         setErrorString("Failed to open parameters file.");
         return false;
     }
 
-    m_fileName = fileName;
-
-    // section in file
-    enum Section {
-        BondStrech,
-        EmpiricalBondStrech,
-        AngleBend,
-        StrechBend,
-        DefaultStrechBend,
-        OutOfPlaneBending,
-        Torsion,
-        VanDerWaals,
-        Charge,
-        PartialCharge,
-        End
-    };
-
-    // first section is bond strech parameters
-    int section = BondStrech;
-
-    while(!file.eof()){
-        std::string line;
-        std::getline(file, line);
-        boost::trim_left(line);
-
-        // lines that start with '$' indicate a new section
-        if(boost::starts_with(line, "$")){
-            section++;
+    char magic[sizeof(CompiledFileMagic)];
+    file.read(magic, sizeof(magic));
+    if(file.gcount() == sizeof(magic) &&
+       std::equal(magic, magic + sizeof(magic), CompiledFileMagic)){
+        file.seekg(0);
 
-            if(section == End){
-                break;
-            }
-        }
-
-        // lines starting with '#' are comments
-        else if(boost::starts_with(line, "#")){
-            continue;
+        if(!readCompiled(file, d.get(), 0)){
+            setErrorString("Invalid compiled parameters file.");
+            return false;
         }
+    }
+    else{
+        file.clear();
+        file.seekg(0);
 
-        // read data from line
-        else{
-            std::vector<std::string> data;
-            boost::split(data, line, boost::is_any_of(" "), boost::token_compress_on);
-            if(data.empty() || data.size() < 2){
-                continue;
-            }
-
-            if(section == BondStrech){
-                int bondType = boost::lexical_cast<int>(data[0]);
-                int typeA = boost::lexical_cast<int>(data[1]);
-                int typeB = boost::lexical_cast<int>(data[2]);
-
-                int index = calculateBondStrechIndex(bondType, typeA, typeB);
-
-                MmffBondStrechParameters parameters;
-                parameters.kb = boost::lexical_cast<chemkit::Real>(data[3]);
-                parameters.r0 = boost::lexical_cast<chemkit::Real>(data[4]);
-                d->bondStrechParameters[index] = parameters;
-            }
-            else if(section == EmpiricalBondStrech){
-            }
-            else if(section == AngleBend){
-                int angleType = boost::lexical_cast<int>(data[0]);
-                int typeA = boost::lexical_cast<int>(data[1]);
-                int typeB = boost::lexical_cast<int>(data[2]);
-                int typeC = boost::lexical_cast<int>(data[3]);
-
-                int index = calculateAngleBendIndex(angleType, typeA, typeB, typeC);
-
-                MmffAngleBendParameters parameters;
-                parameters.ka = boost::lexical_cast<chemkit::Real>(data[4]);
-                parameters.theta0 = boost::lexical_cast<chemkit::Real>(data[5]);
-                d->angleBendParameters[index] = parameters;
-            }
-            else if(section == StrechBend){
-                int strechBendType = boost::lexical_cast<int>(data[0]);
-                int typeA = boost::lexical_cast<int>(data[1]);
-                int typeB = boost::lexical_cast<int>(data[2]);
-                int typeC = boost::lexical_cast<int>(data[3]);
-
-                int index = calculateStrechBendIndex(strechBendType, typeA, typeB, typeC);
-
-                MmffStrechBendParameters parameters;
-                parameters.kba_ijk = boost::lexical_cast<chemkit::Real>(data[4]);
-                parameters.kba_kji = boost::lexical_cast<chemkit::Real>(data[5]);
-                d->strechBendParameters[index] = parameters;
-            }
-            else if(section == DefaultStrechBend){
-                MmffDefaultStrechBendParameters parameters;
-                parameters.rowA = boost::lexical_cast<int>(data[0]);
-                parameters.rowB = boost::lexical_cast<int>(data[1]);
-                parameters.rowC = boost::lexical_cast<int>(data[2]);
-                parameters.parameters.kba_ijk = boost::lexical_cast<chemkit::Real>(data[3]);
-                parameters.parameters.kba_kji = boost::lexical_cast<chemkit::Real>(data[4]);
-                d->defaultStrechBendParameters.push_back(parameters);
-            }
-            else if(section == OutOfPlaneBending){
-                int typeA = boost::lexical_cast<int>(data[0]);
-                int typeB = boost::lexical_cast<int>(data[1]);
-                int typeC = boost::lexical_cast<int>(data[2]);
-                int typeD = boost::lexical_cast<int>(data[3]);
+        CompiledFileHeader source;
+        bool haveSource = readSourceStamp(fileName, source);
+        std::string compiledFileName = fileName + ".bin";
 
-                int index = calculateOutOfPlaneBendingIndex(typeA, typeB, typeC, typeD);
+        std::ifstream compiledFile(compiledFileName.c_str(), std::ios::in | std::ios::binary);
+        if(!haveSource || !compiledFile.is_open() || !readCompiled(compiledFile, d.get(), &source)){
+            d = boost::make_shared<MmffParametersData>();
 
-                MmffOutOfPlaneBendingParameters parameters;
-                parameters.koop = boost::lexical_cast<chemkit::Real>(data[4]);
-                d->outOfPlaneBendingParameters[index] = parameters;
+            if(!readText(file)){
+                return false;
             }
-            else if(section == Torsion){
-                int torsionType = boost::lexical_cast<int>(data[0]);
-                int typeA = boost::lexical_cast<int>(data[1]);
-                int typeB = boost::lexical_cast<int>(data[2]);
-                int typeC = boost::lexical_cast<int>(data[3]);
-                int typeD = boost::lexical_cast<int>(data[4]);
-
-                int index = calculateTorsionIndex(torsionType, typeA, typeB, typeC, typeD);
-
-                MmffTorsionParameters parameters;
-                parameters.V1 = boost::lexical_cast<chemkit::Real>(data[5]);
-                parameters.V2 = boost::lexical_cast<chemkit::Real>(data[6]);
-                parameters.V3 = boost::lexical_cast<chemkit::Real>(data[7]);
-                d->torsionParameters[index] = parameters;
-            }
-            else if(section == VanDerWaals){
-                int type = boost::lexical_cast<int>(data[0]);
-                if(type > MaxAtomType)
-                    continue;
-
-                MmffVanDerWaalsParameters parameters;
-                parameters.alpha = boost::lexical_cast<chemkit::Real>(data[1]);
-                parameters.N = boost::lexical_cast<chemkit::Real>(data[2]);
-                parameters.A = boost::lexical_cast<chemkit::Real>(data[3]);
-                parameters.G = boost::lexical_cast<chemkit::Real>(data[4]);
-                parameters.DA = data[5][0];
-                d->vanDerWaalsParameters[type] = parameters;
-            }
-            else if(section == Charge){
-                MmffChargeParameters parameters;
-                parameters.bondType = boost::lexical_cast<int>(data[0]);
-                parameters.typeA = boost::lexical_cast<int>(data[1]);
-                parameters.typeB = boost::lexical_cast<int>(data[2]);
-                parameters.bci = boost::lexical_cast<chemkit::Real>(data[3]);
-                d->chargeParameters.push_back(parameters);
-            }
-            else if(section == PartialCharge){
-                int type = boost::lexical_cast<int>(data[1]);
-                if(type > MaxAtomType)
-                    continue;
 
-                MmffPartialChargeParameters parameters;
-                parameters.pbci = boost::lexical_cast<chemkit::Real>(data[2]);
-                parameters.fcadj = boost::lexical_cast<chemkit::Real>(data[3]);
-                d->partialChargeParameters[type] = parameters;
+            // the parameters are still usable if they can't be written
+            // (e.g. if the data directory is read-only)
+            if(haveSource){
+                writeCompiled(compiledFileName, d.get(), source);
             }
         }
     }
 
+    m_fileName = fileName;
+
     // store parameters in the cache
     if(mmffPlugin){
         mmffPlugin->storeParameters(fileName, d);
@@ -463,6 +568,22 @@ bool MmffParameters::read(const std::string &fileName)
     return true;
 }
 
+/// Writes the compiled parameters to \p fileName. Returns \c false
+/// if an error occurs.
+bool MmffParameters::write(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+    if(!file.is_open()){
+        return false;
+    }
+
+    CompiledFileHeader source;
+    source.sourceSize = 0;
+    source.sourceTime = 0;
+
+    return writeCompiled(file, d.get(), source);
+}
+
 const MmffVanDerWaalsParameters* MmffParameters::vanDerWaalsParameters(int type) const
 {
     return &d->vanDerWaalsParameters[type];
@@ -478,17 +599,13 @@ const MmffAtomParameters* MmffParameters::atomParameters(int type) const
 
 const MmffChargeParameters* MmffParameters::chargeParameters(const chemkit::Atom *a, int typeA, const chemkit::Atom *b, int typeB) const
 {
-    int bondType = calculateBondType(a->bondTo(b), typeA, typeB);
-
-    foreach(const MmffChargeParameters &parameters, d->chargeParameters){
-        if(parameters.bondType == bondType &&
-           parameters.typeA == typeA &&
-           parameters.typeB == typeB){
-            return &parameters;
-        }
+    if(!isValidType(typeA) || !isValidType(typeB)){
+        return 0;
     }
 
-    return 0;
+    int bondType = calculateBondType(a->bondTo(b), typeA, typeB);
+
+    return d->chargeParameters.find(typeRow(typeA, typeB), typeKey(bondType));
 }
 
 const MmffPartialChargeParameters* MmffParameters::partialChargeParameters(int type) const
@@ -501,14 +618,11 @@ const MmffBondStrechParameters* MmffParameters::bondStrechParameters(int bondTyp
     if(typeA > typeB)
         std::swap(typeA, typeB);
 
-    int index = calculateBondStrechIndex(bondType, typeA, typeB);
-
-    std::map<int, MmffBondStrechParameters>::const_iterator iter = d->bondStrechParameters.find(index);
-    if(iter == d->bondStrechParameters.end()){
+    if(!isValidType(typeA) || !isValidType(typeB)){
         return 0;
     }
 
-    return &iter->second;
+    return d->bondStrechParameters.find(typeRow(typeA, typeB), typeKey(bondType));
 }
 
 const MmffBondStrechParameters* MmffParameters::empiricalBondStrechParameters(int atomicNumberA, int atomicNumberB) const
@@ -524,26 +638,20 @@ const MmffAngleBendParameters* MmffParameters::angleBendParameters(int angleType
     if(typeA > typeC)
         std::swap(typeA, typeC);
 
-    int index = calculateAngleBendIndex(angleType, typeA, typeB, typeC);
-
-    std::map<int, MmffAngleBendParameters>::const_iterator iter = d->angleBendParameters.find(index);
-    if(iter == d->angleBendParameters.end()){
+    if(!isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC)){
         return 0;
     }
 
-    return &iter->second;
+    return d->angleBendParameters.find(typeRow(typeB, typeA), typeKey(typeC, angleType));
 }
 
 const MmffStrechBendParameters* MmffParameters::strechBendParameters(int strechBendType, int typeA, int typeB, int typeC) const
 {
-    int index = calculateStrechBendIndex(strechBendType, typeA, typeB, typeC);
-
-    std::map<int, MmffStrechBendParameters>::const_iterator iter = d->strechBendParameters.find(index);
-    if(iter == d->strechBendParameters.end()){
+    if(!isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC)){
         return 0;
     }
 
-    return &iter->second;
+    return d->strechBendParameters.find(typeRow(typeB, typeA), typeKey(typeC, strechBendType));
 }
 
 const MmffStrechBendParameters* MmffParameters::defaultStrechBendParameters(int typeA, int typeB, int typeC) const
@@ -552,15 +660,14 @@ const MmffStrechBendParameters* MmffParameters::defaultStrechBendParameters(int
     int rowB = MmffAtomTyper::typeToElement(typeB).period() - 1;
     int rowC = MmffAtomTyper::typeToElement(typeC).period() - 1;
 
-    foreach(const MmffDefaultStrechBendParameters &parameters, d->defaultStrechBendParameters){
-        if(parameters.rowA == rowA &&
-           parameters.rowB == rowB &&
-           parameters.rowC == rowC){
-            return &parameters.parameters;
-        }
+    const int rowCount = MmffParametersData::PeriodicTableRowCount;
+    if(rowA < 0 || rowA >= rowCount ||
+       rowB < 0 || rowB >= rowCount ||
+       rowC < 0 || rowC >= rowCount){
+        return 0;
     }
 
-    return 0;
+    return d->defaultStrechBendParameters.find(rowB * rowCount + rowA, typeKey(rowC));
 }
 
 const MmffOutOfPlaneBendingParameters* MmffParameters::outOfPlaneBendingParameters(int typeA, int typeB, int typeC, int typeD) const
@@ -572,36 +679,31 @@ const MmffOutOfPlaneBendingParameters* MmffParameters::outOfPlaneBendingParamete
     if(typeC > typeD)
         std::swap(typeC, typeD);
 
-    int index = calculateOutOfPlaneBendingIndex(typeA, typeB, typeC, typeD);
+    if(!isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC) || !isValidType(typeD)){
+        return 0;
+    }
 
-    std::map<int, MmffOutOfPlaneBendingParameters>::const_iterator iter;
-    iter = d->outOfPlaneBendingParameters.find(index);
-    if(iter != d->outOfPlaneBendingParameters.end()){
-        return &iter->second;
+    const MmffParametersTable<MmffOutOfPlaneBendingParameters> &table = d->outOfPlaneBendingParameters;
+
+    const MmffOutOfPlaneBendingParameters *parameters = table.find(typeRow(typeB, typeA), typeKey(typeC, typeD));
+    if(parameters){
+        return parameters;
     }
 
     // step down 3-2-3-3
-    index = calculateOutOfPlaneBendingIndex(equivalentType(typeA, 3), typeB, equivalentType(typeC, 3), equivalentType(typeD, 3));
-    iter = d->outOfPlaneBendingParameters.find(index);
-    if(iter != d->outOfPlaneBendingParameters.end()){
-        return &iter->second;
+    parameters = table.find(typeRow(typeB, equivalentType(typeA, 3)), typeKey(equivalentType(typeC, 3), equivalentType(typeD, 3)));
+    if(parameters){
+        return parameters;
     }
 
     // step down 4-2-4-4
-    index = calculateOutOfPlaneBendingIndex(equivalentType(typeA, 4), typeB, equivalentType(typeC, 4), equivalentType(typeD, 4));
-    iter = d->outOfPlaneBendingParameters.find(index);
-    if(iter != d->outOfPlaneBendingParameters.end()){
-        return &iter->second;
+    parameters = table.find(typeRow(typeB, equivalentType(typeA, 4)), typeKey(equivalentType(typeC, 4), equivalentType(typeD, 4)));
+    if(parameters){
+        return parameters;
     }
 
     // step down 5-2-5-5
-    index = calculateOutOfPlaneBendingIndex(equivalentType(typeA, 5), typeB, equivalentType(typeC, 5), equivalentType(typeD, 5));
-    iter = d->outOfPlaneBendingParameters.find(index);
-    if(iter != d->outOfPlaneBendingParameters.end()){
-        return &iter->second;
-    }
-
-    return 0;
+    return table.find(typeRow(typeB, equivalentType(typeA, 5)), typeKey(equivalentType(typeC, 5), equivalentType(typeD, 5)));
 }
 
 const MmffTorsionParameters* MmffParameters::torsionParameters(int torsionType, int typeA, int typeB, int typeC, int typeD) const
@@ -614,56 +716,50 @@ const MmffTorsionParameters* MmffParameters::torsionParameters(int torsionType,
         std::swap(typeA, typeD);
     }
 
-    int index = calculateTorsionIndex(torsionType, typeA, typeB, typeC, typeD);
+    if(!isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC) || !isValidType(typeD)){
+        return 0;
+    }
+
+    const MmffParametersTable<MmffTorsionParameters> &table = d->torsionParameters;
+    size_t row = typeRow(typeB, typeC);
 
-    std::map<int, MmffTorsionParameters>::const_iterator iter;
-    iter = d->torsionParameters.find(index);
-    if(iter != d->torsionParameters.end()){
-        return &iter->second;
+    const MmffTorsionParameters *parameters = table.find(row, typeKey(typeA, typeD, torsionType));
+    if(parameters){
+        return parameters;
     }
 
     // step down 3-2-2-5
-    index = calculateTorsionIndex(torsionType, equivalentType(typeA, 3), typeB, typeC, equivalentType(typeD, 5));
-    iter = d->torsionParameters.find(index);
-    if(iter != d->torsionParameters.end()){
-        return &iter->second;
+    parameters = table.find(row, typeKey(equivalentType(typeA, 3), equivalentType(typeD, 5), torsionType));
+    if(parameters){
+        return parameters;
     }
 
     // step down 5-2-2-3
-    index = calculateTorsionIndex(torsionType, equivalentType(typeA, 5), typeB, typeC, equivalentType(typeD, 3));
-    iter = d->torsionParameters.find(index);
-    if(iter != d->torsionParameters.end()){
-        return &iter->second;
+    parameters = table.find(row, typeKey(equivalentType(typeA, 5), equivalentType(typeD, 3), torsionType));
+    if(parameters){
+        return parameters;
     }
 
     // step down 5-2-2-5
-    index = calculateTorsionIndex(torsionType, equivalentType(typeA, 5), typeB, typeC, equivalentType(typeD, 5));
-    iter = d->torsionParameters.find(index);
-    if(iter != d->torsionParameters.end()){
-        return &iter->second;
+    parameters = table.find(row, typeKey(equivalentType(typeA, 5), equivalentType(typeD, 5), torsionType));
+    if(parameters){
+        return parameters;
     }
 
     // step down 5-2-2-5 (with no torsion type)
-    index = calculateTorsionIndex(0, equivalentType(typeA, 5), typeB, typeC, equivalentType(typeD, 5));
-    iter = d->torsionParameters.find(index);
-    if(iter != d->torsionParameters.end()){
-        return &iter->second;
-    }
-
-    return 0;
+    return table.find(row, typeKey(equivalentType(typeA, 5), equivalentType(typeD, 5), 0));
 }
 
 // --- Static Methods ------------------------------------------------------ //
 int MmffParameters::calculateBondType(const chemkit::Bond *bond, int typeA, int typeB)
 {
-    MmffParameters parameters;
-    const MmffAtomParameters *parametersA = parameters.atomParameters(typeA);
-    const MmffAtomParameters *parametersB = parameters.atomParameters(typeB);
-
-    if(!parametersA || !parametersB){
+    if(typeA < 1 || typeA > MaxAtomType || typeB < 1 || typeB > MaxAtomType){
         return 0;
     }
 
+    const MmffAtomParameters *parametersA = &AtomParameters[typeA-1];
+    const MmffAtomParameters *parametersB = &AtomParameters[typeB-1];
+
     if(bond->order() == chemkit::Bond::Single && !MmffAromaticityModel().isAromatic(bond)){
         if(parametersA->sbmb && parametersB->sbmb){
             return 1;
@@ -735,44 +831,195 @@ int MmffParameters::calculateStrechBendType(int bondTypeAB, int bondTypeBC, int
 }
 
 // --- Internal Methods ---------------------------------------------------- //
-int MmffParameters::equivalentType(int type, int level) const
+// Reads and compiles the parameters from the text parameters file.
+bool MmffParameters::readText(std::istream &input)
 {
-    if(level < 3){
-        return type;
-    }
+    // section in file
+    enum Section {
+        BondStrech,
+        EmpiricalBondStrech,
+        AngleBend,
+        StrechBend,
+        DefaultStrechBend,
+        OutOfPlaneBending,
+        Torsion,
+        VanDerWaals,
+        Charge,
+        PartialCharge,
+        End
+    };
+
+    // first section is bond strech parameters
+    int section = BondStrech;
+
+    while(!input.eof()){
+        std::string line;
+        std::getline(input, line);
+        boost::trim_left(line);
 
-    for(int i = 0; i < EquivalentTypesCount; i++){
-        if(EquivalentTypes[i][0] == type){
-            return EquivalentTypes[i][level-1];
+        // lines that start with '$' indicate a new section
+        if(boost::starts_with(line, "$")){
+            section++;
+
+            if(section == End){
+                break;
+            }
         }
-    }
 
-    return 0;
-}
+        // lines starting with '#' are comments
+        else if(boost::starts_with(line, "#")){
+            continue;
+        }
 
-int MmffParameters::calculateBondStrechIndex(int bondType, int typeA, int typeB) const
-{
-    return 2 * (typeA * 136 + typeB) + bondType;
-}
+        // read data from line
+        else{
+            std::vector<std::string> data;
+            boost::split(data, line, boost::is_any_of(" "), boost::token_compress_on);
+            if(data.empty() || data.size() < 2){
+                continue;
+            }
 
-int MmffParameters::calculateAngleBendIndex(int angleType, int typeA, int typeB, int typeC) const
-{
-    return 9 * (typeB * (136*136) + typeA * 136 + typeC) + angleType;
-}
+            if(section == BondStrech){
+                int bondType = boost::lexical_cast<int>(data[0]);
+                int typeA = boost::lexical_cast<int>(data[1]);
+                int typeB = boost::lexical_cast<int>(data[2]);
 
-int MmffParameters::calculateStrechBendIndex(int strechBendType, int typeA, int typeB, int typeC) const
-{
-    return 12 * (typeB * (136*136) + typeA * 136 + typeC) + strechBendType;
-}
+                if(!isValidType(bondType) || !isValidType(typeA) || !isValidType(typeB))
+                    continue;
 
-int MmffParameters::calculateOutOfPlaneBendingIndex(int typeA, int typeB, int typeC, int typeD) const
-{
-    return typeB * (136*136*136) + typeA * (136*136) + typeC * 136 + typeD;
+                MmffBondStrechParameters parameters;
+                parameters.kb = boost::lexical_cast<chemkit::Real>(data[3]);
+                parameters.r0 = boost::lexical_cast<chemkit::Real>(data[4]);
+                d->bondStrechParameters.insert(typeRow(typeA, typeB), typeKey(bondType), parameters);
+            }
+            else if(section == EmpiricalBondStrech){
+            }
+            else if(section == AngleBend){
+                int angleType = boost::lexical_cast<int>(data[0]);
+                int typeA = boost::lexical_cast<int>(data[1]);
+                int typeB = boost::lexical_cast<int>(data[2]);
+                int typeC = boost::lexical_cast<int>(data[3]);
+
+                if(!isValidType(angleType) || !isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC))
+                    continue;
+
+                MmffAngleBendParameters parameters;
+                parameters.ka = boost::lexical_cast<chemkit::Real>(data[4]);
+                parameters.theta0 = boost::lexical_cast<chemkit::Real>(data[5]);
+                d->angleBendParameters.insert(typeRow(typeB, typeA), typeKey(typeC, angleType), parameters);
+            }
+            else if(section == StrechBend){
+                int strechBendType = boost::lexical_cast<int>(data[0]);
+                int typeA = boost::lexical_cast<int>(data[1]);
+                int typeB = boost::lexical_cast<int>(data[2]);
+                int typeC = boost::lexical_cast<int>(data[3]);
+
+                if(!isValidType(strechBendType) || !isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC))
+                    continue;
+
+                MmffStrechBendParameters parameters;
+                parameters.kba_ijk = boost::lexical_cast<chemkit::Real>(data[4]);
+                parameters.kba_kji = boost::lexical_cast<chemkit::Real>(data[5]);
+                d->strechBendParameters.insert(typeRow(typeB, typeA), typeKey(typeC, strechBendType), parameters);
+            }
+            else if(section == DefaultStrechBend){
+                int rowA = boost::lexical_cast<int>(data[0]);
+                int rowB = boost::lexical_cast<int>(data[1]);
+                int rowC = boost::lexical_cast<int>(data[2]);
+
+                const int rowCount = MmffParametersData::PeriodicTableRowCount;
+                if(rowA < 0 || rowA >= rowCount ||
+                   rowB < 0 || rowB >= rowCount ||
+                   rowC < 0 || rowC >= rowCount)
+                    continue;
+
+                MmffStrechBendParameters parameters;
+                parameters.kba_ijk = boost::lexical_cast<chemkit::Real>(data[3]);
+                parameters.kba_kji = boost::lexical_cast<chemkit::Real>(data[4]);
+                d->defaultStrechBendParameters.insert(rowB * rowCount + rowA, typeKey(rowC), parameters);
+            }
+            else if(section == OutOfPlaneBending){
+                int typeA = boost::lexical_cast<int>(data[0]);
+                int typeB = boost::lexical_cast<int>(data[1]);
+                int typeC = boost::lexical_cast<int>(data[2]);
+                int typeD = boost::lexical_cast<int>(data[3]);
+
+                if(!isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC) || !isValidType(typeD))
+                    continue;
+
+                MmffOutOfPlaneBendingParameters parameters;
+                parameters.koop = boost::lexical_cast<chemkit::Real>(data[4]);
+                d->outOfPlaneBendingParameters.insert(typeRow(typeB, typeA), typeKey(typeC, typeD), parameters);
+            }
+            else if(section == Torsion){
+                int torsionType = boost::lexical_cast<int>(data[0]);
+                int typeA = boost::lexical_cast<int>(data[1]);
+                int typeB = boost::lexical_cast<int>(data[2]);
+                int typeC = boost::lexical_cast<int>(data[3]);
+                int typeD = boost::lexical_cast<int>(data[4]);
+
+                if(!isValidType(torsionType) || !isValidType(typeA) || !isValidType(typeB) || !isValidType(typeC) || !isValidType(typeD))
+                    continue;
+
+                MmffTorsionParameters parameters;
+                parameters.V1 = boost::lexical_cast<chemkit::Real>(data[5]);
+                parameters.V2 = boost::lexical_cast<chemkit::Real>(data[6]);
+                parameters.V3 = boost::lexical_cast<chemkit::Real>(data[7]);
+                d->torsionParameters.insert(typeRow(typeB, typeC), typeKey(typeA, typeD, torsionType), parameters);
+            }
+            else if(section == VanDerWaals){
+                int type = boost::lexical_cast<int>(data[0]);
+                if(type > MaxAtomType)
+                    continue;
+
+                MmffVanDerWaalsParameters parameters;
+                parameters.alpha = boost::lexical_cast<chemkit::Real>(data[1]);
+                parameters.N = boost::lexical_cast<chemkit::Real>(data[2]);
+                parameters.A = boost::lexical_cast<chemkit::Real>(data[3]);
+                parameters.G = boost::lexical_cast<chemkit::Real>(data[4]);
+                parameters.DA = data[5][0];
+                d->vanDerWaalsParameters[type] = parameters;
+            }
+            else if(section == Charge){
+                MmffChargeParameters parameters;
+                parameters.bondType = boost::lexical_cast<int>(data[0]);
+                parameters.typeA = boost::lexical_cast<int>(data[1]);
+                parameters.typeB = boost::lexical_cast<int>(data[2]);
+                parameters.bci = boost::lexical_cast<chemkit::Real>(data[3]);
+                if(!isValidType(parameters.bondType) || !isValidType(parameters.typeA) || !isValidType(parameters.typeB))
+                    continue;
+
+                d->chargeParameters.insert(typeRow(parameters.typeA, parameters.typeB), typeKey(parameters.bondType), parameters);
+            }
+            else if(section == PartialCharge){
+                int type = boost::lexical_cast<int>(data[1]);
+                if(type > MaxAtomType)
+                    continue;
+
+                MmffPartialChargeParameters parameters;
+                parameters.pbci = boost::lexical_cast<chemkit::Real>(data[2]);
+                parameters.fcadj = boost::lexical_cast<chemkit::Real>(data[3]);
+                d->partialChargeParameters[type] = parameters;
+            }
+        }
+    }
+
+    d->compile();
+
+    return true;
 }
 
-int MmffParameters::calculateTorsionIndex(int torsionType, int typeA, int typeB, int typeC, int typeD) const
+int MmffParameters::equivalentType(int type, int level) const
 {
-    return 6 * (typeB * (136*136*136) + typeC * (136*136) + typeA * 136 + typeD) + torsionType;
+    if(level < 3){
+        return type;
+    }
+
+    if(type < 1 || type > EquivalentTypesCount){
+        return 0;
+    }
+
+    return EquivalentTypes[type-1][level-1];
 }
 
 // --- Error Handling ------------------------------------------------------ //
@@ -37,6 +37,7 @@
 #define MMFFPARAMETERS_H
 
 #include <string>
+#include <iosfwd>
 
 #include <boost/shared_ptr.hpp>
 
@@ -62,14 +63,6 @@ struct MmffStrechBendParameters
     chemkit::Real kba_kji;
 };
 
-struct MmffDefaultStrechBendParameters
-{
-    int rowA;
-    int rowB;
-    int rowC;
-    MmffStrechBendParameters parameters;
-};
-
 struct MmffOutOfPlaneBendingParameters
 {
     chemkit::Real koop;
@@ -130,6 +123,7 @@ public:
     // parameters
     std::string fileName() const;
     bool read(const std::string &fileName);
+    bool write(const std::string &fileName) const;
     const MmffVanDerWaalsParameters* vanDerWaalsParameters(int type) const;
     const MmffAtomParameters* atomParameters(int type) const;
     const MmffChargeParameters* chargeParameters(const chemkit::Atom *a, int typeA, const chemkit::Atom *b, int typeB) const;
@@ -150,12 +144,8 @@ public:
     static int calculateStrechBendType(int bondTypeAB, int bondTypeBC, int angleType);
 
 private:
+    bool readText(std::istream &input);
     int equivalentType(int type, int level) const;
-    int calculateBondStrechIndex(int bondType, int typeA, int typeB) const;
-    int calculateAngleBendIndex(int angleType, int typeA, int typeB, int typeC) const;
-    int calculateStrechBendIndex(int strechBendType, int typeA, int typeB, int typeC) const;
-    int calculateOutOfPlaneBendingIndex(int typeA, int typeB, int typeC, int typeD) const;
-    int calculateTorsionIndex(int torsionType, int typeA, int typeB, int typeC, int typeD) const;
     void setErrorString(const std::string &errorString);
 
 private:
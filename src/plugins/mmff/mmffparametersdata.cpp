@@ -43,3 +43,17 @@ MmffParametersData::MmffParametersData()
       partialChargeParameters(MmffParameters::MaxAtomType + 1)
 {
 }
+
+/// Compiles the parameters inserted into each table.
+void MmffParametersData::compile()
+{
+    bondStrechParameters.compile(TypeCount * TypeCount);
+    angleBendParameters.compile(TypeCount * TypeCount);
+    strechBendParameters.compile(TypeCount * TypeCount);
+    // the first default strech bend and charge parameters are used
+    defaultStrechBendParameters.compile(PeriodicTableRowCount * PeriodicTableRowCount,
+                                        MmffParametersTable<MmffStrechBendParameters>::KeepFirst);
+    outOfPlaneBendingParameters.compile(TypeCount * TypeCount);
+    torsionParameters.compile(TypeCount * TypeCount);
+    chargeParameters.compile(TypeCount * TypeCount, MmffParametersTable<MmffChargeParameters>::KeepFirst);
+}
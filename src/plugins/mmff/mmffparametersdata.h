@@ -36,25 +36,140 @@
 #ifndef MMFFPARAMETERSDATA_H
 #define MMFFPARAMETERSDATA_H
 
-#include <map>
 #include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
 
 #include "mmffparameters.h"
 
+// Parameters in a table are stored in rows which are addressed
+// directly by their atom (and interaction) types. Each row contains
+// the entries for the remaining types which are distinguished by a
+// key and searched linearly. Rows contain at most a handful of
+// entries so a lookup is a single index calculation followed by a
+// few integer comparisons.
+//
+// Entries are added with insert() while reading the parameters file
+// and then compiled into rows with compile(). If the same row and key
+// is inserted more than once either the first or the last entry is
+// kept depending on the duplicate policy passed to compile().
+template<typename Parameters>
+class MmffParametersTable
+{
+public:
+    enum DuplicatePolicy {
+        KeepFirst,
+        KeepLast
+    };
+
+    struct Entry
+    {
+        boost::uint32_t key;
+        Parameters parameters;
+    };
+
+    void insert(size_t row, boost::uint32_t key, const Parameters &parameters)
+    {
+        Entry entry;
+        entry.key = key;
+        entry.parameters = parameters;
+        m_pending.push_back(std::make_pair(row, entry));
+    }
+
+    const Parameters* find(size_t row, boost::uint32_t key) const
+    {
+        if(row + 1 >= offsets.size()){
+            return 0;
+        }
+
+        for(boost::uint32_t i = offsets[row]; i < offsets[row + 1]; i++){
+            if(entries[i].key == key){
+                return &entries[i].parameters;
+            }
+        }
+
+        return 0;
+    }
+
+    void compile(size_t rowCount, DuplicatePolicy policy = KeepLast)
+    {
+        std::stable_sort(m_pending.begin(), m_pending.end(), rowLessThan);
+
+        offsets.assign(rowCount + 1, 0);
+        entries.clear();
+        entries.reserve(m_pending.size());
+
+        size_t row = 0;
+        for(size_t i = 0; i < m_pending.size(); i++){
+            if(m_pending[i].first >= rowCount){
+                continue;
+            }
+
+            while(row < m_pending[i].first){
+                offsets[++row] = static_cast<boost::uint32_t>(entries.size());
+            }
+
+            // keep either the earlier or the later entry with the same key
+            bool duplicate = false;
+            for(size_t j = offsets[row]; j < entries.size(); j++){
+                if(entries[j].key == m_pending[i].second.key){
+                    if(policy == KeepLast){
+                        entries[j] = m_pending[i].second;
+                    }
+                    duplicate = true;
+                    break;
+                }
+            }
+
+            if(!duplicate){
+                entries.push_back(m_pending[i].second);
+            }
+        }
+
+        while(row < rowCount){
+            offsets[++row] = static_cast<boost::uint32_t>(entries.size());
+        }
+
+        std::vector<std::pair<size_t, Entry> >().swap(m_pending);
+    }
+
+    std::vector<boost::uint32_t> offsets;
+    std::vector<Entry> entries;
+
+private:
+    static bool rowLessThan(const std::pair<size_t, Entry> &a, const std::pair<size_t, Entry> &b)
+    {
+        return a.first < b.first;
+    }
+
+private:
+    std::vector<std::pair<size_t, Entry> > m_pending;
+};
+
 class MmffParametersData
 {
 public:
+    // constants
+    enum {
+        TypeCount = MmffParameters::MaxAtomType + 1,
+        PeriodicTableRowCount = 5
+    };
+
     // construction and destruction
     MmffParametersData();
 
-    std::map<int, MmffBondStrechParameters> bondStrechParameters;
-    std::map<int, MmffAngleBendParameters> angleBendParameters;
-    std::map<int, MmffStrechBendParameters> strechBendParameters;
-    std::vector<MmffDefaultStrechBendParameters> defaultStrechBendParameters;
-    std::map<int, MmffOutOfPlaneBendingParameters> outOfPlaneBendingParameters;
-    std::map<int, MmffTorsionParameters> torsionParameters;
+    void compile();
+
+    MmffParametersTable<MmffBondStrechParameters> bondStrechParameters;
+    MmffParametersTable<MmffAngleBendParameters> angleBendParameters;
+    MmffParametersTable<MmffStrechBendParameters> strechBendParameters;
+    MmffParametersTable<MmffStrechBendParameters> defaultStrechBendParameters;
+    MmffParametersTable<MmffOutOfPlaneBendingParameters> outOfPlaneBendingParameters;
+    MmffParametersTable<MmffTorsionParameters> torsionParameters;
+    MmffParametersTable<MmffChargeParameters> chargeParameters;
     std::vector<MmffVanDerWaalsParameters> vanDerWaalsParameters;
-    std::vector<MmffChargeParameters> chargeParameters;
     std::vector<MmffPartialChargeParameters> partialChargeParameters;
 };
 
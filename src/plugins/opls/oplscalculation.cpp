@@ -71,38 +71,85 @@ bool OplsBondStrechCalculation::setup(const OplsParameters *parameters)
     return true;
 }
 
-chemkit::Real OplsBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real OplsBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                const size_t *atoms,
+                                                const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
 
     chemkit::Real r = coordinates->distance(a, b);
 
     return kb * pow(r - r0, 2);
 }
 
-std::vector<chemkit::Vector3> OplsBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void OplsBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                         const size_t *atoms,
+                                         const chemkit::Real *parameters,
+                                         chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
 
-    chemkit::Real r = coordinates->distance(a, b);
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
+
+    // dE/dr
+    chemkit::Real de_dr = 2.0 * kb * (r - r0);
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real OplsBondStrechCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                           const size_t *atoms,
+                                                           const chemkit::Real *parameters,
+                                                           chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
 
     // dE/dr
     chemkit::Real de_dr = 2.0 * kb * (r - r0);
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+
+    return kb * pow(r - r0, 2);
+}
+
+chemkit::Real OplsBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> OplsBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real OplsBondStrechCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::ForceFieldCalculationBatch* OplsBondStrechCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<OplsBondStrechCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === OplsAngleBendCalculation ============================================ //
@@ -131,41 +178,90 @@ bool OplsAngleBendCalculation::setup(const OplsParameters *parameters)
     return true;
 }
 
-chemkit::Real OplsAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real OplsAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                               const size_t *atoms,
+                                               const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real theta0 = parameter(1);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
 
     chemkit::Real theta = coordinates->angleRadians(a, b, c);
 
     return ka * pow(theta - theta0, 2);
 }
 
-std::vector<chemkit::Vector3> OplsAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void OplsAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                        const size_t *atoms,
+                                        const chemkit::Real *parameters,
+                                        chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real theta0 = parameter(1);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
 
-    chemkit::Real theta = coordinates->angleRadians(a, b, c);
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real theta = coordinates->angleAndGradientRadians(a, b, c, angleGradient);
+
+    // dE/dtheta
+    chemkit::Real de_dtheta = (2.0 * ka * (theta - theta0));
+
+    gradient[0] = angleGradient[0] * de_dtheta;
+    gradient[1] = angleGradient[1] * de_dtheta;
+    gradient[2] = angleGradient[2] * de_dtheta;
+}
+
+chemkit::Real OplsAngleBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                          const size_t *atoms,
+                                                          const chemkit::Real *parameters,
+                                                          chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+
+    chemkit::Real ka = parameters[0];
+    chemkit::Real theta0 = parameters[1];
 
-    boost::array<chemkit::Vector3, 3> gradient = coordinates->angleGradientRadians(a, b, c);
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real theta = coordinates->angleAndGradientRadians(a, b, c, angleGradient);
 
     // dE/dtheta
     chemkit::Real de_dtheta = (2.0 * ka * (theta - theta0));
 
-    gradient[0] *= de_dtheta;
-    gradient[1] *= de_dtheta;
-    gradient[2] *= de_dtheta;
+    gradient[0] = angleGradient[0] * de_dtheta;
+    gradient[1] = angleGradient[1] * de_dtheta;
+    gradient[2] = angleGradient[2] * de_dtheta;
+
+    return ka * pow(theta - theta0, 2);
+}
+
+chemkit::Real OplsAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> OplsAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(3);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real OplsAngleBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::ForceFieldCalculationBatch* OplsAngleBendCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<OplsAngleBendCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === OplsTorsionCalculation ============================================== //
@@ -197,46 +293,98 @@ bool OplsTorsionCalculation::setup(const OplsParameters *parameters)
     return true;
 }
 
-chemkit::Real OplsTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real OplsTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                             const size_t *atoms,
+                                             const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real v1 = parameter(0);
-    chemkit::Real v2 = parameter(1);
-    chemkit::Real v3 = parameter(2);
+    chemkit::Real v1 = parameters[0];
+    chemkit::Real v2 = parameters[1];
+    chemkit::Real v3 = parameters[2];
 
     chemkit::Real phi = coordinates->torsionAngleRadians(a, b, c, d);
 
     return (1.0/2.0) * (v1 * (1.0 + cos(phi)) + v2 * (1.0 - cos(2.0 * phi)) + v3 * (1.0 + cos(3.0 * phi)));
 }
 
-std::vector<chemkit::Vector3> OplsTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void OplsTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                      const size_t *atoms,
+                                      const chemkit::Real *parameters,
+                                      chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real v1 = parameter(0);
-    chemkit::Real v2 = parameter(1);
-    chemkit::Real v3 = parameter(2);
+    chemkit::Real v1 = parameters[0];
+    chemkit::Real v2 = parameters[1];
+    chemkit::Real v3 = parameters[2];
 
-    chemkit::Real phi = coordinates->torsionAngleRadians(a, b, c, d);
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradientRadians(a, b, c, d, torsionGradient);
 
     // dE/dphi
     chemkit::Real de_dphi = (1.0/2.0) * (-v1 * sin(phi) + 2.0 * v2 * sin(2.0 * phi) - 3.0 * v3 * sin(3.0 * phi));
 
-    boost::array<chemkit::Vector3, 4> gradient = coordinates->torsionAngleGradientRadians(a, b, c, d);
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
+}
 
-    gradient[0] *= de_dphi;
-    gradient[1] *= de_dphi;
-    gradient[2] *= de_dphi;
-    gradient[3] *= de_dphi;
+chemkit::Real OplsTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                        const size_t *atoms,
+                                                        const chemkit::Real *parameters,
+                                                        chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
+
+    chemkit::Real v1 = parameters[0];
+    chemkit::Real v2 = parameters[1];
+    chemkit::Real v3 = parameters[2];
+
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradientRadians(a, b, c, d, torsionGradient);
+
+    // dE/dphi
+    chemkit::Real de_dphi = (1.0/2.0) * (-v1 * sin(phi) + 2.0 * v2 * sin(2.0 * phi) - 3.0 * v3 * sin(3.0 * phi));
+
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
+
+    return (1.0/2.0) * (v1 * (1.0 + cos(phi)) + v2 * (1.0 - cos(2.0 * phi)) + v3 * (1.0 + cos(3.0 * phi)));
+}
+
+chemkit::Real OplsTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+std::vector<chemkit::Vector3> OplsTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(4);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real OplsTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* OplsTorsionCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<OplsTorsionCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === OplsNonbondedCalculation ============================================ //
@@ -279,36 +427,67 @@ bool OplsNonbondedCalculation::setup(const OplsParameters *parameters)
     return true;
 }
 
-chemkit::Real OplsNonbondedCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real OplsNonbondedCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                               const size_t *atoms,
+                                               const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real qa = parameter(0);
-    chemkit::Real qb = parameter(1);
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
     chemkit::Real e = 332.06; // vacuum permitivity
-    chemkit::Real sigma = parameter(2);
-    chemkit::Real epsilon = parameter(3);
-    chemkit::Real scale = parameter(4);
+    chemkit::Real sigma = parameters[2];
+    chemkit::Real epsilon = parameters[3];
+    chemkit::Real scale = parameters[4];
 
     chemkit::Real r = coordinates->distance(a, b);
 
     return scale * ((qa * qb * e) / r + 4.0 * epsilon * (pow(sigma / r, 12) - pow(sigma / r, 6)));
 }
 
-std::vector<chemkit::Vector3> OplsNonbondedCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void OplsNonbondedCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                        const size_t *atoms,
+                                        const chemkit::Real *parameters,
+                                        chemkit::Vector3 *gradient)
 {
-    std::vector<chemkit::Vector3> gradient(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    size_t a = atom(0);
-    size_t b = atom(1);
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
+    chemkit::Real e = 332.06; // vacuum permitivity
+    chemkit::Real sigma = parameters[2];
+    chemkit::Real epsilon = parameters[3];
+    chemkit::Real scale = parameters[4];
+
+    chemkit::Real r = coordinates->distance(a, b);
+    chemkit::Real sr = sigma / r;
 
-    chemkit::Real qa = parameter(0);
-    chemkit::Real qb = parameter(1);
+    // dE/dr
+    chemkit::Real de_dr = scale * ((1.0 / pow(r, 3)) * (-qa * qb * e + -4.0 * epsilon * sigma * (12.0 * pow(sr, 11) - 6.0 * pow(sr, 5))));
+
+    // dE/da
+    chemkit::Vector3 de_da = (coordinates->position(a) - coordinates->position(b)) * de_dr;
+
+    gradient[0] = de_da;
+    gradient[1] = -de_da;
+}
+
+chemkit::Real OplsNonbondedCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                          const size_t *atoms,
+                                                          const chemkit::Real *parameters,
+                                                          chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real qa = parameters[0];
+    chemkit::Real qb = parameters[1];
     chemkit::Real e = 332.06; // vacuum permitivity
-    chemkit::Real sigma = parameter(2);
-    chemkit::Real epsilon = parameter(3);
-    chemkit::Real scale = parameter(4);
+    chemkit::Real sigma = parameters[2];
+    chemkit::Real epsilon = parameters[3];
+    chemkit::Real scale = parameters[4];
 
     chemkit::Real r = coordinates->distance(a, b);
     chemkit::Real sr = sigma / r;
@@ -322,5 +501,27 @@ std::vector<chemkit::Vector3> OplsNonbondedCalculation::gradient(const chemkit::
     gradient[0] = de_da;
     gradient[1] = -de_da;
 
-    return gradient;
+    return scale * ((qa * qb * e) / r + 4.0 * epsilon * (pow(sigma / r, 12) - pow(sigma / r, 6)));
+}
+
+chemkit::Real OplsNonbondedCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> OplsNonbondedCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real OplsNonbondedCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* OplsNonbondedCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<OplsNonbondedCalculation>(type(), atomCount(), parameterCount());
 }
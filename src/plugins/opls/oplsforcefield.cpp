@@ -90,15 +90,18 @@ bool OplsForceField::setup()
                                                   interaction[3]));
     }
 
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        addCalculation(new OplsNonbondedCalculation(interaction[0],
-                                                    interaction[1]));
+    // with a nonbonded cutoff the nonbonded calculations are created
+    // from the neighbor list instead
+    if(nonbondedCutoff() == 0){
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            addNonbondedCalculations(interaction[0], interaction[1]);
+        }
     }
 
     bool ok = true;
 
     foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<OplsCalculation *>(calculation)->setup(m_parameters);
+        bool setup = setupCalculation(calculation);
 
         if(!setup){
             ok = false;
@@ -109,3 +112,13 @@ bool OplsForceField::setup()
 
     return ok;
 }
+
+void OplsForceField::addNonbondedCalculations(size_t a, size_t b)
+{
+    addCalculation(new OplsNonbondedCalculation(a, b));
+}
+
+bool OplsForceField::setupCalculation(chemkit::ForceFieldCalculation *calculation)
+{
+    return static_cast<OplsCalculation *>(calculation)->setup(m_parameters);
+}
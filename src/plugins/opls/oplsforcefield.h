@@ -50,6 +50,10 @@ public:
     // parameterization
     bool setup();
 
+protected:
+    void addNonbondedCalculations(size_t a, size_t b) CHEMKIT_OVERRIDE;
+    bool setupCalculation(chemkit::ForceFieldCalculation *calculation) CHEMKIT_OVERRIDE;
+
 private:
     OplsParameters *m_parameters;
 };
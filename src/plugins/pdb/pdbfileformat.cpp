@@ -43,6 +43,7 @@
 #include <chemkit/residue.h>
 #include <chemkit/molecule.h>
 #include <chemkit/aminoacid.h>
+#include <chemkit/moleculebuilder.h>
 #include <chemkit/nucleotide.h>
 #include <chemkit/polymerfile.h>
 #include <chemkit/polymerchain.h>
@@ -81,19 +82,17 @@ PdbAtom::PdbAtom(const char *data)
     position = chemkit::Point3(x, y, z);
 
     // atomic number
-    std::string symbol;
-    for(int i = 77; i < 79 && isalpha(data[i]); i++){
-        symbol += tolower(data[i]);
+    size_t symbolLength = 0;
+    if(strlen(data) > 77){
+        while(symbolLength < 2 && isalpha(data[77 + symbolLength])){
+            symbolLength++;
+        }
     }
-    boost::trim(symbol);
-    symbol[0] = toupper(symbol[0]);
-    element = chemkit::Element::fromSymbol(symbol);
+    element = chemkit::Element::fromSymbolCaseInsensitive(&data[77], symbolLength);
 
     if(!element.isValid()){
         // try atomic number from name
-        symbol = boost::to_lower_copy(name);
-        symbol[0] = toupper(symbol[0]);
-        element = chemkit::Element::fromSymbol(symbol);
+        element = chemkit::Element::fromSymbolCaseInsensitive(name);
     }
 }
 
@@ -106,6 +105,7 @@ public:
 
     void addAtom(PdbAtom *atom);
     std::vector<PdbAtom *> atoms() const;
+    size_t atomCount() const;
 
     std::string name() const;
     int index() const;
@@ -139,6 +139,11 @@ std::vector<PdbAtom *> PdbResidue::atoms() const
     return m_atoms;
 }
 
+size_t PdbResidue::atomCount() const
+{
+    return m_atoms.size();
+}
+
 std::string PdbResidue::name() const
 {
     return m_name;
@@ -527,6 +532,16 @@ void PdbFile::writePolymerFile(chemkit::PolymerFile *file)
     std::map<int, chemkit::Atom *> atomIds;
     PdbChain::Type chainType = PdbChain::Protein;
 
+    size_t atomCount = 0;
+    foreach(const PdbChain *pdbChain, m_chains){
+        foreach(const PdbResidue *pdbResidue, pdbChain->residues()){
+            atomCount += pdbResidue->atomCount();
+        }
+    }
+
+    chemkit::MoleculeBuilder builder(polymer.get());
+    builder.reserve(atomCount, 0);
+
     foreach(PdbChain *pdbChain, m_chains){
         chemkit::PolymerChain *chain = polymer->addChain();
         chainType = pdbChain->guessType();
@@ -574,7 +589,7 @@ void PdbFile::writePolymerFile(chemkit::PolymerFile *file)
             }
 
             foreach(PdbAtom *pdbAtom, pdbResidue->atoms()){
-                chemkit::Atom *atom = polymer->addAtom(pdbAtom->element);
+                chemkit::Atom *atom = builder.addAtom(pdbAtom->element, pdbAtom->position);
                 if(!atom){
                     continue;
                 }
@@ -582,7 +597,6 @@ void PdbFile::writePolymerFile(chemkit::PolymerFile *file)
                 atomIds[pdbAtom->id] = atom;
 
                 atom->setType(pdbAtom->name);
-                atom->setPosition(pdbAtom->position);
                 residue->addAtom(atom);
 
                 if(chainType == PdbChain::Protein){
@@ -605,6 +619,8 @@ void PdbFile::writePolymerFile(chemkit::PolymerFile *file)
         }
     }
 
+    builder.commit();
+
     // set amino acid conformations (alpha helix or beta sheet)
     if(chainType == PdbChain::Protein){
         for(size_t i = 0; i < m_chains.size(); i++){
@@ -653,17 +669,19 @@ void PdbFile::writePolymerFile(chemkit::PolymerFile *file)
             ligand->setName(pdbLigand->name());
         }
 
+        chemkit::MoleculeBuilder ligandBuilder(ligand.get());
+
         foreach(const PdbAtom *pdbAtom, pdbLigand->atoms()){
-            chemkit::Atom *atom = ligand->addAtom(pdbAtom->element);
+            chemkit::Atom *atom = ligandBuilder.addAtom(pdbAtom->element, pdbAtom->position);
             if(!atom){
                 continue;
             }
 
-            atom->setPosition(pdbAtom->position);
-
             atomIds[pdbAtom->id] = atom;
         }
 
+        ligandBuilder.commit();
+
         file->addLigand(ligand);
     }
 
@@ -44,6 +44,7 @@ public:
     RuleOfFiveDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 #endif // RULEOFFIVEDESCRIPTOR_H
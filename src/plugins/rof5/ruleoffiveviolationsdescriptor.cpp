@@ -36,6 +36,7 @@
 #include "ruleoffiveviolationsdescriptor.h"
 
 #include <chemkit/molecule.h>
+#include <chemkit/moleculardescriptorcontext.h>
 
 RuleOfFiveViolationsDescriptor::RuleOfFiveViolationsDescriptor()
     : chemkit::MolecularDescriptor("rule-of-five-violations")
@@ -44,13 +45,20 @@ RuleOfFiveViolationsDescriptor::RuleOfFiveViolationsDescriptor()
 }
 
 chemkit::Variant RuleOfFiveViolationsDescriptor::value(const chemkit::Molecule *molecule) const
+{
+    chemkit::MolecularDescriptorContext context(molecule);
+
+    return value(&context);
+}
+
+chemkit::Variant RuleOfFiveViolationsDescriptor::value(chemkit::MolecularDescriptorContext *context) const
 {
     int violations = 0;
 
-    if(molecule->descriptor("molecular-mass").toDouble() > 500.0) violations++;
-    if(molecule->descriptor("hydrogen-bond-donors").toInt() > 5) violations++;
-    if(molecule->descriptor("hydrogen-bond-acceptors").toInt() > 10) violations++;
-    if(molecule->descriptor("moriguchi-logp").toDouble() > 5.0) violations++;
+    if(context->descriptor("molecular-mass").toDouble() > 500.0) violations++;
+    if(context->descriptor("hydrogen-bond-donors").toInt() > 5) violations++;
+    if(context->descriptor("hydrogen-bond-acceptors").toInt() > 10) violations++;
+    if(context->descriptor("moriguchi-logp").toDouble() > 5.0) violations++;
 
     return violations;
 }
@@ -44,6 +44,7 @@ public:
     RuleOfFiveViolationsDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 #endif // RULEOFFIVEVIOLATIONSDESCRIPTOR_H
@@ -0,0 +1,175 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "screeningfingerprint.h"
+
+#include <map>
+#include <algorithm>
+
+#include <chemkit/atom.h>
+#include <chemkit/foreach.h>
+
+// The screening fingerprint is designed for pre-screening candidates
+// in a substructure search. Each bit represents a feature such that if
+// a query molecule is a substructure of a target molecule then every
+// bit set in the query's fingerprint is also set in the target's.
+//
+// The features are linear paths and rings of heavy atoms (by element
+// only, bond orders and aromaticity are ignored so that the fingerprint
+// is valid for each of the SubstructureQuery comparison modes) and
+// lower bounds on the number of atoms of each element.
+
+namespace {
+
+const size_t FingerprintSize = 1024;
+const size_t MaxPathLength = 7;
+const size_t MaxElementCount = 32;
+
+enum FeatureType {
+    PathFeature = 1,
+    ElementCountFeature = 2,
+    RingFeature = 3
+};
+
+} // end anonymous namespace
+
+ScreeningFingerprint::ScreeningFingerprint()
+    : chemkit::Fingerprint("screening")
+{
+}
+
+ScreeningFingerprint::~ScreeningFingerprint()
+{
+}
+
+size_t ScreeningFingerprint::size() const
+{
+    return FingerprintSize;
+}
+
+chemkit::Bitset ScreeningFingerprint::value(const chemkit::Molecule *molecule) const
+{
+    chemkit::Bitset fingerprint(FingerprintSize);
+
+    // count heavy atoms of each element
+    std::map<unsigned char, size_t> elementCounts;
+    foreach(const chemkit::Atom *atom, molecule->atoms()){
+        if(!atom->is(chemkit::Atom::Hydrogen)){
+            elementCounts[atom->atomicNumber()]++;
+        }
+    }
+
+    // set a bit for each power of two less than or equal to the count
+    for(std::map<unsigned char, size_t>::const_iterator iter = elementCounts.begin(); iter != elementCounts.end(); ++iter){
+        for(size_t count = 1; count <= iter->second && count <= MaxElementCount; count *= 2){
+            unsigned char feature[2] = { iter->first, static_cast<unsigned char>(count) };
+            fingerprint.set(hash(ElementCountFeature, feature, feature + 2));
+        }
+    }
+
+    // add each path starting at each heavy atom
+    Path path;
+    std::vector<bool> visited(molecule->size(), false);
+
+    foreach(const chemkit::Atom *atom, molecule->atoms()){
+        if(!atom->is(chemkit::Atom::Hydrogen)){
+            addPaths(path, visited, atom, atom, fingerprint);
+        }
+    }
+
+    return fingerprint;
+}
+
+// Adds the path extended to atom and all of its extensions.
+void ScreeningFingerprint::addPaths(Path &path,
+                                   std::vector<bool> &visited,
+                                   const chemkit::Atom *atom,
+                                   const chemkit::Atom *firstAtom,
+                                   chemkit::Bitset &fingerprint) const
+{
+    path.push_back(atom->atomicNumber());
+    visited[atom->index()] = true;
+
+    fingerprint.set(canonicalHash(path));
+
+    foreach(const chemkit::Atom *neighbor, atom->neighbors()){
+        if(neighbor->is(chemkit::Atom::Hydrogen)){
+            continue;
+        }
+
+        if(!visited[neighbor->index()]){
+            if(path.size() < MaxPathLength){
+                addPaths(path, visited, neighbor, firstAtom, fingerprint);
+            }
+        }
+        else if(path.size() > 2 && neighbor == firstAtom){
+            // the path forms a ring, rings are identified by their
+            // sorted elements so that the feature is independent of
+            // the starting atom and direction
+            Path ring = path;
+            std::sort(ring.begin(), ring.end());
+            fingerprint.set(hash(RingFeature, &ring[0], &ring[0] + ring.size()));
+        }
+    }
+
+    visited[atom->index()] = false;
+    path.pop_back();
+}
+
+// Returns the hash of the feature data in [begin, end).
+size_t ScreeningFingerprint::hash(unsigned char type, const unsigned char *begin, const unsigned char *end)
+{
+    // fnv-1a hash
+    unsigned int value = 2166136261u;
+
+    value = (value ^ type) * 16777619u;
+    for(const unsigned char *i = begin; i != end; ++i){
+        value = (value ^ *i) * 16777619u;
+    }
+
+    return value % FingerprintSize;
+}
+
+// Returns the hash of the path which is the same regardless of the
+// direction the path was traversed in.
+size_t ScreeningFingerprint::canonicalHash(const Path &path)
+{
+    if(std::lexicographical_compare(path.rbegin(), path.rend(), path.begin(), path.end())){
+        Path reversed(path.rbegin(), path.rend());
+        return hash(PathFeature, &reversed[0], &reversed[0] + reversed.size());
+    }
+
+    return hash(PathFeature, &path[0], &path[0] + path.size());
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef SCREENINGFINGERPRINT_H
+#define SCREENINGFINGERPRINT_H
+
+#include <vector>
+
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+
+class ScreeningFingerprint : public chemkit::Fingerprint
+{
+public:
+    ScreeningFingerprint();
+    ~ScreeningFingerprint();
+
+    size_t size() const CHEMKIT_OVERRIDE;
+    chemkit::Bitset value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+
+private:
+    typedef std::vector<unsigned char> Path;
+
+    void addPaths(Path &path,
+                  std::vector<bool> &visited,
+                  const chemkit::Atom *atom,
+                  const chemkit::Atom *firstAtom,
+                  chemkit::Bitset &fingerprint) const;
+    static size_t hash(unsigned char type, const unsigned char *begin, const unsigned char *end);
+    static size_t canonicalHash(const Path &path);
+};
+
+#endif // SCREENINGFINGERPRINT_H
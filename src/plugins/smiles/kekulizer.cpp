@@ -35,7 +35,7 @@
 
 #include "kekulizer.h"
 
-#include <map>
+#include <vector>
 
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
@@ -85,48 +85,41 @@ int costOfDoubleBond(const chemkit::Bond *bond)
 // === Kekulizer =========================================================== //
 void Kekulizer::kekulize(const std::vector<chemkit::Bond *> &bonds)
 {
+    if(bonds.empty()){
+        return;
+    }
+
     lemon::ListGraph graph;
     lemon::ListGraph::EdgeMap<int> costs(graph);
 
-    std::map<chemkit::Atom*, int> atomToNode;
-    std::map<int, chemkit::Bond*> edgeToBond;
-    foreach(chemkit::Bond *bond, bonds){
-        int node1;
+    // map from atom index to graph node id (or -1 if the atom
+    // has not been added to the graph yet)
+    std::vector<int> atomToNode(bonds.front()->molecule()->size(), -1);
 
-        std::map<chemkit::Atom*, int>::iterator iter = atomToNode.find(bond->atom1());
-        if(iter != atomToNode.end()){
-            node1 = iter->second;
-        }
-        else{
-            lemon::ListGraph::Node node = graph.addNode();
-            node1 = graph.id(node);
-            atomToNode[bond->atom1()] = node1;
+    foreach(chemkit::Bond *bond, bonds){
+        int &node1 = atomToNode[bond->atom1()->index()];
+        if(node1 == -1){
+            node1 = graph.id(graph.addNode());
         }
 
-        int node2;
-        iter = atomToNode.find(bond->atom2());
-        if(iter != atomToNode.end()){
-            node2 = iter->second;
-        }
-        else{
-            lemon::ListGraph::Node node = graph.addNode();
-            node2 = graph.id(node);
-            atomToNode[bond->atom2()] = node2;
+        int &node2 = atomToNode[bond->atom2()->index()];
+        if(node2 == -1){
+            node2 = graph.id(graph.addNode());
         }
 
+        // edge ids are assigned sequentially so the id of each edge
+        // is the index of its bond in bonds
         lemon::ListGraph::Edge edge = graph.addEdge(graph.nodeFromId(node1), graph.nodeFromId(node2));
         int cost = costOfDoubleBond(bond);
 
         costs.set(edge, 10000000 - cost);
-
-        edgeToBond[graph.id(edge)] = bond;
     }
 
     lemon::MaxWeightedMatching<lemon::ListGraph> matcher(graph, costs);
     matcher.run();
 
     for(lemon::ListGraph::EdgeIt edge(graph); edge != lemon::INVALID; ++edge){
-        chemkit::Bond *bond = edgeToBond[graph.id(edge)];
+        chemkit::Bond *bond = bonds[graph.id(edge)];
 
         if(matcher.matching(edge)){
             bond->setOrder(chemkit::Bond::Double);
@@ -43,8 +43,8 @@
 
 #include "smileslineformat.h"
 
-#include <stack>
 #include <vector>
+#include <algorithm>
 
 #include <boost/format.hpp>
 
@@ -167,20 +167,6 @@ int readCharge(const char **p)
     return 0;
 }
 
-struct BranchState
-{
-    chemkit::Atom *lastAtom;
-    int bondOrder;
-    bool aromatic;
-};
-
-struct RingState
-{
-    chemkit::Atom *firstAtom;
-    int bondOrder;
-    bool aromatic;
-};
-
 } // end anonymous namespace
 
 // === SmilesLineFormat ==================================================== //
@@ -212,19 +198,15 @@ chemkit::Molecule* SmilesLineFormat::read(const char *formula)
 {
     const char *p = formula;
     int number = 0;
-    chemkit::Atom *atom = 0;
-    chemkit::Bond *bond = 0;
-    chemkit::Atom *lastAtom = 0;
-    chemkit::Bond *lastDoubleBond = 0;
+    int atom = -1;
+    int lastAtom = -1;
+    int lastDoubleBond = -1;
     int bondOrder = 1;
-    std::map<chemkit::Atom *, int> charges; // atom -> formal charge
-    std::vector<chemkit::Atom *> organicAtoms;
-    std::vector<chemkit::Bond *> aromaticBonds;
     bool aromatic = false;
-    BranchState branchState;
-    std::stack<BranchState> branchRoots;
+    ParsedAtom parsedAtom;
+    ParsedBond parsedBond;
     RingState ringState;
-    std::map<int, RingState> rings;
+    BranchState branchState;
 
     enum BondStereo {
         Up = 1,
@@ -233,8 +215,15 @@ chemkit::Molecule* SmilesLineFormat::read(const char *formula)
 
     int bondStereo = 0;
 
-    // create molecule
-    chemkit::Molecule *molecule = new chemkit::Molecule;
+    // clear buffers from the previous formula
+    m_atoms.clear();
+    m_bonds.clear();
+    m_organicAtoms.clear();
+    m_aromaticBonds.clear();
+    m_rings.clear();
+    m_branches.clear();
+
+    parsedBond.stereochemistry = chemkit::Stereochemistry::None;
 
     // go to initial state
     if(isTerminator(*p)) goto done;
@@ -247,69 +236,78 @@ bracket_atom:
     assert(*p == '[');
     p++; // move past opening bracket
 
+    parsedAtom.massNumber = 0;
+    parsedAtom.chirality = chemkit::Stereochemistry::None;
+
     // mass number
     if(isdigit(*p)){
-        number = readNumber(&p);
+        parsedAtom.massNumber = readNumber(&p);
     }
 
     // symbol
     if(isupper(*p)){
         if(islower(*(p+1))){
-            atom = molecule->addAtom(chemkit::Element::fromSymbol(p, 2));
+            parsedAtom.element = chemkit::Element::fromSymbol(p, 2);
             p += 2;
         }
         else{
-            atom = molecule->addAtom(chemkit::Element::fromSymbol(*p));
+            parsedAtom.element = chemkit::Element::fromSymbol(*p);
             p++; // move past atom symbol
         }
 
         aromatic = false;
     }
     else if(islower(*p)){
-        atom = molecule->addAtom(readAromaticSymbol(&p));
+        parsedAtom.element = readAromaticSymbol(&p);
         aromatic = true;
-        organicAtoms.push_back(atom);
     }
     else{
         goto parse_error;
     }
 
-    if(!atom->element().isValid()){
+    if(!parsedAtom.element.isValid()){
         goto invalid_atom_error;
     }
 
+    atom = m_atoms.size();
+
+    if(aromatic){
+        m_organicAtoms.push_back(atom);
+    }
+
     // add bond to last atom
-    if(lastAtom){
+    if(lastAtom != -1){
         if(bondOrder){
-            bond = molecule->addBond(atom, lastAtom, bondOrder);
-        }
-        bondOrder = chemkit::Bond::Single;
+            parsedBond.atom1 = atom;
+            parsedBond.atom2 = lastAtom;
+            parsedBond.order = bondOrder;
+            m_bonds.push_back(parsedBond);
 
-        if(bond && aromatic){
-            aromaticBonds.push_back(bond);
+            if(aromatic){
+                m_aromaticBonds.push_back(m_bonds.size() - 1);
+            }
         }
+
+        bondOrder = chemkit::Bond::Single;
     }
 
     lastAtom = atom;
 
-    // set mass number
-    if(number){
-        atom->setMassNumber(number);
-    }
-
     // chirality symbol
     if(*p == '@'){
         p++; // move past chirality symbol
 
         if(*p == '@'){
-            atom->setChirality(chemkit::Stereochemistry::S);
+            parsedAtom.chirality = chemkit::Stereochemistry::S;
             p++; // move past second chirality symbol
         }
         else{
-            atom->setChirality(chemkit::Stereochemistry::R);
+            parsedAtom.chirality = chemkit::Stereochemistry::R;
         }
     }
 
+    m_atoms.push_back(parsedAtom);
+
     // hydrogens
     if(*p == 'H'){
         p++; // move past 'H' symbol
@@ -320,38 +318,29 @@ bracket_atom:
             p++; // move past digit
         }
 
+        parsedAtom.element = chemkit::Atom::Hydrogen;
+        parsedAtom.massNumber = 0;
+        parsedAtom.chirality = chemkit::Stereochemistry::None;
+
         for(int i = 0; i < number; i++){
-            molecule->addBond(atom, molecule->addAtom(chemkit::Atom::Hydrogen));
+            parsedBond.atom1 = atom;
+            parsedBond.atom2 = m_atoms.size();
+            parsedBond.order = chemkit::Bond::Single;
+            m_bonds.push_back(parsedBond);
+            m_atoms.push_back(parsedAtom);
         }
     }
 
-    // charge
-    if(*p == '+'){
+    // charge (formal charges are determined from the valence of each
+    // atom so the charge is read but not stored)
+    if(*p == '+' || *p == '-'){
         p++;
 
-        if(*p == '+'){
-            charges[atom] = +2;
+        if(*p == *(p-1)){
             p++;
         }
         else if(isdigit(*p)){
-            charges[atom] = readNumber(&p);
-        }
-        else{
-            charges[atom] = +1;
-        }
-    }
-    else if(*p == '-'){
-        p++;
-
-        if(*p == '-'){
-            charges[atom] = -2;
-            p++;
-        }
-        else if(isdigit(*p)){
-            charges[atom] = -readNumber(&p);
-        }
-        else{
-            charges[atom] = -1;
+            readNumber(&p);
         }
     }
 
@@ -374,18 +363,26 @@ bracket_atom:
     else                 goto parse_error;
 
 organic_atom:
-    atom = molecule->addAtom(readOrganicSymbol(&p));
-    if(!atom->element().isValid())
+    parsedAtom.element = readOrganicSymbol(&p);
+    if(!parsedAtom.element.isValid())
         goto invalid_atom_error;
 
-    organicAtoms.push_back(atom);
+    parsedAtom.massNumber = 0;
+    parsedAtom.chirality = chemkit::Stereochemistry::None;
+
+    atom = m_atoms.size();
+    m_atoms.push_back(parsedAtom);
+    m_organicAtoms.push_back(atom);
 
-    if(lastAtom){
+    if(lastAtom != -1){
         if(bondOrder){
-            bond = molecule->addBond(atom, lastAtom, bondOrder);
+            parsedBond.atom1 = atom;
+            parsedBond.atom2 = lastAtom;
+            parsedBond.order = bondOrder;
+            m_bonds.push_back(parsedBond);
 
             if(bondOrder == chemkit::Bond::Double){
-                lastDoubleBond = bond;
+                lastDoubleBond = m_bonds.size() - 1;
             }
         }
 
@@ -409,25 +406,35 @@ organic_atom:
 aromatic_atom:
     assert(islower(*p));
 
-    atom = molecule->addAtom(readAromaticSymbol(&p));
-    if(!atom->element().isValid()){
+    parsedAtom.element = readAromaticSymbol(&p);
+    if(!parsedAtom.element.isValid()){
         goto invalid_atom_error;
     }
 
-    organicAtoms.push_back(atom);
+    parsedAtom.massNumber = 0;
+    parsedAtom.chirality = chemkit::Stereochemistry::None;
 
-    if(lastAtom){
+    atom = m_atoms.size();
+    m_atoms.push_back(parsedAtom);
+    m_organicAtoms.push_back(atom);
+
+    if(lastAtom != -1){
         if(bondOrder){
-            bond = molecule->addBond(atom, lastAtom, bondOrder);
+            parsedBond.atom1 = atom;
+            parsedBond.atom2 = lastAtom;
+            parsedBond.order = bondOrder;
+            m_bonds.push_back(parsedBond);
 
             if(bondOrder == chemkit::Bond::Double){
-                lastDoubleBond = bond;
+                lastDoubleBond = m_bonds.size() - 1;
             }
 
             if(aromatic){
-                aromaticBonds.push_back(bond);
+                m_aromaticBonds.push_back(m_bonds.size() - 1);
             }
         }
+
+        bondOrder = chemkit::Bond::Single;
     }
 
     aromatic = true;
@@ -462,32 +469,32 @@ bond:
 
     // set stereochemistry
     if(*p == '/'){
-        if(bondStereo != 0 && lastDoubleBond){
+        if(bondStereo != 0 && lastDoubleBond != -1){
             if(bondStereo == Up){
-                lastDoubleBond->setStereochemistry(chemkit::Stereochemistry::E);
+                m_bonds[lastDoubleBond].stereochemistry = chemkit::Stereochemistry::E;
             }
             else if(bondStereo == Down){
-                lastDoubleBond->setStereochemistry(chemkit::Stereochemistry::Z);
+                m_bonds[lastDoubleBond].stereochemistry = chemkit::Stereochemistry::Z;
             }
 
             bondStereo = 0;
-            lastDoubleBond = 0;
+            lastDoubleBond = -1;
         }
         else{
             bondStereo = Up;
         }
     }
     else if(*p == '\\'){
-        if(bondStereo != 0 && lastDoubleBond){
+        if(bondStereo != 0 && lastDoubleBond != -1){
             if(bondStereo == Up){
-                lastDoubleBond->setStereochemistry(chemkit::Stereochemistry::Z);
+                m_bonds[lastDoubleBond].stereochemistry = chemkit::Stereochemistry::Z;
             }
             else if(bondStereo == Down){
-                lastDoubleBond->setStereochemistry(chemkit::Stereochemistry::E);
+                m_bonds[lastDoubleBond].stereochemistry = chemkit::Stereochemistry::E;
             }
 
             bondStereo = 0;
-            lastDoubleBond = 0;
+            lastDoubleBond = -1;
         }
         else{
             bondStereo = Down;
@@ -510,21 +517,40 @@ ring:
 
     if(*p == '%'){
         p++; // move past '%'
-        number = readNumber(&p);
+
+        // ring bond labels after '%' are exactly two digits
+        if(!isdigit(p[0]) || !isdigit(p[1])){
+            goto parse_error;
+        }
+        number = (p[0] - '0') * 10 + (p[1] - '0');
+        p += 2; // move past digits
     }
     else{
         number = *p - '0';
         p++; // move past digit
     }
 
-    if(rings.find(number) != rings.end()){
-        // ring closure
-        ringState = rings[number];
-        rings.erase(number);
-        bond = molecule->addBond(ringState.firstAtom, lastAtom, ringState.bondOrder);
+    if(number >= static_cast<int>(m_rings.size())){
+        ringState.firstAtom = -1;
+        m_rings.resize(number + 1, ringState);
+    }
+
+    if(m_rings[number].firstAtom != -1){
+        // ring closure (an atom cannot close a ring to itself)
+        if(m_rings[number].firstAtom == lastAtom){
+            goto parse_error;
+        }
+
+        ringState = m_rings[number];
+        m_rings[number].firstAtom = -1;
+
+        parsedBond.atom1 = ringState.firstAtom;
+        parsedBond.atom2 = lastAtom;
+        parsedBond.order = ringState.bondOrder;
+        m_bonds.push_back(parsedBond);
 
         if(aromatic && ringState.aromatic){
-            aromaticBonds.push_back(bond);
+            m_aromaticBonds.push_back(m_bonds.size() - 1);
         }
     }
     else{
@@ -532,7 +558,7 @@ ring:
         ringState.firstAtom = lastAtom;
         ringState.bondOrder = bondOrder;
         ringState.aromatic = aromatic;
-        rings[number] = ringState;
+        m_rings[number] = ringState;
     }
 
     // go to next state
@@ -554,7 +580,7 @@ start_branch:
     branchState.lastAtom = lastAtom;
     branchState.bondOrder = bondOrder;
     branchState.aromatic = aromatic;
-    branchRoots.push(branchState);
+    m_branches.push_back(branchState);
 
     // go to next state
     if(isupper(*p))      goto organic_atom;
@@ -566,14 +592,14 @@ start_branch:
 end_branch:
     assert(*p == ')');
 
-    if(branchRoots.empty())
+    if(m_branches.empty())
         goto parse_error;
 
     p++; // move past closing parenthesis
 
     // restore state to what it was before the branch
-    branchState = branchRoots.top();
-    branchRoots.pop();
+    branchState = m_branches.back();
+    m_branches.pop_back();
     lastAtom = branchState.lastAtom;
     bondOrder = branchState.bondOrder;
     aromatic = branchState.aromatic;
@@ -592,27 +618,118 @@ end_branch:
 parse_error:
     setErrorString((boost::format("Error parsing smiles at character #%d ('%c').") %
                        (p - formula) % *p).str());
-    goto error;
+    return 0;
 
 invalid_atom_error:
     setErrorString((boost::format("Invalid atom symbol at character #%d ('%c').") %
                              (p - formula) % *p).str());
-    goto error;
-
-error:
-    delete molecule;
     return 0;
 
 done:
+    for(size_t i = 0; i < m_rings.size(); i++){
+        if(m_rings[i].firstAtom != -1){
+            setErrorString((boost::format("Unclosed ring bond %d.") % i).str());
+            return 0;
+        }
+    }
+
+    return createMolecule();
+}
+
+std::string SmilesLineFormat::write(const chemkit::Molecule *molecule)
+{
+    bool kekulize = option("kekulize").toBool();
+
+    return SmilesGraph(molecule).toString(kekulize);
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+// Creates a new molecule from the atoms and bonds in the parse buffers.
+// The storage for the atoms and bonds is reserved up front so that the
+// molecule's vectors are only allocated once.
+chemkit::Molecule* SmilesLineFormat::createMolecule()
+{
+    chemkit::Molecule *molecule = new chemkit::Molecule;
+    molecule->setAtomCapacity(m_atoms.size());
+    molecule->setBondCapacity(m_bonds.size());
+
+    // add atoms
+    m_atomPointers.resize(m_atoms.size());
+
+    for(size_t i = 0; i < m_atoms.size(); i++){
+        const ParsedAtom &parsedAtom = m_atoms[i];
+
+        chemkit::Atom *atom = molecule->addAtom(parsedAtom.element);
+
+        if(parsedAtom.massNumber){
+            atom->setMassNumber(parsedAtom.massNumber);
+        }
+
+        if(parsedAtom.chirality != chemkit::Stereochemistry::None){
+            atom->setChirality(parsedAtom.chirality);
+        }
+
+        m_atomPointers[i] = atom;
+    }
+
+    // add bonds
+    m_bondPointers.resize(m_bonds.size());
+
+    for(size_t i = 0; i < m_bonds.size(); i++){
+        const ParsedBond &parsedBond = m_bonds[i];
+
+        chemkit::Bond *bond = molecule->addBond(m_atomPointers[parsedBond.atom1],
+                                                m_atomPointers[parsedBond.atom2],
+                                                parsedBond.order);
+
+        if(bond && parsedBond.stereochemistry != chemkit::Stereochemistry::None){
+            bond->setStereochemistry(parsedBond.stereochemistry);
+        }
+
+        m_bondPointers[i] = bond;
+    }
+
     // kekulize aromatic bonds
-    if(!aromaticBonds.empty()){
+    if(!m_aromaticBonds.empty()){
+        std::vector<chemkit::Bond *> aromaticBonds;
+        aromaticBonds.reserve(m_aromaticBonds.size());
+        std::vector<bool> added(molecule->bondCount(), false);
+
+        foreach(int index, m_aromaticBonds){
+            chemkit::Bond *bond = m_bondPointers[index];
+
+            // ring closures onto an atom that is already bonded do not
+            // create a new bond
+            if(bond && !added[bond->index()]){
+                aromaticBonds.push_back(bond);
+                added[bond->index()] = true;
+            }
+        }
+
         Kekulizer::kekulize(aromaticBonds);
     }
 
     // add implicit hydrogens (if enabled)
     if(option("add-implicit-hydrogens").toBool()){
-        foreach(chemkit::Atom *atom, organicAtoms){
-            while(atom->formalCharge() < 0){
+        // count the hydrogens needed to bring the formal charge of
+        // each atom up to zero and then add them all at once
+        m_hydrogenCounts.resize(m_organicAtoms.size());
+        size_t hydrogenCount = 0;
+
+        for(size_t i = 0; i < m_organicAtoms.size(); i++){
+            const chemkit::Atom *atom = m_atomPointers[m_organicAtoms[i]];
+
+            m_hydrogenCounts[i] = std::max(0, -atom->formalCharge());
+            hydrogenCount += m_hydrogenCounts[i];
+        }
+
+        molecule->setAtomCapacity(molecule->atomCount() + hydrogenCount);
+        molecule->setBondCapacity(molecule->bondCount() + hydrogenCount);
+
+        for(size_t i = 0; i < m_organicAtoms.size(); i++){
+            chemkit::Atom *atom = m_atomPointers[m_organicAtoms[i]];
+
+            for(int j = 0; j < m_hydrogenCounts[i]; j++){
                 chemkit::Atom *hydrogen = molecule->addAtom(chemkit::Atom::Hydrogen);
                 molecule->addBond(atom, hydrogen);
             }
@@ -621,10 +738,3 @@ done:
 
     return molecule;
 }
-
-std::string SmilesLineFormat::write(const chemkit::Molecule *molecule)
-{
-    bool kekulize = option("kekulize").toBool();
-
-    return SmilesGraph(molecule).toString(kekulize);
-}
@@ -36,7 +36,16 @@
 #ifndef SMILESLINEFORMAT_H
 #define SMILESLINEFORMAT_H
 
+#include <vector>
+
+#include <chemkit/element.h>
 #include <chemkit/lineformat.h>
+#include <chemkit/stereochemistry.h>
+
+namespace chemkit {
+class Atom;
+class Bond;
+}
 
 class SmilesLineFormat : public chemkit::LineFormat
 {
@@ -51,6 +60,52 @@ public:
     chemkit::Molecule* read(const std::string &formula) CHEMKIT_OVERRIDE;
     chemkit::Molecule* read(const char *formula);
     std::string write(const chemkit::Molecule *molecule) CHEMKIT_OVERRIDE;
+
+private:
+    chemkit::Molecule* createMolecule();
+
+private:
+    struct ParsedAtom
+    {
+        chemkit::Element element;
+        int massNumber;
+        chemkit::Stereochemistry::Type chirality;
+    };
+
+    struct ParsedBond
+    {
+        int atom1;
+        int atom2;
+        int order;
+        chemkit::Stereochemistry::Type stereochemistry;
+    };
+
+    struct RingState
+    {
+        int firstAtom;
+        int bondOrder;
+        bool aromatic;
+    };
+
+    struct BranchState
+    {
+        int lastAtom;
+        int bondOrder;
+        bool aromatic;
+    };
+
+    // the parser writes into these buffers which are kept between
+    // calls to read() so that reading many formulas from a file does
+    // not require any allocations once they have grown large enough
+    std::vector<ParsedAtom> m_atoms;
+    std::vector<ParsedBond> m_bonds;
+    std::vector<int> m_organicAtoms;
+    std::vector<int> m_aromaticBonds;
+    std::vector<RingState> m_rings;
+    std::vector<BranchState> m_branches;
+    std::vector<chemkit::Atom *> m_atomPointers;
+    std::vector<chemkit::Bond *> m_bondPointers;
+    std::vector<int> m_hydrogenCounts;
 };
 
 #endif // SMILESLINEFORMAT_H
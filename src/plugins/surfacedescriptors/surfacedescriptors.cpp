@@ -37,6 +37,7 @@
 
 #include <chemkit/molecule.h>
 #include <chemkit/molecularsurface.h>
+#include <chemkit/moleculardescriptorcontext.h>
 
 // === VanDerWallsAreaDescriptor =========================================== //
 VanDerWallsAreaDescriptor::VanDerWallsAreaDescriptor()
@@ -47,9 +48,14 @@ VanDerWallsAreaDescriptor::VanDerWallsAreaDescriptor()
 
 chemkit::Variant VanDerWallsAreaDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    chemkit::MolecularSurface surface(molecule, chemkit::MolecularSurface::VanDerWaals);
+    chemkit::MolecularDescriptorContext context(molecule);
 
-    return surface.surfaceArea();
+    return value(&context);
+}
+
+chemkit::Variant VanDerWallsAreaDescriptor::value(chemkit::MolecularDescriptorContext *context) const
+{
+    return context->surface(chemkit::MolecularSurface::VanDerWaals)->surfaceArea();
 }
 
 // === VanDerWallsVolumeDescriptor ========================================= //
@@ -61,9 +67,14 @@ VanDerWallsVolumeDescriptor::VanDerWallsVolumeDescriptor()
 
 chemkit::Variant VanDerWallsVolumeDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    chemkit::MolecularSurface surface(molecule, chemkit::MolecularSurface::VanDerWaals);
+    chemkit::MolecularDescriptorContext context(molecule);
 
-    return surface.volume();
+    return value(&context);
+}
+
+chemkit::Variant VanDerWallsVolumeDescriptor::value(chemkit::MolecularDescriptorContext *context) const
+{
+    return context->surface(chemkit::MolecularSurface::VanDerWaals)->volume();
 }
 
 // == SolventAccessibleAreaDescriptor ====================================== //
@@ -75,9 +86,14 @@ SolventAccessibleAreaDescriptor::SolventAccessibleAreaDescriptor()
 
 chemkit::Variant SolventAccessibleAreaDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    chemkit::MolecularSurface surface(molecule, chemkit::MolecularSurface::SolventAccessible);
+    chemkit::MolecularDescriptorContext context(molecule);
 
-    return surface.surfaceArea();
+    return value(&context);
+}
+
+chemkit::Variant SolventAccessibleAreaDescriptor::value(chemkit::MolecularDescriptorContext *context) const
+{
+    return context->surface(chemkit::MolecularSurface::SolventAccessible)->surfaceArea();
 }
 
 // === SolventAccessibleVolumeDescriptor =================================== //
@@ -89,7 +105,12 @@ SolventAccessibleVolumeDescriptor::SolventAccessibleVolumeDescriptor()
 
 chemkit::Variant SolventAccessibleVolumeDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    chemkit::MolecularSurface surface(molecule, chemkit::MolecularSurface::SolventAccessible);
+    chemkit::MolecularDescriptorContext context(molecule);
 
-    return surface.volume();
+    return value(&context);
+}
+
+chemkit::Variant SolventAccessibleVolumeDescriptor::value(chemkit::MolecularDescriptorContext *context) const
+{
+    return context->surface(chemkit::MolecularSurface::SolventAccessible)->volume();
 }
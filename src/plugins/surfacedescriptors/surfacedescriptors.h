@@ -44,6 +44,7 @@ public:
     VanDerWallsAreaDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 class VanDerWallsVolumeDescriptor : public chemkit::MolecularDescriptor
@@ -52,6 +53,7 @@ public:
     VanDerWallsVolumeDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 class SolventAccessibleAreaDescriptor : public chemkit::MolecularDescriptor
@@ -60,6 +62,7 @@ public:
     SolventAccessibleAreaDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 class SolventAccessibleVolumeDescriptor : public chemkit::MolecularDescriptor
@@ -68,6 +71,7 @@ public:
     SolventAccessibleVolumeDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 #endif // SURFACEDESCRIPTORS_H
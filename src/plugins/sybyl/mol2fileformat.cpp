@@ -35,6 +35,8 @@
 
 #include "mol2fileformat.h"
 
+#include <algorithm>
+
 #include <boost/make_shared.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -43,11 +45,13 @@
 #include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/moleculebuilder.h>
 
 #include "sybylatomtyper.h"
 
 Mol2FileFormat::Mol2FileFormat()
-    : chemkit::MoleculeFileFormat("mol2")
+    : chemkit::MoleculeFileFormat("mol2"),
+      m_moleculeHeaderRead(false)
 {
 }
 
@@ -57,47 +61,106 @@ Mol2FileFormat::~Mol2FileFormat()
 
 bool Mol2FileFormat::read(std::istream &input, chemkit::MoleculeFile *file)
 {
-    boost::shared_ptr<chemkit::Molecule> molecule;
+    m_moleculeHeaderRead = false;
 
-    int atomCount = 0;
-    int bondCount = 0;
+    for(;;){
+        boost::shared_ptr<chemkit::Molecule> molecule;
+        bool ok = readNext(input, molecule);
+        if(!ok){
+            return false;
+        }
+        else if(!molecule){
+            break;
+        }
 
-    while(!input.eof()){
+        file->addMolecule(molecule);
+    }
+
+    return true;
+}
+
+bool Mol2FileFormat::supportsReadNext() const
+{
+    return true;
+}
+
+bool Mol2FileFormat::readNext(std::istream &input, boost::shared_ptr<chemkit::Molecule> &molecule)
+{
+    molecule.reset();
+
+    // check if the stream can be moved back to the start of a line,
+    // tellg() sets the error state for streams which do not support
+    // it so the previous state is restored
+    std::ios::iostate state = input.rdstate();
+    bool seekable = input.tellg() != std::streampos(-1);
+    if(!seekable){
+        input.clear(state);
+    }
+
+    // find the start of the next molecule record. the header line
+    // may have already been read while reading the previous molecule
+    while(!m_moleculeHeaderRead && !input.eof()){
         std::string line;
         std::getline(input, line);
 
         if(boost::starts_with(line, "@<TRIPOS>MOLECULE")){
-            if(molecule){
-                file->addMolecule(molecule);
-            }
+            m_moleculeHeaderRead = true;
+        }
+    }
 
-            std::string name;
-            std::getline(input, name);
-            boost::trim(name);
-
-            std::string countsLineString;
-            std::getline(input, countsLineString);
-            boost::trim_left(countsLineString);
-            std::vector<std::string> countsLine;
-            boost::split(countsLine,
-                         countsLineString,
-                         boost::is_any_of(" \t"),
-                         boost::token_compress_on);
-            if(countsLine.size() < 2){
-                continue;
-            }
+    if(!m_moleculeHeaderRead){
+        return true;
+    }
 
-            atomCount = boost::lexical_cast<int>(countsLine[0]);
-            bondCount = boost::lexical_cast<int>(countsLine[1]);
+    m_moleculeHeaderRead = false;
+
+    std::string name;
+    std::getline(input, name);
+    boost::trim(name);
+
+    std::string countsLineString;
+    std::getline(input, countsLineString);
+    boost::trim_left(countsLineString);
+    std::vector<std::string> countsLine;
+    boost::split(countsLine,
+                 countsLineString,
+                 boost::is_any_of(" \t"),
+                 boost::token_compress_on);
+    if(countsLine.size() < 2){
+        // skip to the next molecule
+        return readNext(input, molecule);
+    }
+
+    int atomCount = boost::lexical_cast<int>(countsLine[0]);
+    int bondCount = boost::lexical_cast<int>(countsLine[1]);
+
+    molecule = boost::make_shared<chemkit::Molecule>();
 
-            molecule = boost::make_shared<chemkit::Molecule>();
+    if(!name.empty()){
+        molecule->setName(name);
+    }
+
+    chemkit::MoleculeBuilder builder(molecule.get());
+    builder.reserve(std::max(atomCount, 0), std::max(bondCount, 0));
 
-            if(!name.empty()){
-                molecule->setName(name);
+    while(!input.eof()){
+        std::streampos lineStart = seekable ? input.tellg() : std::streampos(-1);
+
+        std::string line;
+        std::getline(input, line);
+
+        if(boost::starts_with(line, "@<TRIPOS>MOLECULE")){
+            // start of the next molecule. if the stream is seekable move
+            // back to the header so that the stream is left positioned at
+            // the start of the next record, otherwise remember that the
+            // header has already been read
+            if(seekable){
+                input.seekg(lineStart);
             }
-        }
-        else if(!molecule){
-            continue;
+            else{
+                m_moleculeHeaderRead = true;
+            }
+            break;
         }
         else if(boost::starts_with(line, "@<TRIPOS>")){
             boost::trim(line);
@@ -114,36 +177,34 @@ bool Mol2FileFormat::read(std::istream &input, chemkit::MoleculeFile *file)
                                  boost::is_any_of(" \t"),
                                  boost::token_compress_on);
                     if(atomLine.size() < 6){
+                        setErrorString("Failed to read atom line");
+                        molecule.reset();
                         return false;
                     }
 
-                    chemkit::Element element;
-                    std::string symbol = atomLine[5];
-                    boost::to_lower(symbol);
-                    symbol[0] = toupper(symbol[0]);
-                    size_t dotPosition = symbol.find_first_of('.');
-                    if(dotPosition == std::string::npos){
-                        element = chemkit::Element::fromSymbol(symbol);
-                    }
-                    else{
-                        element = chemkit::Element::fromSymbol(symbol.c_str(), dotPosition);
-                    }
+                    const std::string &symbol = atomLine[5];
+                    size_t symbolLength = std::min(symbol.find_first_of('.'), symbol.size());
+                    chemkit::Element element =
+                        chemkit::Element::fromSymbolCaseInsensitive(symbol.c_str(), symbolLength);
+
+                    chemkit::Point3 position(boost::lexical_cast<chemkit::Real>(atomLine[2]),
+                                             boost::lexical_cast<chemkit::Real>(atomLine[3]),
+                                             boost::lexical_cast<chemkit::Real>(atomLine[4]));
 
-                    chemkit::Atom *atom = molecule->addAtom(element);
+                    chemkit::Atom *atom = builder.addAtom(element, position);
                     if(!atom){
                         continue;
                     }
 
-                    atom->setPosition(boost::lexical_cast<chemkit::Real>(atomLine[2]),
-                                      boost::lexical_cast<chemkit::Real>(atomLine[3]),
-                                      boost::lexical_cast<chemkit::Real>(atomLine[4]));
-
                     if(atomLine.size() >= 9){
                         atom->setPartialCharge(boost::lexical_cast<chemkit::Real>(atomLine[8]));
                     }
                 }
             }
             else if(type == "BOND"){
+                std::vector<std::pair<size_t, size_t> > bonds;
+                std::vector<int> bondOrders;
+
                 while(bondCount--){
                     std::string bondLineString;
                     std::getline(input, bondLineString);
@@ -157,8 +218,8 @@ bool Mol2FileFormat::read(std::istream &input, chemkit::MoleculeFile *file)
                         continue;
                     }
 
-                    chemkit::Atom *a1 = molecule->atom(boost::lexical_cast<int>(bondLine[1]) - 1);
-                    chemkit::Atom *a2 = molecule->atom(boost::lexical_cast<int>(bondLine[2]) - 1);
+                    int a1 = boost::lexical_cast<int>(bondLine[1]) - 1;
+                    int a2 = boost::lexical_cast<int>(bondLine[2]) - 1;
 
                     int bondOrder;
                     std::string bondOrderString = bondLine[3];
@@ -182,16 +243,17 @@ bool Mol2FileFormat::read(std::istream &input, chemkit::MoleculeFile *file)
                     }
 
                     if(bondOrder > 0){
-                        molecule->addBond(a1, a2, bondOrder);
+                        bonds.push_back(std::make_pair(a1, a2));
+                        bondOrders.push_back(bondOrder);
                     }
                 }
+
+                builder.addBonds(bonds, bondOrders);
             }
         }
     }
 
-    if(molecule){
-        file->addMolecule(molecule);
-    }
+    builder.commit();
 
     return true;
 }
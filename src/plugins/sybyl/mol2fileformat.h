@@ -45,7 +45,12 @@ public:
     ~Mol2FileFormat();
 
     bool read(std::istream &input, chemkit::MoleculeFile *file) CHEMKIT_OVERRIDE;
+    bool supportsReadNext() const CHEMKIT_OVERRIDE;
+    bool readNext(std::istream &input, boost::shared_ptr<chemkit::Molecule> &molecule) CHEMKIT_OVERRIDE;
     bool write(const chemkit::MoleculeFile *file, std::ostream &output) CHEMKIT_OVERRIDE;
+
+private:
+    bool m_moleculeHeaderRead;
 };
 
 #endif // MOL2FILEFORMAT_H
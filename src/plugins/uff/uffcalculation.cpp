@@ -121,36 +121,82 @@ bool UffBondStrechCalculation::setup()
     return true;
 }
 
-chemkit::Real UffBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real UffBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                               const size_t *atoms,
+                                               const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
     chemkit::Real r = coordinates->distance(a, b);
 
     return 0.5 * kb * pow(r - r0, 2);
 }
 
-std::vector<chemkit::Vector3> UffBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void UffBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                        const size_t *atoms,
+                                        const chemkit::Real *parameters,
+                                        chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real kb = parameter(0);
-    chemkit::Real r0 = parameter(1);
-    chemkit::Real r = coordinates->distance(a, b);
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
+
+    // dE/dr
+    chemkit::Real de_dr = kb * (r - r0);
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real UffBondStrechCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                          const size_t *atoms,
+                                                          const chemkit::Real *parameters,
+                                                          chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+
+    chemkit::Real kb = parameters[0];
+    chemkit::Real r0 = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
 
     // dE/dr
     chemkit::Real de_dr = kb * (r - r0);
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+
+    return 0.5 * kb * pow(r - r0, 2);
+}
+
+chemkit::Real UffBondStrechCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> UffBondStrechCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+chemkit::Real UffBondStrechCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::ForceFieldCalculationBatch* UffBondStrechCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<UffBondStrechCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === UffAngleBendCalculation ============================================= //
@@ -210,44 +256,95 @@ bool UffAngleBendCalculation::setup()
     return true;
 }
 
-chemkit::Real UffAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real UffAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                              const size_t *atoms,
+                                              const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real c0 = parameter(1);
-    chemkit::Real c1 = parameter(2);
-    chemkit::Real c2 = parameter(3);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
 
     chemkit::Real theta = coordinates->angleRadians(a, b, c);
 
     return ka * (c0 + (c1 * cos(theta)) + (c2 * cos(2*theta)));
 }
 
-std::vector<chemkit::Vector3> UffAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void UffAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                       const size_t *atoms,
+                                       const chemkit::Real *parameters,
+                                       chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    chemkit::Real ka = parameter(0);
-    chemkit::Real c1 = parameter(2);
-    chemkit::Real c2 = parameter(3);
+    chemkit::Real ka = parameters[0];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
 
-    chemkit::Real theta = coordinates->angleRadians(a, b, c);
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real theta = coordinates->angleAndGradientRadians(a, b, c, angleGradient);
 
     // dE/dtheta
     chemkit::Real de_dtheta = -ka * (c1 * sin(theta) + 2 * c2 * sin(2 * theta));
 
-    boost::array<chemkit::Vector3, 3> gradient = coordinates->angleGradientRadians(a, b, c);
+    gradient[0] = angleGradient[0] * de_dtheta;
+    gradient[1] = angleGradient[1] * de_dtheta;
+    gradient[2] = angleGradient[2] * de_dtheta;
+}
 
-    gradient[0] *= de_dtheta;
-    gradient[1] *= de_dtheta;
-    gradient[2] *= de_dtheta;
+chemkit::Real UffAngleBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                         const size_t *atoms,
+                                                         const chemkit::Real *parameters,
+                                                         chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+    chemkit::Real ka = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
+
+    boost::array<chemkit::Vector3, 3> angleGradient;
+    chemkit::Real theta = coordinates->angleAndGradientRadians(a, b, c, angleGradient);
+
+    // dE/dtheta
+    chemkit::Real de_dtheta = -ka * (c1 * sin(theta) + 2 * c2 * sin(2 * theta));
+
+    gradient[0] = angleGradient[0] * de_dtheta;
+    gradient[1] = angleGradient[1] * de_dtheta;
+    gradient[2] = angleGradient[2] * de_dtheta;
+
+    return ka * (c0 + (c1 * cos(theta)) + (c2 * cos(2*theta)));
+}
+
+chemkit::Real UffAngleBendCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> UffAngleBendCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(3);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real UffAngleBendCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* UffAngleBendCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<UffAngleBendCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === UffTorsionCalculation =============================================== //
@@ -349,46 +446,98 @@ bool UffTorsionCalculation::setup()
     return true;
 }
 
-chemkit::Real UffTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real UffTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                            const size_t *atoms,
+                                            const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real V = parameter(0);
-    chemkit::Real n = parameter(1);
-    chemkit::Real phi0 = parameter(2);
+    chemkit::Real V = parameters[0];
+    chemkit::Real n = parameters[1];
+    chemkit::Real phi0 = parameters[2];
 
     chemkit::Real phi = coordinates->torsionAngleRadians(a, b, c, d);
 
     return 0.5 * V * (1 - cos(n * phi0) * cos(n * phi));
 }
 
-std::vector<chemkit::Vector3> UffTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void UffTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                     const size_t *atoms,
+                                     const chemkit::Real *parameters,
+                                     chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real V = parameter(0);
-    chemkit::Real n = parameter(1);
-    chemkit::Real phi0 = parameter(2);
+    chemkit::Real V = parameters[0];
+    chemkit::Real n = parameters[1];
+    chemkit::Real phi0 = parameters[2];
 
-    chemkit::Real phi = coordinates->torsionAngleRadians(a, b, c, d);
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradientRadians(a, b, c, d, torsionGradient);
 
     // dE/dphi
     chemkit::Real de_dphi = 0.5 * V * n * cos(n * phi0) * sin(n * phi);
 
-    boost::array<chemkit::Vector3, 4> gradient = coordinates->torsionAngleGradientRadians(a, b, c, d);
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
+}
+
+chemkit::Real UffTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                       const size_t *atoms,
+                                                       const chemkit::Real *parameters,
+                                                       chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    gradient[0] *= de_dphi;
-    gradient[1] *= de_dphi;
-    gradient[2] *= de_dphi;
-    gradient[3] *= de_dphi;
+    chemkit::Real V = parameters[0];
+    chemkit::Real n = parameters[1];
+    chemkit::Real phi0 = parameters[2];
+
+    boost::array<chemkit::Vector3, 4> torsionGradient;
+    chemkit::Real phi = coordinates->torsionAngleAndGradientRadians(a, b, c, d, torsionGradient);
+
+    // dE/dphi
+    chemkit::Real de_dphi = 0.5 * V * n * cos(n * phi0) * sin(n * phi);
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+    gradient[0] = torsionGradient[0] * de_dphi;
+    gradient[1] = torsionGradient[1] * de_dphi;
+    gradient[2] = torsionGradient[2] * de_dphi;
+    gradient[3] = torsionGradient[3] * de_dphi;
+
+    return 0.5 * V * (1 - cos(n * phi0) * cos(n * phi));
+}
+
+chemkit::Real UffTorsionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> UffTorsionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(4);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real UffTorsionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* UffTorsionCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<UffTorsionCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === UffInversionCalculation ============================================= //
@@ -447,17 +596,19 @@ bool UffInversionCalculation::setup()
     return true;
 }
 
-chemkit::Real UffInversionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real UffInversionCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                              const size_t *atoms,
+                                              const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real k = parameter(0);
-    chemkit::Real c0 = parameter(1);
-    chemkit::Real c1 = parameter(2);
-    chemkit::Real c2 = parameter(3);
+    chemkit::Real k = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
 
     chemkit::Real w = coordinates->wilsonAngleRadians(a, b, c, d);
     chemkit::Real y = w + (chemkit::constants::Pi / 2.0);
@@ -465,31 +616,83 @@ chemkit::Real UffInversionCalculation::energy(const chemkit::CartesianCoordinate
     return k * (c0 + c1 * sin(y) + c2 * cos(2 * y));
 }
 
-std::vector<chemkit::Vector3> UffInversionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void UffInversionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                       const size_t *atoms,
+                                       const chemkit::Real *parameters,
+                                       chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
-    size_t c = atom(2);
-    size_t d = atom(3);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
 
-    chemkit::Real k = parameter(0);
-    chemkit::Real c1 = parameter(2);
-    chemkit::Real c2 = parameter(3);
+    chemkit::Real k = parameters[0];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
 
-    chemkit::Real w = coordinates->wilsonAngleRadians(a, b, c, d);
+    boost::array<chemkit::Vector3, 4> wilsonGradient;
+    chemkit::Real w = coordinates->wilsonAngleAndGradientRadians(a, b, c, d, wilsonGradient);
     chemkit::Real y = w + (chemkit::constants::Pi / 2.0);
 
     // dE/dw
     chemkit::Real de_dw = k * (c1 * cos(y) - 2 * c2 * sin(2 * y));
 
-    boost::array<chemkit::Vector3, 4> gradient = coordinates->wilsonAngleGradientRadians(a, b, c, d);
+    gradient[0] = wilsonGradient[0] * de_dw;
+    gradient[1] = wilsonGradient[1] * de_dw;
+    gradient[2] = wilsonGradient[2] * de_dw;
+    gradient[3] = wilsonGradient[3] * de_dw;
+}
+
+chemkit::Real UffInversionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                         const size_t *atoms,
+                                                         const chemkit::Real *parameters,
+                                                         chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
+    size_t c = atoms[2];
+    size_t d = atoms[3];
+
+    chemkit::Real k = parameters[0];
+    chemkit::Real c0 = parameters[1];
+    chemkit::Real c1 = parameters[2];
+    chemkit::Real c2 = parameters[3];
+
+    boost::array<chemkit::Vector3, 4> wilsonGradient;
+    chemkit::Real w = coordinates->wilsonAngleAndGradientRadians(a, b, c, d, wilsonGradient);
+    chemkit::Real y = w + (chemkit::constants::Pi / 2.0);
+
+    // dE/dw
+    chemkit::Real de_dw = k * (c1 * cos(y) - 2 * c2 * sin(2 * y));
+
+    gradient[0] = wilsonGradient[0] * de_dw;
+    gradient[1] = wilsonGradient[1] * de_dw;
+    gradient[2] = wilsonGradient[2] * de_dw;
+    gradient[3] = wilsonGradient[3] * de_dw;
+
+    return k * (c0 + c1 * sin(y) + c2 * cos(2 * y));
+}
+
+chemkit::Real UffInversionCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> UffInversionCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(4);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
 
-    gradient[0] *= de_dw;
-    gradient[1] *= de_dw;
-    gradient[2] *= de_dw;
-    gradient[3] *= de_dw;
+chemkit::Real UffInversionCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+chemkit::ForceFieldCalculationBatch* UffInversionCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<UffInversionCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === UffVanDerWaalsCalculation =========================================== //
@@ -520,36 +723,82 @@ bool UffVanDerWaalsCalculation::setup()
     return true;
 }
 
-chemkit::Real UffVanDerWaalsCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+chemkit::Real UffVanDerWaalsCalculation::energy(const chemkit::CartesianCoordinates *coordinates,
+                                                const size_t *atoms,
+                                                const chemkit::Real *parameters)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real d = parameter(0);
-    chemkit::Real x = parameter(1);
+    chemkit::Real d = parameters[0];
+    chemkit::Real x = parameters[1];
     chemkit::Real r = coordinates->distance(a, b);
 
     return d * (-2 * pow(x/r, 6) + pow(x/r, 12));
 }
 
-std::vector<chemkit::Vector3> UffVanDerWaalsCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+void UffVanDerWaalsCalculation::gradient(const chemkit::CartesianCoordinates *coordinates,
+                                         const size_t *atoms,
+                                         const chemkit::Real *parameters,
+                                         chemkit::Vector3 *gradient)
 {
-    size_t a = atom(0);
-    size_t b = atom(1);
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    chemkit::Real d = parameter(0);
-    chemkit::Real x = parameter(1);
-    chemkit::Real r = coordinates->distance(a, b);
+    chemkit::Real d = parameters[0];
+    chemkit::Real x = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
 
     // dE/dr
     chemkit::Real de_dr = -12 * d * x / pow(r, 2) * (pow(x/r, 11) - pow(x/r, 5));
 
-    boost::array<chemkit::Vector3, 2> gradient = coordinates->distanceGradient(a, b);
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+}
+
+chemkit::Real UffVanDerWaalsCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates,
+                                                           const size_t *atoms,
+                                                           const chemkit::Real *parameters,
+                                                           chemkit::Vector3 *gradient)
+{
+    size_t a = atoms[0];
+    size_t b = atoms[1];
 
-    gradient[0] *= de_dr;
-    gradient[1] *= de_dr;
+    chemkit::Real d = parameters[0];
+    chemkit::Real x = parameters[1];
+    boost::array<chemkit::Vector3, 2> distanceGradient;
+    chemkit::Real r = coordinates->distanceAndGradient(a, b, distanceGradient);
 
-    return std::vector<chemkit::Vector3>(gradient.begin(), gradient.end());
+    // dE/dr
+    chemkit::Real de_dr = -12 * d * x / pow(r, 2) * (pow(x/r, 11) - pow(x/r, 5));
+
+    gradient[0] = distanceGradient[0] * de_dr;
+    gradient[1] = distanceGradient[1] * de_dr;
+
+    return d * (-2 * pow(x/r, 6) + pow(x/r, 12));
+}
+
+chemkit::Real UffVanDerWaalsCalculation::energy(const chemkit::CartesianCoordinates *coordinates) const
+{
+    return energy(coordinates, atomData(), parameterData());
+}
+
+std::vector<chemkit::Vector3> UffVanDerWaalsCalculation::gradient(const chemkit::CartesianCoordinates *coordinates) const
+{
+    std::vector<chemkit::Vector3> atomGradients(2);
+    gradient(coordinates, atomData(), parameterData(), &atomGradients[0]);
+    return atomGradients;
+}
+
+chemkit::Real UffVanDerWaalsCalculation::energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const
+{
+    return energyAndGradient(coordinates, atomData(), parameterData(), gradient);
+}
+
+chemkit::ForceFieldCalculationBatch* UffVanDerWaalsCalculation::createBatch() const
+{
+    return new chemkit::ForceFieldCalculationBatchAdaptor<UffVanDerWaalsCalculation>(type(), atomCount(), parameterCount());
 }
 
 // === UffElectrostaticCalculation ========================================= //
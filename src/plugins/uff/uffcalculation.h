@@ -37,6 +37,7 @@
 #define UFFCALCULATION_H
 
 #include <chemkit/forcefieldcalculation.h>
+#include <chemkit/forcefieldcalculationbatch.h>
 
 #include "uffparameters.h"
 
@@ -61,6 +62,14 @@ public:
     bool setup();
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class UffAngleBendCalculation : public UffCalculation
@@ -71,6 +80,14 @@ public:
     bool setup();
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class UffTorsionCalculation : public UffCalculation
@@ -81,6 +98,14 @@ public:
     bool setup();
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class UffInversionCalculation : public UffCalculation
@@ -91,6 +116,14 @@ public:
     bool setup();
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class UffVanDerWaalsCalculation : public UffCalculation
@@ -101,6 +134,14 @@ public:
     bool setup();
     chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
     std::vector<chemkit::Vector3> gradient(const chemkit::CartesianCoordinates *coordinates) const CHEMKIT_OVERRIDE;
+    chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, chemkit::Vector3 *gradient) const CHEMKIT_OVERRIDE;
+
+    static chemkit::Real energy(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters);
+    static void gradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+    static chemkit::Real energyAndGradient(const chemkit::CartesianCoordinates *coordinates, const size_t *atoms, const chemkit::Real *parameters, chemkit::Vector3 *gradient);
+
+protected:
+    chemkit::ForceFieldCalculationBatch* createBatch() const CHEMKIT_OVERRIDE;
 };
 
 class UffElectrostaticCalculation : public UffCalculation
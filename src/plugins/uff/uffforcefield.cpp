@@ -125,16 +125,18 @@ bool UffForceField::setup()
         }
     }
 
-    // van der waals
-    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
-        addCalculation(new UffVanDerWaalsCalculation(interaction[0],
-                                                     interaction[1]));
+    // van der waals (with a nonbonded cutoff these are created from
+    // the neighbor list instead)
+    if(nonbondedCutoff() == 0){
+        foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+            addNonbondedCalculations(interaction[0], interaction[1]);
+        }
     }
 
     bool ok = true;
 
     foreach(chemkit::ForceFieldCalculation *calculation, calculations()){
-        bool setup = static_cast<UffCalculation *>(calculation)->setup();
+        bool setup = setupCalculation(calculation);
 
         if(!setup){
             ok = false;
@@ -146,6 +148,16 @@ bool UffForceField::setup()
     return ok;
 }
 
+void UffForceField::addNonbondedCalculations(size_t a, size_t b)
+{
+    addCalculation(new UffVanDerWaalsCalculation(a, b));
+}
+
+bool UffForceField::setupCalculation(chemkit::ForceFieldCalculation *calculation)
+{
+    return static_cast<UffCalculation *>(calculation)->setup();
+}
+
 /// Returns \c true if \p atom is in group six of the periodic table.
 bool UffForceField::isGroupSix(size_t atom) const
 {
@@ -55,6 +55,10 @@ public:
 
     bool isGroupSix(size_t atom) const;
 
+protected:
+    void addNonbondedCalculations(size_t a, size_t b) CHEMKIT_OVERRIDE;
+    bool setupCalculation(chemkit::ForceFieldCalculation *calculation) CHEMKIT_OVERRIDE;
+
 private:
     UffParameters *m_parameters;
 };
@@ -35,55 +35,10 @@
 
 #include "wienerindexdescriptor.h"
 
-#include <set>
-#include <vector>
-
 #include <chemkit/atom.h>
-#include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
-
-namespace {
-
-// Returns the graph distance between the two atoms.
-int distanceBetween(const chemkit::Atom *a, const chemkit::Atom *b)
-{
-    int distance = 0;
-
-    std::set<const chemkit::Atom*> visited;
-
-    std::vector<const chemkit::Atom*> row;
-    row.push_back(a);
-
-    while(!row.empty()){
-        std::vector<const chemkit::Atom*> nextRow;
-
-        foreach(const chemkit::Atom *atom, row){
-            if(atom == b){
-                return distance;
-            }
-
-            visited.insert(atom);
-
-            foreach(const chemkit::Atom *neighbor, atom->neighbors()){
-                if(visited.find(neighbor) != visited.end()){
-                    continue;
-                }
-                else if(neighbor->isTerminalHydrogen()){
-                    continue;
-                }
-
-                nextRow.push_back(neighbor);
-            }
-        }
-
-        row = nextRow;
-        distance++;
-    }
-
-    return 0;
-}
-
-} // end anonymous namespace
+#include <chemkit/moleculardescriptorcontext.h>
+#include <chemkit/topologicaldistancematrix.h>
 
 WienerIndexDescriptor::WienerIndexDescriptor()
     : chemkit::MolecularDescriptor("wiener-index")
@@ -98,6 +53,18 @@ WienerIndexDescriptor::~WienerIndexDescriptor()
 // Returns the wiener index for the molecule.
 chemkit::Variant WienerIndexDescriptor::value(const chemkit::Molecule *molecule) const
 {
+    chemkit::MolecularDescriptorContext context(molecule);
+
+    return value(&context);
+}
+
+chemkit::Variant WienerIndexDescriptor::value(chemkit::MolecularDescriptorContext *context) const
+{
+    const chemkit::Molecule *molecule = context->molecule();
+    const chemkit::TopologicalDistanceMatrix *distances = context->distanceMatrix();
+
+    // terminal hydrogens are never between two other atoms so
+    // ignoring them does not change the distances between the others
     int index = 0;
 
     for(size_t i = 0; i < molecule->atomCount(); i++){
@@ -112,7 +79,7 @@ chemkit::Variant WienerIndexDescriptor::value(const chemkit::Molecule *molecule)
                 continue;
             }
 
-            index += distanceBetween(a, b);
+            index += static_cast<int>(distances->distance(i, j));
         }
     }
 
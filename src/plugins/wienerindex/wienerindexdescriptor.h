@@ -46,6 +46,7 @@ public:
     ~WienerIndexDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
+    chemkit::Variant value(chemkit::MolecularDescriptorContext *context) const CHEMKIT_OVERRIDE;
 };
 
 #endif // WIENERINDEXDESCRIPTOR_H
@@ -0,0 +1,448 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "xtcdecoder.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+
+namespace {
+
+// The xtc compression algorithm is the one used by xdr3dfcoord() in
+// the xdrf library. It is reimplemented here to read from memory
+// without going through an XDR stream and without the static state
+// used by xdr3dfcoord().
+
+const int magicints[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+    8, 10, 12, 16, 20, 25, 32, 40, 50, 64,
+    80, 101, 128, 161, 203, 256, 322, 406, 512, 645,
+    812, 1024, 1290, 1625, 2048, 2580, 3250, 4096, 5060, 6501,
+    8192, 10321, 13003, 16384, 20642, 26007, 32768, 41285, 52015, 65536,
+    82570, 104031, 131072, 165140, 208063, 262144, 330280, 416127, 524287, 660561,
+    832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021, 4194304, 5284491, 6658042,
+    8388607, 10568983, 13316085, 16777216
+};
+
+const int FirstIndex = 9;
+const int LastIndex = sizeof(magicints) / sizeof(*magicints);
+
+const int XtcMagic = 1995;
+
+// size of the frame header (magic, atom count, step, time and box)
+const size_t HeaderSize = 13 * 4;
+
+// size of the compressed coordinate header (atom count, precision,
+// minimum and maximum integers, small index and byte count)
+const size_t CompressedHeaderSize = 10 * 4;
+
+// Reads packed bit fields from the compressed coordinate data.
+class BitReader
+{
+public:
+    BitReader(const unsigned char *data, size_t size)
+        : m_data(data),
+          m_size(size),
+          m_count(0),
+          m_lastBits(0),
+          m_lastByte(0),
+          m_overrun(false)
+    {
+    }
+
+    int receiveBits(int bitCount)
+    {
+        int mask = (1 << bitCount) - 1;
+        int value = 0;
+
+        while(bitCount >= 8){
+            m_lastByte = (m_lastByte << 8) | nextByte();
+            value |= (m_lastByte >> m_lastBits) << (bitCount - 8);
+            bitCount -= 8;
+        }
+
+        if(bitCount > 0){
+            if(m_lastBits < static_cast<unsigned int>(bitCount)){
+                m_lastBits += 8;
+                m_lastByte = (m_lastByte << 8) | nextByte();
+            }
+
+            m_lastBits -= bitCount;
+            value |= (m_lastByte >> m_lastBits) & ((1 << bitCount) - 1);
+        }
+
+        return value & mask;
+    }
+
+    void receiveInts(int bitCount, const unsigned int sizes[3], int values[3])
+    {
+        int bytes[32];
+        bytes[1] = bytes[2] = bytes[3] = 0;
+
+        int byteCount = 0;
+        while(bitCount > 8){
+            bytes[byteCount++] = receiveBits(8);
+            bitCount -= 8;
+        }
+        if(bitCount > 0){
+            bytes[byteCount++] = receiveBits(bitCount);
+        }
+
+        for(int i = 2; i > 0; i--){
+            unsigned int value = 0;
+            for(int j = byteCount - 1; j >= 0; j--){
+                value = (value << 8) | bytes[j];
+                unsigned int quotient = value / sizes[i];
+                bytes[j] = quotient;
+                value = value - quotient * sizes[i];
+            }
+            values[i] = value;
+        }
+
+        values[0] = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
+    }
+
+    bool overrun() const
+    {
+        return m_overrun;
+    }
+
+private:
+    unsigned int nextByte()
+    {
+        if(m_count >= m_size){
+            m_overrun = true;
+            return 0;
+        }
+
+        return m_data[m_count++];
+    }
+
+private:
+    const unsigned char *m_data;
+    size_t m_size;
+    size_t m_count;
+    unsigned int m_lastBits;
+    unsigned int m_lastByte;
+    bool m_overrun;
+};
+
+// Returns the number of bits needed to store values up to size.
+int sizeOfInt(unsigned int size)
+{
+    unsigned int value = 1;
+    int bitCount = 0;
+
+    while(size >= value && bitCount < 32){
+        bitCount++;
+        value <<= 1;
+    }
+
+    return bitCount;
+}
+
+// Returns the number of bits needed to store three values packed
+// with the given sizes.
+int sizeOfInts(const unsigned int sizes[3])
+{
+    unsigned int bytes[32];
+    unsigned int byteCount = 1;
+    bytes[0] = 1;
+
+    for(int i = 0; i < 3; i++){
+        unsigned int carry = 0;
+        unsigned int byte;
+        for(byte = 0; byte < byteCount; byte++){
+            carry = bytes[byte] * sizes[i] + carry;
+            bytes[byte] = carry & 0xff;
+            carry >>= 8;
+        }
+        while(carry != 0){
+            bytes[byte++] = carry & 0xff;
+            carry >>= 8;
+        }
+        byteCount = byte;
+    }
+
+    int bitCount = 0;
+    unsigned int value = 1;
+    byteCount--;
+    while(bytes[byteCount] >= value){
+        bitCount++;
+        value *= 2;
+    }
+
+    return bitCount + byteCount * 8;
+}
+
+} // end anonymous namespace
+
+XtcDecoder::XtcDecoder(const char *data, size_t size)
+    : m_data(reinterpret_cast<const unsigned char *>(data)),
+      m_size(size)
+{
+}
+
+// Returns the size in bytes of the frame starting at offset or zero
+// if there is no valid frame at offset. Only the frame headers are
+// read, the coordinates are not decompressed.
+size_t XtcDecoder::frameSize(size_t offset) const
+{
+    if(offset + HeaderSize + 4 > m_size || readInt(offset) != XtcMagic){
+        return 0;
+    }
+
+    int atomCount = readInt(offset + 4);
+    if(atomCount < 0 || readInt(offset + HeaderSize) != atomCount){
+        return 0;
+    }
+
+    size_t size = 0;
+    if(atomCount <= 9){
+        size = HeaderSize + 4 + 3 * 4 * atomCount;
+    }
+    else{
+        if(offset + HeaderSize + CompressedHeaderSize > m_size){
+            return 0;
+        }
+
+        int byteCount = readInt(offset + HeaderSize + CompressedHeaderSize - 4);
+        if(byteCount < 0){
+            return 0;
+        }
+
+        // opaque data is padded to a multiple of four bytes
+        size = HeaderSize + CompressedHeaderSize + ((size_t(byteCount) + 3) & ~size_t(3));
+    }
+
+    if(offset + size > m_size){
+        return 0;
+    }
+
+    return size;
+}
+
+// Returns the number of atoms in the frame at offset.
+int XtcDecoder::atomCount(size_t offset) const
+{
+    return readInt(offset + 4);
+}
+
+// Decodes the frame at offset into frame. Coordinates are stored in
+// nanometers as in the file.
+bool XtcDecoder::decode(size_t offset, XtcFrame &frame) const
+{
+    size_t size = frameSize(offset);
+    if(size == 0){
+        return false;
+    }
+
+    int atomCount = readInt(offset + 4);
+    frame.step = readInt(offset + 8);
+    frame.time = readFloat(offset + 12);
+    for(int i = 0; i < 9; i++){
+        frame.box[i] = readFloat(offset + 16 + 4 * i);
+    }
+
+    frame.coordinates.resize(3 * atomCount);
+    if(atomCount == 0){
+        return true;
+    }
+
+    // small systems are stored uncompressed
+    if(atomCount <= 9){
+        for(int i = 0; i < 3 * atomCount; i++){
+            frame.coordinates[i] = readFloat(offset + HeaderSize + 4 + 4 * i);
+        }
+
+        return true;
+    }
+
+    size_t position = offset + HeaderSize + 4;
+    float precision = readFloat(position);
+    int minInt[3];
+    int maxInt[3];
+    for(int i = 0; i < 3; i++){
+        minInt[i] = readInt(position + 4 + 4 * i);
+        maxInt[i] = readInt(position + 16 + 4 * i);
+    }
+    int smallIndex = readInt(position + 28);
+    int byteCount = readInt(position + 32);
+
+    if(smallIndex < FirstIndex || smallIndex >= LastIndex || precision == 0){
+        return false;
+    }
+
+    unsigned int sizeInt[3];
+    unsigned int bitSizeInt[3];
+    int bitSize = 0;
+    for(int i = 0; i < 3; i++){
+        sizeInt[i] = maxInt[i] - minInt[i] + 1;
+    }
+
+    // large ranges are stored as separate bit fields
+    if((sizeInt[0] | sizeInt[1] | sizeInt[2]) > 0xffffff){
+        for(int i = 0; i < 3; i++){
+            bitSizeInt[i] = sizeOfInt(sizeInt[i]);
+        }
+    }
+    else{
+        bitSize = sizeOfInts(sizeInt);
+    }
+
+    int smaller = magicints[std::max(FirstIndex, smallIndex - 1)] / 2;
+    int small = magicints[smallIndex] / 2;
+    unsigned int sizeSmall[3];
+    sizeSmall[0] = sizeSmall[1] = sizeSmall[2] = magicints[smallIndex];
+
+    BitReader reader(m_data + position + 36, byteCount);
+    float inversePrecision = 1.0f / precision;
+    float *output = &frame.coordinates[0];
+    int run = 0;
+    int i = 0;
+
+    while(i < atomCount){
+        int coordinate[3];
+        if(bitSize == 0){
+            for(int j = 0; j < 3; j++){
+                coordinate[j] = reader.receiveBits(bitSizeInt[j]);
+            }
+        }
+        else{
+            reader.receiveInts(bitSize, sizeInt, coordinate);
+        }
+
+        i++;
+        for(int j = 0; j < 3; j++){
+            coordinate[j] += minInt[j];
+        }
+
+        int previous[3] = { coordinate[0], coordinate[1], coordinate[2] };
+
+        int isSmaller = 0;
+        if(reader.receiveBits(1) == 1){
+            run = reader.receiveBits(5);
+            isSmaller = run % 3;
+            run -= isSmaller;
+            isSmaller--;
+        }
+
+        if(run > 0){
+            if(i + run / 3 > atomCount){
+                return false;
+            }
+
+            for(int k = 0; k < run; k += 3){
+                reader.receiveInts(smallIndex, sizeSmall, coordinate);
+                i++;
+
+                for(int j = 0; j < 3; j++){
+                    coordinate[j] += previous[j] - small;
+                }
+
+                if(k == 0){
+                    // the first two atoms are swapped to improve the
+                    // compression of water molecules
+                    for(int j = 0; j < 3; j++){
+                        std::swap(coordinate[j], previous[j]);
+                        *output++ = previous[j] * inversePrecision;
+                    }
+                }
+                else{
+                    for(int j = 0; j < 3; j++){
+                        previous[j] = coordinate[j];
+                    }
+                }
+
+                for(int j = 0; j < 3; j++){
+                    *output++ = coordinate[j] * inversePrecision;
+                }
+            }
+        }
+        else{
+            for(int j = 0; j < 3; j++){
+                *output++ = coordinate[j] * inversePrecision;
+            }
+        }
+
+        smallIndex += isSmaller;
+        if(smallIndex < FirstIndex || smallIndex >= LastIndex){
+            return false;
+        }
+
+        if(isSmaller < 0){
+            small = smaller;
+            if(smallIndex > FirstIndex){
+                smaller = magicints[smallIndex - 1] / 2;
+            }
+            else{
+                smaller = 0;
+            }
+        }
+        else if(isSmaller > 0){
+            smaller = small;
+            small = magicints[smallIndex] / 2;
+        }
+
+        sizeSmall[0] = sizeSmall[1] = sizeSmall[2] = magicints[smallIndex];
+    }
+
+    return !reader.overrun();
+}
+
+// Reads a big-endian 32-bit integer.
+int XtcDecoder::readInt(size_t offset) const
+{
+    const unsigned char *p = m_data + offset;
+
+    boost::uint32_t value = (boost::uint32_t(p[0]) << 24) |
+                            (boost::uint32_t(p[1]) << 16) |
+                            (boost::uint32_t(p[2]) << 8) |
+                            (boost::uint32_t(p[3]));
+
+    return static_cast<boost::int32_t>(value);
+}
+
+// Reads a big-endian 32-bit IEEE float.
+float XtcDecoder::readFloat(size_t offset) const
+{
+    boost::uint32_t value = static_cast<boost::uint32_t>(readInt(offset));
+
+    float result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef XTCDECODER_H
+#define XTCDECODER_H
+
+#include <vector>
+#include <cstddef>
+
+// Contains the data for a single decoded xtc frame.
+struct XtcFrame
+{
+    int step;
+    float time;
+    float box[9];
+    std::vector<float> coordinates;
+};
+
+// Decodes xtc frames directly from a buffer holding the contents of
+// an xtc file (e.g. a memory mapped file). The decoder does not copy
+// or modify the buffer and may be shared between threads.
+class XtcDecoder
+{
+public:
+    XtcDecoder(const char *data, size_t size);
+
+    size_t frameSize(size_t offset) const;
+    int atomCount(size_t offset) const;
+    bool decode(size_t offset, XtcFrame &frame) const;
+
+private:
+    int readInt(size_t offset) const;
+    float readFloat(size_t offset) const;
+
+private:
+    const unsigned char *m_data;
+    size_t m_size;
+};
+
+#endif // XTCDECODER_H
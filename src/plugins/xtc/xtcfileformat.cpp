@@ -1,6 +1,6 @@
 /******************************************************************************
 **
-** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
 ** All rights reserved.
 **
 ** This file is a part of the chemkit project. For more information
@@ -35,19 +35,17 @@
 
 #include "xtcfileformat.h"
 
-#include <boost/filesystem.hpp>
+#include <iterator>
+
 #include <boost/make_shared.hpp>
 
-#include <rpc/xdr.h>
-#include <rpc/types.h>
 #include <chemkit/vector3.h>
 #include <chemkit/unitcell.h>
 #include <chemkit/trajectory.h>
 #include <chemkit/trajectoryfile.h>
 #include <chemkit/trajectoryframe.h>
-#include <chemkit/cartesiancoordinates.h>
 
-#include "../../3rdparty/xdrf/xdrf.h"
+#include "xtcdecoder.h"
 
 XtcFileFormat::XtcFileFormat()
     : chemkit::TrajectoryFileFormat("xtc")
@@ -56,88 +54,122 @@ XtcFileFormat::XtcFileFormat()
 
 bool XtcFileFormat::read(std::istream &input, chemkit::TrajectoryFile *file)
 {
-    // read data into temporary file
-    std::string tempFileName = (boost::filesystem::temp_directory_path() /
-                                boost::filesystem::unique_path()).string();
+    // streams (e.g. compressed files) are read into memory and
+    // decoded in place
+    std::vector<char> data((std::istreambuf_iterator<char>(input)),
+                           std::istreambuf_iterator<char>());
 
-    std::ofstream ostream(tempFileName.c_str());
-    ostream << input.rdbuf();
-    size_t dataSize = ostream.tellp();
-    ostream.close();
+    if(data.empty()){
+        setErrorString("File is empty.");
+        return false;
+    }
 
-    XDR xdrs;
-    xdropen(&xdrs, tempFileName.c_str(), "r");
+    return read(&data[0], data.size(), file);
+}
 
-    boost::shared_ptr<chemkit::Trajectory> trajectory = boost::make_shared<chemkit::Trajectory>();
+bool XtcFileFormat::readMappedFile(const boost::iostreams::mapped_file_source &input, chemkit::TrajectoryFile *file)
+{
+    return read(input.data(), input.size(), file);
+}
 
-    while(xdr_getpos(&xdrs) < dataSize){
-        // read magic (should be '1995')
-        int magic = 0;
-        xdr_int(&xdrs, &magic);
-        if(magic != 1995){
-            break;
-        }
+bool XtcFileFormat::supportsFrameAccess() const
+{
+    return true;
+}
 
-        // read atom count
-        int atomCount = 0;
-        xdr_int(&xdrs, &atomCount);
+bool XtcFileFormat::readFrameOffsets(const boost::iostreams::mapped_file_source &input, const chemkit::TrajectoryFile *file, std::vector<size_t> &offsets)
+{
+    CHEMKIT_UNUSED(file);
 
-        // set trajectory size
-        if(trajectory->isEmpty() || trajectory->size() < size_t(atomCount)){
-            trajectory->resize(atomCount);
-        }
+    return readFrameOffsets(XtcDecoder(input.data(), input.size()), input.size(), offsets);
+}
 
-        // create new frame
-        chemkit::TrajectoryFrame *frame = trajectory->addFrame();
+bool XtcFileFormat::readFrame(const boost::iostreams::mapped_file_source &input, size_t offset, chemkit::TrajectoryFrame *frame)
+{
+    return readFrame(XtcDecoder(input.data(), input.size()), offset, frame);
+}
 
-        // read frame number
-        int frameNumber = 0;
-        xdr_int(&xdrs, &frameNumber);
+bool XtcFileFormat::read(const char *data, size_t size, chemkit::TrajectoryFile *file)
+{
+    XtcDecoder decoder(data, size);
 
-        // read time
-        float time = 0;
-        xdr_float(&xdrs, &time);
+    std::vector<size_t> offsets;
+    if(!readFrameOffsets(decoder, size, offsets)){
+        return false;
+    }
 
-        // read unit cell
-        float box[3][3];
-        for(int i = 0; i < 3; i++){
-            for(int j = 0; j < 3; j++){
-                xdr_float(&xdrs, &box[i][j]);
-            }
-        }
+    boost::shared_ptr<chemkit::Trajectory> trajectory = boost::make_shared<chemkit::Trajectory>();
 
-        chemkit::Vector3 x(box[0][0], box[0][1], box[0][2]);
-        chemkit::Vector3 y(box[1][0], box[1][1], box[1][2]);
-        chemkit::Vector3 z(box[2][0], box[2][1], box[2][2]);
+    for(size_t i = 0; i < offsets.size(); i++){
+        chemkit::TrajectoryFrame *frame = trajectory->addFrame();
 
-        frame->setUnitCell(new chemkit::UnitCell(x * 10, y * 10, z * 10));
+        if(!readFrame(decoder, offsets[i], frame)){
+            return false;
+        }
+    }
 
-        // read coordinates
-        std::vector<float> coordinateData(3 * atomCount);
-        float precision = 1000.0f;
-        xdr3dfcoord(&xdrs, &coordinateData[0], &atomCount, &precision);
+    file->setTrajectory(trajectory);
 
-        for(int i = 0; i < atomCount; i++){
-            // multiply each coordinate by 10 to convert
-            // from nanometers to angstroms
-            chemkit::Point3 position(coordinateData[i*3+0] * 10,
-                                     coordinateData[i*3+1] * 10,
-                                     coordinateData[i*3+2] * 10);
+    return true;
+}
 
-            frame->setPosition(i, position);
+bool XtcFileFormat::readFrameOffsets(const XtcDecoder &decoder, size_t size, std::vector<size_t> &offsets)
+{
+    offsets.clear();
+
+    // walk the frame headers, the coordinates are skipped using the
+    // compressed data size stored in each frame
+    size_t offset = 0;
+    while(offset < size){
+        size_t frameSize = decoder.frameSize(offset);
+        if(frameSize == 0){
+            break;
         }
+
+        offsets.push_back(offset);
+        offset += frameSize;
     }
 
-    xdrclose(&xdrs);
+    if(offsets.empty()){
+        setErrorString("File contains no valid frames.");
+        return false;
+    }
 
-    // remove temp file
-    boost::filesystem::remove(tempFileName);
+    return true;
+}
 
-    if(trajectory->isEmpty()){
+bool XtcFileFormat::readFrame(const XtcDecoder &decoder, size_t offset, chemkit::TrajectoryFrame *frame)
+{
+    XtcFrame data;
+    if(!decoder.decode(offset, data)){
+        setErrorString("Failed to decode frame.");
         return false;
     }
 
-    file->setTrajectory(trajectory);
+    size_t atomCount = data.coordinates.size() / 3;
+
+    // set trajectory size
+    chemkit::Trajectory *trajectory = frame->trajectory();
+    if(trajectory->size() < atomCount){
+        trajectory->resize(atomCount);
+    }
+
+    frame->setTime(data.time);
+
+    // multiply each value by 10 to convert from nanometers to angstroms
+    chemkit::Vector3 x(data.box[0], data.box[1], data.box[2]);
+    chemkit::Vector3 y(data.box[3], data.box[4], data.box[5]);
+    chemkit::Vector3 z(data.box[6], data.box[7], data.box[8]);
+
+    frame->setUnitCell(new chemkit::UnitCell(x * 10, y * 10, z * 10));
+
+    for(size_t i = 0; i < atomCount; i++){
+        chemkit::Point3 position(data.coordinates[i*3+0] * 10,
+                                 data.coordinates[i*3+1] * 10,
+                                 data.coordinates[i*3+2] * 10);
+
+        frame->setPosition(i, position);
+    }
 
     return true;
 }
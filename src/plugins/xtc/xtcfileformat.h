@@ -1,6 +1,6 @@
 /******************************************************************************
 **
-** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
 ** All rights reserved.
 **
 ** This file is a part of the chemkit project. For more information
@@ -38,12 +38,23 @@
 
 #include <chemkit/trajectoryfileformat.h>
 
+class XtcDecoder;
+
 class XtcFileFormat : public chemkit::TrajectoryFileFormat
 {
 public:
     XtcFileFormat();
 
-    bool read(std::istream &input, chemkit::TrajectoryFile *file);
+    bool read(std::istream &input, chemkit::TrajectoryFile *file) CHEMKIT_OVERRIDE;
+    bool readMappedFile(const boost::iostreams::mapped_file_source &input, chemkit::TrajectoryFile *file) CHEMKIT_OVERRIDE;
+    bool supportsFrameAccess() const CHEMKIT_OVERRIDE;
+    bool readFrameOffsets(const boost::iostreams::mapped_file_source &input, const chemkit::TrajectoryFile *file, std::vector<size_t> &offsets) CHEMKIT_OVERRIDE;
+    bool readFrame(const boost::iostreams::mapped_file_source &input, size_t offset, chemkit::TrajectoryFrame *frame) CHEMKIT_OVERRIDE;
+
+private:
+    bool read(const char *data, size_t size, chemkit::TrajectoryFile *file);
+    bool readFrameOffsets(const XtcDecoder &decoder, size_t size, std::vector<size_t> &offsets);
+    bool readFrame(const XtcDecoder &decoder, size_t offset, chemkit::TrajectoryFrame *frame);
 };
 
 #endif // XTCFILEFORMAT_H
@@ -36,7 +36,9 @@
 #include "xyzfileformat.h"
 
 #include <cstdio>
+#include <limits>
 #include <iomanip>
+#include <algorithm>
 
 #include <boost/make_shared.hpp>
 
@@ -45,6 +47,7 @@
 #include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/moleculebuilder.h>
 
 XyzFileFormat::XyzFileFormat()
     : chemkit::MoleculeFileFormat("xyz")
@@ -53,49 +56,7 @@ XyzFileFormat::XyzFileFormat()
 
 bool XyzFileFormat::read(std::istream &input, chemkit::MoleculeFile *file)
 {
-    // atom count line
-    int atomCount = 0;
-    input >> atomCount;
-    input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-    // comment line (unused)
-    std::string commentLine;
-    std::getline(input, commentLine);
-    CHEMKIT_UNUSED(commentLine);
-
-    // create molecule
-    boost::shared_ptr<chemkit::Molecule> molecule(new chemkit::Molecule);
-
-    // read atoms and coordinates
-    for(int i = 0; i < atomCount; i++){
-        std::string symbol;
-        double x = 0;
-        double y = 0;
-        double z = 0;
-
-        input >> symbol >> x >> y >> z;
-        if(input.fail()){
-            input.clear();
-        }
-
-        // add atom from symbol or atomic number
-        chemkit::Atom *atom = 0;
-        if(symbol.empty()){
-            continue;
-        }
-        else if(isdigit(symbol.at(0))){
-            int atomicNumber = boost::lexical_cast<int>(symbol);
-            atom = molecule->addAtom(atomicNumber);
-        }
-        else{
-            atom = molecule->addAtom(symbol);
-        }
-
-        // set atom position
-        if(atom){
-            atom->setPosition(x, y, z);
-        }
-    }
+    boost::shared_ptr<chemkit::Molecule> molecule = readMolecule(input);
 
     // add molecule to file
     file->addMolecule(molecule);
@@ -124,6 +85,11 @@ bool XyzFileFormat::readMappedFile(const boost::iostreams::mapped_file_source &i
     // create molecule
     boost::shared_ptr<chemkit::Molecule> molecule = boost::make_shared<chemkit::Molecule>();
 
+    std::vector<chemkit::Element> elements;
+    std::vector<chemkit::Point3> positions;
+    elements.reserve(atomCount);
+    positions.reserve(atomCount);
+
     // read atoms and coordinates
     for(unsigned int i = 0; i < atomCount; i++){
         char symbol[4];
@@ -136,31 +102,60 @@ bool XyzFileFormat::readMappedFile(const boost::iostreams::mapped_file_source &i
         }
         while(data[position++] != '\n');
 
-        chemkit::Atom *atom = 0;
         if(strlen(symbol) == 0){
             continue;
         }
         else if(isdigit(symbol[0])){
             chemkit::Element::AtomicNumberType atomicNumber =
                 boost::lexical_cast<chemkit::Element::AtomicNumberType>(symbol);
-            atom = molecule->addAtom(atomicNumber);
+            elements.push_back(chemkit::Element(atomicNumber));
         }
         else{
-            atom = molecule->addAtom(symbol);
+            elements.push_back(chemkit::Element(symbol));
         }
 
-        // set atom position
-        if(atom){
-            atom->setPosition(x, y, z);
-        }
+        positions.push_back(chemkit::Point3(x, y, z));
     }
 
+    // add atoms to the molecule
+    chemkit::MoleculeBuilder builder(molecule.get());
+    builder.addAtoms(elements, positions);
+    builder.commit();
+
     // add molecule to file
     file->addMolecule(molecule);
 
     return true;
 }
 
+bool XyzFileFormat::supportsReadNext() const
+{
+    return true;
+}
+
+bool XyzFileFormat::readNext(std::istream &input, boost::shared_ptr<chemkit::Molecule> &molecule)
+{
+    molecule.reset();
+
+    // skip any blank lines between molecules
+    input >> std::ws;
+    if(input.eof()){
+        return true;
+    }
+
+    molecule = readMolecule(input);
+    if(input.fail()){
+        setErrorString("Failed to read atom count line");
+        molecule.reset();
+        return false;
+    }
+
+    // skip to the end of the last atom line
+    input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    return true;
+}
+
 bool XyzFileFormat::write(const chemkit::MoleculeFile *file, std::ostream &output)
 {
     boost::shared_ptr<chemkit::Molecule> molecule = file->molecule();
@@ -187,3 +182,58 @@ bool XyzFileFormat::write(const chemkit::MoleculeFile *file, std::ostream &outpu
 
     return true;
 }
+
+boost::shared_ptr<chemkit::Molecule> XyzFileFormat::readMolecule(std::istream &input)
+{
+    // atom count line
+    int atomCount = 0;
+    input >> atomCount;
+    input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    // comment line (unused)
+    std::string commentLine;
+    std::getline(input, commentLine);
+    CHEMKIT_UNUSED(commentLine);
+
+    // create molecule
+    boost::shared_ptr<chemkit::Molecule> molecule(new chemkit::Molecule);
+
+    std::vector<chemkit::Element> elements;
+    std::vector<chemkit::Point3> positions;
+    elements.reserve(std::max(atomCount, 0));
+    positions.reserve(std::max(atomCount, 0));
+
+    // read atoms and coordinates
+    for(int i = 0; i < atomCount; i++){
+        std::string symbol;
+        double x = 0;
+        double y = 0;
+        double z = 0;
+
+        input >> symbol >> x >> y >> z;
+        if(input.fail()){
+            input.clear();
+        }
+
+        // element from symbol or atomic number
+        if(symbol.empty()){
+            continue;
+        }
+        else if(isdigit(symbol.at(0))){
+            int atomicNumber = boost::lexical_cast<int>(symbol);
+            elements.push_back(chemkit::Element(atomicNumber));
+        }
+        else{
+            elements.push_back(chemkit::Element(symbol));
+        }
+
+        positions.push_back(chemkit::Point3(x, y, z));
+    }
+
+    // add atoms to the molecule
+    chemkit::MoleculeBuilder builder(molecule.get());
+    builder.addAtoms(elements, positions);
+    builder.commit();
+
+    return molecule;
+}
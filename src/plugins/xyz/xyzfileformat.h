@@ -45,7 +45,12 @@ public:
 
     bool read(std::istream &input, chemkit::MoleculeFile *file) CHEMKIT_OVERRIDE;
     bool readMappedFile(const boost::iostreams::mapped_file_source &input, chemkit::MoleculeFile *file) CHEMKIT_OVERRIDE;
+    bool supportsReadNext() const CHEMKIT_OVERRIDE;
+    bool readNext(std::istream &input, boost::shared_ptr<chemkit::Molecule> &molecule) CHEMKIT_OVERRIDE;
     bool write(const chemkit::MoleculeFile *file, std::ostream &output) CHEMKIT_OVERRIDE;
+
+private:
+    boost::shared_ptr<chemkit::Molecule> readMolecule(std::istream &input);
 };
 
 #endif // XYZFILEFORMAT_H
@@ -134,4 +134,51 @@ void GrepTest::benzoicAcid()
     QCOMPARE(moleculeNames[38], QString("170"));
 }
 
+namespace {
+
+// Runs chemkit-grep with arguments and returns the names of the
+// matching molecules.
+QStringList grepNames(const QStringList &arguments)
+{
+    QProcess process;
+    process.start(grepApplication, QStringList() << "--names-only" << arguments);
+    process.waitForFinished();
+
+    QString output = process.readAllStandardOutput();
+    QStringList names = output.split("\n", QString::SkipEmptyParts);
+    for(int i = 0; i < names.size(); i++){
+        names[i] = names[i].trimmed();
+    }
+
+    return names;
+}
+
+} // end anonymous namespace
+
+// Composition matches ignore bonds so the fingerprint index must not
+// exclude any molecules for them. For example, the COC query matches
+// any molecule with two carbons and an oxygen even when the oxygen is
+// not bonded between the carbons.
+void GrepTest::compositionIndex()
+{
+    QTemporaryFile indexFile;
+    indexFile.open();
+    indexFile.close();
+
+    QString dataFileName = testDataPath + "pubchem_416_benzenes.sdf";
+
+    QStringList expected = grepNames(QStringList() << "--composition" << "COC" << dataFileName);
+    QVERIFY(!expected.isEmpty());
+
+    QStringList indexed = grepNames(QStringList() << "--composition"
+                                                  << "--index" << indexFile.fileName()
+                                                  << "COC" << dataFileName);
+    QCOMPARE(indexed, expected);
+
+    // the structure match finds fewer molecules
+    QStringList structure = grepNames(QStringList() << "--index" << indexFile.fileName()
+                                                    << "COC" << dataFileName);
+    QVERIFY(structure.size() < expected.size());
+}
+
 QTEST_APPLESS_MAIN(GrepTest)
@@ -45,6 +45,7 @@ class GrepTest : public QObject
     private slots:
         void ironComposition();
         void benzoicAcid();
+        void compositionIndex();
 };
 
 #endif // GREPTEST_H
@@ -65,4 +65,38 @@ void BondPredictorTest::predictBonds()
     QCOMPARE(h1->isBondedTo(h2), false);
 }
 
+void BondPredictorTest::lattice()
+{
+    // create a 10x10x10 cubic lattice of carbon atoms with each
+    // atom 1.5 angstroms from its six nearest neighbors
+    chemkit::Molecule molecule;
+    for(int x = 0; x < 10; x++){
+        for(int y = 0; y < 10; y++){
+            for(int z = 0; z < 10; z++){
+                chemkit::Atom *atom = molecule.addAtom(6);
+                atom->setPosition(x * 1.5, y * 1.5, z * 1.5);
+            }
+        }
+    }
+
+    chemkit::BondPredictor predictor(&molecule);
+    std::vector<chemkit::BondPredictor::PredictedBond> bonds = predictor.predictedBonds();
+    QCOMPARE(bonds.size(), size_t(3 * 10 * 10 * 9));
+
+    // bonds are ordered by the index of their first and then their
+    // second atom
+    for(size_t i = 1; i < bonds.size(); i++){
+        size_t a1 = boost::get<0>(bonds[i-1])->index();
+        size_t b1 = boost::get<1>(bonds[i-1])->index();
+        size_t a2 = boost::get<0>(bonds[i])->index();
+        size_t b2 = boost::get<1>(bonds[i])->index();
+
+        QVERIFY(a1 < b1);
+        QVERIFY(a1 < a2 || (a1 == a2 && b1 < b2));
+    }
+
+    QVERIFY(boost::get<0>(bonds[0]) == molecule.atom(0));
+    QVERIFY(boost::get<1>(bonds[0]) == molecule.atom(1));
+}
+
 QTEST_APPLESS_MAIN(BondPredictorTest)
@@ -143,6 +143,34 @@ void ElementTest::fromSymbol()
              chemkit::Element::AtomicNumberType(26));
     QCOMPARE(chemkit::Element::fromSymbol("S", 1).atomicNumber(),
              chemkit::Element::AtomicNumberType(16));
+    QCOMPARE(chemkit::Element::fromSymbol("Uuo").atomicNumber(),
+             chemkit::Element::AtomicNumberType(118));
+    QCOMPARE(chemkit::Element::fromSymbol("fe").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbol("FE").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbol('c').atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+}
+
+void ElementTest::fromSymbolCaseInsensitive()
+{
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("Fe").atomicNumber(),
+             chemkit::Element::AtomicNumberType(26));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("FE").atomicNumber(),
+             chemkit::Element::AtomicNumberType(26));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("fe").atomicNumber(),
+             chemkit::Element::AtomicNumberType(26));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("c").atomicNumber(),
+             chemkit::Element::AtomicNumberType(6));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("UUO").atomicNumber(),
+             chemkit::Element::AtomicNumberType(118));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("CA1").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("").atomicNumber(),
+             chemkit::Element::AtomicNumberType(0));
+    QCOMPARE(chemkit::Element::fromSymbolCaseInsensitive("CL.3", 2).atomicNumber(),
+             chemkit::Element::AtomicNumberType(17));
 }
 
 void ElementTest::isValidAtomicNumber()
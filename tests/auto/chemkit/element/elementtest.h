@@ -54,6 +54,7 @@ class ElementTest : public QObject
         void isMetal();
         void fromName();
         void fromSymbol();
+        void fromSymbolCaseInsensitive();
         void isValidAtomicNumber();
         void isValidSymbol();
 };
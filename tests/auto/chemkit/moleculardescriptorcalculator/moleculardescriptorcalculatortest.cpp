@@ -0,0 +1,162 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculardescriptorcalculatortest.h"
+
+#include <chemkit/molecule.h>
+#include <chemkit/threadpool.h>
+#include <chemkit/moleculefile.h>
+#include <chemkit/molecularsurface.h>
+#include <chemkit/moleculardescriptorcontext.h>
+#include <chemkit/moleculardescriptorcalculator.h>
+
+const std::string dataPath = "../../../data/";
+
+void MolecularDescriptorCalculatorTest::addDescriptor()
+{
+    chemkit::MolecularDescriptorCalculator calculator;
+    QCOMPARE(calculator.descriptorCount(), size_t(0));
+
+    QCOMPARE(calculator.addDescriptor("atom-count"), true);
+    QCOMPARE(calculator.addDescriptor("mass"), true);
+    QCOMPARE(calculator.descriptorCount(), size_t(2));
+    QCOMPARE(calculator.descriptors()[0], std::string("atom-count"));
+    QCOMPARE(calculator.descriptors()[1], std::string("mass"));
+
+    QCOMPARE(calculator.addDescriptor("invalid-descriptor"), false);
+    QCOMPARE(calculator.descriptorCount(), size_t(2));
+    QVERIFY(!calculator.errorString().empty());
+}
+
+void MolecularDescriptorCalculatorTest::setDescriptors()
+{
+    chemkit::MolecularDescriptorCalculator calculator;
+    calculator.addDescriptor("atom-count");
+
+    std::vector<std::string> names;
+    names.push_back("bond-count");
+    names.push_back("wiener-index");
+    QCOMPARE(calculator.setDescriptors(names), true);
+    QVERIFY(calculator.descriptors() == names);
+
+    names.push_back("invalid-descriptor");
+    QCOMPARE(calculator.setDescriptors(names), false);
+    QCOMPARE(calculator.descriptorCount(), size_t(2));
+}
+
+void MolecularDescriptorCalculatorTest::calculate()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    chemkit::MolecularDescriptorCalculator calculator;
+    calculator.addDescriptor("atom-count");
+    calculator.addDescriptor("mass");
+    calculator.addDescriptor("wiener-index");
+    calculator.addDescriptor("hydrogen-bond-donors");
+    calculator.addDescriptor("rule-of-five-violations");
+
+    QCOMPARE(calculator.calculate(file.molecules()), true);
+    QCOMPARE(calculator.rowCount(), file.moleculeCount());
+    QCOMPARE(calculator.column(0).size(), file.moleculeCount());
+    QCOMPARE(calculator.column("wiener-index").size(), file.moleculeCount());
+    QCOMPARE(calculator.column("invalid-descriptor").size(), size_t(0));
+
+    // compare with the values calculated for each molecule
+    for(size_t i = 0; i < file.moleculeCount(); i++){
+        const chemkit::Molecule *molecule = file.molecule(i).get();
+
+        QCOMPARE(calculator.value(i, 0).toInt(), molecule->descriptor("atom-count").toInt());
+        QCOMPARE(calculator.value(i, 1).toDouble(), molecule->descriptor("mass").toDouble());
+        QCOMPARE(calculator.value(i, 2).toInt(), molecule->descriptor("wiener-index").toInt());
+        QCOMPARE(calculator.value(i, 3).toInt(), molecule->descriptor("hydrogen-bond-donors").toInt());
+        QCOMPARE(calculator.value(i, 4).toInt(), molecule->descriptor("rule-of-five-violations").toInt());
+    }
+
+    QVERIFY(calculator.value(file.moleculeCount(), 0).isNull());
+    QVERIFY(calculator.value(0, 5).isNull());
+
+    calculator.clear();
+    QCOMPARE(calculator.rowCount(), size_t(0));
+    QCOMPARE(calculator.column(0).size(), size_t(0));
+}
+
+void MolecularDescriptorCalculatorTest::cancel()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+
+    std::vector<const chemkit::Molecule *> molecules(10, &ethanol);
+
+    chemkit::MolecularDescriptorCalculator calculator;
+    calculator.addDescriptor("atom-count");
+
+    chemkit::CancellationToken token;
+    token.cancel();
+    QCOMPARE(calculator.calculate(molecules, &token), false);
+    QCOMPARE(calculator.rowCount(), size_t(0));
+
+    token.reset();
+    QCOMPARE(calculator.calculate(molecules, &token), true);
+    QCOMPARE(calculator.rowCount(), size_t(10));
+    QCOMPARE(calculator.value(9, 0).toInt(), 9);
+}
+
+void MolecularDescriptorCalculatorTest::context()
+{
+    chemkit::MoleculeFile file(dataPath + "guanine.cml");
+    QVERIFY(file.read());
+    const chemkit::Molecule *guanine = file.molecule().get();
+    QVERIFY(guanine != 0);
+
+    chemkit::MolecularDescriptorContext context(guanine);
+    QVERIFY(context.molecule() == guanine);
+
+    // surfaces are only created once
+    const chemkit::MolecularSurface *surface = context.surface(chemkit::MolecularSurface::VanDerWaals);
+    QVERIFY(surface == context.surface(chemkit::MolecularSurface::VanDerWaals));
+    QVERIFY(surface != context.surface(chemkit::MolecularSurface::SolventAccessible));
+    QCOMPARE(surface->surfaceType(), chemkit::MolecularSurface::VanDerWaals);
+
+    chemkit::MolecularSurface expected(guanine, chemkit::MolecularSurface::VanDerWaals);
+    QCOMPARE(qRound(context.descriptor("vdw-area").toDouble()), qRound(expected.surfaceArea()));
+    QCOMPARE(qRound(context.descriptor("vdw-volume").toDouble()), qRound(expected.volume()));
+
+    QVERIFY(context.descriptor("invalid-descriptor").isNull());
+}
+
+QTEST_APPLESS_MAIN(MolecularDescriptorCalculatorTest)
@@ -0,0 +1,211 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculebuildertest.h"
+
+#include <boost/bind.hpp>
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/moleculebuilder.h>
+#include <chemkit/moleculewatcher.h>
+
+namespace {
+
+struct SignalCounter
+{
+    SignalCounter() : count(0) { }
+
+    template<typename T>
+    void increment(const T *) { count++; }
+
+    int count;
+};
+
+} // end anonymous namespace
+
+void MoleculeBuilderTest::basic()
+{
+    chemkit::Molecule molecule;
+    chemkit::MoleculeBuilder builder(&molecule);
+    QVERIFY(builder.molecule() == &molecule);
+
+    builder.reserve(10, 12);
+    QVERIFY(molecule.atomCapacity() >= 10);
+    QVERIFY(molecule.bondCapacity() >= 12);
+    QCOMPARE(molecule.atomCount(), size_t(0));
+    QCOMPARE(molecule.bondCount(), size_t(0));
+}
+
+void MoleculeBuilderTest::addAtom()
+{
+    chemkit::Molecule molecule;
+    chemkit::MoleculeBuilder builder(&molecule);
+
+    chemkit::Atom *C1 = builder.addAtom("C");
+    QVERIFY(C1 != 0);
+    QCOMPARE(C1->symbol(), std::string("C"));
+    QCOMPARE(C1->index(), size_t(0));
+    QCOMPARE(molecule.coordinateSetCount(), size_t(0));
+
+    chemkit::Atom *O2 = builder.addAtom("O", chemkit::Point3(1, 2, 3));
+    QVERIFY(O2 != 0);
+    QCOMPARE(O2->index(), size_t(1));
+    QCOMPARE(O2->position(), chemkit::Point3(1, 2, 3));
+    QCOMPARE(C1->position(), chemkit::Point3(0, 0, 0));
+    QCOMPARE(molecule.formula(), std::string("CO"));
+}
+
+void MoleculeBuilderTest::addAtoms()
+{
+    chemkit::Molecule molecule;
+    molecule.addAtom("N");
+
+    std::vector<chemkit::Element> elements;
+    elements.push_back(chemkit::Element("C"));
+    elements.push_back(chemkit::Element(8));
+    elements.push_back(chemkit::Element("H"));
+
+    std::vector<chemkit::Point3> positions;
+    positions.push_back(chemkit::Point3(1, 0, 0));
+    positions.push_back(chemkit::Point3(0, 1, 0));
+    positions.push_back(chemkit::Point3(0, 0, 1));
+
+    chemkit::MoleculeBuilder builder(&molecule);
+    builder.addAtoms(elements, positions);
+    QCOMPARE(molecule.atomCount(), size_t(4));
+    QCOMPARE(molecule.formula(), std::string("CHNO"));
+    QCOMPARE(molecule.atom(0)->position(), chemkit::Point3(0, 0, 0));
+    QCOMPARE(molecule.atom(1)->position(), chemkit::Point3(1, 0, 0));
+    QCOMPARE(molecule.atom(2)->position(), chemkit::Point3(0, 1, 0));
+    QCOMPARE(molecule.atom(3)->position(), chemkit::Point3(0, 0, 1));
+
+    builder.addAtoms(elements);
+    QCOMPARE(molecule.atomCount(), size_t(7));
+    QCOMPARE(molecule.atom(6)->position(), chemkit::Point3(0, 0, 0));
+}
+
+void MoleculeBuilderTest::addBond()
+{
+    chemkit::Molecule molecule;
+    chemkit::MoleculeBuilder builder(&molecule);
+
+    chemkit::Atom *C1 = builder.addAtom("C");
+    chemkit::Atom *O2 = builder.addAtom("O");
+
+    chemkit::Bond *C1_O2 = builder.addBond(C1, O2, 2);
+    QVERIFY(C1_O2 != 0);
+    QCOMPARE(C1_O2->order(), 2);
+    QCOMPARE(molecule.bondCount(), size_t(1));
+    QVERIFY(C1->isBondedTo(O2));
+
+    // existing bond
+    QVERIFY(builder.addBond(O2, C1) == C1_O2);
+    QCOMPARE(molecule.bondCount(), size_t(1));
+
+    // bond to self
+    QVERIFY(builder.addBond(C1, C1) == 0);
+
+    // atom from another molecule
+    chemkit::Molecule other;
+    chemkit::Atom *N1 = other.addAtom("N");
+    QVERIFY(builder.addBond(C1, N1) == 0);
+    QCOMPARE(molecule.bondCount(), size_t(1));
+}
+
+void MoleculeBuilderTest::addBonds()
+{
+    // cyclopropanone
+    chemkit::Molecule molecule;
+    chemkit::MoleculeBuilder builder(&molecule);
+
+    std::vector<chemkit::Element> elements(3, chemkit::Element("C"));
+    elements.push_back(chemkit::Element("O"));
+    builder.addAtoms(elements);
+
+    std::vector<std::pair<size_t, size_t> > bonds;
+    bonds.push_back(std::make_pair(0, 1));
+    bonds.push_back(std::make_pair(1, 2));
+    bonds.push_back(std::make_pair(2, 0));
+    bonds.push_back(std::make_pair(0, 3));
+    bonds.push_back(std::make_pair(0, 12)); // out of range
+
+    std::vector<int> orders(5, 1);
+    orders[3] = 2;
+
+    builder.addBonds(bonds, orders);
+    QCOMPARE(molecule.bondCount(), size_t(4));
+    QCOMPARE(molecule.ringCount(), size_t(1));
+    QCOMPARE(molecule.atom(0)->valence(), 4);
+    QCOMPARE(molecule.bond(3)->order(), 2);
+}
+
+void MoleculeBuilderTest::commit()
+{
+    chemkit::Molecule molecule;
+    chemkit::MoleculeWatcher watcher(&molecule);
+
+    SignalCounter atomsAdded;
+    SignalCounter bondsAdded;
+    SignalCounter structureChanged;
+    watcher.atomAdded.connect(boost::bind(&SignalCounter::increment<chemkit::Atom>, &atomsAdded, _1));
+    watcher.bondAdded.connect(boost::bind(&SignalCounter::increment<chemkit::Bond>, &bondsAdded, _1));
+    watcher.structureChanged.connect(boost::bind(&SignalCounter::increment<chemkit::Molecule>, &structureChanged, _1));
+
+    chemkit::MoleculeBuilder builder(&molecule);
+    builder.reserve(3, 2);
+    chemkit::Atom *O1 = builder.addAtom("O");
+    builder.addBond(O1, builder.addAtom("H"));
+    builder.addBond(O1, builder.addAtom("H"));
+    QCOMPARE(structureChanged.count, 0);
+
+    builder.commit();
+    QCOMPARE(atomsAdded.count, 0);
+    QCOMPARE(bondsAdded.count, 0);
+    QCOMPARE(structureChanged.count, 1);
+    QCOMPARE(molecule.formula(), std::string("H2O"));
+
+    // nothing changed since the last commit
+    builder.commit();
+    QCOMPARE(structureChanged.count, 1);
+
+    // the molecule's own methods still notify per atom
+    molecule.addAtom("C");
+    QCOMPARE(atomsAdded.count, 1);
+    QCOMPARE(structureChanged.count, 1);
+}
+
+QTEST_APPLESS_MAIN(MoleculeBuilderTest)
@@ -35,10 +35,44 @@
 
 #include "ringtest.h"
 
+#include <algorithm>
+
 #include <chemkit/chemkit.h>
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
 #include <chemkit/ring.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
+#include <chemkit/moleculefile.h>
+
+const std::string dataPath = "../../../data/";
+
+namespace {
+
+// Returns the size of each ring in molecule in ascending order.
+std::vector<size_t> ringSizes(const chemkit::Molecule *molecule)
+{
+    std::vector<size_t> sizes;
+    foreach(const chemkit::Ring *ring, molecule->rings()){
+        sizes.push_back(ring->size());
+    }
+
+    std::sort(sizes.begin(), sizes.end());
+
+    return sizes;
+}
+
+std::vector<size_t> sizeList(const std::string &sizes)
+{
+    std::vector<size_t> list;
+    for(size_t i = 0; i < sizes.size(); i++){
+        list.push_back(sizes[i] - '0');
+    }
+
+    return list;
+}
+
+} // end anonymous namespace
 
 void RingTest::initTestCase()
 {
@@ -206,6 +240,112 @@ void RingTest::isAromatic()
     QCOMPARE(cyclopropaneRing->isAromatic(), false);
 }
 
+void RingTest::ringSystems()
+{
+    chemkit::LineFormat *smiles = chemkit::LineFormat::create("smiles");
+    QVERIFY(smiles != 0);
+
+    struct RingSystem {
+        const char *name;
+        const char *smiles;
+        const char *sizes;
+    };
+
+    const RingSystem systems[] = {
+        // acyclic
+        {"hexane", "CCCCCC", ""},
+        {"neopentanol", "CC(C)(C)CO", ""},
+
+        // spiro
+        {"spiropentane", "C1CC12CC2", "33"},
+        {"spiro[4.5]decane", "C1CCC2(C1)CCCCC2", "56"},
+
+        // fused
+        {"naphthalene", "c1ccc2ccccc2c1", "66"},
+        {"indane", "C1Cc2ccccc2C1", "56"},
+        {"anthracene", "c1ccc2cc3ccccc3cc2c1", "666"},
+
+        // bridged
+        {"norbornane", "C1CC2CCC1C2", "55"},
+        {"bicyclo[2.2.2]octane", "C1CC2CCC1CC2", "66"},
+        {"adamantane", "C1C2CC3CC1CC(C2)C3", "666"},
+        {"cubane", "C12C3C4C1C5C2C3C45", "44444"},
+
+        // ring systems joined by a bridge
+        {"biphenyl", "c1ccccc1-c1ccccc1", "66"},
+        {"dicyclopropylethane", "C1CC1CCC1CC1", "33"},
+        {"phenylcyclohexylmethane", "c1ccccc1CC1CCCCC1", "66"}
+    };
+
+    for(size_t i = 0; i < sizeof(systems) / sizeof(systems[0]); i++){
+        chemkit::Molecule *molecule = smiles->read(systems[i].smiles);
+        QVERIFY(molecule != 0);
+
+        if(ringSizes(molecule) != sizeList(systems[i].sizes)){
+            qDebug() << "ring sizes do not match for" << systems[i].name;
+        }
+        QVERIFY(ringSizes(molecule) == sizeList(systems[i].sizes));
+
+        delete molecule;
+    }
+
+    // the spiro atom is in both rings
+    chemkit::Molecule *spiro = smiles->read("C1CCC2(C1)CCCCC2");
+    QCOMPARE(spiro->atom(3)->ringCount(), size_t(2));
+    QVERIFY(spiro->atom(3)->isInRing(5));
+    QVERIFY(spiro->atom(3)->isInRing(6));
+    delete spiro;
+
+    // the bond between the two rings in biphenyl is not in a ring
+    chemkit::Molecule *biphenyl = smiles->read("c1ccccc1-c1ccccc1");
+    QCOMPARE(biphenyl->atom(5)->ringCount(), size_t(1));
+    QVERIFY(!biphenyl->atom(5)->bondTo(biphenyl->atom(6))->isInRing());
+    delete biphenyl;
+
+    delete smiles;
+}
+
+// The ringSets() method checks molecules with cage-like ring systems
+// for which the smallest set of smallest rings previously contained a
+// ring that was a combination of the other rings. In each the ring
+// containing the given atom was missing.
+void RingTest::ringSets()
+{
+    chemkit::MoleculeFile benzenesFile(dataPath + "pubchem_416_benzenes.sdf");
+    QVERIFY(benzenesFile.read());
+
+    chemkit::MoleculeFile mmffFile(dataPath + "MMFF94_hypervalent.mol2");
+    QVERIFY(mmffFile.read());
+
+    struct RingSet {
+        const chemkit::MoleculeFile *file;
+        const char *name;
+        const char *sizes;
+        size_t atom;
+        size_t ringSize;
+    };
+
+    const RingSet sets[] = {
+        {&benzenesFile, "2264", "6666", 2, 6},
+        {&benzenesFile, "92", "6666", 4, 6},
+        {&benzenesFile, "2476", "3566666", 25, 6},
+        {&benzenesFile, "2579", "6666", 6, 6},
+        {&benzenesFile, "2073", "556666", 18, 6},
+        {&mmffFile, "CIVLAU02", "445", 5, 5}
+    };
+
+    for(size_t i = 0; i < sizeof(sets) / sizeof(sets[0]); i++){
+        boost::shared_ptr<chemkit::Molecule> molecule = sets[i].file->molecule(sets[i].name);
+        QVERIFY(molecule != 0);
+
+        if(ringSizes(molecule.get()) != sizeList(sets[i].sizes)){
+            qDebug() << "ring sizes do not match for" << sets[i].name;
+        }
+        QVERIFY(ringSizes(molecule.get()) == sizeList(sets[i].sizes));
+        QVERIFY(molecule->atom(sets[i].atom)->isInRing(sets[i].ringSize));
+    }
+}
+
 void RingTest::cleanupTestCase()
 {
     delete benzeneRing->molecule();
@@ -72,6 +72,8 @@ class RingTest : public QObject
         void heteroatomCount();
         void isHeterocycle();
         void isAromatic();
+        void ringSystems();
+        void ringSets();
         void cleanupTestCase();
 };
 
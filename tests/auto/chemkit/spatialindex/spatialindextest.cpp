@@ -0,0 +1,322 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "spatialindextest.h"
+
+#include <limits>
+#include <algorithm>
+
+#include <chemkit/unitcell.h>
+#include <chemkit/spatialindex.h>
+#include <chemkit/cartesiancoordinates.h>
+
+namespace {
+
+// Returns count points spread pseudo-randomly over a box of the
+// given size.
+chemkit::CartesianCoordinates randomCoordinates(size_t count, chemkit::Real size)
+{
+    chemkit::CartesianCoordinates coordinates;
+
+    unsigned int seed = 12345;
+    for(size_t i = 0; i < count; i++){
+        chemkit::Real values[3];
+        for(int k = 0; k < 3; k++){
+            seed = seed * 1103515245 + 12345;
+            values[k] = size * ((seed >> 8) & 0xffff) / chemkit::Real(0xffff);
+        }
+
+        coordinates.append(values[0], values[1], values[2]);
+    }
+
+    return coordinates;
+}
+
+// Returns the indices within radius of point using the index's
+// distance function.
+std::vector<size_t> bruteForceWithin(const chemkit::SpatialIndex &index, const chemkit::Point3 &point, chemkit::Real radius)
+{
+    std::vector<size_t> indices;
+
+    for(size_t i = 0; i < index.size(); i++){
+        if(index.distance(point, index.position(i)) <= radius){
+            indices.push_back(i);
+        }
+    }
+
+    return indices;
+}
+
+// Returns all pairs within cutoff using the index's distance function.
+std::vector<chemkit::SpatialIndex::Pair> bruteForcePairs(const chemkit::SpatialIndex &index, chemkit::Real cutoff)
+{
+    std::vector<chemkit::SpatialIndex::Pair> pairs;
+
+    for(size_t i = 0; i < index.size(); i++){
+        for(size_t j = i + 1; j < index.size(); j++){
+            if(index.distance(index.position(i), index.position(j)) <= cutoff){
+                chemkit::SpatialIndex::Pair pair = {{ i, j }};
+                pairs.push_back(pair);
+            }
+        }
+    }
+
+    return pairs;
+}
+
+} // end anonymous namespace
+
+void SpatialIndexTest::basic()
+{
+    chemkit::CartesianCoordinates coordinates;
+    chemkit::SpatialIndex empty(&coordinates);
+    QCOMPARE(empty.size(), size_t(0));
+    QCOMPARE(empty.isEmpty(), true);
+    QCOMPARE(empty.isPeriodic(), false);
+    QCOMPARE(empty.within(chemkit::Point3(0, 0, 0), 10.0).size(), size_t(0));
+    QCOMPARE(empty.nearest(chemkit::Point3(0, 0, 0), 3).size(), size_t(0));
+    QCOMPARE(empty.pairs(10.0).size(), size_t(0));
+
+    coordinates.append(0, 0, 0);
+    coordinates.append(1, 0, 0);
+    coordinates.append(5, 0, 0);
+    chemkit::SpatialIndex index(&coordinates, 2.0);
+    QCOMPARE(index.size(), size_t(3));
+    QCOMPARE(index.cellSize(), chemkit::Real(2.0));
+    QVERIFY(index.position(2) == chemkit::Point3(5, 0, 0));
+    QCOMPARE(index.distance(chemkit::Point3(0, 0, 0), chemkit::Point3(3, 4, 0)), chemkit::Real(5.0));
+
+    std::vector<chemkit::SpatialIndex::Pair> pairs = index.pairs(1.5);
+    QCOMPARE(pairs.size(), size_t(1));
+    QCOMPARE(pairs[0][0], size_t(0));
+    QCOMPARE(pairs[0][1], size_t(1));
+}
+
+void SpatialIndexTest::within()
+{
+    chemkit::CartesianCoordinates coordinates = randomCoordinates(1000, 30.0);
+    chemkit::SpatialIndex index(&coordinates, 3.0);
+
+    chemkit::Real radii[] = { 0.5, 2.0, 3.0, 7.5, 100.0 };
+    for(int r = 0; r < 5; r++){
+        for(size_t i = 0; i < coordinates.size(); i += 37){
+            chemkit::Point3 point = coordinates.position(i) + chemkit::Vector3(0.3, -0.2, 0.1);
+            QVERIFY(index.within(point, radii[r]) == bruteForceWithin(index, point, radii[r]));
+        }
+    }
+
+    // points outside of the grid
+    chemkit::Point3 outside(-20, 45, 15);
+    QVERIFY(index.within(outside, 25.0) == bruteForceWithin(index, outside, 25.0));
+}
+
+void SpatialIndexTest::nearest()
+{
+    chemkit::CartesianCoordinates coordinates = randomCoordinates(500, 20.0);
+    chemkit::SpatialIndex index(&coordinates, 2.0);
+
+    chemkit::Point3 point(4.1, 17.3, 9.9);
+    std::vector<size_t> nearest = index.nearest(point, 10);
+    QCOMPARE(nearest.size(), size_t(10));
+
+    std::vector<std::pair<chemkit::Real, size_t> > expected;
+    for(size_t i = 0; i < coordinates.size(); i++){
+        expected.push_back(std::make_pair((coordinates.position(i) - point).norm(), i));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    for(size_t i = 0; i < nearest.size(); i++){
+        QCOMPARE(nearest[i], expected[i].second);
+    }
+
+    // more points than are in the index
+    QCOMPARE(index.nearest(point, 1000).size(), size_t(500));
+
+    // point far away from all others
+    chemkit::Point3 farPoint(500, 500, 500);
+    size_t closest = 0;
+    for(size_t i = 1; i < coordinates.size(); i++){
+        if((coordinates.position(i) - farPoint).norm() < (coordinates.position(closest) - farPoint).norm()){
+            closest = i;
+        }
+    }
+
+    std::vector<size_t> far = index.nearest(farPoint, 1);
+    QCOMPARE(far.size(), size_t(1));
+    QCOMPARE(far[0], closest);
+}
+
+void SpatialIndexTest::pairs()
+{
+    chemkit::CartesianCoordinates coordinates = randomCoordinates(800, 25.0);
+    chemkit::SpatialIndex index(&coordinates, 4.0);
+
+    QVERIFY(index.pairs(2.5) == bruteForcePairs(index, 2.5));
+    QVERIFY(index.pairs(6.0) == bruteForcePairs(index, 6.0));
+}
+
+void SpatialIndexTest::periodic()
+{
+    chemkit::CartesianCoordinates coordinates = randomCoordinates(600, 20.0);
+    chemkit::UnitCell cell(chemkit::Vector3(20, 0, 0),
+                           chemkit::Vector3(0, 20, 0),
+                           chemkit::Vector3(0, 0, 20));
+    chemkit::SpatialIndex index(&coordinates, 3.0, &cell);
+    QCOMPARE(index.isPeriodic(), true);
+
+    // distances wrap around the box
+    QCOMPARE(qRound(index.distance(chemkit::Point3(1, 1, 1), chemkit::Point3(19, 1, 1))), 2);
+    QCOMPARE(qRound(index.distance(chemkit::Point3(1, 1, 1), chemkit::Point3(41, 1, 1))), 0);
+
+    chemkit::Point3 corner(0.5, 0.5, 19.5);
+    QVERIFY(index.within(corner, 4.0) == bruteForceWithin(index, corner, 4.0));
+    QVERIFY(index.within(corner, 15.0) == bruteForceWithin(index, corner, 15.0));
+    QVERIFY(index.pairs(3.5) == bruteForcePairs(index, 3.5));
+
+    // nearest neighbors across the boundary
+    std::vector<size_t> nearest = index.nearest(corner, 5);
+    QCOMPARE(nearest.size(), size_t(5));
+    std::vector<std::pair<chemkit::Real, size_t> > expected;
+    for(size_t i = 0; i < coordinates.size(); i++){
+        expected.push_back(std::make_pair(index.distance(corner, coordinates.position(i)), i));
+    }
+    std::sort(expected.begin(), expected.end());
+    for(size_t i = 0; i < nearest.size(); i++){
+        QCOMPARE(nearest[i], expected[i].second);
+    }
+}
+
+void SpatialIndexTest::triclinic()
+{
+    chemkit::CartesianCoordinates coordinates = randomCoordinates(400, 15.0);
+    chemkit::UnitCell cell(chemkit::Vector3(15, 0, 0),
+                           chemkit::Vector3(5, 14, 0),
+                           chemkit::Vector3(-3, 4, 13));
+    chemkit::SpatialIndex index(&coordinates, 2.5, &cell);
+    QCOMPARE(index.isPeriodic(), true);
+
+    for(size_t i = 0; i < coordinates.size(); i += 41){
+        QVERIFY(index.within(coordinates.position(i), 5.0) == bruteForceWithin(index, coordinates.position(i), 5.0));
+    }
+
+    QVERIFY(index.pairs(3.0) == bruteForcePairs(index, 3.0));
+}
+
+void SpatialIndexTest::update()
+{
+    chemkit::CartesianCoordinates coordinates = randomCoordinates(500, 20.0);
+    chemkit::SpatialIndex index(&coordinates, 3.0);
+
+    // move single points
+    index.setPosition(0, chemkit::Point3(10, 10, 10));
+    index.setPosition(1, chemkit::Point3(10.5, 10, 10));
+    index.setPosition(2, chemkit::Point3(-5, -5, -5));
+    coordinates.setPosition(0, chemkit::Point3(10, 10, 10));
+    coordinates.setPosition(1, chemkit::Point3(10.5, 10, 10));
+    coordinates.setPosition(2, chemkit::Point3(-5, -5, -5));
+
+    QVERIFY(index.position(2) == chemkit::Point3(-5, -5, -5));
+    QVERIFY(index.pairs(2.0) == bruteForcePairs(index, 2.0));
+    QVERIFY(index.within(chemkit::Point3(-4, -4, -4), 2.0) == bruteForceWithin(index, chemkit::Point3(-4, -4, -4), 2.0));
+
+    // move all points slightly
+    for(size_t i = 0; i < coordinates.size(); i++){
+        coordinates[i] += chemkit::Vector3(0.7, -1.3, 0.4);
+    }
+    index.update(&coordinates);
+    for(size_t i = 0; i < coordinates.size(); i++){
+        QVERIFY(index.position(i) == coordinates.position(i));
+    }
+    QVERIFY(index.pairs(2.0) == bruteForcePairs(index, 2.0));
+
+    // move points far outside of the original grid
+    coordinates.moveBy(100, 0, 0);
+    index.update(&coordinates);
+    QVERIFY(index.pairs(2.0) == bruteForcePairs(index, 2.0));
+
+    // change the number of points
+    coordinates.append(0, 0, 0);
+    index.update(&coordinates);
+    QCOMPARE(index.size(), size_t(501));
+}
+
+void SpatialIndexTest::nonFinite()
+{
+    chemkit::Real nan = std::numeric_limits<chemkit::Real>::quiet_NaN();
+    chemkit::Real inf = std::numeric_limits<chemkit::Real>::infinity();
+
+    chemkit::CartesianCoordinates coordinates;
+    coordinates.append(0, 0, 0);
+    coordinates.append(1, 0, 0);
+    coordinates.append(nan, 0, 0);
+    coordinates.append(0, inf, 0);
+    coordinates.append(0, 0, -inf);
+    coordinates.append(3, 0, 0);
+
+    // non-finite points are kept but never found
+    chemkit::SpatialIndex index(&coordinates, 2.0);
+    QCOMPARE(index.size(), size_t(6));
+    QCOMPARE(index.within(chemkit::Point3(0, 0, 0), 2.0).size(), size_t(2));
+    QCOMPARE(index.within(chemkit::Point3(nan, 0, 0), 2.0).size(), size_t(0));
+    QCOMPARE(index.nearest(chemkit::Point3(0, 0, 0), 10).size(), size_t(3));
+    QCOMPARE(index.nearest(chemkit::Point3(inf, 0, 0), 2).size(), size_t(0));
+    QCOMPARE(index.pairs(2.5).size(), size_t(2));
+
+    // moving points to and from non-finite positions
+    index.setPosition(0, chemkit::Point3(nan, nan, nan));
+    QCOMPARE(index.nearest(chemkit::Point3(0, 0, 0), 10).size(), size_t(2));
+    QCOMPARE(index.pairs(2.5).size(), size_t(1));
+    index.setPosition(2, chemkit::Point3(2, 0, 0));
+    QCOMPARE(index.nearest(chemkit::Point3(0, 0, 0), 10).size(), size_t(3));
+    QCOMPARE(index.pairs(2.5).size(), size_t(3));
+
+    // finite points too far apart to store in a grid
+    chemkit::Real maximum = std::numeric_limits<chemkit::Real>::max();
+    coordinates.setPosition(3, chemkit::Point3(maximum, 0, 0));
+    coordinates.setPosition(4, chemkit::Point3(-maximum, 0, 0));
+    index.update(&coordinates);
+    QVERIFY(index.pairs(2.5) == bruteForcePairs(index, 2.5));
+    QCOMPARE(index.nearest(chemkit::Point3(0, 0, 0), 10).size(), size_t(5));
+
+    // periodic index
+    chemkit::UnitCell cell(chemkit::Vector3(10, 0, 0),
+                           chemkit::Vector3(0, 10, 0),
+                           chemkit::Vector3(0, 0, 10));
+    chemkit::SpatialIndex periodic(&coordinates, 2.0, &cell);
+    QCOMPARE(periodic.within(chemkit::Point3(nan, 0, 0), 2.0).size(), size_t(0));
+    QVERIFY(periodic.within(chemkit::Point3(0, 0, 0), 2.0) == bruteForceWithin(periodic, chemkit::Point3(0, 0, 0), 2.0));
+}
+
+QTEST_APPLESS_MAIN(SpatialIndexTest)
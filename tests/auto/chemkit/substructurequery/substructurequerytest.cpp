@@ -254,6 +254,51 @@ void SubstructureQueryTest::matches()
     QCOMPARE(query.matches(phenol.get()), true);
 }
 
+void SubstructureQueryTest::flags()
+{
+    boost::shared_ptr<chemkit::Molecule> methane = boost::make_shared<chemkit::Molecule>("C", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethane = boost::make_shared<chemkit::Molecule>("CC", "smiles");
+
+    chemkit::SubstructureQuery query(methane);
+    QCOMPARE(query.flags(), 0);
+    QCOMPARE(query.matches(ethane.get()), true);
+
+    // changing the flags should recompile the query
+    query.setFlags(chemkit::SubstructureQuery::CompareHydrogens);
+    QCOMPARE(query.flags(), int(chemkit::SubstructureQuery::CompareHydrogens));
+    QCOMPARE(query.matches(methane.get()), true);
+    QCOMPARE(query.matches(ethane.get()), false);
+
+    query.setFlags(0);
+    QCOMPARE(query.matches(ethane.get()), true);
+}
+
+// The target may contain bonds between atoms that are not bonded in the
+// query. A chain query matched along a ring in the target must not be
+// rejected by the vf2 look-ahead check even though the ring closure
+// places an unmapped target neighbor in the terminal set early.
+void SubstructureQueryTest::extraTargetBonds()
+{
+    boost::shared_ptr<chemkit::Molecule> pentane = boost::make_shared<chemkit::Molecule>("CCCCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> hexane = boost::make_shared<chemkit::Molecule>("CCCCCC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> isopentane = boost::make_shared<chemkit::Molecule>("CC(C)CC", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethylcyclopropane = boost::make_shared<chemkit::Molecule>("CCC1CC1", "smiles");
+    boost::shared_ptr<chemkit::Molecule> methylcyclobutane = boost::make_shared<chemkit::Molecule>("C1CCC1C", "smiles");
+    boost::shared_ptr<chemkit::Molecule> propylcyclopropane = boost::make_shared<chemkit::Molecule>("CCCC1CC1", "smiles");
+
+    chemkit::SubstructureQuery query(pentane);
+    QCOMPARE(query.matches(ethylcyclopropane.get()), true);
+    QCOMPARE(query.matches(methylcyclobutane.get()), true);
+
+    query.setMolecule(isopentane);
+    QCOMPARE(query.matches(ethylcyclopropane.get()), true);
+    QCOMPARE(query.matches(methylcyclobutane.get()), true);
+
+    query.setMolecule(hexane);
+    QCOMPARE(query.matches(ethylcyclopropane.get()), false);
+    QCOMPARE(query.matches(propylcyclopropane.get()), true);
+}
+
 void SubstructureQueryTest::find()
 {
     boost::shared_ptr<chemkit::Molecule> alanine(new chemkit::Molecule);
@@ -301,4 +346,58 @@ void SubstructureQueryTest::find()
     QCOMPARE(carboxylMoiety.isEmpty(), true);
 }
 
+void SubstructureQueryTest::context()
+{
+    boost::shared_ptr<chemkit::Molecule> ethanol(new chemkit::Molecule);
+    chemkit::Atom *ethanol_C1 = ethanol->addAtom("C");
+    chemkit::Atom *ethanol_C2 = ethanol->addAtom("C");
+    chemkit::Atom *ethanol_O3 = ethanol->addAtom("O");
+    ethanol->addBond(ethanol_C1, ethanol_C2);
+    ethanol->addBond(ethanol_C2, ethanol_O3);
+
+    boost::shared_ptr<chemkit::Molecule> propane(new chemkit::Molecule);
+    chemkit::Atom *propane_C1 = propane->addAtom("C");
+    chemkit::Atom *propane_C2 = propane->addAtom("C");
+    chemkit::Atom *propane_C3 = propane->addAtom("C");
+    propane->addBond(propane_C1, propane_C2);
+    propane->addBond(propane_C2, propane_C3);
+
+    boost::shared_ptr<chemkit::Molecule> hydroxyl(new chemkit::Molecule);
+    chemkit::Atom *hydroxyl_C1 = hydroxyl->addAtom("C");
+    chemkit::Atom *hydroxyl_O2 = hydroxyl->addAtom("O");
+    hydroxyl->addBond(hydroxyl_C1, hydroxyl_O2);
+
+    boost::shared_ptr<chemkit::Molecule> ethane(new chemkit::Molecule);
+    chemkit::Atom *ethane_C1 = ethane->addAtom("C");
+    chemkit::Atom *ethane_C2 = ethane->addAtom("C");
+    ethane->addBond(ethane_C1, ethane_C2);
+
+    // one context shared between queries and molecules
+    chemkit::SubstructureQuery::Context context;
+    chemkit::SubstructureQuery hydroxylQuery(hydroxyl);
+    chemkit::SubstructureQuery ethaneQuery(ethane);
+
+    QCOMPARE(hydroxylQuery.matches(ethanol.get(), context), true);
+    QCOMPARE(hydroxylQuery.matches(propane.get(), context), false);
+    QCOMPARE(ethaneQuery.matches(propane.get(), context), true);
+    QCOMPARE(hydroxylQuery.matches(propane.get(), context), false);
+
+    std::map<chemkit::Atom *, chemkit::Atom *> mapping = hydroxylQuery.mapping(ethanol.get(), context);
+    QCOMPARE(mapping.size(), size_t(2));
+    QVERIFY(mapping[hydroxyl_C1] == ethanol_C2);
+    QVERIFY(mapping[hydroxyl_O2] == ethanol_O3);
+
+    mapping = hydroxylQuery.mapping(propane.get(), context);
+    QCOMPARE(mapping.size(), size_t(0));
+
+    mapping = ethaneQuery.mapping(propane.get(), context);
+    QCOMPARE(mapping.size(), size_t(2));
+    QVERIFY(mapping[ethane_C1]->molecule() == propane.get());
+    QVERIFY(mapping[ethane_C2]->molecule() == propane.get());
+
+    // results match those from queries without a context
+    QCOMPARE(hydroxylQuery.matches(ethanol.get()), true);
+    QCOMPARE(hydroxylQuery.matches(propane.get()), false);
+}
+
 QTEST_APPLESS_MAIN(SubstructureQueryTest)
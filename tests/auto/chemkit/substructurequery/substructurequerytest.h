@@ -47,7 +47,10 @@ class SubstructureQueryTest : public QObject
         void mapping();
         void maximumMapping();
         void matches();
+        void flags();
+        void extraTargetBonds();
         void find();
+        void context();
 };
 
 #endif // SUBSTRUCTUREQUERYTEST_H
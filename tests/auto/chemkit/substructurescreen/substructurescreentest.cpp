@@ -0,0 +1,176 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "substructurescreentest.h"
+
+#include <algorithm>
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/substructurequery.h>
+#include <chemkit/substructurescreen.h>
+
+namespace {
+
+// Returns a set of molecules with carbon chains of varying length
+// where every third molecule has a hydroxyl group.
+std::vector<boost::shared_ptr<chemkit::Molecule> > createMolecules(size_t count)
+{
+    std::vector<boost::shared_ptr<chemkit::Molecule> > molecules;
+
+    for(size_t i = 0; i < count; i++){
+        boost::shared_ptr<chemkit::Molecule> molecule(new chemkit::Molecule);
+
+        chemkit::Atom *previous = molecule->addAtom("C");
+        for(size_t j = 0; j < i % 5; j++){
+            chemkit::Atom *carbon = molecule->addAtom("C");
+            molecule->addBond(previous, carbon);
+            previous = carbon;
+        }
+
+        if(i % 3 == 0){
+            chemkit::Atom *oxygen = molecule->addAtom("O");
+            molecule->addBond(previous, oxygen);
+        }
+
+        molecules.push_back(molecule);
+    }
+
+    return molecules;
+}
+
+boost::shared_ptr<chemkit::Molecule> createHydroxyl()
+{
+    boost::shared_ptr<chemkit::Molecule> hydroxyl(new chemkit::Molecule);
+    chemkit::Atom *C1 = hydroxyl->addAtom("C");
+    chemkit::Atom *O2 = hydroxyl->addAtom("O");
+    hydroxyl->addBond(C1, O2);
+
+    return hydroxyl;
+}
+
+} // end anonymous namespace
+
+void SubstructureScreenTest::query()
+{
+    boost::shared_ptr<chemkit::Molecule> hydroxyl = createHydroxyl();
+
+    chemkit::SubstructureQuery query(hydroxyl);
+    query.setFlags(chemkit::SubstructureQuery::CompareExact);
+
+    chemkit::SubstructureScreen screen(query);
+    QVERIFY(screen.query().molecule() == hydroxyl);
+    QCOMPARE(screen.query().flags(), int(chemkit::SubstructureQuery::CompareExact));
+    QCOMPARE(screen.isOrdered(), true);
+    QCOMPARE(screen.isInverted(), false);
+}
+
+void SubstructureScreenTest::threadCount()
+{
+    chemkit::SubstructureScreen screen;
+    QVERIFY(screen.threadCount() >= 1);
+
+    screen.setThreadCount(3);
+    QCOMPARE(screen.threadCount(), size_t(3));
+
+    screen.setQueueSize(0);
+    QCOMPARE(screen.queueSize(), size_t(1));
+}
+
+void SubstructureScreenTest::run()
+{
+    std::vector<boost::shared_ptr<chemkit::Molecule> > molecules = createMolecules(200);
+
+    chemkit::SubstructureQuery query(createHydroxyl());
+
+    chemkit::SubstructureScreen screen(query);
+    screen.setThreadCount(4);
+    screen.setQueueSize(8);
+
+    std::vector<boost::shared_ptr<chemkit::Molecule> > matches = screen.run(molecules);
+    QCOMPARE(matches.size(), size_t(67));
+
+    // matches should be in the same order as the input
+    for(size_t i = 0; i < matches.size(); i++){
+        QVERIFY(matches[i] == molecules[i * 3]);
+    }
+
+    // a single thread should give the same results
+    screen.setThreadCount(1);
+    QVERIFY(screen.run(molecules) == matches);
+}
+
+void SubstructureScreenTest::unordered()
+{
+    std::vector<boost::shared_ptr<chemkit::Molecule> > molecules = createMolecules(200);
+
+    chemkit::SubstructureQuery query(createHydroxyl());
+
+    chemkit::SubstructureScreen screen(query);
+    screen.setThreadCount(4);
+    screen.setOrdered(false);
+
+    std::vector<boost::shared_ptr<chemkit::Molecule> > matches = screen.run(molecules);
+    QCOMPARE(matches.size(), size_t(67));
+
+    std::vector<boost::shared_ptr<chemkit::Molecule> > expected;
+    for(size_t i = 0; i < molecules.size(); i += 3){
+        expected.push_back(molecules[i]);
+    }
+
+    std::sort(matches.begin(), matches.end());
+    std::sort(expected.begin(), expected.end());
+    QVERIFY(matches == expected);
+}
+
+void SubstructureScreenTest::inverted()
+{
+    std::vector<boost::shared_ptr<chemkit::Molecule> > molecules = createMolecules(200);
+
+    chemkit::SubstructureQuery query(createHydroxyl());
+
+    chemkit::SubstructureScreen screen(query);
+    screen.setThreadCount(2);
+    screen.setInverted(true);
+
+    std::vector<boost::shared_ptr<chemkit::Molecule> > matches = screen.run(molecules);
+    QCOMPARE(matches.size(), size_t(133));
+    QVERIFY(matches[0] == molecules[1]);
+    QVERIFY(matches[1] == molecules[2]);
+    QVERIFY(matches[2] == molecules[4]);
+}
+
+QTEST_APPLESS_MAIN(SubstructureScreenTest)
@@ -0,0 +1,235 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "threadpooltest.h"
+
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <chemkit/concurrent.h>
+#include <chemkit/threadpool.h>
+
+namespace {
+
+class Counter
+{
+public:
+    Counter() : m_value(0) { }
+
+    void increment()
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_value++;
+    }
+
+    void add(size_t index)
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_value += index;
+    }
+
+    size_t value() const
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        return m_value;
+    }
+
+private:
+    mutable boost::mutex m_mutex;
+    size_t m_value;
+};
+
+struct Square
+{
+    typedef int result_type;
+
+    int operator()(int value) const
+    {
+        return value * value;
+    }
+};
+
+// Runs an inner parallel loop from inside an outer one.
+void addRange(chemkit::ThreadPool *pool, Counter *counter, size_t index)
+{
+    pool->parallelFor(0, index, boost::bind(&Counter::add, counter, _1));
+}
+
+// Cancels the token once index reaches ten.
+void cancelAt(chemkit::CancellationToken *token, Counter *counter, size_t index)
+{
+    counter->increment();
+
+    if(index == 10){
+        token->cancel();
+    }
+}
+
+void throwAt(size_t index)
+{
+    if(index == 50){
+        throw std::runtime_error("error");
+    }
+}
+
+int answer()
+{
+    return 42;
+}
+
+} // end anonymous namespace
+
+void ThreadPoolTest::threadCount()
+{
+    chemkit::ThreadPool pool(3);
+    QCOMPARE(pool.threadCount(), size_t(3));
+    QCOMPARE(pool.isWorkerThread(), false);
+
+    chemkit::ThreadPool defaultPool;
+    QVERIFY(defaultPool.threadCount() >= 1);
+
+    QVERIFY(chemkit::ThreadPool::globalInstance() != 0);
+    QVERIFY(chemkit::ThreadPool::globalInstance() == chemkit::ThreadPool::globalInstance());
+}
+
+void ThreadPoolTest::submit()
+{
+    chemkit::ThreadPool pool(4);
+    Counter counter;
+
+    for(int i = 0; i < 1000; i++){
+        pool.submit(boost::bind(&Counter::increment, &counter));
+    }
+
+    pool.waitForDone();
+    QCOMPARE(counter.value(), size_t(1000));
+
+    // canceled tasks are skipped
+    chemkit::CancellationToken token;
+    token.cancel();
+    QCOMPARE(token.isCanceled(), true);
+    pool.submit(boost::bind(&Counter::increment, &counter), &token);
+    pool.waitForDone();
+    QCOMPARE(counter.value(), size_t(1000));
+
+    token.reset();
+    QCOMPARE(token.isCanceled(), false);
+}
+
+void ThreadPoolTest::parallelFor()
+{
+    chemkit::ThreadPool pool(4);
+    Counter counter;
+
+    bool finished = pool.parallelFor(0, 1000, boost::bind(&Counter::add, &counter, _1));
+    QCOMPARE(finished, true);
+    QCOMPARE(counter.value(), size_t(999 * 1000 / 2));
+
+    // empty range
+    QCOMPARE(pool.parallelFor(5, 5, boost::bind(&Counter::add, &counter, _1)), true);
+    QCOMPARE(counter.value(), size_t(999 * 1000 / 2));
+}
+
+void ThreadPoolTest::parallelMap()
+{
+    std::vector<int> input;
+    for(int i = 0; i < 100; i++){
+        input.push_back(i);
+    }
+
+    std::vector<int> output = chemkit::concurrent::parallel_map(input, Square());
+    QCOMPARE(output.size(), size_t(100));
+    for(int i = 0; i < 100; i++){
+        QCOMPARE(output[i], i * i);
+    }
+}
+
+void ThreadPoolTest::nested()
+{
+    // a single thread must not deadlock when loops are nested
+    chemkit::ThreadPool pool(1);
+    Counter counter;
+
+    pool.parallelFor(0, 20, boost::bind(&addRange, &pool, &counter, _1));
+
+    size_t expected = 0;
+    for(size_t i = 0; i < 20; i++){
+        expected += i * (i - 1) / 2;
+    }
+    QCOMPARE(counter.value(), expected);
+}
+
+void ThreadPoolTest::cancel()
+{
+    chemkit::ThreadPool pool(2);
+    chemkit::CancellationToken token;
+    Counter counter;
+
+    bool finished = pool.parallelFor(0, 100000, boost::bind(&cancelAt, &token, &counter, _1), &token);
+    QCOMPARE(finished, false);
+    QVERIFY(counter.value() < 100000);
+    QCOMPARE(token.isCanceled(), true);
+}
+
+void ThreadPoolTest::exception()
+{
+    chemkit::ThreadPool pool(2);
+
+    bool thrown = false;
+    try {
+        pool.parallelFor(0, 100, &throwAt);
+    }
+    catch(std::runtime_error &){
+        thrown = true;
+    }
+
+    QCOMPARE(thrown, true);
+}
+
+void ThreadPoolTest::run()
+{
+    std::vector<boost::shared_future<int> > futures;
+    for(int i = 0; i < 100; i++){
+        futures.push_back(chemkit::concurrent::run(boost::function<int ()>(&answer)));
+    }
+
+    for(size_t i = 0; i < futures.size(); i++){
+        QCOMPARE(futures[i].get(), 42);
+    }
+}
+
+QTEST_APPLESS_MAIN(ThreadPoolTest)
@@ -0,0 +1,161 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "topologicaldistancematrixtest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/molecule.h>
+#include <chemkit/topologicaldistancematrix.h>
+
+void TopologicalDistanceMatrixTest::basic()
+{
+    chemkit::TopologicalDistanceMatrix empty;
+    QVERIFY(empty.molecule() == 0);
+    QCOMPARE(empty.size(), size_t(0));
+
+    chemkit::Molecule molecule;
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QVERIFY(matrix.molecule() == &molecule);
+    QCOMPARE(matrix.size(), size_t(0));
+}
+
+void TopologicalDistanceMatrixTest::chain()
+{
+    // butane carbon chain
+    chemkit::Molecule butane;
+    for(int i = 0; i < 4; i++){
+        butane.addAtom("C");
+    }
+    for(int i = 0; i < 3; i++){
+        butane.addBond(i, i + 1);
+    }
+
+    chemkit::TopologicalDistanceMatrix matrix(&butane);
+    QCOMPARE(matrix.size(), size_t(4));
+    QCOMPARE(matrix.distance(0, 0), size_t(0));
+    QCOMPARE(matrix.distance(0, 1), size_t(1));
+    QCOMPARE(matrix.distance(0, 3), size_t(3));
+    QCOMPARE(matrix.distance(3, 0), size_t(3));
+    QCOMPARE(matrix.distance(1, 3), size_t(2));
+    QCOMPARE(matrix.distance(butane.atom(2), butane.atom(0)), size_t(2));
+    QCOMPARE(matrix.eccentricity(0), size_t(3));
+    QCOMPARE(matrix.eccentricity(1), size_t(2));
+
+    // cyclohexane carbon ring
+    chemkit::Molecule cyclohexane;
+    for(int i = 0; i < 6; i++){
+        cyclohexane.addAtom("C");
+    }
+    for(int i = 0; i < 6; i++){
+        cyclohexane.addBond(i, (i + 1) % 6);
+    }
+
+    matrix.setMolecule(&cyclohexane);
+    QVERIFY(matrix.molecule() == &cyclohexane);
+    QCOMPARE(matrix.size(), size_t(6));
+    QCOMPARE(matrix.distance(0, 5), size_t(1));
+    QCOMPARE(matrix.distance(0, 3), size_t(3));
+    QCOMPARE(matrix.distance(1, 5), size_t(2));
+    QCOMPARE(matrix.eccentricity(4), size_t(3));
+}
+
+void TopologicalDistanceMatrixTest::disconnected()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    molecule.addBond(C1, C2);
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.isConnected(0, 1), true);
+    QCOMPARE(matrix.isConnected(0, 2), false);
+    QCOMPARE(matrix.isConnected(2, 2), true);
+    QCOMPARE(matrix.distance(C1, C3), size_t(0));
+    QCOMPARE(matrix.eccentricity(2), size_t(0));
+}
+
+void TopologicalDistanceMatrixTest::structureChanged()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, C3);
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.distance(0, 2), size_t(2));
+
+    molecule.addBond(C1, C3);
+    QCOMPARE(matrix.distance(0, 2), size_t(1));
+
+    molecule.removeBond(C1, C3);
+    molecule.removeBond(C2, C3);
+    QCOMPARE(matrix.isConnected(0, 2), false);
+
+    chemkit::Atom *C4 = molecule.addAtom("C");
+    molecule.addBond(C3, C4);
+    molecule.addBond(C4, C1);
+    QCOMPARE(matrix.size(), size_t(4));
+    QCOMPARE(matrix.distance(C2, C3), size_t(3));
+
+    molecule.removeAtom(C1);
+    QCOMPARE(matrix.size(), size_t(3));
+    QCOMPARE(matrix.isConnected(C2->index(), C3->index()), false);
+    QCOMPARE(matrix.distance(C3, C4), size_t(1));
+}
+
+void TopologicalDistanceMatrixTest::large()
+{
+    // linear chains long enough to need 16-bit distances
+    chemkit::Molecule molecule;
+    chemkit::Atom *previous = 0;
+    for(size_t i = 0; i < 300; i++){
+        chemkit::Atom *atom = molecule.addAtom("C");
+        if(previous){
+            molecule.addBond(previous, atom);
+        }
+        previous = atom;
+    }
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.distance(0, 299), size_t(299));
+    QCOMPARE(matrix.distance(150, 10), size_t(140));
+    QCOMPARE(matrix.eccentricity(0), size_t(299));
+    QCOMPARE(matrix.eccentricity(150), size_t(150));
+}
+
+QTEST_APPLESS_MAIN(TopologicalDistanceMatrixTest)
@@ -0,0 +1,436 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fingerprintdatabasetest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <chemkit/fingerprint.h>
+#include <chemkit/fingerprintdatabase.h>
+
+namespace {
+
+// Returns a fingerprint with size bits where each bit is set with
+// the given probability.
+chemkit::Bitset randomFingerprint(size_t size, double probability)
+{
+    chemkit::Bitset fingerprint(size);
+
+    for(size_t i = 0; i < size; i++){
+        if(rand() < probability * RAND_MAX){
+            fingerprint.set(i);
+        }
+    }
+
+    return fingerprint;
+}
+
+chemkit::Real tanimoto(const chemkit::Bitset &a, const chemkit::Bitset &b)
+{
+    if(a.none() && b.none()){
+        return 0;
+    }
+
+    return chemkit::Fingerprint::tanimotoCoefficient(a, b);
+}
+
+bool hitLessThan(const chemkit::FingerprintDatabase::Hit &a,
+                 const chemkit::FingerprintDatabase::Hit &b)
+{
+    if(a.second != b.second){
+        return a.second > b.second;
+    }
+
+    return a.first < b.first;
+}
+
+// Returns every hit for query sorted from most to least similar.
+std::vector<chemkit::FingerprintDatabase::Hit> bruteForce(const std::vector<chemkit::Bitset> &fingerprints,
+                                                          const chemkit::Bitset &query)
+{
+    std::vector<chemkit::FingerprintDatabase::Hit> hits;
+
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        hits.push_back(std::make_pair(i, tanimoto(fingerprints[i], query)));
+    }
+
+    std::sort(hits.begin(), hits.end(), hitLessThan);
+
+    return hits;
+}
+
+} // end anonymous namespace
+
+void FingerprintDatabaseTest::basic()
+{
+    chemkit::FingerprintDatabase database(166);
+    QCOMPARE(database.size(), size_t(0));
+    QCOMPARE(database.isEmpty(), true);
+    QCOMPARE(database.bitCount(), size_t(166));
+    QCOMPARE(database.fingerprint(0), chemkit::Bitset());
+    QCOMPARE(database.id(0), std::string());
+}
+
+void FingerprintDatabaseTest::addFingerprint()
+{
+    chemkit::FingerprintDatabase database;
+    QCOMPARE(database.bitCount(), size_t(0));
+
+    chemkit::Bitset a(100);
+    a.set(0);
+    a.set(64);
+    a.set(99);
+    QCOMPARE(database.addFingerprint(a, "a"), size_t(0));
+    QCOMPARE(database.bitCount(), size_t(100));
+
+    chemkit::Bitset b(100);
+    b.set(5);
+    QCOMPARE(database.addFingerprint(b, "b"), size_t(1));
+
+    // bits past the end of the fingerprint are ignored
+    chemkit::Bitset c(200);
+    c.set(10);
+    c.set(150);
+    QCOMPARE(database.addFingerprint(c), size_t(2));
+
+    QCOMPARE(database.size(), size_t(3));
+    QCOMPARE(database.fingerprint(0), a);
+    QCOMPARE(database.fingerprint(1), b);
+    QCOMPARE(database.fingerprint(2).count(), size_t(1));
+    QCOMPARE(database.fingerprint(2).test(10), true);
+    QCOMPARE(database.id(0), std::string("a"));
+    QCOMPARE(database.id(1), std::string("b"));
+    QCOMPARE(database.id(2), std::string());
+
+    database.clear();
+    QCOMPARE(database.isEmpty(), true);
+    QCOMPARE(database.bitCount(), size_t(100));
+}
+
+void FingerprintDatabaseTest::tanimotoCoefficient()
+{
+    srand(2);
+
+    chemkit::FingerprintDatabase database(1021);
+    std::vector<chemkit::Bitset> fingerprints;
+    for(size_t i = 0; i < 50; i++){
+        fingerprints.push_back(randomFingerprint(1021, 0.2));
+        database.addFingerprint(fingerprints.back());
+    }
+
+    chemkit::Bitset query = randomFingerprint(1021, 0.2);
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        QCOMPARE(database.tanimotoCoefficient(query, i), tanimoto(query, fingerprints[i]));
+    }
+
+    // empty fingerprints have a similarity of zero
+    chemkit::FingerprintDatabase emptyDatabase(64);
+    emptyDatabase.addFingerprint(chemkit::Bitset(64));
+    QCOMPARE(emptyDatabase.tanimotoCoefficient(chemkit::Bitset(64), 0), chemkit::Real(0));
+}
+
+void FingerprintDatabaseTest::search()
+{
+    srand(3);
+
+    // enough fingerprints to be searched in parallel
+    chemkit::FingerprintDatabase database(256);
+    std::vector<chemkit::Bitset> fingerprints;
+    for(size_t i = 0; i < 20000; i++){
+        fingerprints.push_back(randomFingerprint(256, (i % 10 + 1) * 0.05));
+        database.addFingerprint(fingerprints.back());
+    }
+
+    chemkit::Bitset query = fingerprints[1234];
+
+    for(int i = 0; i < 3; i++){
+        chemkit::Real threshold = 0.3 + i * 0.2;
+
+        std::vector<chemkit::FingerprintDatabase::Hit> expected = bruteForce(fingerprints, query);
+        while(!expected.empty() && expected.back().second < threshold){
+            expected.pop_back();
+        }
+
+        std::vector<chemkit::FingerprintDatabase::Hit> hits = database.search(query, threshold);
+        QCOMPARE(hits.size(), expected.size());
+        QVERIFY(hits == expected);
+    }
+
+    std::vector<chemkit::FingerprintDatabase::Hit> exact = database.search(query, 1.0);
+    QCOMPARE(exact.size(), size_t(1));
+    QCOMPARE(exact[0].first, size_t(1234));
+    QCOMPARE(exact[0].second, chemkit::Real(1.0));
+}
+
+void FingerprintDatabaseTest::nearest()
+{
+    srand(4);
+
+    chemkit::FingerprintDatabase database(512);
+    std::vector<chemkit::Bitset> fingerprints;
+    for(size_t i = 0; i < 30000; i++){
+        fingerprints.push_back(randomFingerprint(512, (i % 7 + 1) * 0.04));
+        database.addFingerprint(fingerprints.back());
+    }
+
+    // add duplicates to check that ties are ordered by index
+    fingerprints.push_back(fingerprints[10]);
+    database.addFingerprint(fingerprints.back());
+    fingerprints.push_back(fingerprints[10]);
+    database.addFingerprint(fingerprints.back());
+
+    chemkit::Bitset query = randomFingerprint(512, 0.1);
+    std::vector<chemkit::FingerprintDatabase::Hit> expected = bruteForce(fingerprints, query);
+
+    for(size_t count = 1; count < 100; count *= 3){
+        std::vector<chemkit::FingerprintDatabase::Hit> hits = database.nearest(query, count);
+        QCOMPARE(hits.size(), count);
+        QVERIFY(std::equal(hits.begin(), hits.end(), expected.begin()));
+    }
+
+    std::vector<chemkit::FingerprintDatabase::Hit> hits = database.nearest(fingerprints[10], 3);
+    QCOMPARE(hits.size(), size_t(3));
+    QCOMPARE(hits[0].first, size_t(10));
+    QCOMPARE(hits[1].first, size_t(30000));
+    QCOMPARE(hits[2].first, size_t(30001));
+
+    QCOMPARE(database.nearest(query, 0).size(), size_t(0));
+    QCOMPARE(database.nearest(query, 50000).size(), fingerprints.size());
+}
+
+void FingerprintDatabaseTest::read()
+{
+    std::stringstream input;
+    input << "#FPS1\n"
+          << "#num_bits=12\n"
+          << "#type=Test/1\n"
+          << "0108\tfirst\n"
+          << "ff0f\tsecond\textra\n"
+          << "0000\n";
+
+    chemkit::FingerprintDatabase database;
+    bool ok = database.read(input);
+    if(!ok)
+        qDebug() << database.errorString().c_str();
+    QVERIFY(ok);
+    QCOMPARE(database.size(), size_t(3));
+    QCOMPARE(database.bitCount(), size_t(12));
+
+    // bits are stored in little endian order
+    chemkit::Bitset first = database.fingerprint(0);
+    QCOMPARE(first.size(), size_t(12));
+    QCOMPARE(first.count(), size_t(2));
+    QCOMPARE(first.test(0), true);
+    QCOMPARE(first.test(11), true);
+    QCOMPARE(database.id(0), std::string("first"));
+
+    QCOMPARE(database.fingerprint(1).count(), size_t(12));
+    QCOMPARE(database.id(1), std::string("second"));
+    QCOMPARE(database.fingerprint(2).count(), size_t(0));
+    QCOMPARE(database.id(2), std::string());
+
+    // without a num_bits header the size comes from the first line
+    std::stringstream headerless("0102030405060708\tid\n");
+    QVERIFY(database.read(headerless));
+    QCOMPARE(database.bitCount(), size_t(64));
+    QCOMPARE(database.size(), size_t(1));
+}
+
+void FingerprintDatabaseTest::readInvalid()
+{
+    chemkit::FingerprintDatabase database;
+
+    std::stringstream shortLine("#num_bits=32\n00112233\tok\n0011\tshort\n");
+    QCOMPARE(database.read(shortLine), false);
+    QVERIFY(!database.errorString().empty());
+    QCOMPARE(database.size(), size_t(0));
+
+    std::stringstream notHex("#num_bits=8\nzz\tbad\n");
+    QCOMPARE(database.read(notHex), false);
+
+    QCOMPARE(database.read("invalid_file.fps"), false);
+}
+
+void FingerprintDatabaseTest::write()
+{
+    srand(5);
+
+    chemkit::FingerprintDatabase database(300);
+    std::vector<chemkit::Bitset> fingerprints;
+    for(size_t i = 0; i < 10000; i++){
+        fingerprints.push_back(randomFingerprint(300, (i % 5 + 1) * 0.05));
+        database.addFingerprint(fingerprints.back(), "id" + boost::lexical_cast<std::string>(i));
+    }
+
+    const std::string fileName = "fingerprintdatabasetest.fpdb";
+    bool ok = database.write(fileName);
+    if(!ok)
+        qDebug() << database.errorString().c_str();
+    QVERIFY(ok);
+
+    // read the database back from the mapped file
+    chemkit::FingerprintDatabase mapped;
+    ok = mapped.read(fileName);
+    if(!ok)
+        qDebug() << mapped.errorString().c_str();
+    QVERIFY(ok);
+    QCOMPARE(mapped.size(), size_t(10000));
+    QCOMPARE(mapped.bitCount(), size_t(300));
+
+    for(size_t i = 0; i < fingerprints.size(); i += 37){
+        QCOMPARE(mapped.fingerprint(i), fingerprints[i]);
+        QCOMPARE(mapped.id(i), "id" + boost::lexical_cast<std::string>(i));
+    }
+
+    chemkit::Bitset query = randomFingerprint(300, 0.15);
+    QVERIFY(mapped.search(query, 0.3) == database.search(query, 0.3));
+    QVERIFY(mapped.nearest(query, 20) == database.nearest(query, 20));
+    QCOMPARE(mapped.tanimotoCoefficient(query, 42), database.tanimotoCoefficient(query, 42));
+
+    // writing a mapped database produces the same file
+    const std::string copyFileName = "fingerprintdatabasetest-copy.fpdb";
+    QVERIFY(mapped.write(copyFileName));
+    std::ifstream original(fileName.c_str(), std::ios::binary);
+    std::ifstream copy(copyFileName.c_str(), std::ios::binary);
+    QVERIFY(std::equal(std::istreambuf_iterator<char>(original),
+                       std::istreambuf_iterator<char>(),
+                       std::istreambuf_iterator<char>(copy)));
+
+    // modifying the database copies it into memory
+    size_t index = mapped.addFingerprint(query, "query");
+    QCOMPARE(index, size_t(10000));
+    QCOMPARE(mapped.size(), size_t(10001));
+    QCOMPARE(mapped.fingerprint(index), query);
+    QCOMPARE(mapped.id(9999), std::string("id9999"));
+    QCOMPARE(mapped.fingerprint(9999), fingerprints[9999]);
+    QCOMPARE(mapped.nearest(query, 1)[0].first, index);
+
+    std::remove(fileName.c_str());
+    std::remove(copyFileName.c_str());
+}
+
+void FingerprintDatabaseTest::writeInvalid()
+{
+    chemkit::FingerprintDatabase database(16);
+    database.addFingerprint(chemkit::Bitset(16, 0xff), "a");
+
+    const std::string fileName = "fingerprintdatabasetest-truncated.fpdb";
+    QVERIFY(database.write(fileName));
+
+    // truncate the file
+    std::string data;
+    std::ifstream input(fileName.c_str(), std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    input.close();
+    std::ofstream output(fileName.c_str(), std::ios::binary);
+    output.write(data.c_str(), data.size() - 4);
+    output.close();
+
+    chemkit::FingerprintDatabase truncated;
+    QCOMPARE(truncated.read(fileName), false);
+    QVERIFY(!truncated.errorString().empty());
+    QCOMPARE(truncated.size(), size_t(0));
+
+    std::remove(fileName.c_str());
+}
+
+void FingerprintDatabaseTest::readCorrupt()
+{
+    chemkit::FingerprintDatabase database(16);
+    database.addFingerprint(chemkit::Bitset(16, 0x00ff), "a");
+    database.addFingerprint(chemkit::Bitset(16, 0x000f), "b");
+    database.addFingerprint(chemkit::Bitset(16, 0x0fff), "c");
+
+    const std::string fileName = "fingerprintdatabasetest-corrupt.fpdb";
+    QVERIFY(database.write(fileName));
+
+    std::string data;
+    std::ifstream input(fileName.c_str(), std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    input.close();
+
+    // the header is 32 bytes followed by bucketOffsets[18], blocks[3],
+    // indices[3], positions[3] and idOffsets[4]
+    const size_t sizeOffset = 16;
+    const size_t bucketOffsetsOffset = 32;
+    const size_t positionsOffset = bucketOffsetsOffset + (18 + 3 + 3) * 8;
+    const size_t idOffsetsOffset = positionsOffset + 3 * 8;
+
+    std::vector<std::pair<size_t, boost::uint64_t> > corruptions;
+    corruptions.push_back(std::make_pair(sizeOffset, boost::uint64_t(0x2000000000000000ULL)));
+    corruptions.push_back(std::make_pair(sizeOffset, boost::uint64_t(-1)));
+    corruptions.push_back(std::make_pair(bucketOffsetsOffset + 17 * 8, boost::uint64_t(2)));
+    corruptions.push_back(std::make_pair(bucketOffsetsOffset + 10 * 8, boost::uint64_t(-1)));
+    corruptions.push_back(std::make_pair(positionsOffset + 8, boost::uint64_t(3)));
+    corruptions.push_back(std::make_pair(idOffsetsOffset + 8, boost::uint64_t(1000)));
+    corruptions.push_back(std::make_pair(idOffsetsOffset + 3 * 8, boost::uint64_t(0)));
+
+    for(size_t i = 0; i < corruptions.size(); i++){
+        std::string corrupt = data;
+        std::copy(reinterpret_cast<const char *>(&corruptions[i].second),
+                  reinterpret_cast<const char *>(&corruptions[i].second) + sizeof(boost::uint64_t),
+                  corrupt.begin() + corruptions[i].first);
+
+        std::ofstream output(fileName.c_str(), std::ios::binary);
+        output.write(corrupt.c_str(), corrupt.size());
+        output.close();
+
+        chemkit::FingerprintDatabase mapped;
+        QCOMPARE(mapped.read(fileName), false);
+        QVERIFY(!mapped.errorString().empty());
+        QCOMPARE(mapped.size(), size_t(0));
+    }
+
+    // a file shorter than the header
+    std::ofstream output(fileName.c_str(), std::ios::binary);
+    output.write(data.c_str(), 12);
+    output.close();
+
+    chemkit::FingerprintDatabase truncated;
+    QCOMPARE(truncated.read(fileName), false);
+    QVERIFY(!truncated.errorString().empty());
+
+    std::remove(fileName.c_str());
+}
+
+QTEST_APPLESS_MAIN(FingerprintDatabaseTest)
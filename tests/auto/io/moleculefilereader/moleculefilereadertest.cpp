@@ -0,0 +1,80 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "moleculefilereadertest.h"
+
+#include <sstream>
+
+#include <chemkit/molecule.h>
+#include <chemkit/moleculefilereader.h>
+
+void MoleculeFileReaderTest::fileName()
+{
+    chemkit::MoleculeFileReader reader;
+    QCOMPARE(reader.fileName(), std::string());
+
+    chemkit::MoleculeFileReader readerWithName("foo");
+    QCOMPARE(readerWithName.fileName(), std::string("foo"));
+}
+
+void MoleculeFileReaderTest::format()
+{
+    chemkit::MoleculeFileReader reader;
+    QVERIFY(reader.format() == 0);
+    QCOMPARE(reader.formatName(), std::string());
+
+    QCOMPARE(reader.setFormat("invalid_format"), false);
+    QVERIFY(reader.format() == 0);
+}
+
+void MoleculeFileReaderTest::open()
+{
+    // no file name
+    chemkit::MoleculeFileReader reader;
+    QCOMPARE(reader.open(), false);
+    QCOMPARE(reader.isOpen(), false);
+    QVERIFY(reader.atEnd());
+    QVERIFY(reader.readNext() == 0);
+
+    // no format
+    std::stringstream input;
+    QCOMPARE(reader.open(input), false);
+    QCOMPARE(reader.isOpen(), false);
+    QVERIFY(reader.readNext() == 0);
+    QCOMPARE(reader.position(), size_t(0));
+    QVERIFY(reader.begin() == reader.end());
+}
+
+QTEST_APPLESS_MAIN(MoleculeFileReaderTest)
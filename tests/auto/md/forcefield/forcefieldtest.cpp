@@ -35,11 +35,15 @@
 
 #include "forcefieldtest.h" 
 
+#include <cmath>
+#include <cstring>
 #include <algorithm>
 
+#include <chemkit/atom.h>
 #include <chemkit/chemkit.h>
 #include <chemkit/molecule.h>
 #include <chemkit/forcefield.h>
+#include <chemkit/cartesiancoordinates.h>
 
 #include "mockforcefield.h"
 
@@ -68,6 +72,95 @@ void ForceFieldTest::name()
     delete forceField;
 }
 
+void ForceFieldTest::nonbondedCutoff()
+{
+    // build a pentanol molecule spanning about 20 angstroms
+    chemkit::Molecule molecule("CCCCCO", "smiles");
+    for(size_t i = 0; i < molecule.size(); i++){
+        molecule.atom(i)->setPosition(i * 1.1, std::sin(i) * 1.3, std::cos(i) * 1.3);
+    }
+    const chemkit::CartesianCoordinates *coordinates = molecule.coordinates();
+
+    // energy and gradient without a cutoff
+    chemkit::ForceField *forceField = chemkit::ForceField::create("uff");
+    QVERIFY(forceField != 0);
+    QCOMPARE(forceField->nonbondedCutoff(), chemkit::Real(0));
+    forceField->setTopologyFromMolecule(&molecule);
+    QVERIFY(forceField->setup());
+    size_t calculationCount = forceField->calculationCount();
+    chemkit::Real energy = forceField->energy(coordinates);
+    std::vector<chemkit::Vector3> gradient = forceField->gradient(coordinates);
+
+    // a cutoff larger than the molecule includes every nonbonded pair,
+    // both when set before setup() and when enabled afterwards
+    chemkit::ForceField *cutoffForceField = chemkit::ForceField::create("uff");
+    cutoffForceField->setNonbondedCutoff(100.0);
+    QCOMPARE(cutoffForceField->nonbondedCutoff(), chemkit::Real(100.0));
+    cutoffForceField->setTopologyFromMolecule(&molecule);
+    QVERIFY(cutoffForceField->setup());
+
+    forceField->setNonbondedCutoff(100.0);
+
+    chemkit::ForceField *forceFields[] = { cutoffForceField, forceField };
+    for(size_t i = 0; i < 2; i++){
+        QVERIFY(std::abs(forceFields[i]->energy(coordinates) - energy) < 1e-6 * std::abs(energy));
+        QCOMPARE(forceFields[i]->calculationCount(), calculationCount);
+
+        std::vector<chemkit::Vector3> cutoffGradient = forceFields[i]->gradient(coordinates);
+        QCOMPARE(cutoffGradient.size(), gradient.size());
+        for(size_t j = 0; j < gradient.size(); j++){
+            QVERIFY((cutoffGradient[j] - gradient[j]).norm() < 1e-6);
+        }
+    }
+
+    // disabling the cutoff again restores the original calculations
+    forceField->setNonbondedCutoff(0);
+    QCOMPARE(forceField->calculationCount(), calculationCount);
+    QVERIFY(std::abs(forceField->energy(coordinates) - energy) < 1e-6 * std::abs(energy));
+
+    delete cutoffForceField;
+    delete forceField;
+}
+
+// The threadCount() method checks that the energy is bit-identical for
+// any number of threads, including one, when the calculations are split
+// into more than one chunk.
+void ForceFieldTest::threadCount()
+{
+    for(size_t length = 30; length <= 70; length += 10){
+        // build a chain with several thousand nonbonded interactions
+        chemkit::Molecule molecule(std::string(length, 'C'), "smiles");
+        for(size_t i = 0; i < molecule.size(); i++){
+            molecule.atom(i)->setPosition(i * 1.1, std::sin(i) * 1.3, std::cos(i) * 1.3);
+        }
+        const chemkit::CartesianCoordinates *coordinates = molecule.coordinates();
+
+        chemkit::ForceField *forceField = chemkit::ForceField::create("uff");
+        QVERIFY(forceField != 0);
+        QCOMPARE(forceField->threadCount(), size_t(1));
+        forceField->setTopologyFromMolecule(&molecule);
+        QVERIFY(forceField->setup());
+        QVERIFY(forceField->calculationCount() > 4096);
+
+        std::vector<chemkit::Vector3> gradient;
+        chemkit::Real energy = forceField->energy(coordinates);
+        chemkit::Real combinedEnergy = forceField->energyAndGradient(coordinates, gradient);
+        QVERIFY(std::memcmp(&combinedEnergy, &energy, sizeof(energy)) == 0);
+
+        for(size_t threadCount = 2; threadCount <= 4; threadCount++){
+            forceField->setThreadCount(threadCount);
+
+            chemkit::Real threadedEnergy = forceField->energy(coordinates);
+            QVERIFY(std::memcmp(&threadedEnergy, &energy, sizeof(energy)) == 0);
+
+            threadedEnergy = forceField->energyAndGradient(coordinates, gradient);
+            QVERIFY(std::memcmp(&threadedEnergy, &energy, sizeof(energy)) == 0);
+        }
+
+        delete forceField;
+    }
+}
+
 void ForceFieldTest::cleanupTestCase()
 {
     delete m_plugin;
@@ -51,6 +51,8 @@ class ForceFieldTest : public QObject
         void initTestCase();
         void create();
         void name();
+        void nonbondedCutoff();
+        void threadCount();
         void cleanupTestCase();
 };
 
@@ -82,4 +82,83 @@ void MoleculeGeometryOptimizerTest::water()
     QCOMPARE(qRound(molecule.bondAngle(H2, O1, H3)), 104);
 }
 
+void MoleculeGeometryOptimizerTest::algorithm()
+{
+    chemkit::MoleculeGeometryOptimizer optimizer;
+    QCOMPARE(optimizer.algorithm(), chemkit::MoleculeGeometryOptimizer::Lbfgs);
+
+    optimizer.setAlgorithm(chemkit::MoleculeGeometryOptimizer::ConjugateGradient);
+    QCOMPARE(optimizer.algorithm(), chemkit::MoleculeGeometryOptimizer::ConjugateGradient);
+
+    optimizer.setAlgorithm(chemkit::MoleculeGeometryOptimizer::SteepestDescent);
+    QCOMPARE(optimizer.algorithm(), chemkit::MoleculeGeometryOptimizer::SteepestDescent);
+}
+
+void MoleculeGeometryOptimizerTest::algorithms()
+{
+    chemkit::MoleculeGeometryOptimizer::Algorithm algorithms[] = {
+        chemkit::MoleculeGeometryOptimizer::SteepestDescent,
+        chemkit::MoleculeGeometryOptimizer::ConjugateGradient,
+        chemkit::MoleculeGeometryOptimizer::Lbfgs
+    };
+
+    size_t steepestDescentEvaluationCount = 0;
+
+    for(int i = 0; i < 3; i++){
+        // build distorted ethane molecule
+        chemkit::Molecule molecule("CC", "smiles");
+
+        for(size_t j = 0; j < molecule.size(); j++){
+            molecule.atom(j)->setPosition(j * 0.9, (j % 3) * 0.7, (j % 2) * 0.8);
+        }
+
+        chemkit::MoleculeGeometryOptimizer optimizer(&molecule);
+        optimizer.setAlgorithm(algorithms[i]);
+
+        bool ok = optimizer.optimize();
+        QVERIFY(ok);
+        QVERIFY(optimizer.converged());
+        QVERIFY(optimizer.evaluationCount() > 0);
+        QCOMPARE(molecule.formula(), std::string("C2H6"));
+        QCOMPARE(qRound(molecule.atom(0)->distance(molecule.atom(1)) * 10), 15);
+
+        if(algorithms[i] == chemkit::MoleculeGeometryOptimizer::SteepestDescent){
+            steepestDescentEvaluationCount = optimizer.evaluationCount();
+        }
+        else{
+            QVERIFY(optimizer.evaluationCount() < steepestDescentEvaluationCount);
+        }
+    }
+}
+
+void MoleculeGeometryOptimizerTest::step()
+{
+    // no molecule or force field
+    chemkit::MoleculeGeometryOptimizer optimizer;
+    QCOMPARE(optimizer.step(), false);
+
+    chemkit::Molecule molecule("CC", "smiles");
+
+    for(size_t i = 0; i < molecule.size(); i++){
+        molecule.atom(i)->setPosition(i * 0.9, (i % 3) * 0.7, (i % 2) * 0.8);
+    }
+
+    optimizer.setMolecule(&molecule);
+    QVERIFY(optimizer.setup());
+
+    // step until converged
+    size_t stepCount = 0;
+    while(!optimizer.converged()){
+        QVERIFY(optimizer.step());
+        QVERIFY(++stepCount < 1000);
+    }
+
+    // keep stepping at the minimum until the minimizer stalls
+    stepCount = 0;
+    while(optimizer.step()){
+        QVERIFY(++stepCount < 1000);
+    }
+    QVERIFY(optimizer.converged());
+}
+
 QTEST_APPLESS_MAIN(MoleculeGeometryOptimizerTest)
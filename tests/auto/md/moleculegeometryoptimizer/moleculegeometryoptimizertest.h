@@ -45,6 +45,9 @@ class MoleculeGeometryOptimizerTest : public QObject
     private slots:
         void molecule();
         void water();
+        void algorithm();
+        void algorithms();
+        void step();
 };
 
 #endif // MOLECULEGEOMTRYOPTIMIZERTEST_H
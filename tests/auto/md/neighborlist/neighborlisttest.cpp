@@ -0,0 +1,121 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "neighborlisttest.h"
+
+#include <chemkit/topology.h>
+#include <chemkit/neighborlist.h>
+#include <chemkit/cartesiancoordinates.h>
+
+void NeighborListTest::basic()
+{
+    chemkit::Topology topology(3);
+
+    chemkit::CartesianCoordinates coordinates(3);
+    coordinates.setPosition(0, 0, 0, 0);
+    coordinates.setPosition(1, 4, 0, 0);
+    coordinates.setPosition(2, 20, 0, 0);
+
+    chemkit::NeighborList neighborList(&topology, 5.0, 1.0);
+    QCOMPARE(neighborList.cutoff(), chemkit::Real(5.0));
+    QCOMPARE(neighborList.skin(), chemkit::Real(1.0));
+    QCOMPARE(neighborList.pairCount(), size_t(0));
+
+    neighborList.update(&coordinates);
+    QCOMPARE(neighborList.pairCount(), size_t(1));
+
+    const chemkit::NeighborList::Pair &pair = neighborList.pairs().front();
+    QCOMPARE(pair[0], size_t(0));
+    QCOMPARE(pair[1], size_t(1));
+
+    // pairs within the skin distance are included
+    coordinates.setPosition(2, 9.5, 0, 0);
+    neighborList.rebuild(&coordinates);
+    QCOMPARE(neighborList.pairCount(), size_t(2));
+}
+
+void NeighborListTest::exclusions()
+{
+    // linear chain of bonded atoms: 0-1-2-3
+    chemkit::Topology topology(4);
+    topology.addBondedInteraction(0, 1);
+    topology.addBondedInteraction(1, 2);
+    topology.addBondedInteraction(2, 3);
+
+    chemkit::CartesianCoordinates coordinates(4);
+    for(int i = 0; i < 4; i++){
+        coordinates.setPosition(i, i * 1.5, 0, 0);
+    }
+
+    chemkit::NeighborList neighborList(&topology, 10.0);
+    QVERIFY(neighborList.isExcluded(0, 1));
+    QVERIFY(neighborList.isExcluded(2, 0));
+    QVERIFY(!neighborList.isExcluded(0, 3));
+
+    // only the 1-4 pair is not excluded
+    neighborList.update(&coordinates);
+    QCOMPARE(neighborList.pairCount(), size_t(1));
+    QCOMPARE(neighborList.pairs().front()[0], size_t(0));
+    QCOMPARE(neighborList.pairs().front()[1], size_t(3));
+}
+
+void NeighborListTest::update()
+{
+    chemkit::Topology topology(2);
+
+    chemkit::CartesianCoordinates coordinates(2);
+    coordinates.setPosition(0, 0, 0, 0);
+    coordinates.setPosition(1, 3, 0, 0);
+
+    chemkit::NeighborList neighborList(&topology, 5.0, 2.0);
+    QVERIFY(neighborList.needsUpdate(&coordinates));
+    QCOMPARE(neighborList.update(&coordinates), true);
+    QCOMPARE(neighborList.update(&coordinates), false);
+
+    // moving less than half of the skin distance does not require
+    // the list to be rebuilt
+    coordinates.setPosition(1, 3.5, 0, 0);
+    QVERIFY(!neighborList.needsUpdate(&coordinates));
+    QCOMPARE(neighborList.update(&coordinates), false);
+
+    coordinates.setPosition(1, 4.5, 0, 0);
+    QVERIFY(neighborList.needsUpdate(&coordinates));
+    QCOMPARE(neighborList.update(&coordinates), true);
+
+    neighborList.invalidate();
+    QVERIFY(neighborList.needsUpdate(&coordinates));
+}
+
+QTEST_APPLESS_MAIN(NeighborListTest)
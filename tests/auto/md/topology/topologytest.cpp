@@ -46,4 +46,57 @@ void TopologyTest::size()
     QCOMPARE(topology.size(), size_t(100));
 }
 
+void TopologyTest::interactionTypes()
+{
+    // butane
+    chemkit::Topology topology(4);
+    topology.addBondedInteraction(0, 1);
+    topology.addBondedInteraction(1, 2);
+    topology.addBondedInteraction(2, 3);
+    topology.addAngleInteraction(0, 1, 2);
+    topology.addAngleInteraction(1, 2, 3);
+    topology.addTorsionInteraction(0, 1, 2, 3);
+
+    topology.setBondedInteractionType(1, 2, 1);
+    topology.setAngleInteractionType(1, 2, 3, 2);
+    topology.setTorsionInteractionType(0, 1, 2, 3, 3);
+
+    // types are only set for the given order
+    topology.setBondedInteractionType(1, 0, 4);
+    topology.setAngleInteractionType(2, 1, 0, 5);
+    topology.setTorsionInteractionType(3, 2, 1, 0, 6);
+
+    QCOMPARE(topology.bondedInteractionType(0, 1), 0);
+    QCOMPARE(topology.bondedInteractionType(1, 2), 1);
+    QCOMPARE(topology.bondedInteractionType(2, 1), 1);
+    QCOMPARE(topology.bondedInteractionType(0, 3), 0);
+    QCOMPARE(topology.angleInteractionType(0, 1, 2), 0);
+    QCOMPARE(topology.angleInteractionType(1, 2, 3), 2);
+    QCOMPARE(topology.angleInteractionType(3, 2, 1), 2);
+    QCOMPARE(topology.angleInteractionType(0, 2, 1), 0);
+    QCOMPARE(topology.torsionInteractionType(0, 1, 2, 3), 3);
+    QCOMPARE(topology.torsionInteractionType(3, 2, 1, 0), 3);
+    QCOMPARE(topology.torsionInteractionType(0, 2, 1, 3), 0);
+
+    // atoms outside of the topology
+    QCOMPARE(topology.bondedInteractionType(10, 11), 0);
+    QCOMPARE(topology.angleInteractionType(10, 11, 12), 0);
+    QCOMPARE(topology.torsionInteractionType(10, 11, 12, 13), 0);
+}
+
+void TopologyTest::isOneFour()
+{
+    chemkit::Topology topology(5);
+    topology.addTorsionInteraction(0, 1, 2, 3);
+    topology.addTorsionInteraction(4, 3, 2, 1);
+
+    QCOMPARE(topology.isOneFour(0, 3), true);
+    QCOMPARE(topology.isOneFour(3, 0), true);
+    QCOMPARE(topology.isOneFour(1, 4), true);
+    QCOMPARE(topology.isOneFour(4, 1), true);
+    QCOMPARE(topology.isOneFour(0, 1), false);
+    QCOMPARE(topology.isOneFour(0, 4), false);
+    QCOMPARE(topology.isOneFour(10, 0), false);
+}
+
 QTEST_APPLESS_MAIN(TopologyTest)
@@ -46,6 +46,8 @@ class TopologyTest : public QObject
 
     private slots:
         void size();
+        void interactionTypes();
+        void isOneFour();
 };
 
 #endif // TOPOLOGYTEST_H
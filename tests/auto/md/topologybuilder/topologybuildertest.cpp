@@ -36,6 +36,7 @@
 #include "topologybuildertest.h"
 
 #include <chemkit/atom.h>
+#include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
 #include <chemkit/topology.h>
 #include <chemkit/topologybuilder.h>
@@ -70,4 +71,40 @@ void TopologyBuilderTest::phenol()
     }
 }
 
+void TopologyBuilderTest::nonbondedCutoff()
+{
+    // linear chain of carbon atoms spaced 1.5 angstroms apart
+    chemkit::Molecule molecule;
+    chemkit::Atom *previous = 0;
+    for(int i = 0; i < 20; i++){
+        chemkit::Atom *atom = molecule.addAtom("C");
+        atom->setPosition(i * 1.5, 0, 0);
+
+        if(previous){
+            molecule.addBond(previous, atom);
+        }
+
+        previous = atom;
+    }
+
+    chemkit::TopologyBuilder builder;
+    QCOMPARE(builder.nonbondedCutoff(), chemkit::Real(0));
+    builder.addMolecule(&molecule);
+
+    // every pair not within two bonds
+    QCOMPARE(builder.topology()->nonbondedInteractionCount(), size_t(20 * 19 / 2 - 19 - 18));
+
+    // only pairs within five angstroms (three bonds apart)
+    chemkit::TopologyBuilder cutoffBuilder;
+    cutoffBuilder.setNonbondedCutoff(5.0);
+    QCOMPARE(cutoffBuilder.nonbondedCutoff(), chemkit::Real(5.0));
+    cutoffBuilder.addMolecule(&molecule);
+
+    boost::shared_ptr<chemkit::Topology> topology = cutoffBuilder.topology();
+    QCOMPARE(topology->nonbondedInteractionCount(), size_t(17));
+    foreach(const chemkit::Topology::NonbondedInteraction &interaction, topology->nonbondedInteractions()){
+        QCOMPARE(interaction[1] - interaction[0], size_t(3));
+    }
+}
+
 QTEST_APPLESS_MAIN(TopologyBuilderTest)
@@ -44,6 +44,7 @@ class TopologyBuilderTest : public QObject
 
     private slots:
         void phenol();
+        void nonbondedCutoff();
 };
 
 #endif // TOPOLOGYBUILDERTEST_H
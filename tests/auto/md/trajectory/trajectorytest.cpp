@@ -0,0 +1,230 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "trajectorytest.h"
+
+#include <boost/make_shared.hpp>
+
+#include <chemkit/trajectory.h>
+#include <chemkit/trajectoryframe.h>
+#include <chemkit/trajectorystore.h>
+
+// generates frames where each position is (frame, particle, 0)
+class CountingStore : public chemkit::TrajectoryStore
+{
+public:
+    CountingStore(size_t size, size_t frameCount)
+        : m_size(size),
+          m_frameCount(frameCount),
+          m_readCount(0)
+    {
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    size_t frameCount() const
+    {
+        return m_frameCount;
+    }
+
+    bool readFrame(size_t index, chemkit::TrajectoryFrame *frame)
+    {
+        for(size_t i = 0; i < m_size; i++){
+            frame->setPosition(i, chemkit::Point3(index, i, 0));
+        }
+
+        frame->setTime(index * 2);
+        m_readCount++;
+
+        return true;
+    }
+
+    size_t readCount() const
+    {
+        return m_readCount;
+    }
+
+private:
+    size_t m_size;
+    size_t m_frameCount;
+    size_t m_readCount;
+};
+
+// fails to read every frame with an odd index
+class FailingStore : public CountingStore
+{
+public:
+    FailingStore(size_t size, size_t frameCount)
+        : CountingStore(size, frameCount)
+    {
+    }
+
+    bool readFrame(size_t index, chemkit::TrajectoryFrame *frame)
+    {
+        CountingStore::readFrame(index, frame);
+
+        return index % 2 == 0;
+    }
+};
+
+void TrajectoryTest::basic()
+{
+    chemkit::Trajectory trajectory(4);
+    QCOMPARE(trajectory.size(), size_t(4));
+    QVERIFY(trajectory.isEmpty());
+    QVERIFY(trajectory.store() == 0);
+
+    chemkit::TrajectoryFrame *frame = trajectory.addFrame();
+    QCOMPARE(trajectory.frameCount(), size_t(1));
+    QCOMPARE(frame->size(), size_t(4));
+    QCOMPARE(frame->index(), size_t(0));
+    QVERIFY(frame->trajectory() == &trajectory);
+
+    frame->setPosition(2, chemkit::Point3(1, 2, 3));
+    QVERIFY(frame->position(2) == chemkit::Point3(1, 2, 3));
+
+    trajectory.resize(6);
+    QCOMPARE(frame->size(), size_t(6));
+    QVERIFY(frame->position(2) == chemkit::Point3(1, 2, 3));
+}
+
+void TrajectoryTest::removeFrame()
+{
+    chemkit::Trajectory trajectory(2);
+    chemkit::TrajectoryFrame *a = trajectory.addFrame();
+    chemkit::TrajectoryFrame *b = trajectory.addFrame();
+    chemkit::TrajectoryFrame *c = trajectory.addFrame();
+    QCOMPARE(c->index(), size_t(2));
+
+    QVERIFY(trajectory.removeFrame(a));
+    QCOMPARE(trajectory.frameCount(), size_t(2));
+    QCOMPARE(b->index(), size_t(0));
+    QCOMPARE(c->index(), size_t(1));
+    QVERIFY(trajectory.frames()[1] == c);
+
+    QVERIFY(!trajectory.removeFrame(a));
+}
+
+void TrajectoryTest::store()
+{
+    boost::shared_ptr<CountingStore> store = boost::make_shared<CountingStore>(5, 100);
+
+    chemkit::Trajectory trajectory(store);
+    QCOMPARE(trajectory.size(), size_t(5));
+    QCOMPARE(trajectory.frameCount(), size_t(100));
+    QVERIFY(trajectory.store() == store);
+
+    // frames are not read until they are accessed
+    QCOMPARE(store->readCount(), size_t(0));
+    QCOMPARE(trajectory.frame(42)->size(), size_t(5));
+    QCOMPARE(trajectory.frame(42)->index(), size_t(42));
+    QCOMPARE(store->readCount(), size_t(0));
+    QCOMPARE(trajectory.cachedFrameCount(), size_t(0));
+
+    QVERIFY(trajectory.frame(42)->position(3) == chemkit::Point3(42, 3, 0));
+    QCOMPARE(trajectory.frame(42)->time(), chemkit::Real(84));
+    QCOMPARE(store->readCount(), size_t(1));
+    QCOMPARE(trajectory.cachedFrameCount(), size_t(1));
+
+    // removing a loaded frame releases it
+    QVERIFY(trajectory.removeFrame(trajectory.frame(42)));
+    QCOMPARE(trajectory.frameCount(), size_t(99));
+    QCOMPARE(trajectory.cachedFrameCount(), size_t(0));
+    QVERIFY(trajectory.frame(42)->position(0) == chemkit::Point3(43, 0, 0));
+}
+
+void TrajectoryTest::cacheSize()
+{
+    boost::shared_ptr<CountingStore> store = boost::make_shared<CountingStore>(1000, 50);
+
+    chemkit::Trajectory trajectory(store);
+
+    // each frame uses at least 24000 bytes of coordinates
+    trajectory.setCacheSize(100000);
+    QCOMPARE(trajectory.cacheSize(), size_t(100000));
+
+    for(size_t i = 0; i < trajectory.frameCount(); i++){
+        QVERIFY(trajectory.frame(i)->position(999) == chemkit::Point3(i, 999, 0));
+        QVERIFY(trajectory.cachedFrameCount() <= 4);
+    }
+    QCOMPARE(store->readCount(), size_t(50));
+
+    // recently used frames are not read again
+    size_t cached = trajectory.cachedFrameCount();
+    for(size_t i = 50 - cached; i < 50; i++){
+        trajectory.frame(i)->position(0);
+    }
+    QCOMPARE(store->readCount(), size_t(50));
+
+    // frames which were released are read again
+    QVERIFY(trajectory.frame(0)->position(1) == chemkit::Point3(0, 1, 0));
+    QCOMPARE(store->readCount(), size_t(51));
+
+    // the most recently used frame is always kept
+    trajectory.setCacheSize(0);
+    QCOMPARE(trajectory.cachedFrameCount(), size_t(1));
+    trajectory.frame(0)->position(0);
+    QCOMPARE(store->readCount(), size_t(51));
+}
+
+void TrajectoryTest::readError()
+{
+    boost::shared_ptr<FailingStore> store = boost::make_shared<FailingStore>(1000, 10);
+
+    chemkit::Trajectory trajectory(store);
+    QVERIFY(trajectory.errorString().empty());
+
+    QVERIFY(trajectory.frame(0)->coordinates() != 0);
+    QCOMPARE(trajectory.cachedFrameCount(), size_t(1));
+
+    // frames which fail to read are not kept in the cache
+    QVERIFY(trajectory.frame(1)->coordinates() == 0);
+    QVERIFY(trajectory.frame(1)->position(5) == chemkit::Point3(0, 0, 0));
+    QCOMPARE(trajectory.cachedFrameCount(), size_t(1));
+    QVERIFY(!trajectory.errorString().empty());
+
+    // and do not count towards the cache size
+    trajectory.setCacheSize(30000);
+    for(size_t i = 0; i < trajectory.frameCount(); i += 2){
+        QVERIFY(trajectory.frame(i)->coordinates() != 0);
+        trajectory.frame(i + 1)->coordinates();
+        QCOMPARE(trajectory.cachedFrameCount(), size_t(1));
+    }
+}
+
+QTEST_APPLESS_MAIN(TrajectoryTest)
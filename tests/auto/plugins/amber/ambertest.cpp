@@ -35,6 +35,8 @@
 
 #include "ambertest.h"
 
+#include <cstring>
+
 #include <boost/range/algorithm.hpp>
 
 #include <chemkit/atom.h>
@@ -43,6 +45,7 @@
 #include <chemkit/atomtyper.h>
 #include <chemkit/forcefield.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/cartesiancoordinates.h>
 #include <chemkit/moleculardescriptor.h>
 
 #ifdef CHEMKIT_WITH_MD_IO
@@ -204,4 +207,38 @@ void AmberTest::water()
     delete forceField;
 }
 
+// The energyAndGradient() method checks that the combined energy and
+// gradient calculation gives the same results as calculating them
+// separately.
+void AmberTest::energyAndGradient()
+{
+    std::vector<std::string> fileNames;
+    fileNames.push_back("adenosine.mol");
+    fileNames.push_back("serine.mol");
+
+    std::vector<chemkit::Vector3> gradient;
+
+    for(size_t i = 0; i < fileNames.size(); i++){
+        boost::shared_ptr<chemkit::Molecule> molecule =
+            chemkit::MoleculeFile::quickRead(dataPath + fileNames[i]);
+        QVERIFY(molecule != 0);
+        const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+        chemkit::ForceField *forceField = chemkit::ForceField::create("amber");
+        QVERIFY(forceField != 0);
+        forceField->setTopologyFromMolecule(molecule.get());
+        QVERIFY(forceField->setup());
+
+        chemkit::Real energy = forceField->energyAndGradient(coordinates, gradient);
+        chemkit::Real expectedEnergy = forceField->energy(coordinates);
+        QVERIFY(memcmp(&energy, &expectedEnergy, sizeof(chemkit::Real)) == 0);
+
+        std::vector<chemkit::Vector3> expectedGradient = forceField->gradient(coordinates);
+        QCOMPARE(gradient.size(), expectedGradient.size());
+        QVERIFY(memcmp(&gradient[0], &expectedGradient[0], gradient.size() * sizeof(chemkit::Vector3)) == 0);
+
+        delete forceField;
+    }
+}
+
 QTEST_APPLESS_MAIN(AmberTest)
@@ -35,10 +35,13 @@
 
 #include "mdltest.h"
 
+#include <sstream>
+
 #include <boost/range/algorithm.hpp>
 
 #include <chemkit/molecule.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/moleculefilereader.h>
 #include <chemkit/moleculefileformat.h>
 
 const std::string dataPath = "../../../data/";
@@ -143,4 +146,118 @@ void MdlTest::read_serine()
     QCOMPARE(molecule->formula(), std::string("C3H7NO3"));
 }
 
+void MdlTest::readNext_benzenes()
+{
+    chemkit::MoleculeFileReader reader(dataPath + "pubchem_416_benzenes.sdf");
+
+    bool ok = reader.open();
+    if(!ok)
+        qDebug() << reader.errorString().c_str();
+    QVERIFY(ok);
+    QCOMPARE(reader.formatName(), std::string("sdf"));
+
+    // read each molecule one at a time
+    size_t count = 0;
+    while(boost::shared_ptr<chemkit::Molecule> molecule = reader.readNext()){
+        QCOMPARE(molecule->name(), molecule->data("PUBCHEM_COMPOUND_CID").toString());
+        count++;
+    }
+
+    QCOMPARE(count, size_t(416));
+    QCOMPARE(reader.position(), size_t(416));
+    QVERIFY(reader.atEnd());
+}
+
+void MdlTest::readNext_invalidRecord()
+{
+    std::string water =
+        "water\n"
+        "\n"
+        "\n"
+        "  3  2  0  0  0  0  0  0  0  0999 V2000\n"
+        "    0.0000    0.0000    0.0000 O   0  0  0  0  0  0  0  0  0  0  0  0\n"
+        "    0.9572    0.0000    0.0000 H   0  0  0  0  0  0  0  0  0  0  0  0\n"
+        "   -0.2400    0.9266    0.0000 H   0  0  0  0  0  0  0  0  0  0  0  0\n"
+        "  1  2  1  0  0  0  0\n"
+        "  1  3  1  0  0  0  0\n"
+        "M  END\n"
+        "$$$$\n";
+
+    // record with a truncated atom block
+    std::string invalid =
+        "invalid\n"
+        "\n"
+        "\n"
+        "  2  1  0  0  0  0  0  0  0  0999 V2000\n"
+        "    0.0000    0.0000\n"
+        "  1  2  1  0  0  0  0\n"
+        "M  END\n"
+        "$$$$\n";
+
+    // record which ends in the middle of its atom block
+    std::string truncated =
+        "truncated\n"
+        "\n"
+        "\n"
+        "  3  2  0  0  0  0  0  0  0  0999 V2000\n"
+        "    0.0000    0.0000    0.0000 O   0  0  0  0  0  0  0  0  0  0  0  0\n"
+        "$$$$\n";
+
+    std::stringstream input(water + invalid + water + truncated + water);
+
+    chemkit::MoleculeFileReader reader;
+    QVERIFY(reader.setFormat("sdf"));
+    QVERIFY(reader.open(input));
+
+    boost::shared_ptr<chemkit::Molecule> molecule = reader.readNext();
+    QVERIFY(molecule != 0);
+    QCOMPARE(molecule->formula(), std::string("H2O"));
+
+    // the invalid record is reported as an error rather than the end
+    // of the file
+    molecule = reader.readNext();
+    QVERIFY(molecule == 0);
+    QVERIFY(!reader.errorString().empty());
+    QCOMPARE(reader.position(), size_t(1));
+    QCOMPARE(reader.atEnd(), false);
+
+    // reading continues with the record after the invalid one
+    molecule = reader.readNext();
+    QVERIFY(molecule != 0);
+    QCOMPARE(molecule->formula(), std::string("H2O"));
+    QVERIFY(reader.errorString().empty());
+
+    molecule = reader.readNext();
+    QVERIFY(molecule == 0);
+    QVERIFY(!reader.errorString().empty());
+    QCOMPARE(reader.atEnd(), false);
+
+    molecule = reader.readNext();
+    QVERIFY(molecule != 0);
+    QCOMPARE(molecule->formula(), std::string("H2O"));
+    QCOMPARE(reader.position(), size_t(3));
+
+    QVERIFY(reader.readNext() == 0);
+    QCOMPARE(reader.atEnd(), true);
+    QVERIFY(reader.errorString().empty());
+
+    // the same records read into a molecule file, the invalid records
+    // are reported but the valid molecules are still read
+    std::stringstream fileInput(water + invalid + water + truncated + water);
+    chemkit::MoleculeFile file;
+    QCOMPARE(file.read(fileInput, "sdf"), false);
+    QVERIFY(!file.errorString().empty());
+    QCOMPARE(file.moleculeCount(), size_t(3));
+
+    // blank lines after the last record are ignored
+    std::stringstream trailingInput(water + water + "\n\n");
+    QVERIFY(reader.open(trailingInput));
+    size_t count = 0;
+    while(reader.readNext()){
+        count++;
+    }
+    QCOMPARE(count, size_t(2));
+    QVERIFY(reader.errorString().empty());
+}
+
 QTEST_APPLESS_MAIN(MdlTest)
@@ -48,6 +48,8 @@ class MdlTest : public QObject
         void read_guanine();
         void read_benzenes();
         void read_serine();
+        void readNext_benzenes();
+        void readNext_invalidRecord();
 };
 
 #endif // MDLTEST_H
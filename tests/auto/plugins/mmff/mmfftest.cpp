@@ -37,6 +37,8 @@
 
 #include <QtXml>
 
+#include <cstring>
+
 #include <boost/range/algorithm.hpp>
 
 #include <chemkit/molecule.h>
@@ -44,6 +46,7 @@
 #include <chemkit/atomtyper.h>
 #include <chemkit/forcefield.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/cartesiancoordinates.h>
 #include <chemkit/aromaticitymodel.h>
 #include <chemkit/partialchargemodel.h>
 #include <chemkit/moleculardescriptor.h>
@@ -192,4 +195,97 @@ void MmffTest::validate()
     QCOMPARE(failedMolecules.size(), 0);
 }
 
+namespace {
+
+// compares the exact bit patterns so that NaN values compare as equal
+bool sameBits(const std::vector<chemkit::Vector3> &a, const std::vector<chemkit::Vector3> &b)
+{
+    return a.size() == b.size() &&
+           (a.empty() || memcmp(&a[0], &b[0], a.size() * sizeof(chemkit::Vector3)) == 0);
+}
+
+} // end anonymous namespace
+
+// The threadCount() method checks that energies and gradients calculated
+// with multiple threads match the single-threaded results and that the
+// deterministic mode gives identical results for every thread count.
+void MmffTest::threadCount()
+{
+    chemkit::MoleculeFile dataFile(dataPath + "MMFF94_hypervalent.mol2");
+    QVERIFY(dataFile.read());
+
+    for(size_t i = 0; i < 50; i++){
+        const chemkit::Molecule *molecule = dataFile.molecule(i).get();
+        const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+        chemkit::ForceField *forceField = chemkit::ForceField::create("mmff");
+        QVERIFY(forceField);
+        forceField->setTopologyFromMolecule(molecule);
+        forceField->setup();
+
+        chemkit::Real energy = forceField->energy(coordinates);
+        std::vector<chemkit::Vector3> gradient = forceField->gradient(coordinates);
+
+        // default mode
+        forceField->setThreadCount(4);
+        QCOMPARE(forceField->threadCount(), size_t(4));
+        QVERIFY(qAbs(forceField->energy(coordinates) - energy) < 1e-6);
+        std::vector<chemkit::Vector3> threadedGradient = forceField->gradient(coordinates);
+        QCOMPARE(threadedGradient.size(), gradient.size());
+        for(size_t j = 0; j < gradient.size(); j++){
+            // skip gradients that are undefined for the serial calculation
+            if(!(gradient[j] == gradient[j])){
+                continue;
+            }
+
+            QVERIFY((threadedGradient[j] - gradient[j]).norm() < 1e-6);
+        }
+
+        // deterministic mode
+        forceField->setDeterministic(true);
+        QVERIFY(forceField->isDeterministic());
+        forceField->setThreadCount(1);
+        chemkit::Real deterministicEnergy = forceField->energy(coordinates);
+        std::vector<chemkit::Vector3> deterministicGradient = forceField->gradient(coordinates);
+        QVERIFY(sameBits(deterministicGradient, gradient));
+
+        for(size_t threadCount = 2; threadCount <= 8; threadCount *= 2){
+            forceField->setThreadCount(threadCount);
+            chemkit::Real threadedEnergy = forceField->energy(coordinates);
+            QVERIFY(memcmp(&threadedEnergy, &deterministicEnergy, sizeof(chemkit::Real)) == 0);
+            QVERIFY(sameBits(forceField->gradient(coordinates), deterministicGradient));
+        }
+
+        delete forceField;
+    }
+}
+
+// The energyAndGradient() method checks that the combined energy and
+// gradient calculation gives the same results as calculating them
+// separately.
+void MmffTest::energyAndGradient()
+{
+    chemkit::MoleculeFile dataFile(dataPath + "MMFF94_hypervalent.mol2");
+    QVERIFY(dataFile.read());
+
+    std::vector<chemkit::Vector3> gradient;
+
+    for(size_t i = 0; i < 50; i++){
+        const chemkit::Molecule *molecule = dataFile.molecule(i).get();
+        const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+        chemkit::ForceField *forceField = chemkit::ForceField::create("mmff");
+        QVERIFY(forceField);
+        forceField->setTopologyFromMolecule(molecule);
+        forceField->setup();
+
+        chemkit::Real energy = forceField->energyAndGradient(coordinates, gradient);
+        chemkit::Real expectedEnergy = forceField->energy(coordinates);
+        QVERIFY(memcmp(&energy, &expectedEnergy, sizeof(chemkit::Real)) == 0);
+        QVERIFY(sameBits(gradient, forceField->gradient(coordinates)));
+
+        delete forceField;
+    }
+}
+
 QTEST_APPLESS_MAIN(MmffTest)
@@ -45,6 +45,8 @@ class MmffTest : public QObject
     private slots:
         void initTestCase();
         void validate();
+        void threadCount();
+        void energyAndGradient();
 };
 
 #endif // MMFFTEST_H
@@ -0,0 +1,336 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "mmffparameterstest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include <chemkit/atom.h>
+#include <chemkit/molecule.h>
+
+#include "mmffparameters.h"
+
+const std::string parametersFileName = "mmff94.prm";
+const std::string textFileName = "mmffparameterstest.prm";
+const std::string compiledFileName = "mmffparameterstest.bin";
+
+namespace {
+
+// returns true if both parameters are missing or both are equal
+bool equal(const MmffBondStrechParameters *a, const MmffBondStrechParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->kb == b->kb && a->r0 == b->r0;
+}
+
+bool equal(const MmffAngleBendParameters *a, const MmffAngleBendParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->ka == b->ka && a->theta0 == b->theta0;
+}
+
+bool equal(const MmffStrechBendParameters *a, const MmffStrechBendParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->kba_ijk == b->kba_ijk && a->kba_kji == b->kba_kji;
+}
+
+bool equal(const MmffOutOfPlaneBendingParameters *a, const MmffOutOfPlaneBendingParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->koop == b->koop;
+}
+
+bool equal(const MmffTorsionParameters *a, const MmffTorsionParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->V1 == b->V1 && a->V2 == b->V2 && a->V3 == b->V3;
+}
+
+bool equal(const MmffVanDerWaalsParameters *a, const MmffVanDerWaalsParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->alpha == b->alpha && a->N == b->N && a->A == b->A && a->G == b->G && a->DA == b->DA;
+}
+
+bool equal(const MmffChargeParameters *a, const MmffChargeParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->bondType == b->bondType && a->typeA == b->typeA && a->typeB == b->typeB && a->bci == b->bci;
+}
+
+bool equal(const MmffPartialChargeParameters *a, const MmffPartialChargeParameters *b)
+{
+    if(!a || !b)
+        return a == b;
+
+    return a->pbci == b->pbci && a->fcadj == b->fcadj;
+}
+
+// Returns the integer columns at the start of each line in the
+// parameters file. Lines in section are returned for section (where
+// the first section is zero).
+std::vector<std::vector<int> > readTypes(const std::string &fileName, int section, int columns)
+{
+    std::vector<std::vector<int> > types;
+
+    std::ifstream file(fileName.c_str());
+    int currentSection = 0;
+    std::string line;
+    while(std::getline(file, line)){
+        boost::trim_left(line);
+
+        if(boost::starts_with(line, "$")){
+            currentSection++;
+            continue;
+        }
+        else if(currentSection != section || line.empty() || boost::starts_with(line, "#")){
+            continue;
+        }
+
+        std::stringstream stream(line);
+        std::vector<int> row(columns);
+        for(int i = 0; i < columns; i++){
+            stream >> row[i];
+        }
+
+        if(stream){
+            types.push_back(row);
+        }
+    }
+
+    return types;
+}
+
+void copyFile(const std::string &source, const std::string &destination)
+{
+    std::ifstream input(source.c_str(), std::ios::in | std::ios::binary);
+    std::ofstream output(destination.c_str(), std::ios::out | std::ios::binary);
+    output << input.rdbuf();
+}
+
+// replaces the first occurrence of before with after in fileName
+void replaceInFile(const std::string &fileName, const std::string &before, const std::string &after)
+{
+    std::string contents;
+    {
+        std::ifstream input(fileName.c_str(), std::ios::in | std::ios::binary);
+        std::stringstream buffer;
+        buffer << input.rdbuf();
+        contents = buffer.str();
+    }
+
+    boost::replace_first(contents, before, after);
+
+    std::ofstream output(fileName.c_str(), std::ios::out | std::ios::binary);
+    output << contents;
+}
+
+} // end anonymous namespace
+
+void MmffParametersTest::initTestCase()
+{
+    // make sure the parameters are read from the text file
+    std::remove((parametersFileName + ".bin").c_str());
+    std::remove((textFileName + ".bin").c_str());
+    std::remove(compiledFileName.c_str());
+}
+
+// The readWrite() method reads the parameters from the text file,
+// writes them to a compiled file and reads them back. Every parameter
+// lookup must return the same values from both.
+void MmffParametersTest::readWrite()
+{
+    MmffParameters text;
+    QVERIFY(text.read(parametersFileName));
+    QVERIFY(text.write(compiledFileName));
+
+    MmffParameters compiled;
+    QVERIFY(compiled.read(compiledFileName));
+    QCOMPARE(compiled.fileName(), compiledFileName);
+
+    const int maxType = MmffParameters::MaxAtomType;
+
+    // van der waals and partial charge parameters
+    for(int type = 1; type <= maxType; type++){
+        QVERIFY(equal(text.vanDerWaalsParameters(type), compiled.vanDerWaalsParameters(type)));
+        QVERIFY(equal(text.partialChargeParameters(type), compiled.partialChargeParameters(type)));
+    }
+
+    // charge parameters (the bond type is calculated from the bond)
+    chemkit::Molecule molecule;
+    chemkit::Atom *a = molecule.addAtom("C");
+    chemkit::Atom *b = molecule.addAtom("C");
+    molecule.addBond(a, b);
+
+    int chargeCount = 0;
+    for(int typeA = 1; typeA <= maxType; typeA++){
+        for(int typeB = 1; typeB <= maxType; typeB++){
+            const MmffChargeParameters *parameters = text.chargeParameters(a, typeA, b, typeB);
+            QVERIFY(equal(parameters, compiled.chargeParameters(a, typeA, b, typeB)));
+            chargeCount += parameters != 0;
+        }
+    }
+    QVERIFY(chargeCount > 0);
+
+    // bond strech parameters
+    for(int bondType = 0; bondType <= 1; bondType++){
+        for(int typeA = 1; typeA <= maxType; typeA++){
+            for(int typeB = 1; typeB <= maxType; typeB++){
+                QVERIFY(equal(text.bondStrechParameters(bondType, typeA, typeB),
+                              compiled.bondStrechParameters(bondType, typeA, typeB)));
+            }
+        }
+    }
+
+    // default strech bend parameters
+    for(int typeA = 1; typeA <= maxType; typeA++){
+        for(int typeB = 1; typeB <= maxType; typeB++){
+            for(int typeC = 1; typeC <= maxType; typeC++){
+                QVERIFY(equal(text.defaultStrechBendParameters(typeA, typeB, typeC),
+                              compiled.defaultStrechBendParameters(typeA, typeB, typeC)));
+            }
+        }
+    }
+
+    // angle bend parameters
+    std::vector<std::vector<int> > angles = readTypes(parametersFileName, 2, 4);
+    QVERIFY(!angles.empty());
+    foreach(const std::vector<int> &t, angles){
+        const MmffAngleBendParameters *parameters = text.angleBendParameters(t[0], t[1], t[2], t[3]);
+        QVERIFY(parameters != 0);
+        QVERIFY(equal(parameters, compiled.angleBendParameters(t[0], t[1], t[2], t[3])));
+    }
+
+    // strech bend parameters
+    std::vector<std::vector<int> > strechBends = readTypes(parametersFileName, 3, 4);
+    QVERIFY(!strechBends.empty());
+    foreach(const std::vector<int> &t, strechBends){
+        const MmffStrechBendParameters *parameters = text.strechBendParameters(t[0], t[1], t[2], t[3]);
+        QVERIFY(parameters != 0);
+        QVERIFY(equal(parameters, compiled.strechBendParameters(t[0], t[1], t[2], t[3])));
+    }
+
+    // out of plane bending parameters
+    std::vector<std::vector<int> > outOfPlaneBends = readTypes(parametersFileName, 5, 4);
+    QVERIFY(!outOfPlaneBends.empty());
+    foreach(const std::vector<int> &t, outOfPlaneBends){
+        QVERIFY(equal(text.outOfPlaneBendingParameters(t[0], t[1], t[2], t[3]),
+                      compiled.outOfPlaneBendingParameters(t[0], t[1], t[2], t[3])));
+    }
+
+    // torsion parameters
+    std::vector<std::vector<int> > torsions = readTypes(parametersFileName, 6, 5);
+    QVERIFY(!torsions.empty());
+    foreach(const std::vector<int> &t, torsions){
+        QVERIFY(equal(text.torsionParameters(t[0], t[1], t[2], t[3], t[4]),
+                      compiled.torsionParameters(t[0], t[1], t[2], t[3], t[4])));
+    }
+
+    std::remove(compiledFileName.c_str());
+}
+
+// The staleCompiledFile() method checks that the compiled file written
+// next to a parameters file is only used while the size and
+// modification time of the parameters file are unchanged.
+void MmffParametersTest::staleCompiledFile()
+{
+    const std::string binFileName = textFileName + ".bin";
+
+    copyFile(parametersFileName, textFileName);
+    std::time_t time = boost::filesystem::last_write_time(textFileName);
+
+    // reading the parameters writes the compiled file
+    MmffParameters original;
+    QVERIFY(original.read(textFileName));
+    QVERIFY(boost::filesystem::exists(binFileName));
+    QCOMPARE(original.vanDerWaalsParameters(1)->alpha, chemkit::Real(1.050));
+
+    // with the same size and modification time the compiled file is
+    // used even though the alpha value for type 1 has changed
+    replaceInFile(textFileName, "1     1.050     2.490", "1     1.060     2.490");
+    boost::filesystem::last_write_time(textFileName, time);
+
+    MmffParameters unchanged;
+    QVERIFY(unchanged.read(textFileName));
+    QCOMPARE(unchanged.vanDerWaalsParameters(1)->alpha, chemkit::Real(1.050));
+
+    // a different modification time causes the compiled file to be ignored
+    boost::filesystem::last_write_time(textFileName, time + 10);
+
+    MmffParameters modified;
+    QVERIFY(modified.read(textFileName));
+    QCOMPARE(modified.vanDerWaalsParameters(1)->alpha, chemkit::Real(1.060));
+
+    // a different size causes the compiled file to be ignored
+    std::time_t modifiedTime = boost::filesystem::last_write_time(textFileName);
+    replaceInFile(textFileName, "1     1.060     2.490", "1     1.0700     2.490");
+    boost::filesystem::last_write_time(textFileName, modifiedTime);
+
+    MmffParameters resized;
+    QVERIFY(resized.read(textFileName));
+    QCOMPARE(resized.vanDerWaalsParameters(1)->alpha, chemkit::Real(1.070));
+
+    std::remove(textFileName.c_str());
+    std::remove(binFileName.c_str());
+}
+
+void MmffParametersTest::cleanupTestCase()
+{
+    std::remove((parametersFileName + ".bin").c_str());
+    std::remove((textFileName + ".bin").c_str());
+    std::remove(compiledFileName.c_str());
+}
+
+QTEST_APPLESS_MAIN(MmffParametersTest)
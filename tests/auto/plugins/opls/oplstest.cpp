@@ -39,6 +39,8 @@
 
 #include "oplstest.h"
 
+#include <cstring>
+
 #include <boost/range/algorithm.hpp>
 
 #include <chemkit/molecule.h>
@@ -46,6 +48,7 @@
 #include <chemkit/atomtyper.h>
 #include <chemkit/forcefield.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/cartesiancoordinates.h>
 #include <chemkit/moleculardescriptor.h>
 
 const std::string dataPath = "../../../data/";
@@ -98,4 +101,39 @@ void OplsTest::energy()
     delete opls;
 }
 
+// The energyAndGradient() method checks that the combined energy and
+// gradient calculation gives the same results as calculating them
+// separately.
+void OplsTest::energyAndGradient()
+{
+    std::vector<std::string> fileNames;
+    fileNames.push_back("water.mol");
+    fileNames.push_back("methanol.sdf");
+    fileNames.push_back("ethanol.cml");
+
+    std::vector<chemkit::Vector3> gradient;
+
+    for(size_t i = 0; i < fileNames.size(); i++){
+        boost::shared_ptr<chemkit::Molecule> molecule =
+            chemkit::MoleculeFile::quickRead(dataPath + fileNames[i]);
+        QVERIFY(molecule != 0);
+        const chemkit::CartesianCoordinates *coordinates = molecule->coordinates();
+
+        chemkit::ForceField *forceField = chemkit::ForceField::create("opls");
+        QVERIFY(forceField != 0);
+        forceField->setTopologyFromMolecule(molecule.get());
+        QVERIFY(forceField->setup());
+
+        chemkit::Real energy = forceField->energyAndGradient(coordinates, gradient);
+        chemkit::Real expectedEnergy = forceField->energy(coordinates);
+        QVERIFY(memcmp(&energy, &expectedEnergy, sizeof(chemkit::Real)) == 0);
+
+        std::vector<chemkit::Vector3> expectedGradient = forceField->gradient(coordinates);
+        QCOMPARE(gradient.size(), expectedGradient.size());
+        QVERIFY(memcmp(&gradient[0], &expectedGradient[0], gradient.size() * sizeof(chemkit::Vector3)) == 0);
+
+        delete forceField;
+    }
+}
+
 QTEST_APPLESS_MAIN(OplsTest)
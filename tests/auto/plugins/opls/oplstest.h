@@ -46,6 +46,7 @@ class OplsTest : public QObject
         void initTestCase();
         void energy_data();
         void energy();
+        void energyAndGradient();
 };
 
 #endif // OPLSTEST_H
@@ -0,0 +1,142 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "screeningtest.h"
+
+#include <boost/range/algorithm.hpp>
+
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+#include <chemkit/substructurequery.h>
+#include <chemkit/substructureindex.h>
+
+const std::string dataPath = "../../../data/";
+
+void ScreeningTest::initTestCase()
+{
+    // verify that the screening plugin registered itself correctly
+    QVERIFY(boost::count(chemkit::Fingerprint::fingerprints(), "screening") == 1);
+}
+
+void ScreeningTest::name()
+{
+    chemkit::Fingerprint *fingerprint = chemkit::Fingerprint::create("screening");
+    QVERIFY(fingerprint != 0);
+    QCOMPARE(fingerprint->name(), std::string("screening"));
+    delete fingerprint;
+}
+
+void ScreeningTest::size()
+{
+    chemkit::Molecule molecule("c1ccccc1O", "smiles");
+    QCOMPARE(molecule.fingerprint("screening").size(), size_t(1024));
+}
+
+void ScreeningTest::substructure()
+{
+    // each query is a substructure of its target so the query's
+    // fingerprint must be a subset of the target's fingerprint
+    const char *pairs[][2] = {
+        { "C", "CCO" },
+        { "CO", "CCCCCCCCO" },
+        { "c1ccccc1", "c1ccccc1O" },
+        { "OC1CCCCC1", "CC1CCC(O)CC1" },
+        { "C=O", "C([C@@H](C(=O)O)N)O" },
+        { "CC(=O)O", "CN[C@H](CC(O)=O)C(O)=O" },
+        { "C1CCCC1", "C1CCC2(CC1)CCCC2" },
+        { "c1cc[nH]c1", "c1ccc2c(c1)c(c[nH]2)C[C@@H](C(=O)O)N" },
+        { "CNC", "CN1C=NC2=C1C(=O)N(C(=O)N2C)C" }
+    };
+
+    for(size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++){
+        chemkit::SubstructureQuery query(pairs[i][0], "smiles");
+        chemkit::Molecule target(pairs[i][1], "smiles");
+        QVERIFY(query.matches(&target));
+
+        chemkit::Bitset queryFingerprint = query.molecule()->fingerprint("screening");
+        chemkit::Bitset targetFingerprint = target.fingerprint("screening");
+        QVERIFY(queryFingerprint.is_subset_of(targetFingerprint));
+    }
+
+    // molecules with different rings are distinguished
+    chemkit::Molecule cyclopropane("C1CC1", "smiles");
+    chemkit::Molecule propane("CCC", "smiles");
+    QVERIFY(!cyclopropane.fingerprint("screening").is_subset_of(propane.fingerprint("screening")));
+}
+
+void ScreeningTest::index()
+{
+    chemkit::SubstructureIndex index;
+    QVERIFY(index.isEmpty());
+    QCOMPARE(index.fingerprintName(), std::string("screening"));
+
+    bool ok = index.build(dataPath + "pubchem_416_benzenes.sdf");
+    QVERIFY(ok);
+    QCOMPARE(index.size(), size_t(416));
+    QVERIFY(index.isCurrent());
+
+    // every match must be among the candidates
+    chemkit::SubstructureQuery query("c1ccccc1O", "smiles");
+
+    std::vector<size_t> candidates = index.candidates(query);
+    QVERIFY(candidates.size() < index.size());
+
+    size_t matchCount = 0;
+    for(size_t i = 0; i < index.size(); i++){
+        boost::shared_ptr<chemkit::Molecule> molecule = index.molecule(i);
+        QVERIFY(molecule != 0);
+
+        if(query.matches(molecule.get())){
+            QVERIFY(boost::count(candidates, i) == 1);
+            matchCount++;
+        }
+    }
+    QCOMPARE(index.search(query).size(), matchCount);
+
+    // write and read back the index
+    ok = index.write("screening.idx");
+    QVERIFY(ok);
+
+    chemkit::SubstructureIndex copy;
+    ok = copy.read("screening.idx");
+    QVERIFY(ok);
+    QCOMPARE(copy.size(), index.size());
+    QCOMPARE(copy.fileName(), index.fileName());
+    QVERIFY(copy.isCurrent());
+    QVERIFY(copy.candidates(query) == candidates);
+    QVERIFY(copy.fingerprint(5) == index.fingerprint(5));
+}
+
+QTEST_APPLESS_MAIN(ScreeningTest)
@@ -43,6 +43,7 @@
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/moleculefilereader.h>
 #include <chemkit/aromaticitymodel.h>
 #include <chemkit/substructurequery.h>
 #include <chemkit/moleculefileformat.h>
@@ -1221,6 +1222,14 @@ void SmilesTest::addHydrogens()
     delete format;
 }
 
+void SmilesTest::disconnected()
+{
+    chemkit::Molecule molecule("c1ccccc1.c1ccccc1", "smiles");
+    QCOMPARE(molecule.formula(), std::string("C12H12"));
+    QCOMPARE(molecule.fragmentCount(), size_t(2));
+    QCOMPARE(molecule.ringCount(), size_t(2));
+}
+
 void SmilesTest::isotope()
 {
     chemkit::LineFormat *format = chemkit::LineFormat::create("smiles");
@@ -1243,6 +1252,13 @@ void SmilesTest::isotope()
     QCOMPARE(molecule->formula(), std::string("U"));
     QCOMPARE(molecule->atom(0)->massNumber(), chemkit::Atom::MassNumberType(238));
 
+    delete molecule;
+
+    // atoms without a mass number should not use the ring number
+    molecule = format->read("C1CC1[Se]");
+    QVERIFY(molecule);
+    QCOMPARE(molecule->atom(3)->massNumber(), chemkit::Atom::MassNumberType(68));
+
     delete molecule;
     delete format;
 }
@@ -1304,6 +1320,27 @@ void SmilesTest::invalidAtom()
     delete format;
 }
 
+void SmilesTest::invalidRingNumber()
+{
+    chemkit::LineFormat *format = chemkit::LineFormat::create("smiles");
+    QVERIFY(format);
+
+    chemkit::Molecule *molecule = format->read("C%999999999C");
+    QVERIFY(molecule == 0);
+    QVERIFY(format->errorString().empty() == false);
+
+    molecule = format->read("C%1");
+    QVERIFY(molecule == 0);
+    QVERIFY(format->errorString().empty() == false);
+
+    molecule = format->read("C%10CCCCC%10");
+    QVERIFY(molecule != 0);
+    QCOMPARE(molecule->ringCount(), size_t(1));
+    delete molecule;
+
+    delete format;
+}
+
 void SmilesTest::wildcardAtom()
 {
     chemkit::LineFormat *format = chemkit::LineFormat::create("smiles");
@@ -1348,4 +1385,26 @@ void SmilesTest::cox2()
     QCOMPARE(file.molecule(127)->formula(), std::string("C21H19NO5S"));
 }
 
+void SmilesTest::cox2_readNext()
+{
+    chemkit::MoleculeFileReader reader(dataPath + "cox2.smi");
+
+    bool ok = reader.open();
+    if(!ok)
+        qDebug() << "Failed to open file: " << reader.errorString().c_str();
+    QVERIFY(ok);
+
+    boost::shared_ptr<chemkit::Molecule> molecule = reader.readNext();
+    QVERIFY(molecule != 0);
+    QCOMPARE(molecule->formula(), std::string("C13H18N2O5S"));
+
+    size_t count = 1;
+    while(reader.readNext()){
+        count++;
+    }
+
+    QCOMPARE(count, size_t(128));
+    QVERIFY(reader.readNext() == 0);
+}
+
 QTEST_APPLESS_MAIN(SmilesTest)
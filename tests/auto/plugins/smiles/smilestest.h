@@ -159,6 +159,7 @@ class SmilesTest : public QObject
 
         // feature tests
         void addHydrogens();
+        void disconnected();
         void isotope();
         void kekulize();
         void quadrupleBond();
@@ -166,11 +167,13 @@ class SmilesTest : public QObject
         // invalid tests
         void extraParenthesis();
         void invalidAtom();
+        void invalidRingNumber();
         void wildcardAtom();
 
         // file tests
         void herg();
         void cox2();
+        void cox2_readNext();
 
     private:
         void COMPARE_SMILES(const chemkit::Molecule *molecule, const std::string &smiles);
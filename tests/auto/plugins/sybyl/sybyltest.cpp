@@ -40,6 +40,7 @@
 #include <chemkit/molecule.h>
 #include <chemkit/atomtyper.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/moleculefilereader.h>
 #include <chemkit/moleculefileformat.h>
 
 const std::string dataPath = "../../../data/";
@@ -79,4 +80,25 @@ void SybylTest::readMol2()
     QCOMPARE(molecule->formula().c_str(), formula.constData());
 }
 
+void SybylTest::readNext()
+{
+    chemkit::MoleculeFile file(dataPath + "MMFF94_hypervalent.mol2");
+    QVERIFY(file.read());
+
+    chemkit::MoleculeFileReader reader(dataPath + "MMFF94_hypervalent.mol2");
+    QVERIFY(reader.open());
+
+    // the reader should return the same molecules as the file
+    size_t index = 0;
+    foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, reader){
+        QVERIFY(index < file.moleculeCount());
+        QCOMPARE(molecule->name(), file.molecule(index)->name());
+        QCOMPARE(molecule->formula(), file.molecule(index)->formula());
+        QCOMPARE(molecule->bondCount(), file.molecule(index)->bondCount());
+        index++;
+    }
+
+    QCOMPARE(index, file.moleculeCount());
+}
+
 QTEST_APPLESS_MAIN(SybylTest)
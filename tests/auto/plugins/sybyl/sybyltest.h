@@ -46,6 +46,7 @@ class SybylTest : public QObject
         void initTestCase();
         void readMol2_data();
         void readMol2();
+        void readNext();
 };
 
 #endif // SYBYLTEST_H
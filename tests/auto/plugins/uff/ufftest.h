@@ -44,6 +44,7 @@ class UffTest : public QObject
 
     private slots:
         void initTestCase();
+        void energyAndGradient();
 };
 
 #endif // UFFTEST_H
@@ -64,4 +64,51 @@ void XtcTest::spc216()
     QCOMPARE(trajectory->frameCount(), size_t(201));
 }
 
+void XtcTest::frameAccess()
+{
+    chemkit::TrajectoryFile file(dataPath + "spc216.xtc");
+    QVERIFY(file.read());
+    boost::shared_ptr<chemkit::Trajectory> trajectory = file.trajectory();
+
+    bool ok = file.open();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+    QVERIFY(file.isOpen());
+    QCOMPARE(file.frameCount(), size_t(201));
+
+    // read a single frame
+    chemkit::Trajectory single;
+    chemkit::TrajectoryFrame *frame = single.addFrame();
+    QVERIFY(file.readFrame(150, frame));
+    QCOMPARE(single.size(), size_t(648));
+    QVERIFY(frame->position(10) == trajectory->frame(150)->position(10));
+    QVERIFY(frame->time() == trajectory->frame(150)->time());
+    QVERIFY(!file.readFrame(201, frame));
+
+    // read every tenth frame
+    boost::shared_ptr<chemkit::Trajectory> strided = file.readFrames(5, file.frameCount(), 10);
+    QVERIFY(strided != 0);
+    QCOMPARE(strided->frameCount(), size_t(20));
+    for(size_t i = 0; i < strided->frameCount(); i++){
+        QVERIFY(strided->frame(i)->position(647) == trajectory->frame(5 + i * 10)->position(647));
+    }
+
+    // the opened file's trajectory reads its frames on demand
+    boost::shared_ptr<chemkit::Trajectory> lazy = file.trajectory();
+    QVERIFY(lazy != 0);
+    QVERIFY(lazy != trajectory);
+    QVERIFY(lazy->store() != 0);
+    QCOMPARE(lazy->size(), size_t(648));
+    QCOMPARE(lazy->frameCount(), size_t(201));
+    QCOMPARE(lazy->cachedFrameCount(), size_t(0));
+    QVERIFY(lazy->frame(200)->position(100) == trajectory->frame(200)->position(100));
+    QCOMPARE(lazy->cachedFrameCount(), size_t(1));
+
+    file.close();
+    QVERIFY(!file.isOpen());
+    QVERIFY(lazy->frame(100)->position(100) == trajectory->frame(100)->position(100));
+    QCOMPARE(file.frameCount(), size_t(0));
+}
+
 QTEST_APPLESS_MAIN(XtcTest)
@@ -45,6 +45,7 @@ class XtcTest : public QObject
     private slots:
         void initTestCase();
         void spc216();
+        void frameAccess();
 };
 
 #endif // XTCTEST_H
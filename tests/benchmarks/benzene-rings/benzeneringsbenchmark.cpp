@@ -37,11 +37,16 @@
 // algorithm.
 //
 // Based on: http://depth-first.com/articles/2009/01/21/mx-performance-comparison-2-exhaustive-ring-perception-in-mx-and-cdk
+//
+// The natural products and proteins benchmarks measure the ring
+// perception for large molecules where most of the atoms are not
+// part of a ring.
 
 #include "benzeneringsbenchmark.h"
 
 #include <chemkit/molecule.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/bondpredictor.h>
 
 const std::string dataPath = "../../data/";
 
@@ -73,4 +78,66 @@ void BenzeneRingsBenchmark::benchmark()
     QCOMPARE(ringCount, 1288);
 }
 
+void BenzeneRingsBenchmark::naturalProducts_data()
+{
+    QTest::addColumn<QString>("smiles");
+    QTest::addColumn<int>("ringCount");
+
+    QTest::newRow("erythromycin")
+        << "CCC1C(C(C(C(=O)C(CC(C(C(C(C(C(=O)O1)C)OC2CC(C(C(O2)C)O)(C)OC)C)OC3C(C(CC(O3)C)N(C)C)O)(C)O)C)C)O)(C)O"
+        << 3;
+    QTest::newRow("strychnine")
+        << "C1CN2CC3=CCOC4CC(=O)N5C6C4C3CC2C61C7=CC=CC=C75"
+        << 7;
+    QTest::newRow("paclitaxel")
+        << "CC1=C2C(C(=O)C3(C(CC4C(C3C(C(C2(C)C)(CC1OC(=O)C(C(C5=CC=CC=C5)NC(=O)C6=CC=CC=C6)O)O)OC(=O)C7=CC=CC=C7)(CO4)OC(=O)C)O)C)OC(=O)C"
+        << 7;
+    QTest::newRow("vancomycin")
+        << "CC1C(C(CC(O1)OC2C(C(C(OC2OC3=C4C=C5C=C3OC6=C(C=C(C=C6)C(C(C(=O)NC(C(=O)NC5C(=O)NC7C8=CC(=C(C=C8)O)C9=C(C=C(C=C9O)O)C(NC(=O)C(C(C1=CC(=C(O4)C=C1)Cl)O)NC7=O)C(=O)O)CC(=O)N)NC(=O)C(CC(C)C)NC)O)Cl)CO)O)O)(C)N)O"
+        << 10;
+}
+
+void BenzeneRingsBenchmark::naturalProducts()
+{
+    QFETCH(QString, smiles);
+    QFETCH(int, ringCount);
+
+    chemkit::Molecule molecule(smiles.toStdString(), "smiles");
+    QVERIFY(!molecule.isEmpty());
+
+    QBENCHMARK {
+        // copy the molecule so that the rings are perceived each time
+        chemkit::Molecule copy(molecule);
+        QCOMPARE(copy.rings().size(), size_t(ringCount));
+    }
+}
+
+void BenzeneRingsBenchmark::proteins_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("ringCount");
+
+    QTest::newRow("2DHB") << "2DHB.pdb" << 57;
+    QTest::newRow("1THM") << "1THM.pdb" << 46;
+    QTest::newRow("2LYZ") << "2LYZ.pdb" << 32;
+}
+
+void BenzeneRingsBenchmark::proteins()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, ringCount);
+
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + fileName.toStdString());
+    QVERIFY(molecule != 0);
+
+    // the pdb files only contain bonds for the hetero groups
+    chemkit::BondPredictor::predictBonds(molecule.get());
+
+    QBENCHMARK {
+        chemkit::Molecule copy(*molecule);
+        QCOMPARE(copy.rings().size(), size_t(ringCount));
+    }
+}
+
 QTEST_APPLESS_MAIN(BenzeneRingsBenchmark)
@@ -44,6 +44,10 @@ class BenzeneRingsBenchmark : public QObject
 
     private slots:
         void benchmark();
+        void naturalProducts_data();
+        void naturalProducts();
+        void proteins_data();
+        void proteins();
 };
 
 #endif // BENZENERINGSBENCHMARK_H
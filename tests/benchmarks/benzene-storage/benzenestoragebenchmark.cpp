@@ -0,0 +1,190 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+// This benchmark measures the time and memory used to store the
+// atoms and bonds of the 416 molecules in the benzenes data set.
+//
+// The memory benchmark counts the heap allocations made while
+// reading the file by replacing the global operator new and
+// operator delete.
+
+#include "benzenestoragebenchmark.h"
+
+#include <new>
+#include <cstdlib>
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/moleculefile.h>
+
+const std::string dataPath = "../../data/";
+
+namespace {
+
+size_t allocationCount = 0;
+long long allocatedBytes = 0;
+
+// each allocation is prefixed with its size so that the number of
+// bytes in use can be tracked when it is freed
+const size_t headerSize = 2 * sizeof(size_t);
+
+} // end anonymous namespace
+
+void* operator new(size_t size)
+{
+    size_t *block = static_cast<size_t *>(std::malloc(size + headerSize));
+    if(!block){
+        throw std::bad_alloc();
+    }
+
+    block[0] = size;
+    allocationCount++;
+    allocatedBytes += size;
+
+    return reinterpret_cast<char *>(block) + headerSize;
+}
+
+void operator delete(void *pointer) throw()
+{
+    if(!pointer){
+        return;
+    }
+
+    size_t *block = reinterpret_cast<size_t *>(static_cast<char *>(pointer) - headerSize);
+    allocatedBytes -= block[0];
+
+    std::free(block);
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *pointer) throw()
+{
+    operator delete(pointer);
+}
+
+void BenzeneStorageBenchmark::read()
+{
+    QBENCHMARK {
+        chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+        bool ok = file.read();
+        if(!ok)
+            qDebug() << file.errorString().c_str();
+        QVERIFY(ok);
+        QCOMPARE(file.moleculeCount(), size_t(416));
+    }
+}
+
+void BenzeneStorageBenchmark::copy()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    QBENCHMARK {
+        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+            chemkit::Molecule copy(*molecule);
+            QCOMPARE(copy.bondCount(), molecule->bondCount());
+        }
+    }
+}
+
+void BenzeneStorageBenchmark::traverse()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    size_t neighborCount = 0;
+
+    QBENCHMARK {
+        neighborCount = 0;
+
+        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+            foreach(const chemkit::Atom *atom, molecule->atoms()){
+                foreach(const chemkit::Atom *neighbor, atom->neighbors()){
+                    if(neighbor->index() > atom->index()){
+                        neighborCount++;
+                    }
+                }
+            }
+        }
+    }
+
+    size_t bondCount = 0;
+    foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+        bondCount += molecule->bondCount();
+    }
+
+    // each bond is counted once from its lower indexed atom
+    QCOMPARE(neighborCount, bondCount);
+}
+
+void BenzeneStorageBenchmark::memory()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+
+    size_t initialAllocationCount = allocationCount;
+    long long initialAllocatedBytes = allocatedBytes;
+
+    QBENCHMARK_ONCE {
+        bool ok = file.read();
+        if(!ok)
+            qDebug() << file.errorString().c_str();
+        QVERIFY(ok);
+    }
+
+    size_t atomCount = 0;
+    size_t bondCount = 0;
+    foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+        atomCount += molecule->atomCount();
+        bondCount += molecule->bondCount();
+    }
+
+    qDebug() << "atoms:" << atomCount
+             << "bonds:" << bondCount
+             << "allocations:" << (allocationCount - initialAllocationCount)
+             << "bytes in use:" << (allocatedBytes - initialAllocatedBytes);
+}
+
+QTEST_APPLESS_MAIN(BenzeneStorageBenchmark)
@@ -35,6 +35,8 @@
 
 #include "mmffenergybenchmark.h"
 
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
 #include <chemkit/molecule.h>
 #include <chemkit/topology.h>
 #include <chemkit/forcefield.h>
@@ -74,4 +76,68 @@ void MmffEnergyBenchmark::benchmark()
     QCOMPARE(qRound(totalEnergy), 5228);
 }
 
+void MmffEnergyBenchmark::scaling_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("deterministic");
+
+    QTest::newRow("1 thread") << 1 << false;
+    QTest::newRow("2 threads") << 2 << false;
+    QTest::newRow("4 threads") << 4 << false;
+    QTest::newRow("8 threads") << 8 << false;
+    QTest::newRow("8 threads (deterministic)") << 8 << true;
+}
+
+// The scaling() method measures the energy and gradient evaluation time
+// with multiple threads. The system is built by placing the first 100
+// molecules of the validation suite on a grid which results in a single
+// molecule with several thousand atoms and millions of nonbonded pairs.
+void MmffEnergyBenchmark::scaling()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, deterministic);
+
+    // load test file
+    chemkit::MoleculeFile file(dataPath + "MMFF94_hypervalent.mol2");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    // build cluster
+    chemkit::Molecule cluster;
+    for(size_t i = 0; i < 100; i++){
+        const chemkit::Molecule *molecule = file.molecule(i).get();
+        chemkit::Vector3 offset(15.0 * (i % 5), 15.0 * ((i / 5) % 5), 15.0 * (i / 25));
+
+        size_t firstAtom = cluster.size();
+        foreach(const chemkit::Atom *atom, molecule->atoms()){
+            chemkit::Atom *copy = cluster.addAtomCopy(atom);
+            copy->setPosition(atom->position() + offset);
+        }
+
+        foreach(const chemkit::Bond *bond, molecule->bonds()){
+            cluster.addBond(firstAtom + bond->atom1()->index(),
+                            firstAtom + bond->atom2()->index(),
+                            bond->order());
+        }
+    }
+
+    chemkit::ForceField *forceField = chemkit::ForceField::create("mmff");
+    QVERIFY(forceField);
+    forceField->setTopologyFromMolecule(&cluster);
+    forceField->setup();
+    forceField->setThreadCount(threadCount);
+    forceField->setDeterministic(deterministic);
+
+    const chemkit::CartesianCoordinates *coordinates = cluster.coordinates();
+
+    QBENCHMARK {
+        forceField->energy(coordinates);
+        forceField->gradient(coordinates);
+    }
+
+    delete forceField;
+}
+
 QTEST_APPLESS_MAIN(MmffEnergyBenchmark)
@@ -44,6 +44,8 @@ class MmffEnergyBenchmark : public QObject
 
     private slots:
         void benchmark();
+        void scaling_data();
+        void scaling();
 };
 
 #endif // MMFFENERGYBENCHMARK_H
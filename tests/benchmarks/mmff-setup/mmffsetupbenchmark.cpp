@@ -0,0 +1,88 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+// This benchmark measures the time it takes to set up the mmff force
+// field for proteins from the test data set. Bonds are predicted from
+// the atomic coordinates. The proteins lack the bond orders needed to
+// assign every parameter, so setup is not expected to succeed, but
+// every calculation is still created and looked up in the topology.
+
+#include "mmffsetupbenchmark.h"
+
+#include <chemkit/molecule.h>
+#include <chemkit/topology.h>
+#include <chemkit/forcefield.h>
+#include <chemkit/moleculefile.h>
+#include <chemkit/bondpredictor.h>
+
+const std::string dataPath = "../../data/";
+
+void MmffSetupBenchmark::benchmark_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("atomCount");
+    QTest::addColumn<int>("torsionCount");
+
+    QTest::newRow("1D3Z") << "1D3Z.pdb" << 1231 << 3299;
+    QTest::newRow("2DHB") << "2DHB.pdb" << 2201 << 3602;
+}
+
+void MmffSetupBenchmark::benchmark()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, atomCount);
+    QFETCH(int, torsionCount);
+
+    boost::shared_ptr<chemkit::Molecule> molecule =
+        chemkit::MoleculeFile::quickRead(dataPath + fileName.toStdString());
+    QVERIFY(molecule != 0);
+    QCOMPARE(molecule->size(), size_t(atomCount));
+
+    chemkit::BondPredictor::predictBonds(molecule.get());
+
+    QBENCHMARK_ONCE {
+        chemkit::ForceField *forceField = chemkit::ForceField::create("mmff");
+        QVERIFY(forceField);
+
+        forceField->setTopologyFromMolecule(molecule.get());
+        forceField->setup();
+
+        QCOMPARE(forceField->topology()->torsionInteractionCount(), size_t(torsionCount));
+
+        delete forceField;
+    }
+}
+
+QTEST_APPLESS_MAIN(MmffSetupBenchmark)
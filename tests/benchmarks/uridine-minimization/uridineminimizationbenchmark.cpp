@@ -41,21 +41,37 @@
 
 const std::string dataPath = "../../data/";
 
+void UridineMinimizationBenchmark::benchmark_data()
+{
+    QTest::addColumn<int>("algorithm");
+
+    QTest::newRow("steepest-descent") << int(chemkit::MoleculeGeometryOptimizer::SteepestDescent);
+    QTest::newRow("conjugate-gradient") << int(chemkit::MoleculeGeometryOptimizer::ConjugateGradient);
+    QTest::newRow("l-bfgs") << int(chemkit::MoleculeGeometryOptimizer::Lbfgs);
+}
+
 void UridineMinimizationBenchmark::benchmark()
 {
+    QFETCH(int, algorithm);
+
     boost::shared_ptr<chemkit::Molecule> molecule = chemkit::MoleculeFile::quickRead(dataPath + "uridine.mol2");
     QVERIFY(molecule != 0);
 
     chemkit::MoleculeGeometryOptimizer optimizer;
     optimizer.setForceField("uff");
+    optimizer.setAlgorithm(chemkit::MoleculeGeometryOptimizer::Algorithm(algorithm));
     optimizer.setMolecule(molecule.get());
 
-    bool ok = optimizer.setup();
-    QVERIFY(ok);
-
     QBENCHMARK {
+        // start each iteration from the input coordinates
+        bool ok = optimizer.setup();
+        QVERIFY(ok);
+
         for(;;){
-            optimizer.step();
+            // stop if the minimizer stalls before converging
+            if(!optimizer.step()){
+                break;
+            }
 
             // converge when rmsg = 0.1
             if(optimizer.converged()){
@@ -63,6 +79,8 @@ void UridineMinimizationBenchmark::benchmark()
             }
         }
     }
+
+    QVERIFY(optimizer.evaluationCount() > 0);
 }
 
 QTEST_APPLESS_MAIN(UridineMinimizationBenchmark)